@@ -0,0 +1,167 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <BlockCompression.h>
+#include <Types.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Epoch;
+
+namespace EpochEngineTest
+{
+    // Fills a block with one color in the first 8 texels and another in the rest.
+    static void fillBlock( const U8* first, const U8* second, U8* outTexels ) {
+        for( U32 i = 0; i < 16; ++i ) {
+            const U8* color = i < 8 ? first : second;
+            for( U32 c = 0; c < 4; ++c ) {
+                outTexels[i * 4 + c] = color[c];
+            }
+        }
+    }
+
+    static void unpackColor565( const U32 packed, I32* outColor ) {
+        I32 r = ( packed >> 11 ) & 0x1F;
+        I32 g = ( packed >> 5 ) & 0x3F;
+        I32 b = packed & 0x1F;
+        outColor[0] = ( r << 3 ) | ( r >> 2 );
+        outColor[1] = ( g << 2 ) | ( g >> 4 );
+        outColor[2] = ( b << 3 ) | ( b >> 2 );
+    }
+
+    // Decodes a BC1 block as a GPU would, into RGB texels 4 bytes apart.
+    static void decodeBC1( const U8* block, U8* outTexels ) {
+        U32 color0 = block[0] | ( block[1] << 8 );
+        U32 color1 = block[2] | ( block[3] << 8 );
+        I32 palette[4][3];
+        unpackColor565( color0, palette[0] );
+        unpackColor565( color1, palette[1] );
+        for( U32 c = 0; c < 3; ++c ) {
+            if( color0 > color1 ) {
+                palette[2][c] = ( 2 * palette[0][c] + palette[1][c] ) / 3;
+                palette[3][c] = ( palette[0][c] + 2 * palette[1][c] ) / 3;
+            } else {
+                palette[2][c] = ( palette[0][c] + palette[1][c] ) / 2;
+                palette[3][c] = 0;
+            }
+        }
+
+        U32 indices = block[4] | ( block[5] << 8 ) | ( block[6] << 16 ) | ( (U32)block[7] << 24 );
+        for( U32 i = 0; i < 16; ++i ) {
+            U32 index = ( indices >> ( i * 2 ) ) & 3;
+            for( U32 c = 0; c < 3; ++c ) {
+                outTexels[i * 4 + c] = (U8)palette[index][c];
+            }
+        }
+    }
+
+    // Reads bits from a block, least significant first, advancing the given bit position.
+    static U32 readBits( const U8* block, U32* bit, const U32 count ) {
+        U32 value = 0;
+        for( U32 i = 0; i < count; ++i, ++( *bit ) ) {
+            value |= ( ( block[*bit >> 3] >> ( *bit & 7 ) ) & 1U ) << i;
+        }
+        return value;
+    }
+
+    // Decodes a BC7 block as a GPU would, into RGBA texels. Only mode 6 is supported, so returns false for any other mode.
+    static const bool decodeBC7Mode6( const U8* block, U8* outTexels ) {
+        static const U32 weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        U32 bit = 0;
+        if( readBits( block, &bit, 7 ) != 0x40 ) {
+            return false;
+        }
+
+        U32 endpoints[2][4];
+        for( U32 c = 0; c < 4; ++c ) {
+            endpoints[0][c] = readBits( block, &bit, 7 );
+            endpoints[1][c] = readBits( block, &bit, 7 );
+        }
+        U32 pBit0 = readBits( block, &bit, 1 );
+        U32 pBit1 = readBits( block, &bit, 1 );
+        for( U32 c = 0; c < 4; ++c ) {
+            endpoints[0][c] = ( endpoints[0][c] << 1 ) | pBit0;
+            endpoints[1][c] = ( endpoints[1][c] << 1 ) | pBit1;
+        }
+
+        // The first index has an implied high bit of zero.
+        for( U32 i = 0; i < 16; ++i ) {
+            U32 weight = weights[readBits( block, &bit, i == 0 ? 3 : 4 )];
+            for( U32 c = 0; c < 4; ++c ) {
+                outTexels[i * 4 + c] = (U8)( ( ( 64 - weight ) * endpoints[0][c] + weight * endpoints[1][c] + 32 ) >> 6 );
+            }
+        }
+        return true;
+    }
+
+    static void assertTexelsNear( const U8* expected, const U8* actual, const U32 channelCount, const I32 tolerance ) {
+        for( U32 i = 0; i < 16; ++i ) {
+            for( U32 c = 0; c < channelCount; ++c ) {
+                I32 difference = (I32)expected[i * 4 + c] - (I32)actual[i * 4 + c];
+                Assert::IsTrue( difference <= tolerance && difference >= -tolerance );
+            }
+        }
+    }
+
+    TEST_CLASS( BlockCompressionTest ) {
+public:
+
+    // Colors which are exact in 5:6:5 come back from BC1 unchanged.
+    TEST_METHOD( BC1SolidColor ) {
+        const U8 magenta[4] = { 255, 0, 255, 255 };
+        U8 texels[64];
+        fillBlock( magenta, magenta, texels );
+
+        U8 block[8];
+        BlockCompression::EncodeBC1( texels, block );
+        U8 decoded[64];
+        decodeBC1( block, decoded );
+        assertTexelsNear( texels, decoded, 3, 0 );
+    }
+
+    TEST_METHOD( BC1TwoColors ) {
+        const U8 black[4] = { 0, 0, 0, 255 };
+        const U8 white[4] = { 255, 255, 255, 255 };
+        U8 texels[64];
+        fillBlock( black, white, texels );
+
+        U8 block[8];
+        BlockCompression::EncodeBC1( texels, block );
+
+        // The 4 color mode must be used, as the other one decodes index 3 as black regardless of the endpoints.
+        U32 color0 = block[0] | ( block[1] << 8 );
+        U32 color1 = block[2] | ( block[3] << 8 );
+        Assert::IsTrue( color0 > color1 );
+
+        U8 decoded[64];
+        decodeBC1( block, decoded );
+        assertTexelsNear( texels, decoded, 3, 0 );
+    }
+
+    // BC7 endpoints are 7 bits per channel plus a bit shared by every channel, so a channel may be off by one.
+    TEST_METHOD( BC7SolidColor ) {
+        const U8 color[4] = { 200, 101, 50, 255 };
+        U8 texels[64];
+        fillBlock( color, color, texels );
+
+        U8 block[16];
+        BlockCompression::EncodeBC7( texels, block );
+        U8 decoded[64];
+        Assert::IsTrue( decodeBC7Mode6( block, decoded ) );
+        assertTexelsNear( texels, decoded, 4, 1 );
+    }
+
+    TEST_METHOD( BC7TwoColors ) {
+        const U8 first[4] = { 10, 200, 30, 0 };
+        const U8 second[4] = { 240, 40, 180, 255 };
+        U8 texels[64];
+        fillBlock( first, second, texels );
+
+        U8 block[16];
+        BlockCompression::EncodeBC7( texels, block );
+        U8 decoded[64];
+        Assert::IsTrue( decodeBC7Mode6( block, decoded ) );
+        assertTexelsNear( texels, decoded, 4, 1 );
+    }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <Math/TMath.h>
+#include <Math/Vector3.h>
+#include <String/TString.h>
+#include <World/Entities/CameraEntity.h>
+#include <Types.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Epoch;
+
+namespace EpochEngineTest
+{
+    static void assertVectorNear( const Vector3& expected, const Vector3& actual ) {
+        Assert::AreEqual( expected.X, actual.X, 0.0001f );
+        Assert::AreEqual( expected.Y, actual.Y, 0.0001f );
+        Assert::AreEqual( expected.Z, actual.Z, 0.0001f );
+    }
+
+    TEST_CLASS( CameraEntityTest ) {
+public:
+
+    TEST_METHOD( ATan2TakesYThenX ) {
+        Assert::AreEqual( TMath::PI * 0.5f, TMath::ATan2( 1.0f, 0.0f ), 0.0001f );
+        Assert::AreEqual( -TMath::PI * 0.5f, TMath::ATan2( -1.0f, 0.0f ), 0.0001f );
+        Assert::AreEqual( TMath::PI, TMath::ATan2( 0.0f, -1.0f ), 0.0001f );
+        Assert::AreEqual( (F32)TMath::ATan2( 0.3, -0.7 ), TMath::ATan2( 0.3f, -0.7f ), 0.0001f );
+    }
+
+    TEST_METHOD( UpdateKeepsLookAtDirection ) {
+        CameraEntity* camera = CameraEntity::Create( TString( "camera" ) );
+
+        // The default camera's placement, and a few in other quadrants.
+        const Vector3 positions[4] = {
+            Vector3( 0.0f, 25.0f, 25.0f ),
+            Vector3( -10.0f, 5.0f, 3.0f ),
+            Vector3( 4.0f, -8.0f, -6.0f ),
+            Vector3( 7.0f, 0.0f, -2.0f ),
+        };
+        for( U32 i = 0; i < 4; ++i ) {
+            camera->SetPosition( positions[i] );
+            camera->LookAt( Vector3::Zero() );
+            Vector3 expected = Vector3::Normalized( Vector3::Zero() - positions[i] );
+            assertVectorNear( expected, camera->GetForward() );
+
+            // With no input, rebuilding the direction from yaw and pitch must not turn the camera.
+            camera->Update( 0.016f );
+            assertVectorNear( expected, camera->GetForward() );
+        }
+
+        WObject::Free( camera );
+    }
+    };
+}
\ No newline at end of file
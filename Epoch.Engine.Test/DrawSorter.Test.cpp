@@ -0,0 +1,54 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <Renderer/Frontend/DrawSorter.h>
+#include <Types.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Epoch;
+
+namespace EpochEngineTest
+{
+
+    TEST_CLASS( DrawSorterTest ) {
+public:
+
+    TEST_METHOD( KeysOrderByStateThenDepth ) {
+        U64 nearMesh = DrawSorter::SetDepth( DrawSorter::MakeKey( DrawPass::Opaque, 0, 0, 1 ), DrawPass::Opaque, 0.1f );
+        U64 farMesh = DrawSorter::SetDepth( DrawSorter::MakeKey( DrawPass::Opaque, 0, 0, 0 ), DrawPass::Opaque, 0.9f );
+        U64 otherShader = DrawSorter::SetDepth( DrawSorter::MakeKey( DrawPass::Opaque, 1, 0, 0 ), DrawPass::Opaque, 0.0f );
+        U64 transparent = DrawSorter::MakeKey( DrawPass::Transparent, 0, 0, 0 );
+
+        // The mesh outranks depth, the shader outranks the mesh, and the pass outranks everything.
+        Assert::IsTrue( farMesh < nearMesh );
+        Assert::IsTrue( nearMesh < otherShader );
+        Assert::IsTrue( otherShader < transparent );
+
+        Assert::AreEqual( 1U, DrawSorter::GetShaderId( otherShader ) );
+        Assert::AreEqual( 1U, DrawSorter::GetMeshId( nearMesh ) );
+        Assert::AreEqual( 0U, DrawSorter::GetMaterialId( nearMesh ) );
+
+        // Opaque draws go front to back, transparent draws back to front.
+        U64 base = DrawSorter::MakeKey( DrawPass::Opaque, 0, 0, 0 );
+        Assert::IsTrue( DrawSorter::SetDepth( base, DrawPass::Opaque, 0.2f ) < DrawSorter::SetDepth( base, DrawPass::Opaque, 0.8f ) );
+        base = DrawSorter::MakeKey( DrawPass::Transparent, 0, 0, 0 );
+        Assert::IsTrue( DrawSorter::SetDepth( base, DrawPass::Transparent, 0.8f ) < DrawSorter::SetDepth( base, DrawPass::Transparent, 0.2f ) );
+    }
+
+    TEST_METHOD( SortIsStableAndCarriesValues ) {
+        const U32 count = 6;
+        U64 keys[count] = { 5, 0x0100000000000002ULL, 5, 1, 0x0100000000000000ULL, 1 };
+        U32 values[count] = { 0, 1, 2, 3, 4, 5 };
+        U64 scratchKeys[count];
+        U32 scratchValues[count];
+        DrawSorter::Sort( keys, values, count, scratchKeys, scratchValues );
+
+        U64 expectedKeys[count] = { 1, 1, 5, 5, 0x0100000000000000ULL, 0x0100000000000002ULL };
+        U32 expectedValues[count] = { 3, 5, 0, 2, 4, 1 };
+        for( U32 i = 0; i < count; ++i ) {
+            Assert::AreEqual( expectedKeys[i], keys[i] );
+            Assert::AreEqual( expectedValues[i], values[i] );
+        }
+    }
+    };
+}
\ No newline at end of file
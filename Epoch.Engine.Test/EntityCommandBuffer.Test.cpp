@@ -0,0 +1,143 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <Types.h>
+#include <String/TString.h>
+#include <World/Entity.h>
+#include <World/Level.h>
+#include <World/EntityCommandBuffer.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Epoch;
+
+namespace EpochEngineTest
+{
+    // Clears the watched entity pointer passed as context once that entity is released.
+    static void clearIfReleased( void* context, Entity* entity ) {
+        Entity** watched = static_cast<Entity**>( context );
+        if( *watched == entity ) {
+            *watched = nullptr;
+        }
+    }
+
+    TEST_CLASS( EntityCommandBufferTest ) {
+public:
+
+    TEST_METHOD( CreateEntityRejectsMissingParent ) {
+        EntityCommandBuffer buffer;
+        Assert::IsNull( buffer.CreateEntity( TString( "orphan" ), nullptr ) );
+        Assert::AreEqual( 0U, buffer.GetPendingCount() );
+
+        buffer.Apply();
+        Assert::AreEqual( 0U, buffer.GetStats().Applied );
+    }
+
+    TEST_METHOD( DestroyReleasesHierarchy ) {
+        Level level( TString( "level" ) );
+        Entity* root = level.GetRootEntity();
+        EntityCommandBuffer buffer;
+
+        Entity* parent = buffer.CreateEntity( TString( "parent" ), root );
+        Entity* child = buffer.CreateEntity( TString( "child" ), parent );
+        Entity* sibling = buffer.CreateEntity( TString( "sibling" ), root );
+        buffer.Apply();
+        Assert::AreEqual( 3U, level.GetEntityCount() );
+        Assert::AreEqual( 2U, root->ChildCount() );
+        Assert::IsTrue( child->GetParent() == parent );
+
+        // Destroying a child along with its parent releases it only once.
+        buffer.DestroyEntity( child );
+        buffer.DestroyEntity( parent );
+        buffer.Apply();
+
+        EntityCommandBufferStats stats = buffer.GetStats();
+        Assert::AreEqual( 2U, stats.EntitiesFreed );
+        Assert::AreEqual( 1U, level.GetEntityCount() );
+        Assert::AreEqual( 1U, root->ChildCount() );
+        Assert::IsTrue( sibling->GetParent() == root );
+
+        level.Unload();
+    }
+
+    TEST_METHOD( ReleaseCallbackSeesDestroyedDescendants ) {
+        Level level( TString( "level" ) );
+        EntityCommandBuffer buffer;
+
+        Entity* parent = buffer.CreateEntity( TString( "parent" ), level.GetRootEntity() );
+        Entity* child = buffer.CreateEntity( TString( "child" ), parent );
+        buffer.Apply();
+
+        Entity* watched = child;
+        buffer.SetReleaseCallback( &clearIfReleased, &watched );
+        buffer.DestroyEntity( parent );
+        buffer.Apply();
+        Assert::IsNull( watched );
+
+        buffer.SetReleaseCallback( nullptr, nullptr );
+        level.Unload();
+    }
+
+    TEST_METHOD( UnloadCallsReleaseCallback ) {
+        Level level( TString( "level" ) );
+        EntityCommandBuffer buffer;
+
+        Entity* parent = buffer.CreateEntity( TString( "parent" ), level.GetRootEntity() );
+        Entity* child = buffer.CreateEntity( TString( "child" ), parent );
+        buffer.Apply();
+
+        // Unloading frees entities without going through a command buffer, so it must report them itself.
+        Entity* watched = child;
+        level.Unload( &clearIfReleased, &watched );
+        Assert::IsNull( watched );
+    }
+
+    TEST_METHOD( ReparentMovesHierarchyAcrossLevels ) {
+        Level source( TString( "source" ) );
+        Level destination( TString( "destination" ) );
+        EntityCommandBuffer buffer;
+
+        Entity* entity = buffer.CreateEntity( TString( "entity" ), source.GetRootEntity() );
+        Entity* child = buffer.CreateEntity( TString( "child" ), entity );
+        buffer.Apply();
+        Assert::IsTrue( child->GetLevel() == &source );
+
+        buffer.SetParent( entity, destination.GetRootEntity() );
+        buffer.Apply();
+
+        Assert::IsTrue( entity->GetParent() == destination.GetRootEntity() );
+        Assert::IsTrue( entity->GetLevel() == &destination );
+        Assert::IsTrue( child->GetLevel() == &destination );
+        Assert::AreEqual( 0U, source.GetEntityCount() );
+        Assert::AreEqual( 0U, source.GetRootEntity()->ChildCount() );
+        Assert::AreEqual( 2U, destination.GetEntityCount() );
+
+        // Parenting to a descendant is refused.
+        buffer.SetParent( entity, child );
+        buffer.Apply();
+        Assert::IsTrue( entity->GetParent() == destination.GetRootEntity() );
+
+        source.Unload();
+        destination.Unload();
+    }
+
+    TEST_METHOD( CreateAndDestroyInOneBatch ) {
+        Level level( TString( "level" ) );
+        EntityCommandBuffer buffer;
+
+        Entity* entity = buffer.CreateEntity( TString( "transient" ), level.GetRootEntity() );
+        buffer.CreateEntity( TString( "child" ), entity );
+        buffer.DestroyEntity( entity );
+        Assert::AreEqual( 3U, buffer.GetPendingCount() );
+        buffer.Apply();
+
+        // Creates are applied before destroys, so both are attached and then released.
+        Assert::AreEqual( 0U, buffer.GetPendingCount() );
+        Assert::AreEqual( 3U, buffer.GetStats().Applied );
+        Assert::AreEqual( 2U, buffer.GetStats().EntitiesFreed );
+        Assert::AreEqual( 0U, level.GetEntityCount() );
+        Assert::AreEqual( 0U, level.GetRootEntity()->ChildCount() );
+
+        level.Unload();
+    }
+    };
+}
\ No newline at end of file
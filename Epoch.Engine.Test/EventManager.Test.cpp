@@ -0,0 +1,171 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <thread>
+#include <chrono>
+
+#include <Containers/List.h>
+#include <Events/Event.h>
+#include <Events/EventManager.h>
+#include <Types.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Epoch;
+
+namespace EpochEngineTest
+{
+    struct KeyedPayload {
+        U32 Key;
+        U32 Value;
+    };
+
+    // Records the value of each event it receives, and how many batches they arrived in.
+    class RecordingHandler : public IEventHandler {
+    public:
+        List<U32> Values;
+        List<EventType> Types;
+        U32 BatchCount = 0;
+        U32 BatchDelayMs = 0;
+
+        virtual void OnEvent( const Event* event ) override {
+            Values.Add( event->GetPayload<KeyedPayload>().Value );
+            Types.Add( event->Type );
+        }
+
+        virtual void OnEventBatch( const Event* events, const U32 count ) override {
+            BatchCount++;
+            if( BatchDelayMs > 0 ) {
+                std::this_thread::sleep_for( std::chrono::milliseconds( BatchDelayMs ) );
+            }
+            IEventHandler::OnEventBatch( events, count );
+        }
+    };
+
+    static void postKeyed( const EventType type, const U32 key, const U32 value ) {
+        Event event( type, nullptr );
+        event.SetPayload( KeyedPayload { key, value } );
+        EventManager::Post( event, false );
+    }
+
+    TEST_CLASS( EventManagerTest ) {
+public:
+
+    TEST_METHOD_CLEANUP( ResetManager ) {
+        EventManager::SetCoalescePolicy( EventType::ASSET_LOADED, EventCoalescePolicy::NONE );
+        EventManager::SetCoalescePolicy( EventType::UNKNOWN, EventCoalescePolicy::NONE );
+        EventManager::SetUpdateBudget( EVENT_DEFAULT_UPDATE_BUDGET_MS );
+    }
+
+    TEST_METHOD( QueuedEventsKeepPostOrderAcrossBatches ) {
+        RecordingHandler handler;
+        EventManager::Listen( EventType::ASSET_LOADED, &handler );
+        EventManager::Listen( EventType::UNKNOWN, &handler );
+
+        postKeyed( EventType::ASSET_LOADED, 0, 1 );
+        postKeyed( EventType::ASSET_LOADED, 0, 2 );
+        postKeyed( EventType::UNKNOWN, 0, 3 );
+        postKeyed( EventType::ASSET_LOADED, 0, 4 );
+        Assert::AreEqual( 0U, handler.Values.Size() );
+
+        EventManager::Update( 0.0f );
+        EventManager::StopListening( EventType::ASSET_LOADED, &handler );
+        EventManager::StopListening( EventType::UNKNOWN, &handler );
+
+        // Each run of the same type is one batch.
+        Assert::AreEqual( 4U, handler.Values.Size() );
+        Assert::AreEqual( 3U, handler.BatchCount );
+        for( U32 i = 0; i < 4; ++i ) {
+            Assert::AreEqual( i + 1, handler.Values[i] );
+        }
+        Assert::IsTrue( handler.Types[2] == EventType::UNKNOWN );
+    }
+
+    TEST_METHOD( KeepLastDeliversOnlyTheLatest ) {
+        RecordingHandler handler;
+        EventManager::Listen( EventType::ASSET_LOADED, &handler );
+        EventManager::SetCoalescePolicy( EventType::ASSET_LOADED, EventCoalescePolicy::KEEP_LAST );
+        EventManagerStats before = EventManager::GetStats();
+
+        postKeyed( EventType::ASSET_LOADED, 1, 10 );
+        postKeyed( EventType::ASSET_LOADED, 2, 20 );
+        postKeyed( EventType::ASSET_LOADED, 1, 30 );
+        EventManager::Update( 0.0f );
+        EventManager::StopListening( EventType::ASSET_LOADED, &handler );
+
+        Assert::AreEqual( 1U, handler.Values.Size() );
+        Assert::AreEqual( 30U, handler.Values[0] );
+
+        EventManagerStats after = EventManager::GetStats();
+        Assert::AreEqual( 3ULL, after.Posted - before.Posted );
+        Assert::AreEqual( 2ULL, after.Coalesced - before.Coalesced );
+        Assert::AreEqual( 1ULL, after.Delivered - before.Delivered );
+    }
+
+    TEST_METHOD( MergeByKeyKeepsTheLatestPerKey ) {
+        RecordingHandler handler;
+        EventManager::Listen( EventType::ASSET_LOADED, &handler );
+        EventManager::SetCoalescePolicy( EventType::ASSET_LOADED, EventCoalescePolicy::MERGE_BY_KEY, sizeof( U32 ) );
+
+        postKeyed( EventType::ASSET_LOADED, 1, 10 );
+        postKeyed( EventType::ASSET_LOADED, 2, 20 );
+        postKeyed( EventType::ASSET_LOADED, 1, 30 );
+        postKeyed( EventType::ASSET_LOADED, 3, 40 );
+        EventManager::Update( 0.0f );
+        EventManager::StopListening( EventType::ASSET_LOADED, &handler );
+
+        // The survivors keep the position of their latest post.
+        Assert::AreEqual( 3U, handler.Values.Size() );
+        Assert::AreEqual( 20U, handler.Values[0] );
+        Assert::AreEqual( 30U, handler.Values[1] );
+        Assert::AreEqual( 40U, handler.Values[2] );
+    }
+
+    TEST_METHOD( BudgetDefersTheRestInOrder ) {
+        RecordingHandler handler;
+        handler.BatchDelayMs = 2;
+        EventManager::Listen( EventType::ASSET_LOADED, &handler );
+        EventManager::Listen( EventType::UNKNOWN, &handler );
+        EventManager::SetUpdateBudget( 1.0f );
+
+        // Alternating types, so every event is its own batch.
+        postKeyed( EventType::ASSET_LOADED, 0, 1 );
+        postKeyed( EventType::UNKNOWN, 0, 2 );
+        postKeyed( EventType::ASSET_LOADED, 0, 3 );
+
+        EventManager::Update( 0.0f );
+        Assert::AreEqual( 1U, handler.Values.Size() );
+
+        // Events posted after deferral go behind the deferred ones.
+        postKeyed( EventType::UNKNOWN, 0, 4 );
+        EventManager::SetUpdateBudget( 0.0f );
+        EventManager::Update( 0.0f );
+        EventManager::StopListening( EventType::ASSET_LOADED, &handler );
+        EventManager::StopListening( EventType::UNKNOWN, &handler );
+
+        Assert::AreEqual( 4U, handler.Values.Size() );
+        for( U32 i = 0; i < 4; ++i ) {
+            Assert::AreEqual( i + 1, handler.Values[i] );
+        }
+    }
+
+    TEST_METHOD( ImmediateEventsBypassTheQueue ) {
+        RecordingHandler handler;
+        EventManager::Listen( EventType::ASSET_LOADED, &handler );
+        EventManager::SetCoalescePolicy( EventType::ASSET_LOADED, EventCoalescePolicy::KEEP_LAST );
+        EventManagerStats before = EventManager::GetStats();
+
+        Event event( EventType::ASSET_LOADED, nullptr );
+        event.SetPayload( KeyedPayload { 0, 7 } );
+        EventManager::Post( event, true );
+        EventManager::Post( event, true );
+        EventManager::StopListening( EventType::ASSET_LOADED, &handler );
+
+        // Never coalesced, and not counted as delivered.
+        Assert::AreEqual( 2U, handler.Values.Size() );
+        Assert::AreEqual( 0U, handler.BatchCount );
+        EventManagerStats after = EventManager::GetStats();
+        Assert::AreEqual( 2ULL, after.Posted - before.Posted );
+        Assert::AreEqual( 0ULL, after.Delivered - before.Delivered );
+    }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <Math/Matrix4x4.h>
+#include <Math/Frustum.h>
+#include <Renderer/Frontend/FrustumCuller.h>
+#include <Types.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Epoch;
+
+namespace EpochEngineTest
+{
+    // Looks down -Z with no view transform, so the volume is x and y in [-10, 10] and z in [-100, -1].
+    static Frustum makeBoxFrustum() {
+        return Frustum::FromViewProjection( Matrix4x4::Orthographic( -10.0f, 10.0f, -10.0f, 10.0f, 1.0f, 100.0f ) );
+    }
+
+    static AABB makeBox( const F32 x, const F32 y, const F32 z, const F32 extent ) {
+        return AABB( Vector3( x - extent, y - extent, z - extent ), Vector3( x + extent, y + extent, z + extent ) );
+    }
+
+    // Fills bounds with deterministic pseudo-random boxes scattered in and around a 60 degree perspective frustum.
+    static void fillRandomBounds( CullingBounds& bounds, const U32 count ) {
+        U32 state = 12345;
+        auto next = [&state]() {
+            state = state * 1664525U + 1013904223U;
+            return (F32)( state >> 8 ) / (F32)( 1 << 24 );
+        };
+        for( U32 i = 0; i < count; ++i ) {
+            bounds.Add( makeBox( next() * 200.0f - 100.0f, next() * 200.0f - 100.0f, next() * 200.0f - 150.0f, next() * 5.0f ) );
+        }
+    }
+
+    TEST_CLASS( FrustumCullerTest ) {
+public:
+
+    TEST_METHOD( FromViewProjectionExtractsPlanes ) {
+        Frustum frustum = makeBoxFrustum();
+
+        // Left, right, bottom, top, near, far, all facing inward.
+        const F32 expected[6][4] = {
+            { 1.0f, 0.0f, 0.0f, 10.0f },
+            { -1.0f, 0.0f, 0.0f, 10.0f },
+            { 0.0f, 1.0f, 0.0f, 10.0f },
+            { 0.0f, -1.0f, 0.0f, 10.0f },
+            { 0.0f, 0.0f, -1.0f, -1.0f },
+            { 0.0f, 0.0f, 1.0f, 100.0f },
+        };
+        for( U32 i = 0; i < 6; ++i ) {
+            const Plane& plane = frustum.Planes[i];
+            Assert::AreEqual( expected[i][0], plane.Normal.X, 0.0001f );
+            Assert::AreEqual( expected[i][1], plane.Normal.Y, 0.0001f );
+            Assert::AreEqual( expected[i][2], plane.Normal.Z, 0.0001f );
+            Assert::AreEqual( expected[i][3], plane.Distance, 0.001f );
+        }
+    }
+
+    TEST_METHOD( IntersectsAABBInsideOutsideAndStraddling ) {
+        Frustum frustum = makeBoxFrustum();
+
+        Assert::IsTrue( frustum.IntersectsAABB( makeBox( 0.0f, 0.0f, -50.0f, 1.0f ) ) );
+        Assert::IsFalse( frustum.IntersectsAABB( makeBox( 20.0f, 0.0f, -50.0f, 1.0f ) ) );
+        Assert::IsFalse( frustum.IntersectsAABB( makeBox( 0.0f, 0.0f, 5.0f, 1.0f ) ) );
+        Assert::IsFalse( frustum.IntersectsAABB( makeBox( 0.0f, 0.0f, -150.0f, 1.0f ) ) );
+
+        // Boxes crossing a plane count as visible.
+        Assert::IsTrue( frustum.IntersectsAABB( makeBox( 10.0f, 0.0f, -50.0f, 1.0f ) ) );
+        Assert::IsTrue( frustum.IntersectsAABB( makeBox( 0.0f, -10.5f, -50.0f, 1.0f ) ) );
+        Assert::IsTrue( frustum.IntersectsAABB( makeBox( 0.0f, 0.0f, -100.5f, 1.0f ) ) );
+    }
+
+    TEST_METHOD( CullRangeKeepsVisibleIndicesInOrder ) {
+        Frustum frustum = makeBoxFrustum();
+        CullingBounds bounds;
+        bounds.Add( makeBox( 0.0f, 0.0f, -50.0f, 1.0f ) );   // Inside.
+        bounds.Add( makeBox( 20.0f, 0.0f, -50.0f, 1.0f ) );  // Outside.
+        bounds.Add( makeBox( -10.0f, 0.0f, -50.0f, 1.0f ) ); // Straddling.
+        bounds.Add( makeBox( 0.0f, 0.0f, 5.0f, 1.0f ) );     // Behind.
+        bounds.Add( makeBox( 5.0f, 5.0f, -2.0f, 1.0f ) );    // Inside, handled by the scalar tail.
+        bounds.Add( makeBox( 0.0f, 0.0f, -101.5f, 1.0f ) );  // Past the far plane.
+
+        U32 visible[6];
+        U32 visibleCount = FrustumCuller::CullRange( frustum, bounds, 0, bounds.Size(), visible );
+        Assert::AreEqual( 3U, visibleCount );
+        Assert::AreEqual( 0U, visible[0] );
+        Assert::AreEqual( 2U, visible[1] );
+        Assert::AreEqual( 4U, visible[2] );
+
+        // Ranges report absolute indices.
+        visibleCount = FrustumCuller::CullRange( frustum, bounds, 1, 4, visible );
+        Assert::AreEqual( 2U, visibleCount );
+        Assert::AreEqual( 2U, visible[0] );
+        Assert::AreEqual( 4U, visible[1] );
+
+        visibleCount = FrustumCuller::Cull( frustum, bounds, visible );
+        Assert::AreEqual( 3U, visibleCount );
+    }
+
+    TEST_METHOD( SimdMatchesScalar ) {
+        Frustum frustum = Frustum::FromViewProjection( Matrix4x4::Perspective( 1.0471976f, 1.5f, 0.1f, 120.0f ) );
+        CullingBounds bounds;
+        fillRandomBounds( bounds, 1003 );
+
+        U32 simd[1003];
+        U32 scalar[1003];
+        U32 simdCount = FrustumCuller::CullRange( frustum, bounds, 3, 1000, simd );
+        U32 scalarCount = FrustumCuller::CullRangeScalar( frustum, bounds, 3, 1000, scalar );
+        Assert::AreEqual( scalarCount, simdCount );
+        Assert::IsTrue( simdCount > 0 && simdCount < 1000 );
+        for( U32 i = 0; i < simdCount; ++i ) {
+            Assert::AreEqual( scalar[i], simd[i] );
+        }
+    }
+
+    TEST_METHOD( ThreadedCullMatchesScalar ) {
+        Frustum frustum = Frustum::FromViewProjection( Matrix4x4::Perspective( 1.0471976f, 1.5f, 0.1f, 120.0f ) );
+        CullingBounds bounds;
+        const U32 count = 100003;
+        fillRandomBounds( bounds, count );
+
+        List<U32> threaded;
+        List<U32> scalar;
+        threaded.Resize( count );
+        scalar.Resize( count );
+        U32 scalarCount = FrustumCuller::CullRangeScalar( frustum, bounds, 0, count, scalar.Data() );
+
+        // Once per thread limit, so the pool is reused across calls and chunk boundaries move.
+        for( U32 maxThreads = 0; maxThreads <= 4; ++maxThreads ) {
+            U32 threadedCount = FrustumCuller::Cull( frustum, bounds, threaded.Data(), maxThreads );
+            Assert::AreEqual( scalarCount, threadedCount );
+            for( U32 i = 0; i < threadedCount; ++i ) {
+                Assert::AreEqual( scalar[i], threaded[i] );
+            }
+        }
+    }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <Assets/Image/ImageUtilities.h>
+#include <Memory/Memory.h>
+#include <Types.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Epoch;
+
+namespace EpochEngineTest
+{
+
+    TEST_CLASS( ImageUtilitiesTest ) {
+public:
+
+    TEST_METHOD( MipLevelCountReachesOnePixel ) {
+        Assert::AreEqual( 1U, ImageUtilities::GetMipLevelCount( 1, 1 ) );
+        Assert::AreEqual( 10U, ImageUtilities::GetMipLevelCount( 512, 512 ) );
+        Assert::AreEqual( 10U, ImageUtilities::GetMipLevelCount( 512, 3 ) );
+        Assert::AreEqual( 3U, ImageUtilities::GetMipLevelCount( 5, 7 ) );
+    }
+
+    TEST_METHOD( MipChainAveragesEachLevel ) {
+
+        // A 2x2 image with one white texel, which averages to a quarter in linear space.
+        byte pixels[16] = {
+            255, 255, 255, 255,   0, 0, 0, 0,
+              0,   0,   0,   0,   0, 0, 0, 0
+        };
+
+        U32 levelCount;
+        U64 size;
+        byte* chain = ImageUtilities::GenerateMipChain( pixels, 2, 2, false, &levelCount, &size );
+        Assert::AreEqual( 2U, levelCount );
+        Assert::AreEqual( (U64)20, size );
+        Assert::AreEqual( 0, TMemory::Memcmp( chain, pixels, 16 ) );
+        Assert::AreEqual( (byte)64, chain[16] );
+        Assert::AreEqual( (byte)64, chain[19] );
+        TMemory::Free( chain );
+
+        // In sRGB, a quarter of linear white is encoded much brighter. Alpha is still averaged linearly.
+        chain = ImageUtilities::GenerateMipChain( pixels, 2, 2, true, &levelCount, &size );
+        Assert::AreEqual( (byte)137, chain[16] );
+        Assert::AreEqual( (byte)64, chain[19] );
+        TMemory::Free( chain );
+    }
+    };
+}
\ No newline at end of file
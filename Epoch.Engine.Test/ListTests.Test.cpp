@@ -42,5 +42,22 @@ public:
 
     }
 
+    TEST_METHOD( RemoveAtSwap ) {
+        List<int> list;
+        list.Add( 0 );
+        list.Add( 1 );
+        list.Add( 2 );
+        list.Add( 3 );
+
+        list.RemoveAtSwap( 1 ); // Should be 0, 3, 2
+        Assert::AreEqual( 3U, list.Size() );
+        Assert::AreEqual( 3, list[1] );
+
+        list.RemoveAtSwap( 2 ); // Should be 0, 3
+        Assert::AreEqual( 2U, list.Size() );
+        Assert::AreEqual( 0, list[0] );
+        Assert::AreEqual( 3, list[1] );
+    }
+
     };
 }
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <Types.h>
+#include <Containers/List.h>
+#include <Math/Vector3.h>
+#include <Math/BoundingVolumes.h>
+#include <String/TString.h>
+#include <World/Entity.h>
+#include <World/LooseOctree.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Epoch;
+
+namespace EpochEngineTest
+{
+    static AABB makeBox( const F32 x, const F32 y, const F32 z, const F32 extent ) {
+        return AABB( Vector3( x - extent, y - extent, z - extent ), Vector3( x + extent, y + extent, z + extent ) );
+    }
+
+    static const bool contains( List<Entity*>& results, Entity* entity ) {
+        return results.IndexOf( entity ) != -1;
+    }
+
+    TEST_CLASS( LooseOctreeTest ) {
+public:
+
+    TEST_METHOD( InsertAndQuery ) {
+        LooseOctree tree( Vector3( 0.0f ), 100.0f );
+        Entity* smallBox = Entity::Create( TString( "small" ) );
+        Entity* distantBox = Entity::Create( TString( "distant" ) );
+        Entity* outsideBox = Entity::Create( TString( "outside" ) );
+
+        tree.Insert( smallBox, makeBox( 10.0f, 10.0f, 10.0f, 0.5f ) );
+        tree.Insert( distantBox, makeBox( -60.0f, -60.0f, -60.0f, 0.5f ) );
+        tree.Insert( outsideBox, makeBox( 500.0f, 0.0f, 0.0f, 1.0f ) );
+        Assert::AreEqual( 3U, tree.Size() );
+
+        List<Entity*> results;
+        tree.QueryAABB( makeBox( 10.0f, 10.0f, 10.0f, 2.0f ), results );
+        Assert::AreEqual( 1U, results.Size() );
+        Assert::IsTrue( contains( results, smallBox ) );
+
+        // Entities outside of the root cell are still found.
+        results.Clear();
+        tree.QueryAABB( makeBox( 500.0f, 0.0f, 0.0f, 2.0f ), results );
+        Assert::AreEqual( 1U, results.Size() );
+        Assert::IsTrue( contains( results, outsideBox ) );
+
+        BoundingSphere sphere;
+        sphere.Center = Vector3( -58.0f, -60.0f, -60.0f );
+        sphere.Radius = 2.0f;
+        results.Clear();
+        tree.QuerySphere( sphere, results );
+        Assert::AreEqual( 1U, results.Size() );
+        Assert::IsTrue( contains( results, distantBox ) );
+
+        Entity::Free( smallBox );
+        Entity::Free( distantBox );
+        Entity::Free( outsideBox );
+    }
+
+    TEST_METHOD( UpdateAndRemove ) {
+        LooseOctree tree( Vector3( 0.0f ), 100.0f );
+        Entity* a = Entity::Create( TString( "a" ) );
+        Entity* b = Entity::Create( TString( "b" ) );
+        U32 handleA = tree.Insert( a, makeBox( 10.0f, 10.0f, 10.0f, 0.5f ) );
+        U32 handleB = tree.Insert( b, makeBox( -10.0f, -10.0f, -10.0f, 0.5f ) );
+
+        // Moving across the tree leaves nothing behind at the old position.
+        tree.Update( handleA, makeBox( -80.0f, 80.0f, -80.0f, 0.5f ) );
+        List<Entity*> results;
+        tree.QueryAABB( makeBox( 10.0f, 10.0f, 10.0f, 2.0f ), results );
+        Assert::AreEqual( 0U, results.Size() );
+        tree.QueryAABB( makeBox( -80.0f, 80.0f, -80.0f, 2.0f ), results );
+        Assert::AreEqual( 1U, results.Size() );
+        Assert::IsTrue( contains( results, a ) );
+
+        tree.Remove( handleB );
+        Assert::AreEqual( 1U, tree.Size() );
+        results.Clear();
+        tree.QueryAABB( makeBox( 0.0f, 0.0f, 0.0f, 100.0f ), results );
+        Assert::AreEqual( 1U, results.Size() );
+        Assert::IsTrue( contains( results, a ) );
+
+        // Freed handles are reused.
+        Assert::AreEqual( handleB, tree.Insert( b, makeBox( 0.0f, 0.0f, 0.0f, 1.0f ) ) );
+        Assert::AreEqual( 2U, tree.Size() );
+
+        Entity::Free( a );
+        Entity::Free( b );
+    }
+
+    TEST_METHOD( BuildMatchesInserts ) {
+        LooseOctree tree( Vector3( 0.0f ), 100.0f );
+        const U32 count = 64;
+        Entity* entities[count];
+        AABB bounds[count];
+        U32 handles[count];
+        for( U32 i = 0; i < count; ++i ) {
+            entities[i] = Entity::Create( TString( "e" ) );
+            bounds[i] = makeBox( (F32)( i % 4 ) * 40.0f - 60.0f, (F32)( ( i / 4 ) % 4 ) * 40.0f - 60.0f, (F32)( i / 16 ) * 40.0f - 60.0f, 1.0f );
+        }
+        tree.Build( entities, bounds, count, handles );
+        Assert::AreEqual( count, tree.Size() );
+
+        for( U32 i = 0; i < count; ++i ) {
+            List<Entity*> results;
+            tree.QueryAABB( bounds[i], results );
+            Assert::AreEqual( 1U, results.Size() );
+            Assert::IsTrue( results[0] == entities[i] );
+        }
+
+        for( U32 i = 0; i < count; ++i ) {
+            Entity::Free( entities[i] );
+        }
+    }
+
+    TEST_METHOD( RaycastFindsClosest ) {
+        LooseOctree tree( Vector3( 0.0f ), 100.0f );
+        Entity* nearBox = Entity::Create( TString( "near" ) );
+        Entity* fartherBox = Entity::Create( TString( "farther" ) );
+        Entity* offsetBox = Entity::Create( TString( "offset" ) );
+        tree.Insert( fartherBox, makeBox( 50.0f, 0.0f, 0.0f, 1.0f ) );
+        tree.Insert( nearBox, makeBox( 10.0f, 0.0f, 0.0f, 1.0f ) );
+        tree.Insert( offsetBox, makeBox( 30.0f, 20.0f, 0.0f, 1.0f ) );
+
+        F32 distance = 0.0f;
+        Entity* hit = tree.Raycast( Vector3( -20.0f, 0.0f, 0.0f ), Vector3( 1.0f, 0.0f, 0.0f ), 1000.0f, &distance );
+        Assert::IsTrue( hit == nearBox );
+        Assert::AreEqual( 29.0f, distance, 0.001f );
+
+        List<Entity*> results;
+        tree.QueryRay( Vector3( -20.0f, 0.0f, 0.0f ), Vector3( 1.0f, 0.0f, 0.0f ), 1000.0f, results );
+        Assert::AreEqual( 2U, results.Size() );
+        Assert::IsTrue( contains( results, nearBox ) && contains( results, fartherBox ) );
+
+        // Out of range.
+        Assert::IsNull( tree.Raycast( Vector3( -20.0f, 0.0f, 0.0f ), Vector3( 1.0f, 0.0f, 0.0f ), 10.0f ) );
+
+        Entity::Free( nearBox );
+        Entity::Free( fartherBox );
+        Entity::Free( offsetBox );
+    }
+
+    TEST_METHOD( RayParallelToSlabPlane ) {
+        LooseOctree tree( Vector3( 0.0f ), 100.0f );
+        Entity* box = Entity::Create( TString( "box" ) );
+        tree.Insert( box, makeBox( 10.0f, 0.0f, 0.0f, 1.0f ) );
+
+        // The origin lies exactly on the box's y and z planes, with zero direction along both.
+        F32 distance = 0.0f;
+        Assert::IsTrue( tree.Raycast( Vector3( 0.0f, 1.0f, -1.0f ), Vector3( 1.0f, 0.0f, 0.0f ), 100.0f, &distance ) == box );
+        Assert::AreEqual( 9.0f, distance, 0.001f );
+
+        // Parallel, but outside of the y slab.
+        Assert::IsNull( tree.Raycast( Vector3( 0.0f, 1.5f, 0.0f ), Vector3( 1.0f, 0.0f, 0.0f ), 100.0f ) );
+
+        // Straight down onto the box, and straight down beside it.
+        Assert::IsTrue( tree.Raycast( Vector3( 11.0f, 50.0f, 0.0f ), Vector3( 0.0f, -1.0f, 0.0f ), 100.0f ) == box );
+        Assert::IsNull( tree.Raycast( Vector3( 11.5f, 50.0f, 0.0f ), Vector3( 0.0f, -1.0f, 0.0f ), 100.0f ) );
+
+        Entity::Free( box );
+    }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <thread>
+
+#include <Containers/MPSCQueue.h>
+#include <Types.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Epoch;
+
+namespace EpochEngineTest
+{
+
+    TEST_CLASS( MPSCQueueTest ) {
+public:
+
+    TEST_METHOD( PushPopInOrder ) {
+        MPSCQueue<U32, 4> queue;
+        U32 value = 0;
+        Assert::IsFalse( queue.TryPop( &value ) );
+
+        Assert::IsTrue( queue.TryPush( 1 ) );
+        Assert::IsTrue( queue.TryPush( 2 ) );
+        Assert::IsTrue( queue.TryPush( 3 ) );
+        Assert::IsTrue( queue.TryPush( 4 ) );
+        Assert::IsFalse( queue.TryPush( 5 ) ); // Full
+
+        Assert::IsTrue( queue.TryPop( &value ) );
+        Assert::AreEqual( 1U, value );
+        Assert::IsTrue( queue.TryPush( 5 ) ); // Wraps around
+
+        for( U32 expected = 2; expected <= 5; ++expected ) {
+            Assert::IsTrue( queue.TryPop( &value ) );
+            Assert::AreEqual( expected, value );
+        }
+        Assert::IsFalse( queue.TryPop( &value ) );
+        Assert::AreEqual( 5ULL, queue.GetPushCount() );
+        Assert::AreEqual( 5ULL, queue.GetPopCount() );
+    }
+
+    TEST_METHOD( MultipleProducers ) {
+        struct Item {
+            U32 Producer;
+            U32 Value;
+        };
+        static MPSCQueue<Item, 256> queue;
+        const U32 producerCount = 4;
+        const U32 itemsPerProducer = 10000;
+
+        std::thread* producers[producerCount];
+        for( U32 p = 0; p < producerCount; ++p ) {
+            producers[p] = new std::thread( [p, itemsPerProducer]() {
+                for( U32 i = 0; i < itemsPerProducer; ) {
+                    if( queue.TryPush( { p, i } ) ) {
+                        ++i;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            } );
+        }
+
+        // Items from each producer must arrive in the order that producer pushed them.
+        U32 nextValue[producerCount] = {};
+        U32 received = 0;
+        Item item;
+        while( received < producerCount * itemsPerProducer ) {
+            if( queue.TryPop( &item ) ) {
+                Assert::AreEqual( nextValue[item.Producer], item.Value );
+                nextValue[item.Producer]++;
+                received++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+        for( U32 p = 0; p < producerCount; ++p ) {
+            producers[p]->join();
+            delete producers[p];
+        }
+        Assert::IsFalse( queue.TryPop( &item ) );
+    }
+
+    };
+}
\ No newline at end of file
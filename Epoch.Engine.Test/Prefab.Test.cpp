@@ -0,0 +1,95 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <Types.h>
+#include <Containers/List.h>
+#include <Math/Transform.h>
+#include <String/TString.h>
+#include <World/Entity.h>
+#include <World/EntityComponents/EntityComponent.h>
+#include <World/Level.h>
+#include <World/Prefab.h>
+#include <World/EntityCommandBuffer.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Epoch;
+
+namespace EpochEngineTest
+{
+
+    TEST_CLASS( PrefabTest ) {
+public:
+
+    TEST_METHOD( SpawnNamesInstancesAndSharesComponents ) {
+        Prefab prefab( TString( "crate" ) );
+        Assert::IsTrue( prefab.AddStaticMeshComponent( TString( "body" ), nullptr ) );
+        Level level( TString( "level" ) );
+
+        Transform transforms[3];
+        for( U32 i = 0; i < 3; ++i ) {
+            transforms[i].Position.Set( (F32)i, 0.0f, 0.0f );
+        }
+        List<Entity*> instances;
+        prefab.Spawn( level.GetRootEntity(), transforms, 3, &instances );
+
+        Assert::AreEqual( 3U, instances.Size() );
+        Assert::AreEqual( 3U, prefab.InstanceCount() );
+        Assert::AreEqual( 3U, level.GetEntityCount() );
+        Assert::AreEqual( 3U, level.GetRootEntity()->ChildCount() );
+        for( U32 i = 0; i < 3; ++i ) {
+            Entity* instance = instances[i];
+            Assert::IsTrue( instance->Name.IsEmpty() );
+            Assert::IsTrue( instance->GetName() == "crate" );
+            Assert::IsTrue( instance->GetPrefab() == &prefab );
+            Assert::AreEqual( (F32)i, instance->GetPosition().X );
+            Assert::AreEqual( 1U, instance->ComponentCount() );
+            Assert::IsTrue( instance->GetComponentAt( 0 )->GetName() == "body" );
+        }
+
+        // Instances can be renamed without affecting the others.
+        instances[0]->Name = "special crate";
+        Assert::IsTrue( instances[0]->GetName() == "special crate" );
+        Assert::IsTrue( instances[1]->GetName() == "crate" );
+
+        // The definition is fixed once there are instances.
+        Assert::IsFalse( prefab.AddStaticMeshComponent( TString( "lid" ), nullptr ) );
+        Assert::AreEqual( 1U, prefab.ComponentCount() );
+
+        level.Unload();
+    }
+
+    TEST_METHOD( ReparentAcrossLevelsDetachesFromPrefab ) {
+        Prefab prefab( TString( "crate" ) );
+        prefab.AddStaticMeshComponent( TString( "body" ), nullptr );
+        Level source( TString( "source" ) );
+        Level destination( TString( "destination" ) );
+
+        Entity* moved = prefab.Spawn( source.GetRootEntity(), Transform() );
+        Entity* child = prefab.Spawn( moved, Transform() );
+        Entity* stays = prefab.Spawn( source.GetRootEntity(), Transform() );
+        Entity* sibling = prefab.Spawn( source.GetRootEntity(), Transform() );
+
+        EntityCommandBuffer buffer;
+        buffer.SetParent( moved, destination.GetRootEntity() );
+        buffer.SetParent( stays, sibling );
+        buffer.Apply();
+
+        // The moved hierarchy keeps its names, but no longer refers to the source level's prefab.
+        Assert::IsTrue( moved->GetLevel() == &destination );
+        Assert::IsTrue( child->GetLevel() == &destination );
+        Assert::IsTrue( moved->GetPrefab() == nullptr );
+        Assert::IsTrue( child->GetPrefab() == nullptr );
+        Assert::IsTrue( moved->GetName() == "crate" );
+        Assert::IsTrue( child->GetComponentAt( 0 )->GetName() == "body" );
+
+        // Reparenting within a level keeps the instance tied to its prefab.
+        Assert::IsTrue( stays->GetPrefab() == &prefab );
+        Assert::IsTrue( stays->GetParent() == sibling );
+
+        // Unloading the source level leaves the moved entities alone.
+        source.Unload();
+        Assert::IsTrue( moved->GetComponentAt( 0 )->GetName() == "body" );
+        destination.Unload();
+    }
+    };
+}
\ No newline at end of file
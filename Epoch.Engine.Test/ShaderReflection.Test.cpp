@@ -0,0 +1,88 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <Renderer/ShaderReflection.h>
+#include <Containers/List.h>
+#include <Types.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Epoch;
+
+// Builds the first word of a SPIR-V instruction.
+#define SPIRV_INSTRUCTION( opcode, length ) ( ( (U32)( length ) << 16 ) | (U32)( opcode ) )
+
+namespace EpochEngineTest
+{
+
+    // A hand-assembled module with a uniform block, a storage buffer, a runtime-sized and a fixed-size texture array, and
+    // an undecorated input which must be skipped.
+    static const U32 testModule[] = {
+        0x07230203, 0x00010500, 0, 20, 0,
+        SPIRV_INSTRUCTION( 71, 3 ), 2, 2,
+        SPIRV_INSTRUCTION( 71, 4 ), 4, 34, 1,
+        SPIRV_INSTRUCTION( 71, 4 ), 4, 33, 0,
+        SPIRV_INSTRUCTION( 71, 3 ), 5, 2,
+        SPIRV_INSTRUCTION( 71, 4 ), 7, 34, 0,
+        SPIRV_INSTRUCTION( 71, 4 ), 7, 33, 1,
+        SPIRV_INSTRUCTION( 71, 4 ), 12, 34, 2,
+        SPIRV_INSTRUCTION( 71, 4 ), 12, 33, 0,
+        SPIRV_INSTRUCTION( 71, 4 ), 17, 34, 0,
+        SPIRV_INSTRUCTION( 71, 4 ), 17, 33, 3,
+        SPIRV_INSTRUCTION( 22, 3 ), 1, 32,
+        SPIRV_INSTRUCTION( 30, 3 ), 2, 1,
+        SPIRV_INSTRUCTION( 32, 4 ), 3, 2, 2,
+        SPIRV_INSTRUCTION( 59, 4 ), 3, 4, 2,
+        SPIRV_INSTRUCTION( 30, 3 ), 5, 1,
+        SPIRV_INSTRUCTION( 32, 4 ), 6, 12, 5,
+        SPIRV_INSTRUCTION( 59, 4 ), 6, 7, 12,
+        SPIRV_INSTRUCTION( 25, 9 ), 8, 1, 1, 0, 0, 0, 1, 0,
+        SPIRV_INSTRUCTION( 27, 3 ), 9, 8,
+        SPIRV_INSTRUCTION( 29, 3 ), 10, 9,
+        SPIRV_INSTRUCTION( 32, 4 ), 11, 0, 10,
+        SPIRV_INSTRUCTION( 59, 4 ), 11, 12, 0,
+        SPIRV_INSTRUCTION( 21, 4 ), 13, 32, 0,
+        SPIRV_INSTRUCTION( 43, 4 ), 13, 14, 4,
+        SPIRV_INSTRUCTION( 28, 4 ), 15, 9, 14,
+        SPIRV_INSTRUCTION( 32, 4 ), 16, 0, 15,
+        SPIRV_INSTRUCTION( 59, 4 ), 16, 17, 0,
+        SPIRV_INSTRUCTION( 32, 4 ), 18, 1, 1,
+        SPIRV_INSTRUCTION( 59, 4 ), 18, 19, 1
+    };
+
+    TEST_CLASS( ShaderReflectionTest ) {
+public:
+
+    TEST_METHOD( ReflectsBindingsInOrder ) {
+        List<ShaderBinding> bindings;
+        Assert::IsTrue( ShaderReflection::ReflectBindings( testModule, sizeof( testModule ) / sizeof( U32 ), bindings ) );
+        Assert::AreEqual( 4U, bindings.Size() );
+
+        Assert::AreEqual( 0U, bindings[0].Set );
+        Assert::AreEqual( 1U, bindings[0].Binding );
+        Assert::AreEqual( 1U, bindings[0].Count );
+        Assert::IsTrue( bindings[0].Type == (U8)ShaderBindingType::StorageBuffer );
+
+        Assert::AreEqual( 0U, bindings[1].Set );
+        Assert::AreEqual( 3U, bindings[1].Binding );
+        Assert::AreEqual( 4U, bindings[1].Count );
+        Assert::IsTrue( bindings[1].Type == (U8)ShaderBindingType::CombinedImageSampler );
+
+        Assert::AreEqual( 1U, bindings[2].Set );
+        Assert::AreEqual( 0U, bindings[2].Binding );
+        Assert::AreEqual( 1U, bindings[2].Count );
+        Assert::IsTrue( bindings[2].Type == (U8)ShaderBindingType::UniformBuffer );
+
+        Assert::AreEqual( 2U, bindings[3].Set );
+        Assert::AreEqual( 0U, bindings[3].Binding );
+        Assert::AreEqual( 0U, bindings[3].Count );
+        Assert::IsTrue( bindings[3].Type == (U8)ShaderBindingType::CombinedImageSampler );
+    }
+
+    TEST_METHOD( RejectsTruncatedModules ) {
+        List<ShaderBinding> bindings;
+        Assert::IsFalse( ShaderReflection::ReflectBindings( testModule, 3, bindings ) );
+        Assert::IsFalse( ShaderReflection::ReflectBindings( testModule, 7, bindings ) );
+        Assert::AreEqual( 0U, bindings.Size() );
+    }
+    };
+}
\ No newline at end of file
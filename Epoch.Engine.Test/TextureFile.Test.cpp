@@ -0,0 +1,168 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <Assets/TextureFile.h>
+#include <String/TString.h>
+#include <Types.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Epoch;
+
+namespace EpochEngineTest
+{
+    static const char* testTexturePath = "TextureFile.Test.etex";
+
+    // An 8x8 BC1 texture with a full chain of 4 levels, each filled with a different byte.
+    static const U32 testMipCount = 4;
+    static U8 testMipData[testMipCount][32];
+
+    static const bool writeTestTexture() {
+        const U8* mipData[testMipCount];
+        for( U32 i = 0; i < testMipCount; ++i ) {
+            memset( testMipData[i], (int)( 0x10 + i ), sizeof( testMipData[i] ) );
+            mipData[i] = testMipData[i];
+        }
+        return TextureFile::Write( TString( testTexturePath ), TextureFileFormat::BC1, true, 8, 8, testMipCount, mipData );
+    }
+
+    // Overwrites bytes of the test texture in place.
+    static void patchTestTexture( const U64 offset, const void* data, const U64 size ) {
+        std::fstream file( testTexturePath, std::ios::in | std::ios::out | std::ios::binary );
+        file.seekp( (std::streamoff)offset );
+        file.write( static_cast<const char*>( data ), (std::streamsize)size );
+    }
+
+    static U64 mipFieldOffset( const U32 level, const U64 fieldOffset ) {
+        return sizeof( TextureFileHeader ) + sizeof( TextureFileMip ) * level + fieldOffset;
+    }
+
+    static const bool opens() {
+        TextureFile file( testTexturePath );
+        bool result = file.TryOpen();
+        file.Close();
+        return result;
+    }
+
+    TEST_CLASS( TextureFileTest ) {
+public:
+
+    TEST_METHOD_CLEANUP( RemoveTestTexture ) {
+        std::remove( testTexturePath );
+    }
+
+    TEST_METHOD( WriteThenOpenRoundTrips ) {
+        Assert::IsTrue( writeTestTexture() );
+
+        TextureFile file( testTexturePath );
+        Assert::IsTrue( file.TryOpen() );
+        const TextureFileHeader* header = file.GetHeader();
+        Assert::AreEqual( (U8)TextureFileFormat::BC1, header->Format );
+        Assert::AreEqual( (U8)1, header->IsSrgb );
+        Assert::AreEqual( 8U, header->Width );
+        Assert::AreEqual( 8U, header->Height );
+        Assert::AreEqual( testMipCount, header->MipLevelCount );
+
+        const U32 sizes[testMipCount] = { 8, 4, 2, 1 };
+        U64 previousEnd = 0;
+        for( U32 i = 0; i < testMipCount; ++i ) {
+            const TextureFileMip& mip = file.GetMip( i );
+            Assert::AreEqual( sizes[i], mip.Width );
+            Assert::AreEqual( sizes[i], mip.Height );
+            Assert::AreEqual( TextureFile::GetMipSize( TextureFileFormat::BC1, sizes[i], sizes[i] ), mip.Size );
+            Assert::AreEqual( 0ULL, mip.Offset % 16 );
+            Assert::IsTrue( mip.Offset >= previousEnd );
+            Assert::AreEqual( 0, memcmp( file.GetData() + mip.Offset, testMipData[i], (size_t)mip.Size ) );
+            previousEnd = mip.Offset + mip.Size;
+        }
+        Assert::AreEqual( previousEnd, header->FileSize );
+        file.Close();
+    }
+
+    TEST_METHOD( RejectsCorruptHeaders ) {
+        const U32 badMagic = 0x12345678;
+        Assert::IsTrue( writeTestTexture() );
+        patchTestTexture( offsetof( TextureFileHeader, Magic ), &badMagic, sizeof( badMagic ) );
+        Assert::IsFalse( opens() );
+
+        const U8 badVersion = 2;
+        Assert::IsTrue( writeTestTexture() );
+        patchTestTexture( offsetof( TextureFileHeader, Version ), &badVersion, sizeof( badVersion ) );
+        Assert::IsFalse( opens() );
+
+        const U8 badFormat = 9;
+        Assert::IsTrue( writeTestTexture() );
+        patchTestTexture( offsetof( TextureFileHeader, Format ), &badFormat, sizeof( badFormat ) );
+        Assert::IsFalse( opens() );
+
+        // More levels than the table holds.
+        const U32 badMipCount = 40;
+        Assert::IsTrue( writeTestTexture() );
+        patchTestTexture( offsetof( TextureFileHeader, MipLevelCount ), &badMipCount, sizeof( badMipCount ) );
+        Assert::IsFalse( opens() );
+
+        // A size which disagrees with the file, as a truncated file would.
+        const U64 badFileSize = 64;
+        Assert::IsTrue( writeTestTexture() );
+        patchTestTexture( offsetof( TextureFileHeader, FileSize ), &badFileSize, sizeof( badFileSize ) );
+        Assert::IsFalse( opens() );
+
+        Assert::IsTrue( writeTestTexture() );
+        Assert::IsTrue( opens() );
+    }
+
+    TEST_METHOD( RejectsCorruptMipTables ) {
+        const U64 badSize = 16;
+        Assert::IsTrue( writeTestTexture() );
+        patchTestTexture( mipFieldOffset( 1, offsetof( TextureFileMip, Size ) ), &badSize, sizeof( badSize ) );
+        Assert::IsFalse( opens() );
+
+        const U32 badWidth = 3;
+        Assert::IsTrue( writeTestTexture() );
+        patchTestTexture( mipFieldOffset( 2, offsetof( TextureFileMip, Width ) ), &badWidth, sizeof( badWidth ) );
+        Assert::IsFalse( opens() );
+
+        TextureFile file( testTexturePath );
+        Assert::IsTrue( writeTestTexture() );
+        Assert::IsTrue( file.TryOpen() );
+        U64 offsets[testMipCount];
+        for( U32 i = 0; i < testMipCount; ++i ) {
+            offsets[i] = file.GetMip( i ).Offset;
+        }
+        U64 fileSize = file.GetHeader()->FileSize;
+        file.Close();
+
+        // Misaligned.
+        U64 badOffset = offsets[3] + 4;
+        patchTestTexture( mipFieldOffset( 3, offsetof( TextureFileMip, Offset ) ), &badOffset, sizeof( badOffset ) );
+        Assert::IsFalse( opens() );
+
+        // Past the end of the file.
+        badOffset = fileSize + 16;
+        Assert::IsTrue( writeTestTexture() );
+        patchTestTexture( mipFieldOffset( 3, offsetof( TextureFileMip, Offset ) ), &badOffset, sizeof( badOffset ) );
+        Assert::IsFalse( opens() );
+
+        // Overlapping the header and mip table.
+        badOffset = 0;
+        Assert::IsTrue( writeTestTexture() );
+        patchTestTexture( mipFieldOffset( 0, offsetof( TextureFileMip, Offset ) ), &badOffset, sizeof( badOffset ) );
+        Assert::IsFalse( opens() );
+
+        // Levels of the same size swapped, so every level is in bounds but they are out of order.
+        Assert::IsTrue( writeTestTexture() );
+        patchTestTexture( mipFieldOffset( 2, offsetof( TextureFileMip, Offset ) ), &offsets[3], sizeof( U64 ) );
+        patchTestTexture( mipFieldOffset( 3, offsetof( TextureFileMip, Offset ) ), &offsets[2], sizeof( U64 ) );
+        Assert::IsFalse( opens() );
+
+        // Overlapping the previous level.
+        Assert::IsTrue( writeTestTexture() );
+        patchTestTexture( mipFieldOffset( 3, offsetof( TextureFileMip, Offset ) ), &offsets[2], sizeof( U64 ) );
+        Assert::IsFalse( opens() );
+    }
+    };
+}
\ No newline at end of file
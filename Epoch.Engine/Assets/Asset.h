@@ -32,20 +32,19 @@ namespace Epoch {
         AssetType _type;
     };
 
+    /**
+     * Signals that an asset has been loaded. A pointer to its data is held in the payload. The data
+     * is owned by the sender, as events are copied by value through the event queue.
+     */
     struct AssetLoadedEvent : public Event {
-    public:
-        const AssetData* Data;
-
     public:
         AssetLoadedEvent( const AssetData* assetData, void* sender ) : Event( EventType::ASSET_LOADED, sender ) {
-            Data = assetData;
+            SetPayload( assetData );
         }
 
-        ~AssetLoadedEvent() {
-            if( Data ) {
-                delete Data;
-                Data = nullptr;
-            }
-        }
+        /**
+         * Returns the asset data carried by the given asset loaded event.
+         */
+        static const AssetData* GetData( const Event* event ) { return event->GetPayload<const AssetData*>(); }
     };
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 
+#include "../../Memory/Memory.h"
+#include "../../Math/TMath.h"
 #include "ImageUtilities.h"
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -6,6 +8,16 @@
 
 namespace Epoch {
 
+    // Decodes an sRGB encoded channel to linear.
+    static F32 srgbToLinear( const F32 value ) {
+        return value <= 0.04045f ? value / 12.92f : TMath::Pow( ( value + 0.055f ) / 1.055f, 2.4f );
+    }
+
+    // Encodes a linear channel as sRGB.
+    static F32 linearToSrgb( const F32 value ) {
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * TMath::Pow( value, 1.0f / 2.4f ) - 0.055f;
+    }
+
     byte* ImageUtilities::LoadImage( const char* path, I32* width, I32* height, I32* componentCount ) {
 
         // NOTE: may replace this with a custom loader at some point.
@@ -13,4 +25,76 @@ namespace Epoch {
 
         return pixelData;
     }
+
+    const U32 ImageUtilities::GetMipLevelCount( const U32 width, const U32 height ) {
+        U32 size = width > height ? width : height;
+        U32 levelCount = 1;
+        while( size > 1 ) {
+            size /= 2;
+            ++levelCount;
+        }
+        return levelCount;
+    }
+
+    byte* ImageUtilities::GenerateMipChain( const byte* pixels, const U32 width, const U32 height, const bool isSrgb, U32* outMipLevelCount, U64* outSize ) {
+        U32 levelCount = GetMipLevelCount( width, height );
+        U64 totalSize = 0;
+        U32 levelWidth = width;
+        U32 levelHeight = height;
+        for( U32 i = 0; i < levelCount; ++i ) {
+            totalSize += (U64)levelWidth * (U64)levelHeight * 4;
+            levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+            levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+        }
+
+        byte* chain = static_cast<byte*>( TMemory::Allocate( totalSize ) );
+        TMemory::Memcpy( chain, pixels, (U64)width * (U64)height * 4 );
+
+        // Decoding every texel through a table is much cheaper than a pow per channel.
+        F32 toLinear[256];
+        for( U32 i = 0; i < 256; ++i ) {
+            toLinear[i] = isSrgb ? srgbToLinear( i / 255.0f ) : i / 255.0f;
+        }
+
+        // Each level is built from the one before it. Odd edges clamp, so their last row or column counts twice.
+        byte* source = chain;
+        U32 sourceWidth = width;
+        U32 sourceHeight = height;
+        for( U32 level = 1; level < levelCount; ++level ) {
+            byte* destination = source + (U64)sourceWidth * (U64)sourceHeight * 4;
+            U32 destinationWidth = sourceWidth > 1 ? sourceWidth / 2 : 1;
+            U32 destinationHeight = sourceHeight > 1 ? sourceHeight / 2 : 1;
+            for( U32 y = 0; y < destinationHeight; ++y ) {
+                U32 y0 = y * 2;
+                U32 y1 = y0 + 1 < sourceHeight ? y0 + 1 : y0;
+                for( U32 x = 0; x < destinationWidth; ++x ) {
+                    U32 x0 = x * 2;
+                    U32 x1 = x0 + 1 < sourceWidth ? x0 + 1 : x0;
+                    const byte* texels[4] = {
+                        source + ( (U64)y0 * sourceWidth + x0 ) * 4,
+                        source + ( (U64)y0 * sourceWidth + x1 ) * 4,
+                        source + ( (U64)y1 * sourceWidth + x0 ) * 4,
+                        source + ( (U64)y1 * sourceWidth + x1 ) * 4
+                    };
+
+                    byte* out = destination + ( (U64)y * destinationWidth + x ) * 4;
+                    for( U32 c = 0; c < 3; ++c ) {
+                        F32 average = ( toLinear[texels[0][c]] + toLinear[texels[1][c]] + toLinear[texels[2][c]] + toLinear[texels[3][c]] ) * 0.25f;
+                        F32 encoded = isSrgb ? linearToSrgb( average ) : average;
+                        out[c] = (byte)( encoded * 255.0f + 0.5f );
+                    }
+                    U32 alphaSum = (U32)texels[0][3] + texels[1][3] + texels[2][3] + texels[3][3];
+                    out[3] = (byte)( ( alphaSum + 2 ) / 4 );
+                }
+            }
+
+            source = destination;
+            sourceWidth = destinationWidth;
+            sourceHeight = destinationHeight;
+        }
+
+        *outMipLevelCount = levelCount;
+        *outSize = totalSize;
+        return chain;
+    }
 }
\ No newline at end of file
@@ -1,10 +1,11 @@
 #pragma once
 
 #include "../../Types.h"
+#include "../../Defines.h"
 
 namespace Epoch {
 
-    class ImageUtilities {
+    class EPOCH_API ImageUtilities {
     public:
 
         /**
@@ -18,6 +19,29 @@ namespace Epoch {
          * @return An array of image bytes. The caller is responsible for freeing this data.
          */
         static byte* LoadImage( const char* path, I32* width, I32* height, I32* componentCount );
+
+        /**
+         * Returns the number of mip levels in a full chain for an image of the given size, down to 1x1.
+         *
+         * @param width The width of the largest level.
+         * @param height The height of the largest level.
+         */
+        static const U32 GetMipLevelCount( const U32 width, const U32 height );
+
+        /**
+         * Builds a full mip chain from the given RGBA pixels using a box filter. Each level is half the size of the one
+         * before it, rounded down, until 1x1.
+         *
+         * @param pixels The pixels of the largest level, 4 bytes per pixel.
+         * @param width The width of the largest level.
+         * @param height The height of the largest level.
+         * @param isSrgb Indicates if the color channels are sRGB encoded, in which case they are averaged in linear space. Alpha is always linear.
+         * @param outMipLevelCount A pointer to a number to which the number of levels is assigned.
+         * @param outSize A pointer to a number to which the total size of all levels in bytes is assigned.
+         *
+         * @return All levels tightly packed, largest first, starting with a copy of the given pixels. The caller is responsible for freeing this data.
+         */
+        static byte* GenerateMipChain( const byte* pixels, const U32 width, const U32 height, const bool isSrgb, U32* outMipLevelCount, U64* outSize );
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "../Logger.h"
+#include "../Containers/List.h"
+#include "../Memory/Memory.h"
+#include "../FileSystem/FileHandle.h"
+#include "ShaderArchive.h"
+
+// Identifies a shader archive. "ESHA" in little-endian.
+#define SHADER_ARCHIVE_MAGIC 0x41485345U
+
+// The code of each module begins on a boundary of this many bytes.
+#define SHADER_ARCHIVE_ALIGNMENT 16
+
+namespace Epoch {
+
+    static U64 alignShaderArchiveOffset( const U64 offset ) {
+        return ( offset + ( SHADER_ARCHIVE_ALIGNMENT - 1 ) ) & ~( (U64)SHADER_ARCHIVE_ALIGNMENT - 1 );
+    }
+
+    static const bool writeShaderArchiveSection( FileHandle& file, U64* position, const U64 offset, const void* data, const U64 size ) {
+        bool result = true;
+        for( ; result && *position < offset; ++( *position ) ) {
+            result = file.Write<U8>( 0 );
+        }
+        if( result && size > 0 ) {
+            result = file.WriteArray<U8>( static_cast<const U8*>( data ), size );
+        }
+        *position += size;
+        return result;
+    }
+
+    ShaderArchive::ShaderArchive( const TString& filePath ) : _file( filePath ) {
+        _filePath = filePath;
+    }
+
+    ShaderArchive::~ShaderArchive() {
+        Close();
+    }
+
+    const bool ShaderArchive::TryOpen() {
+        if( _header ) {
+            return true;
+        }
+        if( !_file.TryOpen() ) {
+            Logger::Error( "Failed to open shader archive located at '%s'.", _filePath.CStr() );
+            return false;
+        }
+
+        const U8* base = _file.GetData();
+        U64 fileSize = _file.GetSize();
+        const ShaderArchiveHeader* header = reinterpret_cast<const ShaderArchiveHeader*>( base );
+        if( fileSize < sizeof( ShaderArchiveHeader ) || header->Magic != SHADER_ARCHIVE_MAGIC ) {
+            Logger::Error( "'%s' is not a shader archive.", _filePath.CStr() );
+            Close();
+            return false;
+        }
+        if( header->Version != (U8)ShaderArchiveVersion::VERSION_1_0 ) {
+            Logger::Error( "Unsupported shader archive version %u in '%s'.", header->Version, _filePath.CStr() );
+            Close();
+            return false;
+        }
+
+        // Validate everything up front, so modules can be created without any further checks.
+        U64 tablesSize = sizeof( ShaderArchiveModule ) * (U64)header->ModuleCount + sizeof( ShaderBinding ) * (U64)header->BindingCount;
+        bool valid = header->FileSize == fileSize && tablesSize <= fileSize - sizeof( ShaderArchiveHeader );
+        const ShaderArchiveModule* modules = reinterpret_cast<const ShaderArchiveModule*>( base + sizeof( ShaderArchiveHeader ) );
+        for( U32 i = 0; valid && i < header->ModuleCount; ++i ) {
+            const ShaderArchiveModule& module = modules[i];
+            valid = module.Name[SHADER_ARCHIVE_MAX_NAME_LENGTH - 1] == '\0' &&
+                module.FirstBinding <= header->BindingCount && module.BindingCount <= header->BindingCount - module.FirstBinding &&
+                module.CodeSize > 0 && ( module.CodeSize % sizeof( U32 ) ) == 0 && ( module.CodeOffset % SHADER_ARCHIVE_ALIGNMENT ) == 0 &&
+                module.CodeOffset <= fileSize && module.CodeSize <= fileSize - module.CodeOffset;
+        }
+        if( !valid ) {
+            Logger::Error( "Shader archive '%s' is truncated or corrupt.", _filePath.CStr() );
+            Close();
+            return false;
+        }
+
+        _header = header;
+        _modules = modules;
+        _bindings = reinterpret_cast<const ShaderBinding*>( modules + header->ModuleCount );
+        return true;
+    }
+
+    void ShaderArchive::Close() {
+        _header = nullptr;
+        _modules = nullptr;
+        _bindings = nullptr;
+        _file.Close();
+    }
+
+    const ShaderArchiveModule* ShaderArchive::FindModule( const char* name, const U8 type ) const {
+        for( U32 i = 0; i < _header->ModuleCount; ++i ) {
+            if( _modules[i].Type == type && TString::Compare( _modules[i].Name, name ) == 0 ) {
+                return &_modules[i];
+            }
+        }
+        return nullptr;
+    }
+
+    const U32* ShaderArchive::GetCode( const ShaderArchiveModule& module ) {
+        return reinterpret_cast<const U32*>( _file.GetData() + module.CodeOffset );
+    }
+
+    const bool ShaderArchive::Write( const TString& filePath, const ShaderArchiveEntry* entries, const U32 entryCount ) {
+        FileHandle file( filePath, true );
+        if( !file.TryOpen( FileMode::FILE_MODE_OUTPUT ) ) {
+            Logger::Error( "Failed to open shader archive located at '%s'.", filePath.CStr() );
+            return false;
+        }
+
+        List<ShaderArchiveModule> modules;
+        List<ShaderBinding> bindings;
+        modules.Resize( entryCount );
+        for( U32 i = 0; i < entryCount; ++i ) {
+            const ShaderArchiveEntry& entry = entries[i];
+            TString name( entry.Name );
+            if( name.Length() >= SHADER_ARCHIVE_MAX_NAME_LENGTH ) {
+                Logger::Error( "Shader name '%s' is too long for a shader archive. Process aborted.", entry.Name.CStr() );
+                file.Close();
+                return false;
+            }
+
+            ShaderArchiveModule& module = modules[i];
+            TMemory::MemZero( &module, sizeof( ShaderArchiveModule ) );
+            TString::CopyEnsureTrailingZero( module.Name, name.CStr(), SHADER_ARCHIVE_MAX_NAME_LENGTH );
+            module.Type = entry.Type;
+            module.FirstBinding = bindings.Size();
+            module.BindingCount = entry.BindingCount;
+            module.CodeSize = (U32)entry.CodeSize;
+            for( U32 b = 0; b < entry.BindingCount; ++b ) {
+                bindings.Add( entry.Bindings[b] );
+            }
+        }
+
+        // Lay out the code after the tables. Modules whose code matches an earlier module's point at that module's copy.
+        U64 offset = alignShaderArchiveOffset( sizeof( ShaderArchiveHeader ) + sizeof( ShaderArchiveModule ) * (U64)entryCount + sizeof( ShaderBinding ) * (U64)bindings.Size() );
+        List<U32> codeSources;
+        for( U32 i = 0; i < entryCount; ++i ) {
+            U32 source = i;
+            for( U32 j = 0; j < i; ++j ) {
+                if( entries[j].CodeSize == entries[i].CodeSize && TMemory::Memcmp( entries[j].Code, entries[i].Code, entries[i].CodeSize ) == 0 ) {
+                    source = j;
+                    break;
+                }
+            }
+            codeSources.Add( source );
+            if( source == i ) {
+                modules[i].CodeOffset = offset;
+                offset = alignShaderArchiveOffset( offset + entries[i].CodeSize );
+            } else {
+                modules[i].CodeOffset = modules[source].CodeOffset;
+            }
+        }
+
+        ShaderArchiveHeader header = {};
+        header.Magic = SHADER_ARCHIVE_MAGIC;
+        header.Version = (U8)ShaderArchiveVersion::VERSION_1_0;
+        header.ModuleCount = entryCount;
+        header.BindingCount = bindings.Size();
+        header.FileSize = sizeof( ShaderArchiveHeader ) + sizeof( ShaderArchiveModule ) * (U64)entryCount + sizeof( ShaderBinding ) * (U64)bindings.Size();
+        for( U32 i = 0; i < entryCount; ++i ) {
+            if( codeSources[i] == i ) {
+                header.FileSize = modules[i].CodeOffset + entries[i].CodeSize;
+            }
+        }
+
+        U64 position = 0;
+        bool result = writeShaderArchiveSection( file, &position, 0, &header, sizeof( ShaderArchiveHeader ) ) &&
+            writeShaderArchiveSection( file, &position, position, modules.Data(), sizeof( ShaderArchiveModule ) * (U64)entryCount ) &&
+            writeShaderArchiveSection( file, &position, position, bindings.Data(), sizeof( ShaderBinding ) * (U64)bindings.Size() );
+        for( U32 i = 0; result && i < entryCount; ++i ) {
+            if( codeSources[i] == i ) {
+                result = writeShaderArchiveSection( file, &position, modules[i].CodeOffset, entries[i].Code, entries[i].CodeSize );
+            }
+        }
+
+        file.Close();
+        if( !result ) {
+            Logger::Error( "Error writing shader archive '%s'. Process aborted.", filePath.CStr() );
+        }
+        return result;
+    }
+}
\ No newline at end of file
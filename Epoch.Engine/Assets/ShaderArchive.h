@@ -0,0 +1,140 @@
+#pragma once
+
+#include "../Types.h"
+#include "../Defines.h"
+#include "../String/TString.h"
+#include "../FileSystem/MappedFile.h"
+#include "../Renderer/ShaderReflection.h"
+
+// The longest name a module in a shader archive can have, including the terminator.
+#define SHADER_ARCHIVE_MAX_NAME_LENGTH 64
+
+namespace Epoch {
+
+    enum class ShaderArchiveVersion : U8 {
+        UNKNOWN = 0x00U,
+        VERSION_1_0 = 0x01U
+    };
+
+    /**
+     * A compiled shader module within a shader archive.
+     */
+    struct ShaderArchiveModule {
+
+        // The name of the shader the module belongs to, such as "Builtin.UnlitShader".
+        char Name[SHADER_ARCHIVE_MAX_NAME_LENGTH];
+
+        // The ShaderType of the stage.
+        U8 Type;
+        U8 Padding[3];
+
+        // The module's bindings, as a range of the archive's binding table.
+        U32 FirstBinding;
+        U32 BindingCount;
+
+        // The SPIR-V code. Modules with identical code share the same offset.
+        U32 CodeSize;
+        U64 CodeOffset;
+    };
+
+    /**
+     * The header at the start of every shader archive. It is followed by the module table, then the binding table, then
+     * the code of each module, each starting on a 16-byte boundary.
+     */
+    struct ShaderArchiveHeader {
+        U32 Magic;
+        U8 Version;
+        U8 Padding[3];
+        U32 ModuleCount;
+        U32 BindingCount;
+        U64 FileSize;
+    };
+
+    /**
+     * A module to be written to a shader archive.
+     */
+    struct ShaderArchiveEntry {
+        TString Name;
+        U8 Type;
+        const U32* Code;
+        U64 CodeSize;
+        const ShaderBinding* Bindings;
+        U32 BindingCount;
+    };
+
+    /**
+     * Every compiled shader module, along with the bindings reflected from it, packed into a single file which is mapped
+     * into memory with one call.
+     */
+    class EPOCH_API ShaderArchive {
+    public:
+        ShaderArchive( const TString& filePath );
+        ~ShaderArchive();
+
+        /**
+         * Attempts to map and validate the archive.
+         *
+         * @returns True if successful; otherwise false.
+         */
+        const bool TryOpen();
+
+        /**
+         * Unmaps the archive. Any pointers into its data are invalid after this.
+         */
+        void Close();
+
+        /**
+         * Returns the number of modules in the archive. Only valid while open.
+         */
+        const U32 GetModuleCount() const { return _header->ModuleCount; }
+
+        /**
+         * Returns the given module. Only valid while open.
+         *
+         * @param index The index of the module.
+         */
+        const ShaderArchiveModule& GetModule( const U32 index ) const { return _modules[index]; }
+
+        /**
+         * Finds the module of the given shader and stage.
+         *
+         * @param name The name of the shader.
+         * @param type The ShaderType of the stage.
+         *
+         * @returns A pointer to the module, or nullptr if the archive has none.
+         */
+        const ShaderArchiveModule* FindModule( const char* name, const U8 type ) const;
+
+        /**
+         * Returns the first of the given module's bindings. Only valid while open.
+         *
+         * @param module The module.
+         */
+        const ShaderBinding* GetBindings( const ShaderArchiveModule& module ) const { return _bindings + module.FirstBinding; }
+
+        /**
+         * Returns the SPIR-V code of the given module. Only valid while open.
+         *
+         * @param module The module.
+         */
+        const U32* GetCode( const ShaderArchiveModule& module );
+
+        /**
+         * Writes a shader archive. Identical code is only written once.
+         *
+         * @param filePath The path of the file to write to.
+         * @param entries The modules to write.
+         * @param entryCount The number of modules.
+         *
+         * @returns True if successful; otherwise false.
+         */
+        static const bool Write( const TString& filePath, const ShaderArchiveEntry* entries, const U32 entryCount );
+
+    private:
+        TString _filePath;
+        MappedFile _file;
+        const ShaderArchiveHeader* _header = nullptr;
+        const ShaderArchiveModule* _modules = nullptr;
+        const ShaderBinding* _bindings = nullptr;
+    };
+}
\ No newline at end of file
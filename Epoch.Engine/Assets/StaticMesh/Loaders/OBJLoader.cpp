@@ -128,6 +128,8 @@ namespace Epoch {
                 vertexArrayIndex++;
             }
 
+            ( *meshes[index] ).ComputeBounds();
+
             // Only push back meshes with actual data in them.
             //if( mesh.Vertices.Size() != 0 && mesh.Indices.Size() != 0 ) {
             ( *meshCount )++;
@@ -15,6 +15,19 @@ namespace Epoch {
     }*/
 
 
+    void StaticMeshData::ComputeBounds() {
+        U32 vertexCount = Vertices.Size();
+        if( vertexCount == 0 ) {
+            Bounds = AABB();
+            Sphere = BoundingSphere();
+            return;
+        }
+
+        const Vector3* positions = &Vertices[0].Position;
+        Bounds = AABB::FromPoints( positions, vertexCount, sizeof( Vertex3D ) );
+        Sphere = BoundingSphere::FromPoints( Bounds, positions, vertexCount, sizeof( Vertex3D ) );
+    }
+
     /*
     FORMAT:
 
@@ -238,6 +251,9 @@ namespace Epoch {
             file.Close();
         }
 
+        // Bounds are not stored in the file, so calculate them now.
+        ComputeBounds();
+
         Logger::Trace( "File read successfully." );
         return true;
     }
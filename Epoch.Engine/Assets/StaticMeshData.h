@@ -3,6 +3,7 @@
 #include "../Types.h"
 #include "../Defines.h"
 #include "../Math/Vector3.h"
+#include "../Math/BoundingVolumes.h"
 #include "../String/TString.h"
 #include "../FileSystem/IBinarySerializable.h"
 #include "../Containers/List.h"
@@ -46,8 +47,23 @@ namespace Epoch {
          */
         TString MaterialName;
 
+        /**
+         * The object-space axis-aligned bounds of the vertex data. Calculated via ComputeBounds().
+         */
+        AABB Bounds;
+
+        /**
+         * The object-space bounding sphere of the vertex data. Calculated via ComputeBounds().
+         */
+        BoundingSphere Sphere;
+
     public:
 
+        /**
+         * Calculates Bounds and Sphere from the current vertex data.
+         */
+        void ComputeBounds();
+
         /**
          * Binary-serializes the contents of this structure to a file at the given path.
          *
@@ -0,0 +1,158 @@
+#include "../Logger.h"
+#include "../Containers/List.h"
+#include "../FileSystem/FileHandle.h"
+#include "TextureFile.h"
+
+// Identifies a texture file. "ETEX" in little-endian.
+#define TEXTURE_FILE_MAGIC 0x58455445U
+
+// Every level of a texture file begins on a boundary of this many bytes, which satisfies the copy alignment of every format.
+#define TEXTURE_FILE_ALIGNMENT 16
+
+namespace Epoch {
+
+    static U64 alignTextureFileOffset( const U64 offset ) {
+        return ( offset + ( TEXTURE_FILE_ALIGNMENT - 1 ) ) & ~( (U64)TEXTURE_FILE_ALIGNMENT - 1 );
+    }
+
+    static const bool writeTextureFileSection( FileHandle& file, U64* position, const U64 offset, const void* data, const U64 size ) {
+        bool result = true;
+        for( ; result && *position < offset; ++( *position ) ) {
+            result = file.Write<U8>( 0 );
+        }
+        if( result && size > 0 ) {
+            result = file.WriteArray<U8>( static_cast<const U8*>( data ), size );
+        }
+        *position += size;
+        return result;
+    }
+
+    TextureFile::TextureFile( const TString& filePath ) : _file( filePath ) {
+        _filePath = filePath;
+    }
+
+    TextureFile::~TextureFile() {
+        Close();
+    }
+
+    const bool TextureFile::TryOpen() {
+        if( _header ) {
+            return true;
+        }
+        if( !_file.TryOpen() ) {
+            Logger::Error( "Failed to open texture file located at '%s'.", _filePath.CStr() );
+            return false;
+        }
+
+        const U8* base = _file.GetData();
+        U64 fileSize = _file.GetSize();
+        const TextureFileHeader* header = reinterpret_cast<const TextureFileHeader*>( base );
+        if( fileSize < sizeof( TextureFileHeader ) || header->Magic != TEXTURE_FILE_MAGIC ) {
+            Logger::Error( "'%s' is not a texture file.", _filePath.CStr() );
+            Close();
+            return false;
+        }
+        if( header->Version != (U8)TextureFileVersion::VERSION_1_0 || header->Format > (U8)TextureFileFormat::BC7 ) {
+            Logger::Error( "Unsupported texture file version %u or format %u in '%s'.", header->Version, header->Format, _filePath.CStr() );
+            Close();
+            return false;
+        }
+
+        // Validate everything up front, so the data can be uploaded without any further checks.
+        U64 mipTableSize = sizeof( TextureFileMip ) * (U64)header->MipLevelCount;
+        bool valid = header->FileSize == fileSize && header->MipLevelCount > 0 && header->MipLevelCount <= 32 &&
+            header->Width > 0 && header->Height > 0 && mipTableSize <= fileSize - sizeof( TextureFileHeader );
+        const TextureFileMip* mips = reinterpret_cast<const TextureFileMip*>( base + sizeof( TextureFileHeader ) );
+        U32 width = header->Width;
+        U32 height = header->Height;
+
+        // Levels must follow the mip table and each other in order without overlapping, as loaders upload them as one
+        // range starting at the first level.
+        U64 minimumOffset = sizeof( TextureFileHeader ) + mipTableSize;
+        for( U32 i = 0; valid && i < header->MipLevelCount; ++i ) {
+            const TextureFileMip& mip = mips[i];
+            valid = mip.Width == width && mip.Height == height &&
+                mip.Size == GetMipSize( (TextureFileFormat)header->Format, width, height ) &&
+                ( mip.Offset % TEXTURE_FILE_ALIGNMENT ) == 0 && mip.Offset >= minimumOffset &&
+                mip.Offset <= fileSize && mip.Size <= fileSize - mip.Offset;
+            minimumOffset = mip.Offset + mip.Size;
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+        if( !valid ) {
+            Logger::Error( "Texture file '%s' is truncated or corrupt.", _filePath.CStr() );
+            Close();
+            return false;
+        }
+
+        _header = header;
+        _mips = mips;
+        return true;
+    }
+
+    void TextureFile::Close() {
+        _header = nullptr;
+        _mips = nullptr;
+        _file.Close();
+    }
+
+    const bool TextureFile::Write( const TString& filePath, const TextureFileFormat format, const bool isSrgb, const U32 width, const U32 height, const U32 mipLevelCount, const U8* const* mipData ) {
+        FileHandle file( filePath, true );
+        if( !file.TryOpen( FileMode::FILE_MODE_OUTPUT ) ) {
+            Logger::Error( "Failed to open texture file located at '%s'.", filePath.CStr() );
+            return false;
+        }
+
+        // Lay out every level first, so the header and mip table can be written in one pass.
+        List<TextureFileMip> mips;
+        mips.Resize( mipLevelCount );
+        U64 offset = alignTextureFileOffset( sizeof( TextureFileHeader ) + sizeof( TextureFileMip ) * (U64)mipLevelCount );
+        U32 levelWidth = width;
+        U32 levelHeight = height;
+        for( U32 i = 0; i < mipLevelCount; ++i ) {
+            mips[i].Offset = offset;
+            mips[i].Size = GetMipSize( format, levelWidth, levelHeight );
+            mips[i].Width = levelWidth;
+            mips[i].Height = levelHeight;
+            offset = alignTextureFileOffset( offset + mips[i].Size );
+            levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+            levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+        }
+
+        TextureFileHeader header = {};
+        header.Magic = TEXTURE_FILE_MAGIC;
+        header.Version = (U8)TextureFileVersion::VERSION_1_0;
+        header.Format = (U8)format;
+        header.IsSrgb = isSrgb ? 1 : 0;
+        header.Width = width;
+        header.Height = height;
+        header.MipLevelCount = mipLevelCount;
+        header.FileSize = mips[mipLevelCount - 1].Offset + mips[mipLevelCount - 1].Size;
+
+        U64 position = 0;
+        bool result = writeTextureFileSection( file, &position, 0, &header, sizeof( TextureFileHeader ) ) &&
+            writeTextureFileSection( file, &position, sizeof( TextureFileHeader ), mips.Data(), sizeof( TextureFileMip ) * (U64)mipLevelCount );
+        for( U32 i = 0; result && i < mipLevelCount; ++i ) {
+            result = writeTextureFileSection( file, &position, mips[i].Offset, mipData[i], mips[i].Size );
+        }
+
+        file.Close();
+        if( !result ) {
+            Logger::Error( "Error writing texture file '%s'. Process aborted.", filePath.CStr() );
+        }
+        return result;
+    }
+
+    const U64 TextureFile::GetMipSize( const TextureFileFormat format, const U32 width, const U32 height ) {
+        U64 blocksWide = ( width + 3 ) / 4;
+        U64 blocksHigh = ( height + 3 ) / 4;
+        switch( format ) {
+        case TextureFileFormat::RGBA8:
+            return (U64)width * (U64)height * 4;
+        case TextureFileFormat::BC1:
+            return blocksWide * blocksHigh * 8;
+        default:
+            return blocksWide * blocksHigh * 16;
+        }
+    }
+}
\ No newline at end of file
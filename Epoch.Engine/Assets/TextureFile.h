@@ -0,0 +1,134 @@
+#pragma once
+
+#include "../Types.h"
+#include "../Defines.h"
+#include "../String/TString.h"
+#include "../FileSystem/MappedFile.h"
+
+namespace Epoch {
+
+    enum class TextureFileVersion : U8 {
+        UNKNOWN = 0x00U,
+        VERSION_1_0 = 0x01U
+    };
+
+    /**
+     * The pixel formats a texture file may hold. Block-compressed formats store each 4x4 texel block in a fixed number
+     * of bytes, and are uploaded to the GPU as-is.
+     */
+    enum class TextureFileFormat : U8 {
+
+        // Uncompressed, 4 bytes per texel.
+        RGBA8 = 0x00U,
+
+        // Opaque color, 8 bytes per block.
+        BC1 = 0x01U,
+
+        // Color with smooth alpha, 16 bytes per block.
+        BC3 = 0x02U,
+
+        // Two independent channels, such as the X and Y of a normal map, 16 bytes per block.
+        BC5 = 0x03U,
+
+        // High quality color with alpha, 16 bytes per block.
+        BC7 = 0x04U
+    };
+
+    /**
+     * The location and size of a single mip level within a texture file.
+     */
+    struct TextureFileMip {
+
+        // The offset in bytes from the start of the file.
+        U64 Offset;
+        U64 Size;
+        U32 Width;
+        U32 Height;
+    };
+
+    /**
+     * The header at the start of every texture file. It is followed by one TextureFileMip per level, then the data of
+     * each level, largest first, each starting on a 16-byte boundary.
+     */
+    struct TextureFileHeader {
+        U32 Magic;
+        U8 Version;
+        U8 Format;
+        U8 IsSrgb;
+        U8 Padding;
+        U32 Width;
+        U32 Height;
+        U32 MipLevelCount;
+        U32 Reserved;
+        U64 FileSize;
+    };
+
+    /**
+     * A cooked texture file, mapped into memory. Its levels are already in the format they are uploaded in, so nothing
+     * needs decoding at load time.
+     */
+    class EPOCH_API TextureFile {
+    public:
+        TextureFile( const TString& filePath );
+        ~TextureFile();
+
+        /**
+         * Attempts to map and validate the file.
+         *
+         * @returns True if successful; otherwise false.
+         */
+        const bool TryOpen();
+
+        /**
+         * Unmaps the file. Any pointers into its data are invalid after this.
+         */
+        void Close();
+
+        /**
+         * Returns the header of the file. Only valid while open.
+         */
+        const TextureFileHeader* GetHeader() const { return _header; }
+
+        /**
+         * Returns the given mip level's location within the file. Only valid while open.
+         *
+         * @param level The mip level, where 0 is the largest.
+         */
+        const TextureFileMip& GetMip( const U32 level ) const { return _mips[level]; }
+
+        /**
+         * Returns a pointer to the start of the mapped file. Only valid while open.
+         */
+        const U8* GetData() { return _file.GetData(); }
+
+        /**
+         * Writes a texture file.
+         *
+         * @param filePath The path of the file to write to.
+         * @param format The format of the given data.
+         * @param isSrgb Indicates if the color channels are sRGB encoded.
+         * @param width The width of the largest level.
+         * @param height The height of the largest level.
+         * @param mipLevelCount The number of levels. Each is half the size of the one before it, rounded down.
+         * @param mipData A pointer to the data of each level, largest first, each of the size given by GetMipSize.
+         *
+         * @returns True if successful; otherwise false.
+         */
+        static const bool Write( const TString& filePath, const TextureFileFormat format, const bool isSrgb, const U32 width, const U32 height, const U32 mipLevelCount, const U8* const* mipData );
+
+        /**
+         * Returns the size in bytes of a level of the given format and size.
+         *
+         * @param format The format of the level.
+         * @param width The width of the level in texels.
+         * @param height The height of the level in texels.
+         */
+        static const U64 GetMipSize( const TextureFileFormat format, const U32 width, const U32 height );
+
+    private:
+        TString _filePath;
+        MappedFile _file;
+        const TextureFileHeader* _header = nullptr;
+        const TextureFileMip* _mips = nullptr;
+    };
+}
\ No newline at end of file
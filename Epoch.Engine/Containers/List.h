@@ -83,6 +83,14 @@ namespace Epoch {
          */
         void RemoveAt( const U32 index );
 
+        /**
+         * Removes the item at the given index by moving the last item into its place. Does not
+         * preserve ordering, but runs in constant time. Does not shrink capacity.
+         *
+         * @param index The index to remove from.
+         */
+        void RemoveAtSwap( const U32 index );
+
         /**
          * Resizes this list to the given size (number of elements).
          *
@@ -90,6 +98,13 @@ namespace Epoch {
          */
         void Resize( const U32 size );
 
+        /**
+         * Ensures this list has room for at least the given number of elements without changing its size.
+         *
+         * @param capacity The minimum capacity.
+         */
+        void Reserve( const U32 capacity );
+
         /**
          * Clears the items from this list. Does not automatically shrink.
          *
@@ -189,6 +204,9 @@ namespace Epoch {
     private:
         void ensureAllocated( U32 count, const bool keepData );
 
+        // Grows capacity geometrically so that repeated adds are amortized constant time.
+        void ensureGrowth( U32 count );
+
     private:
         T* _items = nullptr;
         U32 _size = 0;
@@ -240,14 +258,14 @@ namespace Epoch {
 
     template<class T>
     FORCEINLINE void List<T>::Add( T item ) {
-        ensureAllocated( _size + (U32)1, true );
+        ensureGrowth( _size + (U32)1 );
         _items[_size] = item;
         ++_size;
     }
 
     template<class T>
     FORCEINLINE void List<T>::InsertAt( T item, const U32 index ) {
-        ensureAllocated( _size + (U32)1, true );
+        ensureGrowth( _size + (U32)1 );
 
         // Push out entries after the index.
         for( U32 i = _size - 1; i >= index; --i ) {
@@ -275,19 +293,40 @@ namespace Epoch {
         }
 
         // Pull in entries after the index.
-        for( U32 i = index; i < _size; ++i ) {
+        for( U32 i = index; i < _size - 1; ++i ) {
             _items[i] = _items[i + 1];
         }
 
         --_size;
     }
 
+    template<class T>
+    FORCEINLINE void List<T>::RemoveAtSwap( const U32 index ) {
+
+        // Boot out early if the index is out of range.
+        if( index >= _size ) {
+            return;
+        }
+
+        // Move the last entry into the vacated slot.
+        if( index != _size - 1 ) {
+            _items[index] = _items[_size - 1];
+        }
+
+        --_size;
+    }
+
     template<class T>
     FORCEINLINE void List<T>::Resize( const U32 size ) {
         ensureAllocated( size, true );
         _size = size;
     }
 
+    template<class T>
+    FORCEINLINE void List<T>::Reserve( const U32 capacity ) {
+        ensureAllocated( capacity, true );
+    }
+
     template<class T>
     FORCEINLINE void List<T>::Clear( const bool shrink ) {
         _size = 0;
@@ -332,6 +371,16 @@ namespace Epoch {
         }
     }
 
+    template<class T>
+    FORCEINLINE void List<T>::ensureGrowth( U32 count ) {
+        if( count <= _capacity ) {
+            return;
+        }
+
+        U32 newCapacity = _capacity < 4 ? 4 : _capacity * 2;
+        ensureAllocated( newCapacity > count ? newCapacity : count, true );
+    }
+
     template<class T>
     FORCEINLINE void List<T>::ensureAllocated( U32 count, const bool keepData ) {
 
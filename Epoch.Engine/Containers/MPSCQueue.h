@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+
+#include "../Types.h"
+#include "../Defines.h"
+
+namespace Epoch {
+
+    /**
+     * A fixed-capacity, lock-free queue which any number of threads may push to, but only a single
+     * thread may pop from. Never allocates. Each slot carries a sequence number which indicates whether it
+     * is ready to be written or read, so producers only contend on claiming a position.
+     *
+     * @tparam T The element type. Should be trivially copyable.
+     * @tparam Capacity The maximum number of elements. Must be a power of 2.
+     */
+    template<class T, U32 Capacity>
+    class MPSCQueue {
+        static_assert( Capacity >= 2 && ( Capacity & ( Capacity - 1 ) ) == 0, "MPSCQueue capacity must be a power of 2." );
+    public:
+        MPSCQueue();
+
+        /**
+         * Attempts to push the given item. Safe to call from any thread.
+         *
+         * @param item The item to push.
+         *
+         * @returns True if pushed; false if the queue is full.
+         */
+        const bool TryPush( const T& item );
+
+        /**
+         * Attempts to pop the oldest item. Must only be called from the consuming thread.
+         *
+         * @param outItem A pointer to hold the popped item.
+         *
+         * @returns True if an item was popped; false if the queue is empty.
+         */
+        const bool TryPop( T* outItem );
+
+        /**
+         * Returns the number of items pushed so far. Items with a lower count than this were pushed before
+         * the call. Must only be called from the consuming thread.
+         */
+        const U64 GetPushCount() const { return _pushPosition.load( std::memory_order_acquire ); }
+
+        /**
+         * Returns the number of items popped so far. Must only be called from the consuming thread.
+         */
+        const U64 GetPopCount() const { return _popPosition; }
+
+        /**
+         * Returns the maximum number of items this queue can hold.
+         */
+        const U32 GetCapacity() const { return Capacity; }
+
+    private:
+        struct Slot {
+
+            // Equal to the position when ready to be written, and position + 1 when ready to be read.
+            std::atomic<U64> Sequence;
+            T Item;
+        };
+
+        Slot _slots[Capacity];
+
+        // Kept on separate cache lines so that producers and the consumer do not contend.
+        alignas( 64 ) std::atomic<U64> _pushPosition;
+        alignas( 64 ) U64 _popPosition;
+    };
+
+    template<class T, U32 Capacity>
+    MPSCQueue<T, Capacity>::MPSCQueue() {
+        for( U32 i = 0; i < Capacity; ++i ) {
+            _slots[i].Sequence.store( i, std::memory_order_relaxed );
+        }
+        _pushPosition.store( 0, std::memory_order_relaxed );
+        _popPosition = 0;
+    }
+
+    template<class T, U32 Capacity>
+    const bool MPSCQueue<T, Capacity>::TryPush( const T& item ) {
+        U64 position = _pushPosition.load( std::memory_order_relaxed );
+        Slot* slot;
+        while( true ) {
+            slot = &_slots[position & ( Capacity - 1 )];
+            U64 sequence = slot->Sequence.load( std::memory_order_acquire );
+            I64 difference = (I64)sequence - (I64)position;
+            if( difference == 0 ) {
+
+                // The slot is free. Claim the position, or retry with whatever another producer moved it to.
+                if( _pushPosition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) ) {
+                    break;
+                }
+            } else if( difference < 0 ) {
+
+                // The consumer has not yet freed this slot from the previous lap, so the queue is full.
+                return false;
+            } else {
+                position = _pushPosition.load( std::memory_order_relaxed );
+            }
+        }
+
+        slot->Item = item;
+        slot->Sequence.store( position + 1, std::memory_order_release );
+        return true;
+    }
+
+    template<class T, U32 Capacity>
+    const bool MPSCQueue<T, Capacity>::TryPop( T* outItem ) {
+        Slot& slot = _slots[_popPosition & ( Capacity - 1 )];
+        if( slot.Sequence.load( std::memory_order_acquire ) != _popPosition + 1 ) {
+
+            // Either empty, or a producer has claimed this slot but not finished writing it yet.
+            return false;
+        }
+
+        *outItem = slot.Item;
+
+        // Hand the slot back to producers for the next lap.
+        slot.Sequence.store( _popPosition + Capacity, std::memory_order_release );
+        _popPosition++;
+        return true;
+    }
+}
\ No newline at end of file
@@ -13,6 +13,9 @@ namespace Epoch {
     Engine::Engine( IApplication* application ) {
         Epoch::Logger::Log( "Initializing Epoch Engine: %d", 4 );
         _application = application;     
+
+        // Only the final size matters after a burst of resizes. Key events are discrete, so every one is delivered.
+        EventManager::SetCoalescePolicy( EventType::WINDOW_RESIZED, EventCoalescePolicy::KEEP_LAST );
     }
 
     Engine::~Engine() {
@@ -4,9 +4,16 @@
 
 namespace Epoch {
 
+    Event::Event() {
+        Type = EventType::UNKNOWN;
+        Sender = nullptr;
+        TMemory::MemZero( Payload, EVENT_PAYLOAD_SIZE );
+    }
+
     Event::Event( EventType type, void* sender ) {
         Type = type;
         Sender = sender;
+        TMemory::MemZero( Payload, EVENT_PAYLOAD_SIZE );
     }
 
     void Event::Post( const bool immediate ) {
@@ -1,6 +1,13 @@
 #pragma once
 
+#include <type_traits>
+
 #include "../Types.h"
+#include "../Defines.h"
+#include "../Memory/Memory.h"
+
+// The maximum size of the data carried by an event, in bytes.
+#define EVENT_PAYLOAD_SIZE 32
 
 namespace Epoch {
 
@@ -17,9 +24,10 @@ namespace Epoch {
     };
 
     /**
-     * The base-level event structure to be used with the event system.
+     * The base-level event structure to be used with the event system. Events are copied by value through the
+     * event queue, so any type-specific data must be stored in the payload rather than in members of a derived type.
      */
-    struct Event {
+    struct EPOCH_API Event {
 
         /**
          * This event's type.
@@ -31,6 +39,16 @@ namespace Epoch {
          */
         void* Sender;
 
+        /**
+         * Type-specific data. Set and read using SetPayload/GetPayload.
+         */
+        alignas( 8 ) U8 Payload[EVENT_PAYLOAD_SIZE];
+
+        /**
+         * Creates an event with no type or sender.
+         */
+        Event();
+
         /**
          * Default constructor.
          * 
@@ -40,9 +58,30 @@ namespace Epoch {
         Event( EventType type, void* sender );
 
         /**
-         * Posts this event.
+         * Copies the given data into this event's payload.
+         *
+         * @param data The data to be copied. Must be trivially copyable and fit within EVENT_PAYLOAD_SIZE.
+         */
+        template<typename T>
+        void SetPayload( const T& data ) {
+            static_assert( sizeof( T ) <= EVENT_PAYLOAD_SIZE, "Event payload type is too large." );
+            static_assert( std::is_trivially_copyable<T>::value, "Event payload type must be trivially copyable." );
+            TMemory::Memcpy( Payload, &data, sizeof( T ) );
+        }
+
+        /**
+         * Returns this event's payload as the given type.
+         */
+        template<typename T>
+        const T& GetPayload() const {
+            static_assert( sizeof( T ) <= EVENT_PAYLOAD_SIZE, "Event payload type is too large." );
+            return *reinterpret_cast<const T*>( Payload );
+        }
+
+        /**
+         * Posts this event. Queued events may be posted from any thread.
          * 
-         * @param immediate Indicates if this event will be handled immediately or be queued on a subsequent frame. Default: false
+         * @param immediate Indicates if this event will be handled immediately or be queued on a subsequent frame. Immediate events must be posted from the main thread. Default: false
          */
         void Post( const bool immediate );
 
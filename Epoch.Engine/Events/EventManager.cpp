@@ -1,95 +1,198 @@
-
-#include <map>
-#include <vector>
-#include <queue>
+#include <atomic>
+#include <chrono>
 
 #include "../Logger.h"
+#include "../Containers/List.h"
+#include "../Containers/MPSCQueue.h"
 
 #include "EventManager.h"
 
+#define EVENT_TYPE_COUNT (U64)EventType::EVENT_TYPE_MAX_EVENT_ID
+
 namespace Epoch {
 
-    // Private event queue
-    std::queue<Event> _eventQueue;
+    // A queued event waiting to be dispatched, which may have been superseded by a later one.
+    struct StagedEvent {
+        Event Data;
+        bool Superseded;
+    };
+
+    // Private event queue. Posted to from any thread, drained on the main thread.
+    static MPSCQueue<Event, EVENT_QUEUE_CAPACITY> _eventQueue;
+
+    // Private dispatch table of handlers, indexed by event type.
+    static List<IEventHandler*> _handlers[EVENT_TYPE_COUNT];
+
+    // Coalescing policy and key size, indexed by event type.
+    static EventCoalescePolicy _policies[EVENT_TYPE_COUNT];
+    static U32 _keySizes[EVENT_TYPE_COUNT];
+
+    // Events drained from the queue which have not yet been dispatched, in the order they were posted.
+    static List<StagedEvent> _staged;
 
-    // Private, static map of events:handlers.
-    std::map<const EventType, std::vector<IEventHandler*>*> _entries;
+    // Indices into _staged of live events, per type. Only kept for types which are coalesced.
+    static List<U32> _stagedByType[EVENT_TYPE_COUNT];
 
-    void EventManager::Post( const Event event, const bool immediate ) {
-        auto entry = _entries.find( event.Type );
-        if( entry == _entries.end() ) {
-            Logger::Trace( "EventManager::Post called for event type with no handlers listening." );
+    // Holds each run of same-type events so they can be dispatched as one contiguous batch.
+    static List<Event> _batch;
+
+    static F32 _updateBudgetMs = EVENT_DEFAULT_UPDATE_BUDGET_MS;
+
+    static EventManagerStats _stats;
+    static std::atomic<U64> _droppedCount( 0 );
+    static U64 _immediateCount = 0;
+
+    void EventManager::Post( const Event& event, const bool immediate ) {
+        if( event.Type >= EventType::EVENT_TYPE_MAX_EVENT_ID ) {
+            Logger::Warn( "EventManager::Post called with an invalid event type. Event discarded." );
             return;
-        } else {
-            if( immediate ) {
+        }
 
-                // TODO: Should probably be using an object pool for this instead of new/delete.
-                processEvent( event );
-            } else {
-                _eventQueue.push( event );
+        if( immediate ) {
+            _immediateCount++;
+            if( _handlers[(U64)event.Type].Size() == 0 ) {
+                Logger::Trace( "EventManager::Post called for event type with no handlers listening." );
+                return;
             }
+            processEvent( event );
+        } else if( !_eventQueue.TryPush( event ) ) {
+            _droppedCount++;
+            Logger::Warn( "EventManager event queue is full. Event discarded." );
         }
     }
 
     void EventManager::Listen( const EventType type, IEventHandler* handler ) {
-        auto entry = _entries.find( type );
-        std::vector<IEventHandler*>* handlers = new std::vector<IEventHandler*>();
-        if( entry == _entries.end() ) {
-            auto it2 = _entries.emplace( type, handlers );
-
-        } else {
-            handlers = ( *entry ).second;
-        }
-
-        std::vector<IEventHandler*>::iterator it = std::find( handlers->begin(), handlers->end(), handler );
-        if( it != handlers->end() ) {
+        List<IEventHandler*>& handlers = _handlers[(U64)type];
+        if( handlers.IndexOf( handler ) != -1 ) {
             Logger::Warn( "EventManager::Listen called with already-listened-for handler. Handler not added." );
             return;
         }
 
-        handlers->push_back( handler );
+        handlers.Add( handler );
     }
 
     void EventManager::StopListening( const EventType type, IEventHandler* handler ) {
-        auto entry = _entries.find( type );
-        std::vector<IEventHandler*> handlers;
-        if( entry == _entries.end() ) {
-            Logger::Warn( "EventManager::StopListening called for an event whose type has no handlers. Nothing was done." );
-        } else {
-            handlers = ( *( *entry ).second );
-        }
-
-        std::vector<IEventHandler*>::iterator it = std::find( handlers.begin(), handlers.end(), handler );
-        if( it == handlers.end() ) {
+        if( _handlers[(U64)type].Remove( handler ) == -1 ) {
             Logger::Warn( "EventManager::StopListening called with non-listened-for handler. Nothing was done." );
-            return;
         }
-
-        handlers.erase( it );
     }
 
     void EventManager::Update( const F32 deltaTime ) {
+        auto start = std::chrono::steady_clock::now();
 
-        U32 processed = 0;
-        while( !_eventQueue.empty() ) {
-            Event e = _eventQueue.front();
-            _eventQueue.pop();
-            processEvent( e );
+        // Anything left over from the last update stays at the front, ahead of newly queued events.
+        for( U64 t = 0; t < EVENT_TYPE_COUNT; ++t ) {
+            _stagedByType[t].Clear();
+        }
+        U32 stagedCount = _staged.Size();
+        for( U32 i = 0; i < stagedCount; ++i ) {
+            U64 type = (U64)_staged[i].Data.Type;
+            if( !_staged[i].Superseded && _policies[type] != EventCoalescePolicy::NONE ) {
+                _stagedByType[type].Add( i );
+            }
+        }
 
-            processed++;
+        // Only stage what was queued before this call, so handlers which post events can't keep this loop going.
+        U64 end = _eventQueue.GetPushCount();
+        Event event;
+        while( _eventQueue.GetPopCount() < end && _eventQueue.TryPop( &event ) ) {
+            stageEvent( event );
+        }
 
-            // TODO: make this configurable.
-            if( processed > 50 ) {
-                Logger::Trace( "Too many messages to process on a single frame, deferring to next frame." );
-                break;
+        // Dispatch runs of consecutive same-type events as batches. Superseded events are skipped without breaking a run.
+        stagedCount = _staged.Size();
+        U32 next = 0;
+        while( next < stagedCount ) {
+            if( _staged[next].Superseded ) {
+                next++;
+                continue;
             }
+
+            EventType type = _staged[next].Data.Type;
+            _batch.Clear();
+            while( next < stagedCount && ( _staged[next].Superseded || _staged[next].Data.Type == type ) ) {
+                if( !_staged[next].Superseded ) {
+                    _batch.Add( _staged[next].Data );
+                }
+                next++;
+            }
+            processBatch( type, _batch.Data(), _batch.Size() );
+
+            if( _updateBudgetMs > 0.0f ) {
+                F32 elapsedMs = std::chrono::duration<F32, std::milli>( std::chrono::steady_clock::now() - start ).count();
+                if( elapsedMs >= _updateBudgetMs && next < stagedCount ) {
+                    Logger::Trace( "Event update budget spent, deferring %u events to the next frame.", stagedCount - next );
+                    break;
+                }
+            }
+        }
+
+        // Drop whatever was dispatched, keeping the rest in order.
+        U32 remaining = stagedCount - next;
+        for( U32 i = 0; i < remaining; ++i ) {
+            _staged[i] = _staged[next + i];
         }
+        _staged.Resize( remaining );
+    }
+
+    void EventManager::SetUpdateBudget( const F32 milliseconds ) {
+        _updateBudgetMs = milliseconds;
+    }
+
+    void EventManager::SetCoalescePolicy( const EventType type, const EventCoalescePolicy policy, const U32 keySize ) {
+        _policies[(U64)type] = policy;
+        _keySizes[(U64)type] = keySize > EVENT_PAYLOAD_SIZE ? EVENT_PAYLOAD_SIZE : keySize;
+    }
+
+    const EventManagerStats EventManager::GetStats() {
+        EventManagerStats stats = _stats;
+        stats.Posted = _eventQueue.GetPushCount() + _immediateCount;
+        stats.Dropped = _droppedCount.load();
+        return stats;
     }
 
     void EventManager::processEvent( const Event& event ) {
-        auto entry = _entries.find( event.Type );
-        for( auto handler : *( ( *entry ).second ) ) {
-            handler->OnEvent( &event );
+
+        // Handlers may stop listening while being dispatched to, so the size is re-checked each iteration.
+        List<IEventHandler*>& handlers = _handlers[(U64)event.Type];
+        for( U32 i = 0; i < handlers.Size(); ++i ) {
+            handlers[i]->OnEvent( &event );
+        }
+    }
+
+    void EventManager::processBatch( const EventType type, const Event* events, const U32 count ) {
+        List<IEventHandler*>& handlers = _handlers[(U64)type];
+        for( U32 i = 0; i < handlers.Size(); ++i ) {
+            handlers[i]->OnEventBatch( events, count );
         }
+        _stats.Delivered += count;
+        _stats.Batches++;
+    }
+
+    void EventManager::stageEvent( const Event& event ) {
+        U64 type = (U64)event.Type;
+        EventCoalescePolicy policy = _policies[type];
+        if( policy != EventCoalescePolicy::NONE ) {
+
+            // Supersede the earlier matching event. There is at most one, since each staged event does this.
+            List<U32>& indices = _stagedByType[type];
+            U32 indexCount = indices.Size();
+            for( U32 i = 0; i < indexCount; ++i ) {
+                const Event& other = _staged[indices[i]].Data;
+                if( policy == EventCoalescePolicy::KEEP_LAST ||
+                    ( other.Sender == event.Sender && TMemory::Memcmp( other.Payload, event.Payload, _keySizes[type] ) == 0 ) ) {
+                    _staged[indices[i]].Superseded = true;
+                    _stats.Coalesced++;
+                    indices.RemoveAtSwap( i );
+                    break;
+                }
+            }
+            indices.Add( _staged.Size() );
+        }
+
+        StagedEvent staged;
+        staged.Data = event;
+        staged.Superseded = false;
+        _staged.Add( staged );
     }
 }
\ No newline at end of file
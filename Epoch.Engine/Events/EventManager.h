@@ -1,25 +1,103 @@
 #pragma once
 
-
+#include "../Defines.h"
 #include "Event.h"
 #include "IEventHandler.h"
 
+// The maximum number of queued events. Must be a power of 2.
+#define EVENT_QUEUE_CAPACITY 4096
+
+// The default amount of time spent dispatching queued events per update, in milliseconds.
+#define EVENT_DEFAULT_UPDATE_BUDGET_MS 2.0f
+
 namespace Epoch {
 
+    /**
+     * Determines how queued events of a single type are combined before being dispatched.
+     */
+    enum class EventCoalescePolicy {
+
+        /** Every event is delivered. */
+        NONE,
+
+        /** Only the most recently posted event of the type is delivered. */
+        KEEP_LAST,
+
+        /**
+         * Only the most recently posted event is delivered for each distinct sender and payload key. Only suited to
+         * state-like events, where a later event makes earlier ones irrelevant.
+         */
+        MERGE_BY_KEY
+    };
+
+    /**
+     * Counters kept by the event manager since startup.
+     */
+    struct EventManagerStats {
+
+        /** The number of events posted, both queued and immediate. */
+        U64 Posted = 0;
+
+        /** The number of queued events handed to handlers. Each event is counted once, regardless of the number of handlers. */
+        U64 Delivered = 0;
+
+        /** The number of queued events which were superseded by a later event and never delivered. */
+        U64 Coalesced = 0;
+
+        /** The number of events discarded because the queue was full. */
+        U64 Dropped = 0;
+
+        /** The number of batches dispatched from the queue. */
+        U64 Batches = 0;
+    };
+
     /*
      Manages events across the system. A new event may be posted, to which listeners will
-     listen. Events have a type, which may be 
+     listen. Events have a type, which is used to look up its handlers in a flat dispatch table.
+     Queued events may be posted from any thread, and are dispatched on the main thread during Update.
+     Listening and immediate posting must only be done from the main thread.
     */
-    class EventManager {
+    class EPOCH_API EventManager {
     public:
-        static void Post( const Event event, const bool immediate );
+        static void Post( const Event& event, const bool immediate );
         static void Listen( const EventType type, IEventHandler* handler );
         static void StopListening( const EventType type, IEventHandler* handler );
 
+        /**
+         * Dispatches queued events until the queue is empty or the update budget is spent. Events posted
+         * during this call are left for the next one. Queued events are coalesced according to the policy of
+         * their type, then consecutive events of the same type are handed to each handler as a single batch.
+         *
+         * @param deltaTime The amount of time in seconds since the last frame.
+         */
         static void Update( const F32 deltaTime );
 
+        /**
+         * Sets the maximum amount of time spent dispatching queued events per update. Anything remaining is
+         * deferred to the next update.
+         *
+         * @param milliseconds The budget in milliseconds. 0 removes the limit.
+         */
+        static void SetUpdateBudget( const F32 milliseconds );
+
+        /**
+         * Sets how queued events of the given type are coalesced. Does not affect immediate events.
+         *
+         * @param type The event type.
+         * @param policy The coalescing policy.
+         * @param keySize For MERGE_BY_KEY, the number of leading payload bytes which make up the key. Ignored otherwise. Default: 0.
+         */
+        static void SetCoalescePolicy( const EventType type, const EventCoalescePolicy policy, const U32 keySize = 0 );
+
+        /**
+         * Returns the event counters.
+         */
+        static const EventManagerStats GetStats();
+
     private:
         static void processEvent( const Event& event );
+        static void processBatch( const EventType type, const Event* events, const U32 count );
+        static void stageEvent( const Event& event );
 
     private:
         // Private to enforce singleton pattern.
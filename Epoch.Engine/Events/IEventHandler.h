@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../Types.h"
+
 namespace Epoch {
 
     struct Event;
@@ -16,5 +18,18 @@ namespace Epoch {
          * @param event The event to be processed.
          */
         virtual void OnEvent( const Event* event ) = 0;
+
+        /**
+         * Processes a batch of queued events, all of the same type and in the order they were posted.
+         * By default, each event is passed to OnEvent in turn. Override this to react once per batch.
+         *
+         * @param events A pointer to the first event.
+         * @param count The number of events.
+         */
+        virtual void OnEventBatch( const Event* events, const U32 count ) {
+            for( U32 i = 0; i < count; ++i ) {
+                OnEvent( &events[i] );
+            }
+        }
     };
 }
\ No newline at end of file
@@ -70,7 +70,7 @@ namespace Epoch {
         bool _isBinary;
         U64 _fileSize = 0;
         TString _filePath;
-        std::fstream* _handle;
+        std::fstream* _handle = nullptr;
     };
 
     template<typename T>
@@ -86,7 +86,7 @@ namespace Epoch {
     const bool FileHandle::ReadArray( T** outValue, const U64 length ) {
         if( _handle && _handle->good() ) {
             *outValue = new T[length];
-            _handle->read( (char*)outValue[0], sizeof( outValue[0] ) * length );
+            _handle->read( (char*)outValue[0], sizeof( T ) * length );
             U64 pos = _handle->tellg();
             return true;
         }
@@ -2,6 +2,9 @@
 
 #define EPOCH_FILE_EXT_STATIC_MESH ".esm"
 #define EPOCH_FILE_EXT_MATERIAL ".emtl"
+#define EPOCH_FILE_EXT_LEVEL ".elv"
+#define EPOCH_FILE_EXT_TEXTURE ".etex"
+#define EPOCH_FILE_EXT_SHADER_ARCHIVE ".esa"
 
 namespace Epoch {
 
@@ -0,0 +1,126 @@
+#include "../Logger.h"
+
+#include "MappedFile.h"
+
+#ifdef PLATFORM_WINDOWS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace Epoch {
+
+    MappedFile::MappedFile( const TString& filePath ) {
+        _filePath = filePath;
+    }
+
+    MappedFile::~MappedFile() {
+        Close();
+    }
+
+#ifdef PLATFORM_WINDOWS
+    const bool MappedFile::TryOpen() {
+        if( _data ) {
+            return true;
+        }
+
+        HANDLE file = CreateFileA( _filePath.CStr(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+        if( file == INVALID_HANDLE_VALUE ) {
+            Logger::Error( "Failed to open file '%s' for mapping.", _filePath.CStr() );
+            return false;
+        }
+
+        LARGE_INTEGER size;
+        if( !GetFileSizeEx( file, &size ) || size.QuadPart == 0 ) {
+            Logger::Error( "Unable to map empty or unreadable file '%s'.", _filePath.CStr() );
+            CloseHandle( file );
+            return false;
+        }
+
+        // PAGE_WRITECOPY/FILE_MAP_COPY gives a private, copy-on-write view.
+        HANDLE mapping = CreateFileMappingA( file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr );
+        if( !mapping ) {
+            Logger::Error( "Failed to create file mapping for '%s'.", _filePath.CStr() );
+            CloseHandle( file );
+            return false;
+        }
+
+        void* view = MapViewOfFile( mapping, FILE_MAP_COPY, 0, 0, 0 );
+        if( !view ) {
+            Logger::Error( "Failed to map view of file '%s'.", _filePath.CStr() );
+            CloseHandle( mapping );
+            CloseHandle( file );
+            return false;
+        }
+
+        _fileHandle = file;
+        _mappingHandle = mapping;
+        _data = static_cast<U8*>( view );
+        _size = (U64)size.QuadPart;
+        return true;
+    }
+
+    void MappedFile::Close() {
+        if( _data ) {
+            UnmapViewOfFile( _data );
+            _data = nullptr;
+        }
+        if( _mappingHandle ) {
+            CloseHandle( _mappingHandle );
+            _mappingHandle = nullptr;
+        }
+        if( _fileHandle ) {
+            CloseHandle( _fileHandle );
+            _fileHandle = nullptr;
+        }
+        _size = 0;
+    }
+#else
+    const bool MappedFile::TryOpen() {
+        if( _data ) {
+            return true;
+        }
+
+        int fd = open( _filePath.CStr(), O_RDONLY );
+        if( fd < 0 ) {
+            Logger::Error( "Failed to open file '%s' for mapping.", _filePath.CStr() );
+            return false;
+        }
+
+        struct stat fileStat;
+        if( fstat( fd, &fileStat ) != 0 || fileStat.st_size == 0 ) {
+            Logger::Error( "Unable to map empty or unreadable file '%s'.", _filePath.CStr() );
+            close( fd );
+            return false;
+        }
+
+        // MAP_PRIVATE gives a copy-on-write view.
+        void* view = mmap( nullptr, (size_t)fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+        if( view == MAP_FAILED ) {
+            Logger::Error( "Failed to map file '%s'.", _filePath.CStr() );
+            close( fd );
+            return false;
+        }
+
+        _fileDescriptor = fd;
+        _data = static_cast<U8*>( view );
+        _size = (U64)fileStat.st_size;
+        return true;
+    }
+
+    void MappedFile::Close() {
+        if( _data ) {
+            munmap( _data, (size_t)_size );
+            _data = nullptr;
+        }
+        if( _fileDescriptor >= 0 ) {
+            close( _fileDescriptor );
+            _fileDescriptor = -1;
+        }
+        _size = 0;
+    }
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "../Types.h"
+#include "../Defines.h"
+#include "../String/TString.h"
+
+namespace Epoch {
+
+    /**
+     * A read-only file mapped into memory. The mapping is copy-on-write, so the contents may be modified in
+     * place (for example, to fix up offsets into pointers) without affecting the file on disk. Only pages
+     * which are written to are copied.
+     */
+    class EPOCH_API MappedFile {
+    public:
+        MappedFile( const TString& filePath );
+        ~MappedFile();
+
+        /**
+         * Attempts to open and map the file.
+         *
+         * @returns True if successful; otherwise false.
+         */
+        const bool TryOpen();
+
+        /**
+         * Unmaps and closes the file. Any pointers into its data are invalid after this.
+         */
+        void Close();
+
+        /**
+         * Returns a pointer to the start of the mapped data, or nullptr if not open.
+         */
+        U8* GetData() { return _data; }
+
+        /**
+         * Returns the size of the mapped data in bytes.
+         */
+        const U64 GetSize() const { return _size; }
+
+        const bool IsOpen() const { return _data != nullptr; }
+
+    private:
+        TString _filePath;
+        U8* _data = nullptr;
+        U64 _size = 0;
+
+#ifdef PLATFORM_WINDOWS
+        void* _fileHandle = nullptr;
+        void* _mappingHandle = nullptr;
+#else
+        int _fileDescriptor = -1;
+#endif
+    };
+}
\ No newline at end of file
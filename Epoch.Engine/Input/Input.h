@@ -123,21 +123,33 @@ namespace Epoch {
         RMENU = 0xA5
     };
 
+    /**
+     * Signals that a key was pressed. The key is held in the payload.
+     */
     class KeyDownEvent : public Event {
-    public:
-        Key EventKey;
     public:
         KeyDownEvent( Key key, void* sender ) :Event( EventType::KEY_DOWN, sender ) {
-            EventKey = key;
+            SetPayload( key );
         }
+
+        /**
+         * Returns the key carried by the given key event.
+         */
+        static const Key GetKey( const Event* event ) { return event->GetPayload<Key>(); }
     };
 
+    /**
+     * Signals that a key was released. The key is held in the payload.
+     */
     class KeyUpEvent : public Event {
-    public:
-        Key EventKey;
     public:
         KeyUpEvent( Key key, void* sender ) :Event( EventType::KEY_UP, sender ) {
-            EventKey = key;
+            SetPayload( key );
         }
+
+        /**
+         * Returns the key carried by the given key event.
+         */
+        static const Key GetKey( const Event* event ) { return event->GetPayload<Key>(); }
     };
 }
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include <math.h>
+#include <cmath>
+
+#include "TMath.h"
+#include "Matrix4x4.h"
+#include "BoundingVolumes.h"
+
+namespace Epoch {
+
+    AABB AABB::Transformed( const Matrix4x4& m ) const {
+        const F32* d = m.Data();
+        Vector3 center = GetCenter();
+        Vector3 extents = GetExtents();
+
+        // Transform the center as a point, and project the extents onto each axis using the absolute
+        // value of the rotation/scale portion of the matrix (Arvo).
+        AABB result;
+        for( I32 row = 0; row < 3; ++row ) {
+            F32 c = d[row] * center.X + d[4 + row] * center.Y + d[8 + row] * center.Z + d[12 + row];
+            F32 e = TMath::Abs( d[row] ) * extents.X + TMath::Abs( d[4 + row] ) * extents.Y + TMath::Abs( d[8 + row] ) * extents.Z;
+            result.Min[row] = c - e;
+            result.Max[row] = c + e;
+        }
+        return result;
+    }
+
+    const bool AABB::Intersects( const AABB& other ) const {
+        return Min.X <= other.Max.X && Max.X >= other.Min.X &&
+            Min.Y <= other.Max.Y && Max.Y >= other.Min.Y &&
+            Min.Z <= other.Max.Z && Max.Z >= other.Min.Z;
+    }
+
+    const bool AABB::Intersects( const BoundingSphere& sphere ) const {
+
+        // Distance from the sphere center to the closest point on the box.
+        F32 distanceSq = 0.0f;
+        for( I32 i = 0; i < 3; ++i ) {
+            F32 c = sphere.Center[i];
+            if( c < Min[i] ) {
+                distanceSq += ( Min[i] - c ) * ( Min[i] - c );
+            } else if( c > Max[i] ) {
+                distanceSq += ( c - Max[i] ) * ( c - Max[i] );
+            }
+        }
+        return distanceSq <= sphere.Radius * sphere.Radius;
+    }
+
+    const bool AABB::IntersectsRay( const Vector3& origin, const Vector3& inverseDirection, const F32 maxDistance, F32* outDistance ) const {
+
+        // Slab test.
+        F32 tMin = 0.0f;
+        F32 tMax = maxDistance;
+        for( I32 i = 0; i < 3; ++i ) {
+
+            // A zero direction component has an infinite inverse, and the ray is parallel to this slab, so it only hits if
+            // it starts within it. This is checked explicitly, as the products below are NaN when the origin lies on a slab plane.
+            if( !std::isfinite( inverseDirection[i] ) ) {
+                if( origin[i] < Min[i] || origin[i] > Max[i] ) {
+                    return false;
+                }
+                continue;
+            }
+
+            F32 t1 = ( Min[i] - origin[i] ) * inverseDirection[i];
+            F32 t2 = ( Max[i] - origin[i] ) * inverseDirection[i];
+            tMin = ::Max( tMin, ::Min( t1, t2 ) );
+            tMax = ::Min( tMax, ::Max( t1, t2 ) );
+        }
+
+        if( tMin > tMax ) {
+            return false;
+        }
+
+        if( outDistance ) {
+            *outDistance = tMin;
+        }
+        return true;
+    }
+
+    AABB AABB::Union( const AABB& a, const AABB& b ) {
+        return AABB(
+            Vector3( ::Min( a.Min.X, b.Min.X ), ::Min( a.Min.Y, b.Min.Y ), ::Min( a.Min.Z, b.Min.Z ) ),
+            Vector3( ::Max( a.Max.X, b.Max.X ), ::Max( a.Max.Y, b.Max.Y ), ::Max( a.Max.Z, b.Max.Z ) ) );
+    }
+
+    AABB AABB::FromPoints( const Vector3* points, const U32 count, const U64 stride ) {
+        AABB result;
+        if( count == 0 ) {
+            return result;
+        }
+
+        const U8* ptr = reinterpret_cast<const U8*>( points );
+        result.Min = *points;
+        result.Max = *points;
+        for( U32 i = 1; i < count; ++i ) {
+            const Vector3& p = *reinterpret_cast<const Vector3*>( ptr + ( stride * i ) );
+            result.Min.Set( ::Min( result.Min.X, p.X ), ::Min( result.Min.Y, p.Y ), ::Min( result.Min.Z, p.Z ) );
+            result.Max.Set( ::Max( result.Max.X, p.X ), ::Max( result.Max.Y, p.Y ), ::Max( result.Max.Z, p.Z ) );
+        }
+        return result;
+    }
+
+    BoundingSphere BoundingSphere::Transformed( const Matrix4x4& m ) const {
+        const F32* d = m.Data();
+
+        BoundingSphere result;
+        result.Center.Set(
+            d[0] * Center.X + d[4] * Center.Y + d[8] * Center.Z + d[12],
+            d[1] * Center.X + d[5] * Center.Y + d[9] * Center.Z + d[13],
+            d[2] * Center.X + d[6] * Center.Y + d[10] * Center.Z + d[14] );
+
+        F32 scaleXSq = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+        F32 scaleYSq = d[4] * d[4] + d[5] * d[5] + d[6] * d[6];
+        F32 scaleZSq = d[8] * d[8] + d[9] * d[9] + d[10] * d[10];
+        result.Radius = Radius * sqrtf( ::Max( scaleXSq, ::Max( scaleYSq, scaleZSq ) ) );
+        return result;
+    }
+
+    BoundingSphere BoundingSphere::FromPoints( const AABB& box, const Vector3* points, const U32 count, const U64 stride ) {
+        BoundingSphere result;
+        result.Center = box.GetCenter();
+
+        const U8* ptr = reinterpret_cast<const U8*>( points );
+        F32 maxDistanceSq = 0.0f;
+        for( U32 i = 0; i < count; ++i ) {
+            const Vector3& p = *reinterpret_cast<const Vector3*>( ptr + ( stride * i ) );
+            maxDistanceSq = ::Max( maxDistanceSq, ( p - result.Center ).LengthSquared() );
+        }
+        result.Radius = sqrtf( maxDistanceSq );
+        return result;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "../Defines.h"
+#include "../Types.h"
+#include "Vector3.h"
+
+namespace Epoch {
+
+    class Matrix4x4;
+    struct BoundingSphere;
+
+    /*
+     * An axis-aligned bounding box, represented by its minimum and maximum corners.
+     */
+    struct EPOCH_API AABB {
+    public:
+
+        /** The minimum corner of this box. */
+        Vector3 Min;
+
+        /** The maximum corner of this box. */
+        Vector3 Max;
+
+    public:
+
+        /**
+         * Creates a new, empty box at the origin.
+         */
+        AABB() {}
+
+        /**
+         * Creates a new box from the given corners.
+         *
+         * @param min The minimum corner.
+         * @param max The maximum corner.
+         */
+        AABB( const Vector3& min, const Vector3& max ) : Min( min ), Max( max ) {}
+
+        /**
+         * Returns the center point of this box.
+         */
+        Vector3 GetCenter() const { return ( Min + Max ) * 0.5f; }
+
+        /**
+         * Returns the half-size of this box along each axis.
+         */
+        Vector3 GetExtents() const { return ( Max - Min ) * 0.5f; }
+
+        /**
+         * Returns a box which encloses this box after being transformed by the given matrix.
+         *
+         * @param m The matrix to transform by.
+         *
+         * @returns The transformed box.
+         */
+        AABB Transformed( const Matrix4x4& m ) const;
+
+        /**
+         * Indicates if this box overlaps the given box.
+         *
+         * @param other The box to test against.
+         */
+        const bool Intersects( const AABB& other ) const;
+
+        /**
+         * Indicates if this box overlaps the given sphere.
+         *
+         * @param sphere The sphere to test against.
+         */
+        const bool Intersects( const BoundingSphere& sphere ) const;
+
+        /**
+         * Tests a ray against this box.
+         *
+         * @param origin The origin of the ray.
+         * @param inverseDirection The reciprocal of each component of the ray direction. Components of zero direction must be infinite.
+         * @param maxDistance The maximum distance along the ray to test.
+         * @param outDistance A pointer to hold the distance along the ray at which it enters the box. Optional.
+         *
+         * @returns True if the ray hits this box within maxDistance; otherwise false.
+         */
+        const bool IntersectsRay( const Vector3& origin, const Vector3& inverseDirection, const F32 maxDistance, F32* outDistance = nullptr ) const;
+
+        /**
+         * Returns the smallest box which encloses both of the given boxes.
+         *
+         * @param a The first box.
+         * @param b The second box.
+         */
+        static AABB Union( const AABB& a, const AABB& b );
+
+        /**
+         * Calculates the smallest box which encloses the given points.
+         *
+         * @param points A pointer to the first point.
+         * @param count The number of points.
+         * @param stride The distance in bytes between each point.
+         *
+         * @returns The enclosing box. If count is 0, an empty box at the origin is returned.
+         */
+        static AABB FromPoints( const Vector3* points, const U32 count, const U64 stride = sizeof( Vector3 ) );
+    };
+
+    /*
+     * A bounding sphere, represented by a center point and radius.
+     */
+    struct EPOCH_API BoundingSphere {
+    public:
+
+        /** The center of this sphere. */
+        Vector3 Center;
+
+        /** The radius of this sphere. */
+        F32 Radius = 0.0f;
+
+    public:
+
+        /**
+         * Returns a sphere which encloses this sphere after being transformed by the given matrix.
+         * Non-uniform scale grows the radius by the largest axis scale.
+         *
+         * @param m The matrix to transform by.
+         *
+         * @returns The transformed sphere.
+         */
+        BoundingSphere Transformed( const Matrix4x4& m ) const;
+
+        /**
+         * Calculates a sphere centered on the given box which encloses all of the given points.
+         *
+         * @param box The box enclosing the points, as returned from AABB::FromPoints.
+         * @param points A pointer to the first point.
+         * @param count The number of points.
+         * @param stride The distance in bytes between each point.
+         *
+         * @returns The enclosing sphere.
+         */
+        static BoundingSphere FromPoints( const AABB& box, const Vector3* points, const U32 count, const U64 stride = sizeof( Vector3 ) );
+    };
+}
\ No newline at end of file
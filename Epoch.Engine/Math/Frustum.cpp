@@ -0,0 +1,56 @@
+#include "TMath.h"
+#include "Matrix4x4.h"
+#include "Frustum.h"
+
+namespace Epoch {
+
+    void Plane::Normalize() {
+        F32 length = Normal.Length();
+        if( length > 0.0f ) {
+            F32 inverse = 1.0f / length;
+            Normal = Normal * inverse;
+            Distance *= inverse;
+        }
+    }
+
+    const bool Frustum::IntersectsAABB( const AABB& box ) const {
+        Vector3 center = box.GetCenter();
+        Vector3 extents = box.GetExtents();
+        for( U32 i = 0; i < 6; ++i ) {
+            const Plane& p = Planes[i];
+            F32 radius = TMath::Abs( p.Normal.X ) * extents.X + TMath::Abs( p.Normal.Y ) * extents.Y + TMath::Abs( p.Normal.Z ) * extents.Z;
+            if( p.DistanceTo( center ) + radius < 0.0f ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const bool Frustum::IntersectsSphere( const BoundingSphere& sphere ) const {
+        for( U32 i = 0; i < 6; ++i ) {
+            if( Planes[i].DistanceTo( sphere.Center ) + sphere.Radius < 0.0f ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Frustum Frustum::FromViewProjection( const Matrix4x4& viewProjection ) {
+
+        // Gribb/Hartmann plane extraction. The matrix is column-major, so row r is (d[r], d[4+r], d[8+r], d[12+r]).
+        const F32* d = viewProjection.Data();
+        Frustum result;
+        for( U32 i = 0; i < 6; ++i ) {
+            U32 row = i / 2;
+            F32 sign = ( i % 2 == 0 ) ? 1.0f : -1.0f;
+            Plane& p = result.Planes[i];
+            p.Normal.Set( d[3] + sign * d[row], d[7] + sign * d[4 + row], d[11] + sign * d[8 + row] );
+            p.Distance = d[15] + sign * d[12 + row];
+            p.Normalize();
+        }
+
+        // NOTE: The near plane is extracted using the -w <= z clip range. This is slightly more conservative
+        // than Vulkan's 0 <= z range, which only means an object very close to the camera may not be culled.
+        return result;
+    }
+}
\ No newline at end of file
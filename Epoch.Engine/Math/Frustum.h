@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../Defines.h"
+#include "../Types.h"
+#include "Vector3.h"
+#include "BoundingVolumes.h"
+
+namespace Epoch {
+
+    class Matrix4x4;
+
+    /*
+     * A plane in 3D space, in the form Normal.Dot( point ) + Distance = 0.
+     */
+    struct EPOCH_API Plane {
+    public:
+
+        /** The normal of this plane. Points towards the "inside" half-space. */
+        Vector3 Normal;
+
+        /** The signed distance of this plane from the origin along its normal. */
+        F32 Distance = 0.0f;
+
+    public:
+
+        /**
+         * Returns the signed distance from this plane to the given point. Positive values are in front of the plane.
+         *
+         * @param point The point to test.
+         */
+        F32 DistanceTo( const Vector3& point ) const { return Normal.Dot( point ) + Distance; }
+
+        /**
+         * Normalizes this plane so that its normal is unit-length.
+         */
+        void Normalize();
+    };
+
+    /*
+     * A view frustum made up of 6 inward-facing planes, in the order left, right, bottom, top, near, far.
+     */
+    struct EPOCH_API Frustum {
+    public:
+
+        /** The planes of this frustum. */
+        Plane Planes[6];
+
+    public:
+
+        /**
+         * Indicates if the given box is at least partially inside of this frustum.
+         *
+         * @param box The box to test.
+         *
+         * @returns True if the box intersects this frustum; otherwise false.
+         */
+        const bool IntersectsAABB( const AABB& box ) const;
+
+        /**
+         * Indicates if the given sphere is at least partially inside of this frustum.
+         *
+         * @param sphere The sphere to test.
+         *
+         * @returns True if the sphere intersects this frustum; otherwise false.
+         */
+        const bool IntersectsSphere( const BoundingSphere& sphere ) const;
+
+        /**
+         * Extracts the frustum planes from a combined projection * view matrix.
+         *
+         * @param viewProjection The combined view-projection matrix.
+         *
+         * @returns The extracted frustum.
+         */
+        static Frustum FromViewProjection( const Matrix4x4& viewProjection );
+    };
+}
\ No newline at end of file
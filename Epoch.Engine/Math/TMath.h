@@ -73,8 +73,9 @@ namespace Epoch {
         // Arc sine (64-bit)
         static F64 ASin( const F64 x );
 
-        static F32 ATan2( const F32 x, const F32 y );
-        static F64 ATan2( const F64 x, const F64 y );
+        // Arc tangent of y / x, using the signs of both to choose the quadrant.
+        static F32 ATan2( const F32 y, const F32 x );
+        static F64 ATan2( const F64 y, const F64 x );
 
         // Arc cosine (32-bit) - input clamped to [-1, 1] to avoid silent NaN
         static F32 ACos( const F32 x );
@@ -385,7 +386,7 @@ namespace Epoch {
         return asin( x );
     }
 
-    inline F32 TMath::ATan2( const F32 x, const F32 y ) {
+    inline F32 TMath::ATan2( const F32 y, const F32 x ) {
         // return atan2f( x, y );
         // atan2f occasionally returns NaN with perfectly valid input (possibly due to a compiler or library bug).
         // We are replacing it with a minimax approximation with a max relative error of 7.15255737e-007 compared to the C library function.
@@ -430,8 +431,8 @@ namespace Epoch {
         return t3;
     }
 
-    inline F64 TMath::ATan2( const F64 x, const F64 y ) {
-        return atan2( x, y );
+    inline F64 TMath::ATan2( const F64 y, const F64 x ) {
+        return atan2( y, x );
     }
 
     // Arc cosine (32-bit) - input clamped to [-1, 1] to avoid silent NaN
@@ -28,6 +28,10 @@ namespace Epoch {
             return memcpy( destination, source, size );
         }
 
+        static FORCEINLINE const I32 Memcmp( const void* a, const void* b, U64 size ) {
+            return memcmp( a, b, size );
+        }
+
         static FORCEINLINE void* MemSet( void* destination, U8 character, U64 size ) {
             return memset( destination, character, size );
         }
@@ -23,4 +23,9 @@ namespace Epoch {
 
         return fileBuffer;
     }
+
+    const bool FileHelper::FileExists( const char* path ) {
+        std::ifstream file( path, std::ios::binary );
+        return file.is_open();
+    }
 }
\ No newline at end of file
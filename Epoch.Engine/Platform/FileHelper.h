@@ -18,6 +18,13 @@ namespace Epoch {
          */
         static const char* ReadFileBinaryToArray( const char* path, U64* fileSize );
 
+        /**
+         * Indicates if a file exists at the given path and can be opened for reading.
+         *
+         * @param path The full path to the file.
+         */
+        static const bool FileExists( const char* path );
+
     private:
         // This class is a singleton, so hide these.
         FileHelper() {}
@@ -11,9 +11,9 @@ namespace Epoch {
     class IWindow;
 
     /**
-     * A specialized event used to signal a window resize having occurred.
+     * The payload of a window resized event.
      */
-    struct WindowResizedEvent final : public Event {
+    struct WindowResizedEventData {
 
         /**
          * The previous width of the window in pixels.
@@ -34,26 +34,29 @@ namespace Epoch {
          * The new height of the window in pixels.
          */
         U32 NewHeight;
+    };
 
-        /**
-         * Specialized conversion constructor.
-         */
-        WindowResizedEvent( Event event ) : Event( event.Type, event.Sender ) {
-            PreviousWidth = 0;
-            PreviousHeight = 0;
-            NewWidth = 0;
-            NewHeight = 0;
-        }
+    /**
+     * A specialized event used to signal a window resize having occurred. The sizes are held in the
+     * payload as WindowResizedEventData.
+     */
+    struct WindowResizedEvent final : public Event {
 
         WindowResizedEvent( void* sender, U32 prevWidth, U32 prevHeight, U32 newWidth, U32 newHeight )
             : Event( EventType::WINDOW_RESIZED, sender ) {
 
-            PreviousWidth = prevWidth;
-            PreviousHeight = prevHeight;
-            NewWidth = newWidth;
-            NewHeight = newHeight;
+            WindowResizedEventData data;
+            data.PreviousWidth = prevWidth;
+            data.PreviousHeight = prevHeight;
+            data.NewWidth = newWidth;
+            data.NewHeight = newHeight;
+            SetPayload( data );
         }
 
+        /**
+         * Returns the sizes carried by the given window resized event.
+         */
+        static const WindowResizedEventData& GetData( const Event* event ) { return event->GetPayload<WindowResizedEventData>(); }
     };
 
     /**
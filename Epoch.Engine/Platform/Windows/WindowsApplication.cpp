@@ -124,8 +124,9 @@ namespace Epoch {
             U16 height = HIWORD( lParam );
 
             // TODO: Detect which window was resized.
+            // Queued, so that a burst of resizes while dragging is coalesced into one.
             WindowResizedEvent resizeEvent( _mainWindow, 0, 0, (U32)width, (U32)height );
-            resizeEvent.Post( true );
+            resizeEvent.Post( false );
             break;
         }
 
@@ -146,7 +147,7 @@ namespace Epoch {
 
     void WindowsApplication::handleKeyDown( Key key ) {
         KeyDownEvent event( key, this );
-        event.Post( true );
+        event.Post( false );
         switch( key ) {
 
             // TODO: Temporary convenience - remove later
@@ -159,7 +160,7 @@ namespace Epoch {
 
     void WindowsApplication::handleKeyUp( Key key ) {
         KeyUpEvent event( key, this );
-        event.Post( true );
+        event.Post( false );
     }
 
     const bool WindowsApplication::registerClass( const HINSTANCE handle, const HICON iconHandle ) {
@@ -0,0 +1,99 @@
+#include "WorkerPool.h"
+
+namespace Epoch {
+
+    WorkerPool::WorkerPool( const U32 workerCount ) {
+        _workers.Reserve( workerCount );
+        for( U32 i = 0; i < workerCount; ++i ) {
+            _workers.Add( new std::thread( [this]() { workerMain(); } ) );
+        }
+    }
+
+    WorkerPool::~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            _isShuttingDown = true;
+        }
+        _wakeCondition.notify_all();
+
+        U32 workerCount = _workers.Size();
+        for( U32 i = 0; i < workerCount; ++i ) {
+            _workers[i]->join();
+            delete _workers[i];
+        }
+        _workers.Clear( true );
+    }
+
+    WorkerPool* WorkerPool::GetShared() {
+        static WorkerPool sharedPool( std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0 );
+        return &sharedPool;
+    }
+
+    void WorkerPool::runTasks( const U32 taskCount, TaskFunction function, const void* context ) {
+        if( taskCount == 0 ) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> runLock( _runMutex );
+        {
+            // A worker which woke late for the previous batch may still be looking at its task index, so wait it out.
+            std::unique_lock<std::mutex> lock( _mutex );
+            _doneCondition.wait( lock, [this]() { return _activeWorkers == 0; } );
+
+            _taskFunction = function;
+            _taskContext = context;
+            _taskCount = taskCount;
+            _nextTask.store( 0 );
+            _completedTasks.store( 0 );
+            ++_generation;
+        }
+        if( taskCount > 1 ) {
+            _wakeCondition.notify_all();
+        }
+
+        executeTasks( function, context, taskCount );
+
+        std::unique_lock<std::mutex> lock( _mutex );
+        _doneCondition.wait( lock, [this, taskCount]() { return _completedTasks.load() == taskCount && _activeWorkers == 0; } );
+    }
+
+    void WorkerPool::workerMain() {
+        U64 lastGeneration = 0;
+        while( true ) {
+            TaskFunction function;
+            const void* context;
+            U32 taskCount;
+            {
+                std::unique_lock<std::mutex> lock( _mutex );
+                _wakeCondition.wait( lock, [this, lastGeneration]() { return _isShuttingDown || _generation != lastGeneration; } );
+                if( _isShuttingDown ) {
+                    return;
+                }
+                lastGeneration = _generation;
+                function = _taskFunction;
+                context = _taskContext;
+                taskCount = _taskCount;
+                ++_activeWorkers;
+            }
+
+            executeTasks( function, context, taskCount );
+
+            {
+                std::lock_guard<std::mutex> lock( _mutex );
+                --_activeWorkers;
+            }
+            _doneCondition.notify_all();
+        }
+    }
+
+    void WorkerPool::executeTasks( TaskFunction function, const void* context, const U32 taskCount ) {
+        while( true ) {
+            U32 index = _nextTask.fetch_add( 1 );
+            if( index >= taskCount ) {
+                return;
+            }
+            function( context, index );
+            _completedTasks.fetch_add( 1 );
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "../Types.h"
+#include "../Defines.h"
+#include "../Containers/List.h"
+
+namespace Epoch {
+
+    /**
+     * A fixed set of worker threads which are created once and sleep until handed a batch of tasks, so that
+     * per-frame work can be spread across cores without creating and joining threads every frame.
+     */
+    class EPOCH_API WorkerPool {
+    public:
+
+        /**
+         * Creates a new pool.
+         *
+         * @param workerCount The number of worker threads to create. The calling thread also runs tasks, so a pool
+         * with no workers is valid and simply runs everything on the caller.
+         */
+        WorkerPool( const U32 workerCount );
+        ~WorkerPool();
+
+        /**
+         * Returns the number of worker threads, not counting the calling thread.
+         */
+        const U32 GetWorkerCount() const { return _workers.Size(); }
+
+        /**
+         * Calls task( index ) for each index in [0, taskCount), spread across the workers and the calling thread,
+         * and returns once all have finished. Calls from multiple threads are run one batch at a time.
+         *
+         * @param taskCount The number of tasks to run.
+         * @param task A callable taking the task index. Referenced only until this returns.
+         */
+        template<typename T>
+        void Run( const U32 taskCount, const T& task ) {
+            runTasks( taskCount, []( const void* context, const U32 index ) { ( *static_cast<const T*>( context ) )( index ); }, &task );
+        }
+
+        /**
+         * Returns a pool shared by engine systems, with one worker per additional hardware thread. Created on first use.
+         */
+        static WorkerPool* GetShared();
+
+    private:
+        typedef void ( *TaskFunction )( const void* context, const U32 index );
+
+        void runTasks( const U32 taskCount, TaskFunction function, const void* context );
+        void workerMain();
+        void executeTasks( TaskFunction function, const void* context, const U32 taskCount );
+
+    private:
+        List<std::thread*> _workers;
+
+        // Held for the duration of a batch, so concurrent callers queue up rather than overwrite each other's batch.
+        std::mutex _runMutex;
+
+        // Guards the batch below, the generation and the active worker count.
+        std::mutex _mutex;
+        std::condition_variable _wakeCondition;
+        std::condition_variable _doneCondition;
+
+        // The current batch. Only changed while no workers are active in it.
+        TaskFunction _taskFunction = nullptr;
+        const void* _taskContext = nullptr;
+        U32 _taskCount = 0;
+        U64 _generation = 0;
+
+        // The number of workers which have picked up the current batch and not yet finished with it.
+        U32 _activeWorkers = 0;
+        bool _isShuttingDown = false;
+
+        std::atomic<U32> _nextTask { 0 };
+        std::atomic<U32> _completedTasks { 0 };
+    };
+}
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include "../../Types.h"
 #include "../../World/EntityComponents/StaticMeshEntityComponent.h"
 #include "../../World/World.h"
+#include "../../Math/Matrix4x4.h"
+#include "../RenderData.h"
 
 namespace Epoch {
 
@@ -10,7 +12,7 @@ namespace Epoch {
     class TString;
     class ITexture;
     class IShader;
-    struct WorldRenderableObjectTable;
+    class CameraEntity;
 
     /**
      * Represents the backend of the renderer, which is an abstraction of the
@@ -35,10 +37,11 @@ namespace Epoch {
          * Initializes this renderer.
          *
          * @param enableValidation Indicates if validation should be enabled for this renderer. Has a high performance cost. Should only be used for debugging.
+         * @param framesInFlight The number of frames the CPU may record ahead of the GPU. More hides GPU stalls at the cost of latency.
          *
          * @returns True if successful; otherwise false.
          */
-        virtual const bool Initialize( const bool enableValidation ) = 0;
+        virtual const bool Initialize( const bool enableValidation, const U8 framesInFlight ) = 0;
 
         /**
          * Flags this renderer as shut down and begins the shutdown process. Must be invoked before Destroy or delete.
@@ -85,7 +88,55 @@ namespace Epoch {
          */
         virtual void FreeMeshData( StaticMeshRenderReferenceData* referenceData ) = 0;
 
-        virtual void SetRenderTable( WorldRenderableObjectTable* renderTable ) = 0;
+        /**
+         * Sets the static mesh instances to be drawn in the next frame. Each group is drawn with a single instanced draw.
+         *
+         * @param groups A pointer to the instance groups.
+         * @param groupCount The number of instance groups.
+         * @param instanceTransforms A pointer to the world matrices of all instances, ordered by group.
+         * @param instanceCount The total number of instances.
+         */
+        virtual void SetStaticMeshInstances( const StaticMeshInstanceGroup* groups, const U32 groupCount, const Matrix4x4* instanceTransforms, const U32 instanceCount ) = 0;
+
+        /**
+         * Indicates if this backend can cull static meshes and generate their draws on the GPU. If so, SetStaticMeshObjects
+         * may be used instead of SetStaticMeshInstances.
+         */
+        virtual const bool SupportsGpuCulling() const = 0;
+
+        /**
+         * Sets every static mesh to be drawn, unculled, to be culled on the GPU each frame. Only needs to be called when
+         * the static meshes change, as they are kept and drawn every frame until then. The data must stay valid until the
+         * next call.
+         *
+         * @param groups A pointer to the instance groups, sorted by shader, then material.
+         * @param groupCount The number of instance groups.
+         * @param instanceTransforms A pointer to the world matrices of all instances, ordered by group.
+         * @param instanceBounds A pointer to the world-space bounds of all instances, in the same order.
+         * @param instanceCount The total number of instances.
+         */
+        virtual void SetStaticMeshObjects( const StaticMeshInstanceGroup* groups, const U32 groupCount, const Matrix4x4* instanceTransforms, const AABB* instanceBounds, const U32 instanceCount ) = 0;
+
+        /**
+         * Returns the number of state changes made and skipped while recording the last frame.
+         */
+        virtual const RenderStateStats GetRenderStateStats() const = 0;
+
+        /**
+         * Sets the camera whose view and projection are used to render. If nullptr, a fixed default view is used.
+         *
+         * @param camera A pointer to the camera to render from.
+         */
+        virtual void SetActiveCamera( CameraEntity* camera ) = 0;
+
+        /**
+         * Obtains the view and projection matrices to be used when rendering the next frame. These are only
+         * recalculated when the active camera or the framebuffer size has changed.
+         *
+         * @param view A pointer to hold the view matrix.
+         * @param projection A pointer to hold the projection matrix.
+         */
+        virtual void GetViewProjection( Matrix4x4* view, Matrix4x4* projection ) = 0;
 
         /**
          * Returns a new texture from this renderer. This is always a creation request, as the front end
@@ -0,0 +1,188 @@
+#include "../../../Logger.h"
+#include "../../../Defines.h"
+#include "../../../Memory/Memory.h"
+#include "../../UniformObject.h"
+#include "VulkanUtilities.h"
+#include "VulkanDevice.h"
+#include "VulkanImage.h"
+#include "VulkanInternalBuffer.h"
+#include "VulkanTextureSampler.h"
+#include "VulkanBindlessResources.h"
+
+namespace Epoch {
+
+    VulkanBindlessResources::VulkanBindlessResources( VulkanDevice* device, const U32 maxTextures, const U32 maxMaterials ) {
+        _device = device;
+        _maxMaterials = maxMaterials;
+
+        // The update-after-bind limits are never lower than these, so staying under these is always enough.
+        const VkPhysicalDeviceLimits& limits = _device->Properties.limits;
+        _maxTextures = maxTextures;
+        if( _maxTextures > limits.maxPerStageDescriptorSampledImages ) {
+            _maxTextures = limits.maxPerStageDescriptorSampledImages;
+        }
+        if( _maxTextures > limits.maxPerStageDescriptorSamplers ) {
+            _maxTextures = limits.maxPerStageDescriptorSamplers;
+        }
+        if( _maxTextures < maxTextures ) {
+            Logger::Warn( "Bindless texture array limited to %d textures by the device.", _maxTextures );
+        }
+
+        // Binding 0 is the texture array, binding 1 the material buffer.
+        VkDescriptorSetLayoutBinding bindings[2] = {};
+        bindings[0].binding = 0;
+        bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindings[0].descriptorCount = _maxTextures;
+        bindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        bindings[1].binding = 1;
+        bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[1].descriptorCount = 1;
+        bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        // Unused slots are never written, and slots are written while frames using other slots are in flight.
+        VkDescriptorBindingFlags bindingFlags[2] = {
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT,
+            0
+        };
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO };
+        bindingFlagsInfo.bindingCount = 2;
+        bindingFlagsInfo.pBindingFlags = bindingFlags;
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+        layoutInfo.pNext = &bindingFlagsInfo;
+        layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        layoutInfo.bindingCount = 2;
+        layoutInfo.pBindings = bindings;
+        VK_CHECK( vkCreateDescriptorSetLayout( _device->LogicalDevice, &layoutInfo, nullptr, &_layout ) );
+
+        VkDescriptorPoolSize poolSizes[2];
+        poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        poolSizes[0].descriptorCount = _maxTextures;
+        poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes[1].descriptorCount = 1;
+
+        VkDescriptorPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+        poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        poolInfo.poolSizeCount = 2;
+        poolInfo.pPoolSizes = poolSizes;
+        poolInfo.maxSets = 1;
+        VK_CHECK( vkCreateDescriptorPool( _device->LogicalDevice, &poolInfo, nullptr, &_pool ) );
+
+        VkDescriptorSetAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+        allocInfo.descriptorPool = _pool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &_layout;
+        VK_CHECK( vkAllocateDescriptorSets( _device->LogicalDevice, &allocInfo, &_descriptorSet ) );
+
+        _sampler = new VulkanTextureSampler( _device );
+
+        // Mapped once and left mapped. Memory is host coherent, so writes need no flushing.
+        U64 materialBufferSize = sizeof( MaterialShaderData ) * (U64)_maxMaterials;
+        VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        _materialBuffer = new VulkanInternalBuffer( _device, materialBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, flags );
+        _materialData = static_cast<MaterialShaderData*>( _materialBuffer->LockMemory( 0, materialBufferSize, 0 ) );
+        TMemory::MemZero( _materialData, materialBufferSize );
+
+        // The material buffer never changes, so its descriptor only needs to be written once.
+        VkDescriptorBufferInfo bufferInfo = {};
+        bufferInfo.buffer = _materialBuffer->GetHandle();
+        bufferInfo.offset = 0;
+        bufferInfo.range = materialBufferSize;
+
+        VkWriteDescriptorSet descriptorWrite = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        descriptorWrite.dstSet = _descriptorSet;
+        descriptorWrite.dstBinding = 1;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pBufferInfo = &bufferInfo;
+        vkUpdateDescriptorSets( _device->LogicalDevice, 1, &descriptorWrite, 0, nullptr );
+    }
+
+    VulkanBindlessResources::~VulkanBindlessResources() {
+        if( _textureCount > (U32)_freeTextureIndices.size() ) {
+            Logger::Warn( "%d textures are still in the bindless texture array when destroying it.", _textureCount - (U32)_freeTextureIndices.size() );
+        }
+
+        if( _materialBuffer ) {
+            _materialBuffer->UnlockMemory();
+            delete _materialBuffer;
+            _materialBuffer = nullptr;
+        }
+        _materialData = nullptr;
+
+        if( _sampler ) {
+            delete _sampler;
+            _sampler = nullptr;
+        }
+
+        // Destroying the pool frees its set.
+        _descriptorSet = nullptr;
+        if( _pool ) {
+            vkDestroyDescriptorPool( _device->LogicalDevice, _pool, nullptr );
+            _pool = nullptr;
+        }
+
+        if( _layout ) {
+            vkDestroyDescriptorSetLayout( _device->LogicalDevice, _layout, nullptr );
+            _layout = nullptr;
+        }
+        _device = nullptr;
+    }
+
+    const U32 VulkanBindlessResources::AddTexture( VulkanImage* image ) {
+        U32 index;
+        if( !_freeTextureIndices.empty() ) {
+            index = _freeTextureIndices.back();
+            _freeTextureIndices.pop_back();
+        } else if( _textureCount < _maxTextures ) {
+            index = _textureCount++;
+        } else {
+            Logger::Error( "The bindless texture array is full. Increase the number of textures it holds." );
+            return U32_MAX;
+        }
+
+        VkDescriptorImageInfo imageInfo = {};
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfo.imageView = image->GetView();
+        imageInfo.sampler = _sampler->GetHandle();
+
+        VkWriteDescriptorSet descriptorWrite = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        descriptorWrite.dstSet = _descriptorSet;
+        descriptorWrite.dstBinding = 0;
+        descriptorWrite.dstArrayElement = index;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pImageInfo = &imageInfo;
+        vkUpdateDescriptorSets( _device->LogicalDevice, 1, &descriptorWrite, 0, nullptr );
+
+        return index;
+    }
+
+    void VulkanBindlessResources::RemoveTexture( const U32 index ) {
+
+        // The slot keeps pointing at the old image until reused. It is partially bound, so that is fine as long as nothing samples it.
+        _freeTextureIndices.push_back( index );
+    }
+
+    const U32 VulkanBindlessResources::AddMaterial() {
+        if( !_freeMaterialIndices.empty() ) {
+            U32 index = _freeMaterialIndices.back();
+            _freeMaterialIndices.pop_back();
+            return index;
+        } else if( _materialCount < _maxMaterials ) {
+            return _materialCount++;
+        }
+
+        Logger::Error( "The bindless material buffer is full. Increase the number of materials it holds." );
+        return U32_MAX;
+    }
+
+    void VulkanBindlessResources::UpdateMaterial( const U32 index, const MaterialShaderData& data ) {
+        _materialData[index] = data;
+    }
+
+    void VulkanBindlessResources::RemoveMaterial( const U32 index ) {
+        _freeMaterialIndices.push_back( index );
+    }
+}
\ No newline at end of file
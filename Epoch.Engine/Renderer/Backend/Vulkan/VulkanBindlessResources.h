@@ -0,0 +1,106 @@
+#pragma once
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../../../Types.h"
+
+namespace Epoch {
+
+    struct MaterialShaderData;
+    class VulkanDevice;
+    class VulkanImage;
+    class VulkanInternalBuffer;
+    class VulkanTextureSampler;
+
+    /**
+     * Holds every loaded texture in a single descriptor array, and the shader data of every material in a single storage
+     * buffer, both bound once as one descriptor set. Shaders look textures and materials up by index, so drawing with a
+     * different material needs no descriptor changes. Requires descriptor indexing (Vulkan 1.2).
+     *
+     * Slots are only written while unused by any frame in flight, and are only freed once no frame can still be reading
+     * them, so the set never needs to be waited on.
+     */
+    class VulkanBindlessResources {
+    public:
+
+        /**
+         * Creates new bindless resources.
+         *
+         * @param device The device to create the descriptor set and material buffer on.
+         * @param maxTextures The number of textures the texture array holds. Clamped to the device's limits.
+         * @param maxMaterials The number of materials the material buffer holds.
+         */
+        VulkanBindlessResources( VulkanDevice* device, const U32 maxTextures, const U32 maxMaterials );
+        ~VulkanBindlessResources();
+
+        /**
+         * Adds the given image to the texture array.
+         *
+         * @param image The image to add. Must have a view, and be in shader read layout by the time it is sampled.
+         *
+         * @returns The index of the texture in the texture array, or U32_MAX if the array is full.
+         */
+        const U32 AddTexture( VulkanImage* image );
+
+        /**
+         * Frees the given slot of the texture array. No frame in flight may still be sampling it.
+         *
+         * @param index The index returned by AddTexture.
+         */
+        void RemoveTexture( const U32 index );
+
+        /**
+         * Reserves a slot in the material buffer.
+         *
+         * @returns The index of the material in the material buffer, or U32_MAX if the buffer is full.
+         */
+        const U32 AddMaterial();
+
+        /**
+         * Writes the shader data of the given material.
+         *
+         * @param index The index returned by AddMaterial.
+         * @param data The data to write.
+         */
+        void UpdateMaterial( const U32 index, const MaterialShaderData& data );
+
+        /**
+         * Frees the given slot of the material buffer. No frame in flight may still be reading it.
+         *
+         * @param index The index returned by AddMaterial.
+         */
+        void RemoveMaterial( const U32 index );
+
+        /**
+         * Returns the descriptor set layout of the bindless set.
+         */
+        VkDescriptorSetLayout GetLayout() const { return _layout; }
+
+        /**
+         * Returns the bindless descriptor set, which is the same for every frame.
+         */
+        VkDescriptorSet GetDescriptorSet() const { return _descriptorSet; }
+
+    private:
+        VulkanDevice* _device;
+        VkDescriptorSetLayout _layout = nullptr;
+        VkDescriptorPool _pool = nullptr;
+        VkDescriptorSet _descriptorSet = nullptr;
+
+        // All textures are sampled the same way, so one sampler is shared by every slot.
+        VulkanTextureSampler* _sampler = nullptr;
+
+        // Slots are handed out from the free list first, then from the end of the used range.
+        U32 _maxTextures;
+        U32 _textureCount = 0;
+        std::vector<U32> _freeTextureIndices;
+
+        // The material buffer stays mapped for its whole lifetime.
+        U32 _maxMaterials;
+        U32 _materialCount = 0;
+        std::vector<U32> _freeMaterialIndices;
+        VulkanInternalBuffer* _materialBuffer = nullptr;
+        MaterialShaderData* _materialData = nullptr;
+    };
+}
\ No newline at end of file
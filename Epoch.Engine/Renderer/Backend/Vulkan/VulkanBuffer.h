@@ -1,11 +1,13 @@
 #pragma once
 
 #include <map>
+#include <vector>
 #include <vulkan/vulkan.h>
 
 #include "VulkanUtilities.h"
 #include "VulkanDevice.h"
 #include "VulkanInternalBuffer.h"
+#include "VulkanUploader.h"
 #include "../../../Logger.h"
 #include "../../../Defines.h"
 #include "../../../Memory/Memory.h"
@@ -107,7 +109,8 @@ namespace Epoch {
         virtual void Allocate( U64 size );
 
         /**
-         * Allocates a memory block and sets data in this buffer to that provided.
+         * Allocates a memory block and sets data in this buffer to that provided. If no free block is large enough, the
+         * buffer grows without waiting on the device. See TakeRetiredBuffers.
          *
          * @param data The data to be set.
          *
@@ -116,14 +119,13 @@ namespace Epoch {
         virtual VulkanBufferDataBlock* AllocateData( const List<T>& data );
 
         /**
-         * Sets data in the buffer starting at the offset.
+         * Hands over the internal buffers replaced by growing since this was last called. Frames already submitted may still
+         * be reading them, and queued uploads may still be copying from them, so the caller must keep them alive until work
+         * submitted after this call has completed, then delete them.
          *
-         * @param data The data to be set.
-         * @param offset The offset in bytes to set the data.
-         *
-         * @ returns An allocation index to be referenced during rendering and freeing.
+         * @param outBuffers The list to append the retired buffers to.
          */
-        virtual const U64 SetDataRange( const List<T>& data, U64 offset );
+        void TakeRetiredBuffers( std::vector<VulkanInternalBuffer*>& outBuffers );
 
         /**
          * Retrieves the buffer offset and range for a given index.
@@ -159,6 +161,7 @@ namespace Epoch {
 
     private:
         VkBufferUsageFlagBits getUsageFlag();
+        void grow( const U64 requiredSize );
         void destroy();
         U64 getObjectId();
     private:
@@ -170,6 +173,9 @@ namespace Epoch {
         VulkanBufferType _bufferType;
         VulkanInternalBuffer* _internalBuffer;
 
+        // Internal buffers replaced by growing, which have not yet been taken by TakeRetiredBuffers.
+        std::vector<VulkanInternalBuffer*> _retiredBuffers;
+
         // A listing of allocations kept within this buffer. Used to maintain block sizes and offsets.
         LinkedList<VulkanBufferDataBlock*> _allocations;
     };
@@ -180,15 +186,6 @@ namespace Epoch {
 
         VkDeviceSize bufferSize = sizeof( data[0] ) * data.Size();
 
-        // Create a host-visible staging buffer to upload to. Mark it as the source of the transfer.
-        VkBufferUsageFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-        VulkanInternalBuffer staging( _device, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, flags );
-
-        // Lock, copy, unlock
-        void* pData = staging.LockMemory( 0, bufferSize, 0 );
-        TMemory::Memcpy( pData, data.Data(), bufferSize );
-        staging.UnlockMemory();
-
         // Setup a device-local buffer as the actual buffer. Data will be copied to this from the staging buffer. Mark it as
         // the destination of the transfer.
         Allocate( bufferSize );
@@ -198,8 +195,8 @@ namespace Epoch {
         head->Value->HeapIndex = getObjectId();
         head->Value->Allocated = true;
 
-        // Perform the copy.
-        staging.CopyTo( _internalBuffer, 0, 0, bufferSize );
+        // Queue the upload through the device's staging ring.
+        _device->Uploader->UploadBuffer( _internalBuffer, 0, data.Data(), bufferSize );
     }
 
     template <class T>
@@ -222,7 +219,7 @@ namespace Epoch {
 
         // Setup a device-local buffer as the actual buffer. Data will be copied to this from the staging buffer. Mark it as
         // the destination of the transfer.
-        VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | getUsageFlag();
+        VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | getUsageFlag();
         VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
         _internalBuffer = new VulkanInternalBuffer( _device, size, usage, flags, true );
     }
@@ -240,150 +237,45 @@ namespace Epoch {
         dataBlock->Offset = 0;
         dataBlock->HeapIndex = getObjectId();
 
-        // Update tracking info.
-        bool blockFound = false;
+        // Take the first free block large enough. If there is none, grow the buffer, which always leaves a large enough free block at the end.
         U64 index = 0;
-        U64 runningOffset = 0;
         LinkedListNode<VulkanBufferDataBlock*>* p = _allocations.Peek();
-        while( !blockFound ) {
-            while( p->Value->Allocated ) {
-                runningOffset += p->Value->BlockSize;
-                p = p->Next;
-                ++index;
-            }
-
-            // If it will fit in this block, use it. Otherwise, move on.
-            if( p->Value->BlockSize >= dataBlock->BlockSize ) {
-                Logger::Trace( "DestBlock: %dB, SrcBlock: %dB. Fits, DestBlock new Offset: %dB", p->Value->BlockSize, dataBlock->BlockSize, runningOffset );
-
-                // See if the data will fit in this block.
-                U64 diff = p->Value->BlockSize - dataBlock->BlockSize;
-
-                // Block is an excact fit. Do a straight swap-out
-                if( diff == 0 ) {
-                    p->Value->CopyFrom( dataBlock );
-                    p->Value->Allocated = true;
-                    p->Value->Offset = runningOffset;
-                    blockFound = true;
-
-                    // TODO: determine if this is right
-                    delete dataBlock;
-                    dataBlock = p->Value;
-                } else {
-                    // Block must be larger than needed, so it will fit.
-
-                    // First adjust block to contain the right offset and amount of memory.
-                    p->Value->BlockSize -= dataBlock->BlockSize;
-                    p->Value->ElementSize -= dataBlock->BlockSize;
-                    p->Value->Offset += dataBlock->BlockSize;
-
-                    // Insert.
-                    _allocations.InsertAt( dataBlock, index );
-                    dataBlock->Offset = runningOffset;
-                    blockFound = true;
-                }
-            } else {
-                Logger::Trace( "DestBlock: %dB, SrcBlock: %dB. DestBlock too small. Continuing...", p->Value->BlockSize, dataBlock->BlockSize );
-
-                // Block too small. Keep looking.
-                ++index;
-                runningOffset += p->Value->Offset;
-            }
+        while( p != nullptr && ( p->Value->Allocated || p->Value->BlockSize < dataBlock->BlockSize ) ) {
+            p = p->Next;
+            ++index;
         }
-
-        ASSERT_MSG( dataBlock->Offset + dataBlock->BlockSize <= _totalSize, "Buffer does not have enough room for data to be added." );
-
-        // Create a host-visible staging buffer to upload to. Mark it as the source of the transfer.
-        VkBufferUsageFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-        VulkanInternalBuffer staging( _device, dataBlock->BlockSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, flags );
-
-        // Lock, copy, unlock
-        void* pData = staging.LockMemory( 0, dataBlock->BlockSize, 0 );
-        TMemory::Memcpy( pData, data.Data(), dataBlock->BlockSize );
-        staging.UnlockMemory();
-
-        // Perform the copy from staging to the device local buffer.
-        staging.CopyTo( _internalBuffer, 0, dataBlock->Offset, dataBlock->BlockSize );
-
-        return dataBlock;
-    }
-
-    template <class T>
-    const U64 VulkanBuffer<T>::SetDataRange( const List<T>& data, U64 offset ) {
-
-        ASSERT( data.Size() > 0 );
-
-        VulkanBufferDataBlock* dataBlock = new VulkanBufferDataBlock();
-        dataBlock->ElementCount = (U32)data.Size();
-        dataBlock->ElementSize = sizeof( data[0] );
-        dataBlock->BlockSize = dataBlock->ElementSize * dataBlock->ElementCount;
-        dataBlock->Allocated = true;
-        dataBlock->Offset = offset;
-        dataBlock->HeapIndex = getObjectId();
-
-        // Update tracking info.
-        bool blockFound = false;
-        U64 index = 0;
-        U64 runningOffset = 0;
-        while( !blockFound ) {
-            LinkedListNode<VulkanBufferDataBlock*>* p = _allocations.Peek();
-            while( p->Value->Allocated ) {
-                runningOffset += p->Value->Offset;
+        if( p == nullptr ) {
+            grow( dataBlock->BlockSize );
+            index = 0;
+            p = _allocations.Peek();
+            while( p->Value->Allocated || p->Value->BlockSize < dataBlock->BlockSize ) {
                 p = p->Next;
                 ++index;
             }
-
-            // If it will fit in this block, use it. Otherwise, move on.
-            if( p->Value->BlockSize >= dataBlock->BlockSize ) {
-                Logger::Trace( "DestBlock: %dB, SrcBlock: %dB. Fits, DestBlock new Offset: %dB", p->Value->BlockSize, dataBlock->BlockSize, runningOffset );
-
-                // See if the data will fit in this block.
-                U64 diff = p->Value->BlockSize - dataBlock->BlockSize;
-
-                // Block is an excact fit. Do a straight swap-out
-                if( diff == 0 ) {
-                    p->Value->CopyFrom( dataBlock );
-                    p->Value->Allocated = true;
-                    p->Value->Offset = runningOffset;
-                    blockFound = true;
-                    delete dataBlock;
-                } else {
-                    // Block must be larger than needed, so it will fit.
-
-                    // First adjust block to contain the right offset and amount of memory.
-                    p->Value->BlockSize -= dataBlock->BlockSize;
-                    p->Value->ElementSize -= dataBlock->BlockSize;
-                    p->Value->Offset += dataBlock->BlockSize;
-
-                    // Insert.
-                    _allocations.InsertAt( dataBlock, index );
-                    blockFound = true;
-                }
-            } else {
-                Logger::Trace( "DestBlock: %dB, SrcBlock: %dB. DestBlock too small. Continuing...", p->Value->BlockSize, dataBlock->BlockSize );
-
-                // Block too small. Keep looking.
-                ++index;
-                runningOffset += p->Value->Offset;
-            }
         }
+        Logger::Trace( "DestBlock: %dB, SrcBlock: %dB. Fits, DestBlock new Offset: %dB", p->Value->BlockSize, dataBlock->BlockSize, p->Value->Offset );
+
+        // Block is an excact fit. Do a straight swap-out
+        if( p->Value->BlockSize == dataBlock->BlockSize ) {
+            U64 offset = p->Value->Offset;
+            p->Value->CopyFrom( dataBlock );
+            p->Value->Offset = offset;
+            delete dataBlock;
+            dataBlock = p->Value;
+        } else {
 
-        VkDeviceSize dataSize = sizeof( data[0] ) * data.Size();
-        ASSERT_MSG( offset + dataSize <= _totalSize, "Buffer does not have enough room for data to be added." );
-
-        // Create a host-visible staging buffer to upload to. Mark it as the source of the transfer.
-        VkBufferUsageFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-        VulkanInternalBuffer staging( _device, dataSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, flags );
-
-        // Lock, copy, unlock
-        void* pData = staging.LockMemory( 0, dataSize, 0 );
-        TMemory::Memcpy( pData, data.Data(), dataSize );
-        staging.UnlockMemory();
+            // Block must be larger than needed. Take the front of it, so offsets stay a multiple of the element size.
+            dataBlock->Offset = p->Value->Offset;
+            p->Value->BlockSize -= dataBlock->BlockSize;
+            p->Value->ElementSize -= dataBlock->BlockSize;
+            p->Value->Offset += dataBlock->BlockSize;
+            _allocations.InsertAt( dataBlock, index );
+        }
 
-        // Perform the copy from staging to the device local buffer.
-        staging.CopyTo( _internalBuffer, 0, offset, dataSize );
+        // Queue the upload through the device's staging ring. It is complete before any frame which draws it.
+        _device->Uploader->UploadBuffer( _internalBuffer, dataBlock->Offset, data.Data(), dataBlock->BlockSize );
 
-        return dataBlock->HeapIndex;
+        return dataBlock;
     }
 
     template<class T>
@@ -429,7 +321,7 @@ namespace Epoch {
             p->Value->BlockSize = size;
             p->Value->ElementCount = 1;
             p->Value->ElementSize = size;
-            p->Value->HeapIndex = 0;
+            p->Value->HeapIndex = -1;
         } else {
             Logger::Fatal( "Attempted to call FreeDataRange with an invalid offset of %d, which does not match any allocation present on this buffer.", offset );
         }
@@ -480,8 +372,59 @@ namespace Epoch {
         }
     }
 
+    template <class T>
+    void VulkanBuffer<T>::grow( const U64 requiredSize ) {
+
+        // Doubling keeps growth rare.
+        U64 newSize = _totalSize * 2;
+        if( newSize < _totalSize + requiredSize ) {
+            newSize = _totalSize + requiredSize;
+        }
+        Logger::Warn( "Buffer does not have enough room for %lluB. Growing from %lluB to %lluB.", requiredSize, _totalSize, newSize );
+
+        // Offsets are unchanged, so existing allocations stay valid. The copy is queued behind any uploads to the old buffer,
+        // which stays alive until frames still drawing from it and the copy itself have completed.
+        VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | getUsageFlag();
+        VulkanInternalBuffer* newBuffer = new VulkanInternalBuffer( _device, newSize, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true );
+        _device->Uploader->CopyBuffer( _internalBuffer, 0, newBuffer, 0, _totalSize );
+        _retiredBuffers.push_back( _internalBuffer );
+        _internalBuffer = newBuffer;
+
+        // Extend the free block at the end, or add one if the end is in use.
+        LinkedListNode<VulkanBufferDataBlock*>* last = _allocations.Peek();
+        while( last->Next != nullptr ) {
+            last = last->Next;
+        }
+        U64 addedSize = newSize - _totalSize;
+        if( !last->Value->Allocated ) {
+            last->Value->BlockSize += addedSize;
+            last->Value->ElementSize += addedSize;
+        } else {
+            VulkanBufferDataBlock* freeBlock = new VulkanBufferDataBlock();
+            freeBlock->ElementSize = addedSize;
+            freeBlock->ElementCount = 1;
+            freeBlock->BlockSize = addedSize;
+            freeBlock->Allocated = false;
+            freeBlock->Offset = _totalSize;
+            freeBlock->HeapIndex = -1;
+            _allocations.Append( freeBlock );
+        }
+        _totalSize = newSize;
+    }
+
+    template <class T>
+    void VulkanBuffer<T>::TakeRetiredBuffers( std::vector<VulkanInternalBuffer*>& outBuffers ) {
+        outBuffers.insert( outBuffers.end(), _retiredBuffers.begin(), _retiredBuffers.end() );
+        _retiredBuffers.clear();
+    }
+
     template <class T>
     void VulkanBuffer<T>::destroy() {
+        for( U64 i = 0; i < _retiredBuffers.size(); ++i ) {
+            delete _retiredBuffers[i];
+        }
+        _retiredBuffers.clear();
+
         if( _internalBuffer ) {
             delete _internalBuffer;
             _internalBuffer = nullptr;
@@ -58,14 +58,35 @@ namespace Epoch {
         _state = CommandBufferState::Recording;
     }
 
+    void VulkanCommandBuffer::BeginSecondary( VulkanRenderPass* renderPass, VkFramebuffer framebuffer, const bool isSingleUse ) {
+
+        // Secondary buffers executed within a render pass must know which render pass and subpass they belong to.
+        VkCommandBufferInheritanceInfo inheritanceInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO };
+        inheritanceInfo.renderPass = renderPass->GetHandle();
+        inheritanceInfo.subpass = 0;
+        inheritanceInfo.framebuffer = framebuffer;
+
+        VkCommandBufferBeginInfo beginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        if( isSingleUse ) {
+            beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        }
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        VK_CHECK( vkBeginCommandBuffer( Handle, &beginInfo ) );
+
+        _currentRenderPass = renderPass;
+        _state = CommandBufferState::Recording;
+    }
+
     void VulkanCommandBuffer::End() {
         VK_CHECK( vkEndCommandBuffer( Handle ) );
         _state = CommandBufferState::RecordingEnded;
     }
 
-    void VulkanCommandBuffer::BeginRenderPass( const RenderPassClearInfo& clearInfo, VkFramebuffer framebuffer, VulkanRenderPass* renderPass ) {
+    void VulkanCommandBuffer::BeginRenderPass( const RenderPassClearInfo& clearInfo, VkFramebuffer framebuffer, VulkanRenderPass* renderPass, const bool hasSecondaryContents ) {
         _currentRenderPass = renderPass;
-        _currentRenderPass->Begin( clearInfo, framebuffer, this );
+        _currentRenderPass->Begin( clearInfo, framebuffer, this, hasSecondaryContents );
         _state = CommandBufferState::InRenderPass;
     }
 
@@ -74,13 +95,29 @@ namespace Epoch {
         _state = CommandBufferState::Recording;
     }
 
+    void VulkanCommandBuffer::ExecuteCommands( VulkanCommandBuffer** commandBuffers, const U32 count ) {
+        VkCommandBuffer handles[VULKAN_MAX_EXECUTED_COMMAND_BUFFERS];
+        U32 executed = 0;
+        while( executed < count ) {
+            U32 batchCount = count - executed;
+            if( batchCount > VULKAN_MAX_EXECUTED_COMMAND_BUFFERS ) {
+                batchCount = VULKAN_MAX_EXECUTED_COMMAND_BUFFERS;
+            }
+            for( U32 i = 0; i < batchCount; ++i ) {
+                handles[i] = commandBuffers[executed + i]->Handle;
+            }
+            vkCmdExecuteCommands( Handle, batchCount, handles );
+            executed += batchCount;
+        }
+    }
+
     void VulkanCommandBuffer::AddWaitSemaphore( VkPipelineStageFlags waitFlags, VulkanSemaphore* waitSemaphore ) {
 
         // Wait flags - Allocate more space if need be.
         if( _waitFlagAllocatedCount <= _waitFlagCount ) {
             VkPipelineStageFlags* temp = static_cast<VkPipelineStageFlags*>( TMemory::Allocate( sizeof( VkPipelineStageFlags ) * ( _waitFlagCount + 1 ) ) );
             if( _waitFlags ) {
-                TMemory::Memcpy( temp, _waitFlags, _waitFlagCount );
+                TMemory::Memcpy( temp, _waitFlags, sizeof( VkPipelineStageFlags ) * _waitFlagCount );
                 TMemory::Free( _waitFlags );
             }
             _waitFlags = temp;
@@ -93,7 +130,7 @@ namespace Epoch {
         if( _waitSemaphoreAllocatedCount <= _waitSemaphoreCount ) {
             VulkanSemaphore** temp = static_cast<VulkanSemaphore**>( TMemory::Allocate( sizeof( VulkanSemaphore* ) * ( _waitSemaphoreCount + 1 ) ) );
             if( _waitSemaphores ) {
-                TMemory::Memcpy( temp, _waitSemaphores, _waitSemaphoreCount );
+                TMemory::Memcpy( temp, _waitSemaphores, sizeof( VulkanSemaphore* ) * _waitSemaphoreCount );
                 TMemory::Free( _waitSemaphores );
             }
             _waitSemaphores = temp;
@@ -6,6 +6,9 @@
 #include "../../ICommandBuffer.h"
 #include "../../../Defines.h"
 
+// The number of secondary command buffers passed to the driver per call when executing them from a primary buffer.
+#define VULKAN_MAX_EXECUTED_COMMAND_BUFFERS 16
+
 namespace Epoch {
 
     class VulkanCommandPool;
@@ -43,15 +46,32 @@ namespace Epoch {
          */
         void Begin( const bool isSingleUse = false, const bool isRenderPassContinue = false, const bool isSimultaneousUse = false );
 
+        /**
+         * Begins recording of this secondary command buffer, to be executed entirely within the given render pass.
+         *
+         * @param renderPass The render pass this buffer will be executed within.
+         * @param framebuffer The framebuffer the render pass will render to.
+         * @param isSingleUse Specifies this command buffer will only be used once and will be reset and recorded again between each submission. Default: false
+         */
+        void BeginSecondary( VulkanRenderPass* renderPass, VkFramebuffer framebuffer, const bool isSingleUse = false );
+
         /**
          * Ends recording of this command buffer. From here, the buffer may be submitted to a queue for execution.
          */
         void End();
 
-        void BeginRenderPass( const RenderPassClearInfo& clearInfo, VkFramebuffer framebuffer, VulkanRenderPass* renderPass );
+        void BeginRenderPass( const RenderPassClearInfo& clearInfo, VkFramebuffer framebuffer, VulkanRenderPass* renderPass, const bool hasSecondaryContents = false );
 
         void EndRenderPass();
 
+        /**
+         * Executes the given secondary command buffers, in order, from this primary command buffer.
+         *
+         * @param commandBuffers A pointer to an array of secondary command buffers whose recording has ended.
+         * @param count The number of command buffers.
+         */
+        void ExecuteCommands( VulkanCommandBuffer** commandBuffers, const U32 count );
+
         void AddWaitSemaphore( VkPipelineStageFlags waitFlags, VulkanSemaphore* waitSemaphore );
         void UpdateSubmitted();
         void Reset();
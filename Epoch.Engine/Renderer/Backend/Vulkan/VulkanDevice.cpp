@@ -9,8 +9,26 @@
 #include "VulkanCommandBuffer.h"
 #include "VulkanUtilities.h"
 #include "VulkanQueue.h"
+#include "VulkanMemoryAllocator.h"
+#include "VulkanUploader.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanBindlessResources.h"
+#include "VulkanShaderLibrary.h"
 #include "VulkanDevice.h"
 
+// The size in bytes of the staging ring all uploads are copied through.
+#define VULKAN_STAGING_RING_SIZE ( 64 * 1024 * 1024 )
+
+// The file the pipeline cache is loaded from on startup and saved to on shutdown.
+#define VULKAN_PIPELINE_CACHE_PATH "pipelines.cache"
+
+// The directory holding the shader archive, and any loose shader modules.
+#define VULKAN_SHADER_DIRECTORY "shaders/"
+
+// The number of textures and materials the bindless descriptor set holds.
+#define VULKAN_MAX_BINDLESS_TEXTURES 4096
+#define VULKAN_MAX_BINDLESS_MATERIALS 4096
+
 
 namespace Epoch {
 
@@ -27,9 +45,39 @@ namespace Epoch {
         if( !detectDepthFormat() ) {
             Logger::Fatal( "Unable to find a supported depth format!" );
         }
+
+        MemoryAllocator = new VulkanMemoryAllocator( this );
+        Uploader = new VulkanUploader( this, TransferQueue, VULKAN_STAGING_RING_SIZE );
+        PipelineCache = new VulkanPipelineCache( this, VULKAN_PIPELINE_CACHE_PATH );
+        BindlessResources = new VulkanBindlessResources( this, VULKAN_MAX_BINDLESS_TEXTURES, VULKAN_MAX_BINDLESS_MATERIALS );
+        ShaderLibrary = new VulkanShaderLibrary( this, VULKAN_SHADER_DIRECTORY );
     }
 
     VulkanDevice::~VulkanDevice() {
+        if( ShaderLibrary ) {
+            delete ShaderLibrary;
+            ShaderLibrary = nullptr;
+        }
+
+        if( BindlessResources ) {
+            delete BindlessResources;
+            BindlessResources = nullptr;
+        }
+
+        if( PipelineCache ) {
+            delete PipelineCache;
+            PipelineCache = nullptr;
+        }
+
+        if( Uploader ) {
+            delete Uploader;
+            Uploader = nullptr;
+        }
+
+        if( MemoryAllocator ) {
+            delete MemoryAllocator;
+            MemoryAllocator = nullptr;
+        }
 
         if( CommandPool ) {
             vkDestroyCommandPool( LogicalDevice, CommandPool->GetHandle(), nullptr );
@@ -48,6 +96,7 @@ namespace Epoch {
         // Queues are not destroyed either
         GraphicsQueue = nullptr;
         PresentationQueue = nullptr;
+        TransferQueue = nullptr;
     }
 
     void VulkanDevice::WaitIdle() const {
@@ -124,6 +173,7 @@ namespace Epoch {
                 }
 
                 PhysicalDevice = devices[i];
+                Properties = properties;
                 return;
             }
         }
@@ -169,11 +219,30 @@ namespace Epoch {
             swapChainMeetsRequirements = SwapchainSupport.Formats.size() > 0 && SwapchainSupport.PresentationModes.size() > 0;
         }
 
+        // Textures and materials are indexed from shaders through a single descriptor set, which needs descriptor indexing.
+        VkPhysicalDeviceVulkan12Features vulkan12Features = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+        VkPhysicalDeviceFeatures2 features2 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+        features2.pNext = &vulkan12Features;
+        vkGetPhysicalDeviceFeatures2( physicalDevice, &features2 );
+        bool supportsDescriptorIndexing = properties->apiVersion >= VK_API_VERSION_1_2 &&
+            vulkan12Features.shaderSampledImageArrayNonUniformIndexing &&
+            vulkan12Features.descriptorBindingSampledImageUpdateAfterBind &&
+            vulkan12Features.descriptorBindingUpdateUnusedWhilePending &&
+            vulkan12Features.descriptorBindingPartiallyBound &&
+            vulkan12Features.runtimeDescriptorArray;
+
+        // Optional. Without these, draws are culled and recorded on the CPU instead of being generated on the GPU.
+        SupportsIndirectDraws = features->multiDrawIndirect && features->drawIndirectFirstInstance;
+        SupportsDrawIndirectCount = SupportsIndirectDraws && vulkan12Features.drawIndirectCount;
+
+        // Optional. Without this, cooked textures are ignored and their source images are loaded instead.
+        SupportsBlockCompression = features->textureCompressionBC;
+
         // NOTE: Could also look for discrete GPU. We could score and rank them based on features and capabilities.
-        return supportsRequiredQueueFamilies && swapChainMeetsRequirements && features->samplerAnisotropy;
+        return supportsRequiredQueueFamilies && swapChainMeetsRequirements && features->samplerAnisotropy && supportsDescriptorIndexing;
     }
 
-    void VulkanDevice::detectQueueFamilyIndices( VkPhysicalDevice physicalDevice, I32* graphicsQueueIndex, I32* presentationQueueIndex ) {
+    void VulkanDevice::detectQueueFamilyIndices( VkPhysicalDevice physicalDevice, I32* graphicsQueueIndex, I32* presentationQueueIndex, I32* transferQueueIndex ) {
         U32 queueFamilyCount = 0;
         vkGetPhysicalDeviceQueueFamilyProperties( physicalDevice, &queueFamilyCount, nullptr );
         std::vector<VkQueueFamilyProperties> familyProperties( queueFamilyCount );
@@ -191,6 +260,16 @@ namespace Epoch {
             if( supportsPresentation ) {
                 *presentationQueueIndex = i;
             }
+
+            // A family which can transfer but not draw is typically backed by dedicated copy hardware.
+            if( transferQueueIndex && ( familyProperties[i].queueFlags & VK_QUEUE_TRANSFER_BIT ) && !( familyProperties[i].queueFlags & VK_QUEUE_GRAPHICS_BIT ) ) {
+                *transferQueueIndex = i;
+            }
+        }
+
+        // Graphics queues can always transfer, so fall back to that.
+        if( transferQueueIndex && *transferQueueIndex == -1 ) {
+            *transferQueueIndex = *graphicsQueueIndex;
         }
     }
 
@@ -219,18 +298,24 @@ namespace Epoch {
     void VulkanDevice::createLogicalDevice( const std::vector<const char*>& requiredValidationLayers ) {
         I32 graphicsQueueIndex = -1;
         I32 presentationQueueIndex = -1;
-        detectQueueFamilyIndices( PhysicalDevice, &graphicsQueueIndex, &presentationQueueIndex );
+        I32 transferQueueIndex = -1;
+        detectQueueFamilyIndices( PhysicalDevice, &graphicsQueueIndex, &presentationQueueIndex, &transferQueueIndex );
 
         // If the queue indices are the same, only one queue needs to be created.
         bool presentationSharesGraphicsQueue = graphicsQueueIndex == presentationQueueIndex;
+        bool transferSharesGraphicsQueue = graphicsQueueIndex == transferQueueIndex;
 
         std::vector<U32> indices;
         indices.push_back( graphicsQueueIndex );
         if( !presentationSharesGraphicsQueue ) {
             indices.push_back( presentationQueueIndex );
         }
+        if( !transferSharesGraphicsQueue && transferQueueIndex != presentationQueueIndex ) {
+            indices.push_back( transferQueueIndex );
+        }
 
-        // Device queues
+        // Device queues. The priority must outlive device creation, so it is declared out here.
+        F32 queuePriority = 1.0f;
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos( indices.size() );
         for( U32 i = 0; i < (U32)indices.size(); ++i ) {
             queueCreateInfos[i].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
@@ -238,19 +323,30 @@ namespace Epoch {
             queueCreateInfos[i].queueCount = 1;
             queueCreateInfos[i].flags = 0;
             queueCreateInfos[i].pNext = nullptr;
-            F32 queuePriority = 1.0f;
             queueCreateInfos[i].pQueuePriorities = &queuePriority;
         }
 
         VkPhysicalDeviceFeatures deviceFeatures = {};
         deviceFeatures.samplerAnisotropy = VK_TRUE; // Request anistrophy
+        deviceFeatures.multiDrawIndirect = SupportsIndirectDraws ? VK_TRUE : VK_FALSE;
+        deviceFeatures.drawIndirectFirstInstance = SupportsIndirectDraws ? VK_TRUE : VK_FALSE;
+        deviceFeatures.textureCompressionBC = SupportsBlockCompression ? VK_TRUE : VK_FALSE;
+
+        // Required by the bindless texture array. Support was checked when selecting the device.
+        VkPhysicalDeviceVulkan12Features vulkan12Features = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+        vulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+        vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        vulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+        vulkan12Features.runtimeDescriptorArray = VK_TRUE;
+        vulkan12Features.drawIndirectCount = SupportsDrawIndirectCount ? VK_TRUE : VK_FALSE;
 
         VkDeviceCreateInfo deviceCreateInfo = { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
         deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
         deviceCreateInfo.queueCreateInfoCount = (U32)indices.size();
         deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
         deviceCreateInfo.enabledExtensionCount = 1;
-        deviceCreateInfo.pNext = nullptr;
+        deviceCreateInfo.pNext = &vulkan12Features;
         const char* requiredExtensions[1] = {
             VK_KHR_SWAPCHAIN_EXTENSION_NAME
         };
@@ -270,12 +366,14 @@ namespace Epoch {
         // Save off the queue family indices
         GraphicsFamilyQueueIndex = graphicsQueueIndex;
         PresentationFamilyQueueIndex = presentationQueueIndex;
+        TransferFamilyQueueIndex = transferQueueIndex;
     }
 
     void VulkanDevice::createQueues() {
 
         GraphicsQueue = new VulkanQueue( this, GraphicsFamilyQueueIndex );
         PresentationQueue = new VulkanQueue( this, PresentationFamilyQueueIndex );
+        TransferQueue = new VulkanQueue( this, TransferFamilyQueueIndex );
     }
 
     void VulkanDevice::createCommandPool() {
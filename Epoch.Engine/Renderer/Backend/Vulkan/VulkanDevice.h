@@ -16,6 +16,11 @@ namespace Epoch {
     class VulkanCommandPool;
     class VulkanQueue;
     class VulkanCommandBuffer;
+    class VulkanUploader;
+    class VulkanMemoryAllocator;
+    class VulkanPipelineCache;
+    class VulkanBindlessResources;
+    class VulkanShaderLibrary;
 
     /**
      * Represents both the physical and logical device for Vulkan, as well as any device-specific
@@ -29,6 +34,11 @@ namespace Epoch {
          */
         VkPhysicalDevice PhysicalDevice = nullptr;
 
+        /**
+         * The properties of the physical device, including its limits.
+         */
+        VkPhysicalDeviceProperties Properties;
+
         /**
          * The application's view of the physical device.
          */
@@ -44,6 +54,11 @@ namespace Epoch {
          */
         I32 PresentationFamilyQueueIndex;
 
+        /**
+         * The index for the queue family used for uploads. A transfer-only family if the device has one; otherwise the graphics family.
+         */
+        I32 TransferFamilyQueueIndex;
+
         /**
          * The queue used for graphics pipeline commands.
          */
@@ -54,6 +69,51 @@ namespace Epoch {
          */
         VulkanQueue* PresentationQueue;
 
+        /**
+         * The queue used for uploads. Shares the graphics queue if the device has no transfer-only family.
+         */
+        VulkanQueue* TransferQueue;
+
+        /**
+         * Sub-allocates device memory for buffers and images.
+         */
+        VulkanMemoryAllocator* MemoryAllocator = nullptr;
+
+        /**
+         * Creates and shares graphics pipelines through a pipeline cache which persists between runs.
+         */
+        VulkanPipelineCache* PipelineCache = nullptr;
+
+        /**
+         * Batches uploads of buffer and image data through a staging ring, submitted on the transfer queue.
+         */
+        VulkanUploader* Uploader = nullptr;
+
+        /**
+         * Holds every texture and material in one descriptor set, which shaders index into.
+         */
+        VulkanBindlessResources* BindlessResources = nullptr;
+
+        /**
+         * Creates and owns every shader module, loaded from the shader archive.
+         */
+        VulkanShaderLibrary* ShaderLibrary = nullptr;
+
+        /**
+         * Indicates if draws can be read from buffers written on the GPU, several at a time, each with its own first instance.
+         */
+        bool SupportsIndirectDraws = false;
+
+        /**
+         * Indicates if the number of indirect draws can also be read from a buffer written on the GPU.
+         */
+        bool SupportsDrawIndirectCount = false;
+
+        /**
+         * Indicates if images can be sampled in the BC1 to BC7 block-compressed formats.
+         */
+        bool SupportsBlockCompression = false;
+
         /**
          * Contains swapchain support details.
          */
@@ -118,7 +178,7 @@ namespace Epoch {
     private:
         void selectPhysicalDevice();
         const bool physicalDeviceMeetsRequirements( VkPhysicalDevice physicalDevice, const VkPhysicalDeviceProperties* properties, const VkPhysicalDeviceFeatures* features );
-        void detectQueueFamilyIndices( VkPhysicalDevice physicalDevice, I32* graphicsQueueIndex, I32* presentationQueueIndex );
+        void detectQueueFamilyIndices( VkPhysicalDevice physicalDevice, I32* graphicsQueueIndex, I32* presentationQueueIndex, I32* transferQueueIndex = nullptr );
         void querySwapchainSupport( VkPhysicalDevice physicalDevice );
 
         void createLogicalDevice( const std::vector<const char*>& requiredValidationLayers );
@@ -61,6 +61,14 @@ namespace Epoch {
         return false;
     }
 
+    const bool VulkanFence::Poll() {
+        if( _state == VulkanFenceState::NotReady && vkGetFenceStatus( _device->LogicalDevice, _handle ) == VK_SUCCESS ) {
+            _state = VulkanFenceState::Signaled;
+        }
+
+        return _state == VulkanFenceState::Signaled;
+    }
+
     void VulkanFence::Reset() {
         if( _state != VulkanFenceState::NotReady ) {
             VK_CHECK( vkResetFences( _device->LogicalDevice, 1, &_handle ) );
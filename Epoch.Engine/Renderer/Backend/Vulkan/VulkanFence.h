@@ -32,6 +32,13 @@ namespace Epoch {
          */
         const bool Wait( U64 timeoutNS );
 
+        /**
+         * Checks if this fence has been signaled without waiting for it.
+         *
+         * @returns True if signaled; otherwise false.
+         */
+        const bool Poll();
+
         /**
          * Reset this fence to its default state.
          */
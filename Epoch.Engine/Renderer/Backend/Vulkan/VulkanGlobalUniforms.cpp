@@ -0,0 +1,108 @@
+
+#include "../../../Memory/Memory.h"
+#include "../../UniformObject.h"
+#include "VulkanUtilities.h"
+#include "VulkanDevice.h"
+#include "VulkanInternalBuffer.h"
+#include "VulkanGlobalUniforms.h"
+
+namespace Epoch {
+
+    VulkanGlobalUniforms::VulkanGlobalUniforms( VulkanDevice* device, const U32 frameCount ) {
+        _device = device;
+
+        VkDescriptorSetLayoutBinding uboLayoutBinding = {};
+        uboLayoutBinding.binding = 0;
+        uboLayoutBinding.descriptorCount = 1;
+        uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        uboLayoutBinding.pImmutableSamplers = nullptr;
+        uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &uboLayoutBinding;
+        VK_CHECK( vkCreateDescriptorSetLayout( _device->LogicalDevice, &layoutInfo, nullptr, &_layout ) );
+
+        VkDescriptorPoolSize poolSize;
+        poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        poolSize.descriptorCount = frameCount;
+
+        VkDescriptorPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        poolInfo.maxSets = frameCount;
+        VK_CHECK( vkCreateDescriptorPool( _device->LogicalDevice, &poolInfo, nullptr, &_pool ) );
+
+        std::vector<VkDescriptorSetLayout> layouts( frameCount, _layout );
+        VkDescriptorSetAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+        allocInfo.descriptorPool = _pool;
+        allocInfo.descriptorSetCount = frameCount;
+        allocInfo.pSetLayouts = layouts.data();
+        _descriptorSets.resize( frameCount );
+        VK_CHECK( vkAllocateDescriptorSets( _device->LogicalDevice, &allocInfo, _descriptorSets.data() ) );
+
+        _buffers.resize( frameCount, nullptr );
+        _mappedMemory.resize( frameCount, nullptr );
+        _writtenVersions.resize( frameCount, 0 );
+        VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        for( U32 i = 0; i < frameCount; ++i ) {
+            _buffers[i] = new VulkanInternalBuffer( _device, sizeof( GlobalUniformObject ), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, flags );
+
+            // Mapped once and left mapped. Memory is host coherent, so writes need no flushing.
+            _mappedMemory[i] = _buffers[i]->LockMemory( 0, sizeof( GlobalUniformObject ), 0 );
+            TMemory::MemZero( _mappedMemory[i], sizeof( GlobalUniformObject ) );
+
+            // The buffer never changes, so the descriptor set only needs to be written once.
+            VkDescriptorBufferInfo bufferInfo = {};
+            bufferInfo.buffer = _buffers[i]->GetHandle();
+            bufferInfo.offset = 0;
+            bufferInfo.range = sizeof( GlobalUniformObject );
+
+            VkWriteDescriptorSet descriptorWrite = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+            descriptorWrite.dstSet = _descriptorSets[i];
+            descriptorWrite.dstBinding = 0;
+            descriptorWrite.dstArrayElement = 0;
+            descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            descriptorWrite.descriptorCount = 1;
+            descriptorWrite.pBufferInfo = &bufferInfo;
+            vkUpdateDescriptorSets( _device->LogicalDevice, 1, &descriptorWrite, 0, nullptr );
+        }
+    }
+
+    VulkanGlobalUniforms::~VulkanGlobalUniforms() {
+        for( U64 i = 0; i < _buffers.size(); ++i ) {
+            if( _buffers[i] ) {
+                _buffers[i]->UnlockMemory();
+                delete _buffers[i];
+                _buffers[i] = nullptr;
+            }
+        }
+        _buffers.clear();
+        _mappedMemory.clear();
+        _writtenVersions.clear();
+
+        // Destroying the pool frees its sets.
+        _descriptorSets.clear();
+        if( _pool ) {
+            vkDestroyDescriptorPool( _device->LogicalDevice, _pool, nullptr );
+            _pool = nullptr;
+        }
+
+        if( _layout ) {
+            vkDestroyDescriptorSetLayout( _device->LogicalDevice, _layout, nullptr );
+            _layout = nullptr;
+        }
+        _device = nullptr;
+    }
+
+    void VulkanGlobalUniforms::Update( const U32 frameIndex, const Matrix4x4& view, const Matrix4x4& projection, const U32 version ) {
+        if( _writtenVersions[frameIndex] == version ) {
+            return;
+        }
+
+        GlobalUniformObject* uniform = static_cast<GlobalUniformObject*>( _mappedMemory[frameIndex] );
+        uniform->View = view;
+        uniform->Projection = projection;
+        _writtenVersions[frameIndex] = version;
+    }
+}
\ No newline at end of file
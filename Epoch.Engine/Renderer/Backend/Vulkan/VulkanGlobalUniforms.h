@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../../../Types.h"
+
+namespace Epoch {
+
+    class Matrix4x4;
+    class VulkanDevice;
+    class VulkanInternalBuffer;
+
+    /**
+     * Holds the global uniform data (view, projection, etc.) shared by all shaders, along with the descriptor set
+     * layout all shaders use for it as set 0. Each frame has its own buffer, which stays mapped for its whole lifetime,
+     * and its own descriptor set, which is written once at creation and never again.
+     */
+    class VulkanGlobalUniforms {
+    public:
+
+        /**
+         * Creates new global uniforms.
+         *
+         * @param device The device to create buffers and descriptors on.
+         * @param frameCount The number of frames which may be in flight, each of which gets its own buffer and descriptor set.
+         */
+        VulkanGlobalUniforms( VulkanDevice* device, const U32 frameCount );
+        ~VulkanGlobalUniforms();
+
+        /**
+         * Writes the given view and projection to the given frame's buffer, unless that buffer already holds the given version.
+         * Must only be called once the GPU is done with that frame.
+         *
+         * @param frameIndex The index of the frame about to be drawn.
+         * @param view The view matrix.
+         * @param projection The projection matrix.
+         * @param version A number which changes whenever the view or projection changes. Must not be 0.
+         */
+        void Update( const U32 frameIndex, const Matrix4x4& view, const Matrix4x4& projection, const U32 version );
+
+        /**
+         * Returns the descriptor set layout shared by all shaders for global uniforms.
+         */
+        VkDescriptorSetLayout GetLayout() const { return _layout; }
+
+        /**
+         * Returns the descriptor set of the given frame.
+         */
+        VkDescriptorSet GetDescriptorSet( const U32 frameIndex ) const { return _descriptorSets[frameIndex]; }
+
+    private:
+        VulkanDevice* _device;
+        VkDescriptorSetLayout _layout = nullptr;
+        VkDescriptorPool _pool = nullptr;
+
+        // One of each per frame. A written version of 0 means the buffer has never been written.
+        std::vector<VkDescriptorSet> _descriptorSets;
+        std::vector<VulkanInternalBuffer*> _buffers;
+        std::vector<void*> _mappedMemory;
+        std::vector<U32> _writtenVersions;
+    };
+}
\ No newline at end of file
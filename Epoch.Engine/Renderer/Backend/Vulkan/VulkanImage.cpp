@@ -2,8 +2,8 @@
 #include "../../../Logger.h"
 
 #include "VulkanUtilities.h"
-#include "VulkanCommandBuffer.h"
 #include "VulkanDevice.h"
+#include "VulkanMemoryAllocator.h"
 #include "VulkanImage.h"
 
 namespace Epoch {
@@ -16,7 +16,7 @@ namespace Epoch {
         imageCreateInfo.extent.width = createInfo.Width;
         imageCreateInfo.extent.height = createInfo.Height;
         imageCreateInfo.extent.depth = 1; // TODO: Support configurable depth.
-        imageCreateInfo.mipLevels = 1; // TODO: Support mip mapping
+        imageCreateInfo.mipLevels = createInfo.MipLevels;
         imageCreateInfo.arrayLayers = 1; // TODO: Support number of layers in the image.
         imageCreateInfo.format = createInfo.Format;
         imageCreateInfo.tiling = createInfo.Tiling;
@@ -25,6 +25,14 @@ namespace Epoch {
         imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT; // TODO: Configurable sample count.
         imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE; // TODO: Configurable sharing mode.
 
+        // Images written by uploads are shared with the transfer queue, so no ownership transfer is needed.
+        U32 queueFamilyIndices[2] = { (U32)device->GraphicsFamilyQueueIndex, (U32)device->TransferFamilyQueueIndex };
+        if( ( createInfo.Usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT ) && queueFamilyIndices[0] != queueFamilyIndices[1] ) {
+            imageCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            imageCreateInfo.queueFamilyIndexCount = 2;
+            imageCreateInfo.pQueueFamilyIndices = queueFamilyIndices;
+        }
+
         VkImage imageHandle;
         VK_CHECK( vkCreateImage( device->LogicalDevice, &imageCreateInfo, nullptr, &imageHandle ) );
 
@@ -32,26 +40,26 @@ namespace Epoch {
         VkMemoryRequirements memoryRequirements;
         vkGetImageMemoryRequirements( device->LogicalDevice, imageHandle, &memoryRequirements );
 
-        // Allocate memory
-        VkMemoryAllocateInfo allocateInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-        allocateInfo.allocationSize = memoryRequirements.size;
-        allocateInfo.memoryTypeIndex = VulkanUtilities::FindMemoryType( device->PhysicalDevice, memoryRequirements.memoryTypeBits, createInfo.Properties );
-
-        VkDeviceMemory imageMemory;
-        VK_CHECK( vkAllocateMemory( device->LogicalDevice, &allocateInfo, nullptr, &imageMemory ) );
+        // Sub-allocate from the device's memory blocks rather than allocating memory of its own.
+        VulkanAllocationKind kind = createInfo.Tiling == VK_IMAGE_TILING_LINEAR ? VulkanAllocationKind::Linear : VulkanAllocationKind::Optimal;
+        VulkanAllocation* allocation = device->MemoryAllocator->Allocate( memoryRequirements, createInfo.Properties, kind );
+        if( !allocation ) {
+            Logger::Fatal( "Unable to allocate memory for a %dx%d image.", createInfo.Width, createInfo.Height );
+            return;
+        }
 
         // Bind the memory
-        VK_CHECK( vkBindImageMemory( device->LogicalDevice, imageHandle, imageMemory, 0 ) ); // TODO: configurable memory offset.
+        VK_CHECK( vkBindImageMemory( device->LogicalDevice, imageHandle, allocation->Memory, allocation->Offset ) );
 
         VkImageView view = nullptr;
         if( createInfo.CreateView ) {
-            CreateView( device, imageHandle, createInfo.Format, createInfo.ViewAspectFlags, &view );
+            CreateView( device, imageHandle, createInfo.Format, createInfo.ViewAspectFlags, &view, createInfo.MipLevels );
         }
 
-        *image = new VulkanImage( device, createInfo.Width, createInfo.Height, imageHandle, imageMemory, view );
+        *image = new VulkanImage( device, createInfo.Width, createInfo.Height, createInfo.MipLevels, imageHandle, allocation, view );
     }
 
-    void VulkanImage::CreateView( VulkanDevice* device, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, VkImageView* view ) {
+    void VulkanImage::CreateView( VulkanDevice* device, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, VkImageView* view, const U32 mipLevels ) {
         VkImageViewCreateInfo viewCreateInfo = { VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
         viewCreateInfo.image = image;
         viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D; // TODO: Make configurable.
@@ -60,94 +68,13 @@ namespace Epoch {
 
         // TODO: Make configurable
         viewCreateInfo.subresourceRange.baseMipLevel = 0;
-        viewCreateInfo.subresourceRange.levelCount = 1;
+        viewCreateInfo.subresourceRange.levelCount = mipLevels;
         viewCreateInfo.subresourceRange.baseArrayLayer = 0;
         viewCreateInfo.subresourceRange.layerCount = 1;
 
         VK_CHECK( vkCreateImageView( device->LogicalDevice, &viewCreateInfo, nullptr, view ) );
     }
 
-    void VulkanImage::TransitionLayout( VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout ) {
-        VulkanCommandBuffer* commandBuffer = _device->AllocateAndBeginSingleUseCommandBuffer();
-
-        VkImageMemoryBarrier barrier = {};
-        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.oldLayout = (VkImageLayout)oldLayout;
-        barrier.newLayout = (VkImageLayout)newLayout;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = _imageHandle;
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = 1;
-        barrier.srcAccessMask = 0; // TODO
-        barrier.dstAccessMask = 0; // TODO
-
-        VkPipelineStageFlags sourceStage;
-        VkPipelineStageFlags destinationStage;
-
-        if( oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL ) {
-            barrier.srcAccessMask = 0;
-            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-            sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        } else if( oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL ) {
-            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-            sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-        } else {
-            Logger::Fatal( "unsupported layout transition!" );
-        }
-
-        vkCmdPipelineBarrier(
-            commandBuffer->Handle,
-            sourceStage, destinationStage,
-            0,
-            0, nullptr,
-            0, nullptr,
-            1, &barrier
-        );
-
-        _device->EndSingleUseCommandBuffer( commandBuffer );
-    }
-
-    void VulkanImage::CopyFromBuffer( VkBuffer buffer ) {
-        VulkanCommandBuffer* commandBuffer = _device->AllocateAndBeginSingleUseCommandBuffer();
-
-        VkBufferImageCopy region = {};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
-
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
-
-        region.imageOffset = { 0, 0, 0 };
-        region.imageExtent = {
-            _width,
-            _height,
-            1
-        };
-
-        vkCmdCopyBufferToImage(
-            commandBuffer->Handle,
-            buffer,
-            _imageHandle,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            1,
-            &region
-        );
-
-        _device->EndSingleUseCommandBuffer( commandBuffer );
-    }
-
     VulkanImage::~VulkanImage() {
         VkDevice device = _device->LogicalDevice;
         if( _view ) {
@@ -155,25 +82,31 @@ namespace Epoch {
             _view = nullptr;
         }
 
-        if( _imageMemory ) {
-            vkFreeMemory( device, _imageMemory, nullptr );
-            _imageMemory = nullptr;
-        }
-
         if( _imageHandle ) {
             vkDestroyImage( device, _imageHandle, nullptr );
             _imageHandle = nullptr;
         }
 
+        if( _allocation ) {
+            _device->MemoryAllocator->Free( _allocation );
+            _allocation = nullptr;
+        }
+
         _device = nullptr;
     }
 
-    VulkanImage::VulkanImage( VulkanDevice* device, U32 width, U32 height, VkImage imageHandle, VkDeviceMemory imageMemory, VkImageView view ) {
+    VulkanImage::VulkanImage( VulkanDevice* device, U32 width, U32 height, U32 mipLevels, VkImage imageHandle, VulkanAllocation* allocation, VkImageView view ) {
         _device = device;
         _width = width;
         _height = height;
+        _mipLevels = mipLevels;
         _imageHandle = imageHandle;
-        _imageMemory = imageMemory;
+        _allocation = allocation;
+        _allocation->UserData = this;
         _view = view;
     }
+
+    VkDeviceMemory VulkanImage::GetMemory() {
+        return _allocation->Memory;
+    }
 }
\ No newline at end of file
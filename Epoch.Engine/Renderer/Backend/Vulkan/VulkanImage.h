@@ -15,6 +15,7 @@ namespace Epoch {
         VkImageTiling Tiling;
         VkImageUsageFlags Usage;
         VkMemoryPropertyFlags Properties;
+        U32 MipLevels = 1;
 
         // View info
         bool CreateView = false;
@@ -22,33 +23,33 @@ namespace Epoch {
     };
 
     class VulkanDevice;
+    struct VulkanAllocation;
 
     class VulkanImage : public IImage {
     public:
         void static Create( VulkanDevice* device, VulkanImageCreateInfo& createInfo, VulkanImage** image );
-        void static CreateView( VulkanDevice* device, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, VkImageView* view );
+        void static CreateView( VulkanDevice* device, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, VkImageView* view, const U32 mipLevels = 1 );
 
     public:
-        void TransitionLayout( VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout );
-        void CopyFromBuffer( VkBuffer buffer );
-
         ~VulkanImage();
 
         VkImage GetHandle() { return _imageHandle; }
-        VkDeviceMemory GetMemory() { return _imageMemory; }
+        VkDeviceMemory GetMemory();
         VulkanDevice* GetDevice() const { return _device; }
         const U32 GetWidth() const { return _width; }
         const U32 GetHeight() const { return _height; }
+        const U32 GetMipLevels() const { return _mipLevels; }
 
         const bool HasView() { return _view != nullptr; }
         VkImageView GetView() { return _view; }
     protected:
-        VulkanImage( VulkanDevice* device, U32 width, U32 height, VkImage imageHandle, VkDeviceMemory imageMemory, VkImageView view );
+        VulkanImage( VulkanDevice* device, U32 width, U32 height, U32 mipLevels, VkImage imageHandle, VulkanAllocation* allocation, VkImageView view );
     private:
         U32 _width, _height;
+        U32 _mipLevels;
         VulkanDevice* _device;
         VkImage _imageHandle;
-        VkDeviceMemory _imageMemory;
+        VulkanAllocation* _allocation;
         VkImageView _view;
     };
 }
\ No newline at end of file
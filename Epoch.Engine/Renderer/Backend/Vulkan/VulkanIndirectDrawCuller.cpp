@@ -0,0 +1,247 @@
+#include "../../../Logger.h"
+#include "../../../Memory/Memory.h"
+#include "../../../Math/Frustum.h"
+#include "../../UniformObject.h"
+#include "VulkanUtilities.h"
+#include "VulkanDevice.h"
+#include "VulkanInternalBuffer.h"
+#include "VulkanCommandBuffer.h"
+#include "VulkanPipeline.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanShader.h"
+#include "VulkanShaderLibrary.h"
+#include "VulkanIndirectDrawCuller.h"
+
+// The name of the culling compute shader.
+#define BUILTIN_SHADER_NAME_CULL "Builtin.CullShader"
+
+// The number of objects the culling shader handles per workgroup. Must match the shader's local size.
+#define VULKAN_CULL_WORKGROUP_SIZE 64
+
+// The number of objects and batches each frame's buffers hold when first created. Grown by doubling.
+#define VULKAN_INITIAL_CULL_OBJECTS 1024
+#define VULKAN_INITIAL_CULL_BATCHES 64
+
+namespace Epoch {
+
+    VulkanIndirectDrawCuller::VulkanIndirectDrawCuller( VulkanDevice* device, const U32 frameCount ) {
+        _device = device;
+
+        // The layout is reflected from the shader, so its module is loaded first.
+        _shaderModule = new VulkanShaderModule( _device, BUILTIN_SHADER_NAME_CULL, ShaderType::Compute );
+
+        // Reflected from the shader: binding 0 is the objects, 1 the draws written for them, and 2 the number of visible
+        // draws of each batch.
+        std::vector<VkDescriptorSetLayoutBinding> bindings;
+        VulkanShaderLibrary::GetSetLayoutBindings( &_shaderModule, 1, 0, false, &bindings );
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+        layoutInfo.bindingCount = (U32)bindings.size();
+        layoutInfo.pBindings = bindings.data();
+        VK_CHECK( vkCreateDescriptorSetLayout( _device->LogicalDevice, &layoutInfo, nullptr, &_layout ) );
+
+        std::vector<VkDescriptorPoolSize> poolSizes;
+        VulkanShaderLibrary::GetPoolSizes( bindings, &poolSizes );
+        for( U64 i = 0; i < poolSizes.size(); ++i ) {
+            poolSizes[i].descriptorCount *= frameCount;
+        }
+
+        VkDescriptorPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+        poolInfo.poolSizeCount = (U32)poolSizes.size();
+        poolInfo.pPoolSizes = poolSizes.data();
+        poolInfo.maxSets = frameCount;
+        VK_CHECK( vkCreateDescriptorPool( _device->LogicalDevice, &poolInfo, nullptr, &_pool ) );
+
+        std::vector<VkDescriptorSetLayout> layouts( frameCount, _layout );
+        std::vector<VkDescriptorSet> descriptorSets( frameCount );
+        VkDescriptorSetAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+        allocInfo.descriptorPool = _pool;
+        allocInfo.descriptorSetCount = frameCount;
+        allocInfo.pSetLayouts = layouts.data();
+        VK_CHECK( vkAllocateDescriptorSets( _device->LogicalDevice, &allocInfo, descriptorSets.data() ) );
+
+        _frames.resize( frameCount );
+        for( U32 i = 0; i < frameCount; ++i ) {
+            _frames[i].DescriptorSet = descriptorSets[i];
+            createFrameBuffers( _frames[i], VULKAN_INITIAL_CULL_OBJECTS, VULKAN_INITIAL_CULL_BATCHES );
+        }
+
+        // Compute pipelines are not shared, so this one is created directly rather than acquired from the cache.
+        VkPushConstantRange pushConstantRange = {};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof( CullPushConstants );
+
+        PipelineInfo info;
+        info.DescriptorSetLayouts.push_back( _layout );
+        info.ShaderStages.push_back( _shaderModule->GetShaderStageCreateInfo() );
+        info.PushConstantRanges.push_back( pushConstantRange );
+        _pipeline = new VulkanComputePipeline( _device, info, _device->PipelineCache->GetHandle() );
+    }
+
+    VulkanIndirectDrawCuller::~VulkanIndirectDrawCuller() {
+        if( _pipeline ) {
+            delete _pipeline;
+            _pipeline = nullptr;
+        }
+
+        if( _shaderModule ) {
+            delete _shaderModule;
+            _shaderModule = nullptr;
+        }
+
+        for( U64 i = 0; i < _frames.size(); ++i ) {
+            destroyFrameBuffers( _frames[i] );
+        }
+        _frames.clear();
+
+        // Destroying the pool frees its sets.
+        if( _pool ) {
+            vkDestroyDescriptorPool( _device->LogicalDevice, _pool, nullptr );
+            _pool = nullptr;
+        }
+
+        if( _layout ) {
+            vkDestroyDescriptorSetLayout( _device->LogicalDevice, _layout, nullptr );
+            _layout = nullptr;
+        }
+        _device = nullptr;
+    }
+
+    void VulkanIndirectDrawCuller::Update( const U32 frameIndex, const CullObjectShaderData* objects, const U32 objectCount, const U32 batchCount, const U32 version ) {
+        VulkanCullFrame& frame = _frames[frameIndex];
+        if( frame.WrittenVersion == version ) {
+            return;
+        }
+
+        // The GPU is done with this frame, so its buffers can be replaced.
+        if( objectCount > frame.ObjectCapacity || batchCount > frame.BatchCapacity ) {
+            U32 objectCapacity = frame.ObjectCapacity;
+            while( objectCapacity < objectCount ) {
+                objectCapacity *= 2;
+            }
+            U32 batchCapacity = frame.BatchCapacity;
+            while( batchCapacity < batchCount ) {
+                batchCapacity *= 2;
+            }
+            destroyFrameBuffers( frame );
+            createFrameBuffers( frame, objectCapacity, batchCapacity );
+        }
+
+        if( objectCount > 0 ) {
+            TMemory::Memcpy( frame.MappedObjects, objects, sizeof( CullObjectShaderData ) * (U64)objectCount );
+        }
+        frame.ObjectCount = objectCount;
+        frame.BatchCount = batchCount;
+        frame.WrittenVersion = version;
+    }
+
+    void VulkanIndirectDrawCuller::RecordCull( VulkanCommandBuffer* commandBuffer, const U32 frameIndex, const Frustum& frustum ) {
+        VulkanCullFrame& frame = _frames[frameIndex];
+        if( frame.ObjectCount == 0 ) {
+            return;
+        }
+
+        // Visible draws are counted from zero each frame.
+        VkCommandBuffer handle = commandBuffer->Handle;
+        vkCmdFillBuffer( handle, frame.DrawCountBuffer->GetHandle(), 0, sizeof( U32 ) * (U64)frame.BatchCount, 0 );
+
+        VkMemoryBarrier clearBarrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+        clearBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        clearBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier( handle, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &clearBarrier, 0, nullptr, 0, nullptr );
+
+        CullPushConstants constants = {};
+        for( U32 i = 0; i < 6; ++i ) {
+            const Plane& plane = frustum.Planes[i];
+            constants.Planes[i][0] = plane.Normal.X;
+            constants.Planes[i][1] = plane.Normal.Y;
+            constants.Planes[i][2] = plane.Normal.Z;
+            constants.Planes[i][3] = plane.Distance;
+        }
+        constants.ObjectCount = frame.ObjectCount;
+        constants.CompactDraws = _device->SupportsDrawIndirectCount ? 1 : 0;
+
+        _pipeline->Bind( commandBuffer );
+        vkCmdBindDescriptorSets( handle, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline->GetLayout(), 0, 1, &frame.DescriptorSet, 0, nullptr );
+        vkCmdPushConstants( handle, _pipeline->GetLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof( CullPushConstants ), &constants );
+        vkCmdDispatch( handle, ( frame.ObjectCount + VULKAN_CULL_WORKGROUP_SIZE - 1 ) / VULKAN_CULL_WORKGROUP_SIZE, 1, 1 );
+
+        // Draws and counts are read as indirect parameters once the render pass begins.
+        VkMemoryBarrier cullBarrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+        cullBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        cullBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+        vkCmdPipelineBarrier( handle, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &cullBarrier, 0, nullptr, 0, nullptr );
+    }
+
+    void VulkanIndirectDrawCuller::DrawBatch( VulkanCommandBuffer* commandBuffer, const U32 frameIndex, const U32 batchIndex, const U32 firstObject, const U32 objectCount ) {
+        VulkanCullFrame& frame = _frames[frameIndex];
+        const U32 stride = sizeof( VkDrawIndexedIndirectCommand );
+        VkDeviceSize drawOffset = (VkDeviceSize)firstObject * stride;
+        if( _device->SupportsDrawIndirectCount ) {
+            VkDeviceSize countOffset = (VkDeviceSize)batchIndex * sizeof( U32 );
+            vkCmdDrawIndexedIndirectCount( commandBuffer->Handle, frame.DrawBuffer->GetHandle(), drawOffset, frame.DrawCountBuffer->GetHandle(), countOffset, objectCount, stride );
+        } else {
+            vkCmdDrawIndexedIndirect( commandBuffer->Handle, frame.DrawBuffer->GetHandle(), drawOffset, objectCount, stride );
+        }
+    }
+
+    void VulkanIndirectDrawCuller::createFrameBuffers( VulkanCullFrame& frame, const U32 objectCapacity, const U32 batchCapacity ) {
+        U64 objectBufferSize = sizeof( CullObjectShaderData ) * (U64)objectCapacity;
+        U64 drawBufferSize = sizeof( VkDrawIndexedIndirectCommand ) * (U64)objectCapacity;
+        U64 drawCountBufferSize = sizeof( U32 ) * (U64)batchCapacity;
+
+        // Mapped once and left mapped. Memory is host coherent, so writes need no flushing.
+        VkMemoryPropertyFlags hostFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        frame.ObjectBuffer = new VulkanInternalBuffer( _device, objectBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostFlags );
+        frame.MappedObjects = static_cast<CullObjectShaderData*>( frame.ObjectBuffer->LockMemory( 0, objectBufferSize, 0 ) );
+        frame.ObjectCapacity = objectCapacity;
+
+        // Only ever written and read by the GPU.
+        VkBufferUsageFlags drawUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+        frame.DrawBuffer = new VulkanInternalBuffer( _device, drawBufferSize, drawUsage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT );
+        frame.DrawCountBuffer = new VulkanInternalBuffer( _device, drawCountBufferSize, drawUsage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT );
+        frame.BatchCapacity = batchCapacity;
+
+        VkDescriptorBufferInfo bufferInfos[3] = {};
+        bufferInfos[0].buffer = frame.ObjectBuffer->GetHandle();
+        bufferInfos[0].range = objectBufferSize;
+        bufferInfos[1].buffer = frame.DrawBuffer->GetHandle();
+        bufferInfos[1].range = drawBufferSize;
+        bufferInfos[2].buffer = frame.DrawCountBuffer->GetHandle();
+        bufferInfos[2].range = drawCountBufferSize;
+
+        VkWriteDescriptorSet descriptorWrites[3];
+        for( U32 i = 0; i < 3; ++i ) {
+            descriptorWrites[i] = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+            descriptorWrites[i].dstSet = frame.DescriptorSet;
+            descriptorWrites[i].dstBinding = i;
+            descriptorWrites[i].dstArrayElement = 0;
+            descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            descriptorWrites[i].descriptorCount = 1;
+            descriptorWrites[i].pBufferInfo = &bufferInfos[i];
+        }
+        vkUpdateDescriptorSets( _device->LogicalDevice, 3, descriptorWrites, 0, nullptr );
+    }
+
+    void VulkanIndirectDrawCuller::destroyFrameBuffers( VulkanCullFrame& frame ) {
+        if( frame.ObjectBuffer ) {
+            frame.ObjectBuffer->UnlockMemory();
+            delete frame.ObjectBuffer;
+            frame.ObjectBuffer = nullptr;
+        }
+        frame.MappedObjects = nullptr;
+        frame.ObjectCapacity = 0;
+
+        if( frame.DrawBuffer ) {
+            delete frame.DrawBuffer;
+            frame.DrawBuffer = nullptr;
+        }
+
+        if( frame.DrawCountBuffer ) {
+            delete frame.DrawCountBuffer;
+            frame.DrawCountBuffer = nullptr;
+        }
+        frame.BatchCapacity = 0;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../../../Types.h"
+
+namespace Epoch {
+
+    struct Frustum;
+    struct CullObjectShaderData;
+    class VulkanDevice;
+    class VulkanCommandBuffer;
+    class VulkanInternalBuffer;
+    class VulkanShaderModule;
+    class VulkanComputePipeline;
+
+    /**
+     * The buffers and descriptor set used by the culling shader for a single frame in flight.
+     */
+    struct VulkanCullFrame {
+
+        // The objects to cull, written by the CPU. Stays mapped for its whole lifetime.
+        VulkanInternalBuffer* ObjectBuffer = nullptr;
+        CullObjectShaderData* MappedObjects = nullptr;
+        U32 ObjectCapacity = 0;
+
+        // The indirect draws written by the culling shader, one slot per object, and the number of visible draws of each batch.
+        VulkanInternalBuffer* DrawBuffer = nullptr;
+        VulkanInternalBuffer* DrawCountBuffer = nullptr;
+        U32 BatchCapacity = 0;
+
+        VkDescriptorSet DescriptorSet = nullptr;
+
+        // What the object buffer currently holds. A version of 0 means it has never been written.
+        U32 ObjectCount = 0;
+        U32 BatchCount = 0;
+        U32 WrittenVersion = 0;
+    };
+
+    /**
+     * Culls objects against the view frustum in a compute shader, which writes an indexed indirect draw for each visible
+     * object. The CPU only uploads the object table when it changes and records one indirect draw per batch of objects
+     * sharing a material, so its cost does not grow with the number of objects.
+     *
+     * Objects must be ordered by batch. If the device supports indirect draw counts, visible draws are packed at the start
+     * of their batch and only those are drawn. Otherwise every object keeps a draw, which has no instances if culled.
+     */
+    class VulkanIndirectDrawCuller {
+    public:
+
+        /**
+         * Creates a new culler.
+         *
+         * @param device The device to create the pipeline and buffers on. Must support indirect draws.
+         * @param frameCount The number of frames which may be in flight, each of which gets its own buffers and descriptor set.
+         */
+        VulkanIndirectDrawCuller( VulkanDevice* device, const U32 frameCount );
+        ~VulkanIndirectDrawCuller();
+
+        /**
+         * Writes the given objects to the given frame's object buffer, unless that buffer already holds the given version.
+         * Buffers are grown as needed. Must only be called once the GPU is done with that frame.
+         *
+         * @param frameIndex The index of the frame about to be drawn.
+         * @param objects The objects to cull, ordered by batch.
+         * @param objectCount The number of objects.
+         * @param batchCount The number of batches the objects refer to.
+         * @param version A number which changes whenever the objects change. Must not be 0.
+         */
+        void Update( const U32 frameIndex, const CullObjectShaderData* objects, const U32 objectCount, const U32 batchCount, const U32 version );
+
+        /**
+         * Records the culling of the given frame's objects, followed by a barrier which makes the draws it writes visible to
+         * indirect draws. Must be recorded outside of a render pass, before any of the frame's batches are drawn.
+         *
+         * @param commandBuffer The primary command buffer of the frame.
+         * @param frameIndex The index of the frame being recorded.
+         * @param frustum The frustum to cull against.
+         */
+        void RecordCull( VulkanCommandBuffer* commandBuffer, const U32 frameIndex, const Frustum& frustum );
+
+        /**
+         * Records the indirect draws of a single batch.
+         *
+         * @param commandBuffer The command buffer to record to. The batch's pipeline, descriptors and buffers must be bound.
+         * @param frameIndex The index of the frame being recorded.
+         * @param batchIndex The index of the batch.
+         * @param firstObject The index of the batch's first object.
+         * @param objectCount The number of objects in the batch. Must not exceed the device's indirect draw count limit.
+         */
+        void DrawBatch( VulkanCommandBuffer* commandBuffer, const U32 frameIndex, const U32 batchIndex, const U32 firstObject, const U32 objectCount );
+
+    private:
+        void createFrameBuffers( VulkanCullFrame& frame, const U32 objectCapacity, const U32 batchCapacity );
+        void destroyFrameBuffers( VulkanCullFrame& frame );
+
+    private:
+        VulkanDevice* _device;
+        VkDescriptorSetLayout _layout = nullptr;
+        VkDescriptorPool _pool = nullptr;
+        VulkanShaderModule* _shaderModule = nullptr;
+        VulkanComputePipeline* _pipeline = nullptr;
+
+        std::vector<VulkanCullFrame> _frames;
+    };
+}
\ No newline at end of file
@@ -1,7 +1,10 @@
 
+#include "../../../Logger.h"
+
 #include "VulkanUtilities.h"
 #include "VulkanDevice.h"
 #include "VulkanCommandBuffer.h"
+#include "VulkanMemoryAllocator.h"
 #include "VulkanInternalBuffer.h"
 
 namespace Epoch {
@@ -17,20 +20,27 @@ namespace Epoch {
         bufferInfo.usage = usage;
         bufferInfo.sharingMode = VkSharingMode::VK_SHARING_MODE_EXCLUSIVE; // Only used in one queue.
 
+        // Buffers written by uploads are shared with the transfer queue, so no ownership transfer is needed.
+        U32 queueFamilyIndices[2] = { (U32)_device->GraphicsFamilyQueueIndex, (U32)_device->TransferFamilyQueueIndex };
+        if( ( usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT ) && queueFamilyIndices[0] != queueFamilyIndices[1] ) {
+            bufferInfo.sharingMode = VkSharingMode::VK_SHARING_MODE_CONCURRENT;
+            bufferInfo.queueFamilyIndexCount = 2;
+            bufferInfo.pQueueFamilyIndices = queueFamilyIndices;
+        }
+
         VK_CHECK( vkCreateBuffer( _device->LogicalDevice, &bufferInfo, nullptr, &_handle ) );
 
         // Gather memory requirements
         VkMemoryRequirements requirements;
         vkGetBufferMemoryRequirements( _device->LogicalDevice, _handle, &requirements );
 
-        // Allocate memory info
-        VkMemoryAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-        allocInfo.allocationSize = requirements.size;
-
-        allocInfo.memoryTypeIndex = VulkanUtilities::FindMemoryType( _device->PhysicalDevice, requirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT );
-
-        // Allocate the memory and bind it
-        VK_CHECK( vkAllocateMemory( _device->LogicalDevice, &allocInfo, nullptr, &_memory ) );
+        // Sub-allocate from the device's memory blocks rather than allocating memory of its own.
+        _allocation = _device->MemoryAllocator->Allocate( requirements, flags, VulkanAllocationKind::Linear );
+        if( !_allocation ) {
+            Logger::Fatal( "Unable to allocate memory for a buffer of %lluB.", size );
+            return;
+        }
+        _allocation->UserData = this;
 
         // BindOnCreate assumes 0 offset.
         if( bindOnCreate ) {
@@ -44,9 +54,9 @@ namespace Epoch {
                 vkDestroyBuffer( _device->LogicalDevice, _handle, nullptr );
                 _handle = nullptr;
             }
-            if( _memory ) {
-                vkFreeMemory( _device->LogicalDevice, _memory, nullptr );
-                _memory = nullptr;
+            if( _allocation ) {
+                _device->MemoryAllocator->Free( _allocation );
+                _allocation = nullptr;
             }
 
             _device = nullptr;
@@ -54,17 +64,25 @@ namespace Epoch {
     }
 
     void VulkanInternalBuffer::Bind( U64 offset ) {
-        VK_CHECK( vkBindBufferMemory( _device->LogicalDevice, _handle, _memory, offset ) );
+        VK_CHECK( vkBindBufferMemory( _device->LogicalDevice, _handle, _allocation->Memory, _allocation->Offset + offset ) );
     }
 
     void* VulkanInternalBuffer::LockMemory( U64 offset, U64 size, U64 flags ) {
-        void* pData;
-        VK_CHECK( vkMapMemory( _device->LogicalDevice, _memory, offset, size, (U32)flags, &pData ) );
-        return pData;
+
+        // Host visible memory is mapped by the allocator for as long as it lives, so this is just an offset.
+        if( !_allocation->MappedMemory ) {
+            Logger::Error( "Attempted to lock the memory of a buffer which is not host visible." );
+            return nullptr;
+        }
+        return _allocation->MappedMemory + offset;
     }
 
     void VulkanInternalBuffer::UnlockMemory() {
-        vkUnmapMemory( _device->LogicalDevice, _memory );
+        // Memory stays mapped until the allocation is freed.
+    }
+
+    VkDeviceMemory VulkanInternalBuffer::GetMemory() {
+        return _allocation->Memory;
     }
 
     void VulkanInternalBuffer::CopyTo( VulkanInternalBuffer* other, U64 sourceOffset, U64 destinationOffset, U64 size ) const {
@@ -6,6 +6,7 @@
 namespace Epoch {
 
     class VulkanDevice;
+    struct VulkanAllocation;
 
     class VulkanInternalBuffer {
     public:
@@ -21,12 +22,13 @@ namespace Epoch {
         void CopyFrom( const VulkanInternalBuffer* other, U64 sourceOffset, U64 destinationOffset, U64 size );
 
         VkBuffer GetHandle() { return _handle; }
-        VkDeviceMemory GetMemory() { return _memory; }
+        VkDeviceMemory GetMemory();
+        VulkanAllocation* GetAllocation() { return _allocation; }
     private:
         VkBufferUsageFlags _usage;
         VulkanDevice* _device;
         bool _isLocked = false;
         VkBuffer _handle;
-        VkDeviceMemory _memory;
+        VulkanAllocation* _allocation = nullptr;
     };
 }
\ No newline at end of file
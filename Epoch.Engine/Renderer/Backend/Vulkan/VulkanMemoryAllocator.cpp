@@ -0,0 +1,382 @@
+#include <algorithm>
+
+#include "../../../Logger.h"
+#include "../../../Defines.h"
+
+#include "VulkanUtilities.h"
+#include "VulkanDevice.h"
+#include "VulkanMemoryAllocator.h"
+
+// The size in bytes of memory blocks. Heaps smaller than 8 blocks use an eighth of the heap instead.
+#define VULKAN_MEMORY_BLOCK_SIZE ( 64ULL * 1024 * 1024 )
+
+// The fraction of each heap, in percent, the allocator tries to stay under. The rest is left for the driver and other applications.
+#define VULKAN_MEMORY_BUDGET_PERCENT 80
+
+namespace Epoch {
+
+    static const U64 alignUp( const U64 value, const U64 alignment ) {
+        return ( value + alignment - 1 ) & ~( alignment - 1 );
+    }
+
+    static const bool onSamePage( const U64 firstOffset, const U64 secondOffset, const U64 pageSize ) {
+        return ( firstOffset & ~( pageSize - 1 ) ) == ( secondOffset & ~( pageSize - 1 ) );
+    }
+
+    VulkanMemoryAllocator::VulkanMemoryAllocator( VulkanDevice* device ) {
+        _device = device;
+        vkGetPhysicalDeviceMemoryProperties( _device->PhysicalDevice, &_memoryProperties );
+
+        _bufferImageGranularity = _device->Properties.limits.bufferImageGranularity;
+        if( _bufferImageGranularity == 0 ) {
+            _bufferImageGranularity = 1;
+        }
+
+        for( U32 i = 0; i < _memoryProperties.memoryHeapCount; ++i ) {
+            _heapStats[i].HeapSize = _memoryProperties.memoryHeaps[i].size;
+            _heapStats[i].Budget = ( _memoryProperties.memoryHeaps[i].size / 100 ) * VULKAN_MEMORY_BUDGET_PERCENT;
+        }
+
+        for( U32 i = 0; i < _memoryProperties.memoryTypeCount; ++i ) {
+            U64 heapSize = _memoryProperties.memoryHeaps[_memoryProperties.memoryTypes[i].heapIndex].size;
+            _blockSizes[i] = heapSize / 8 < VULKAN_MEMORY_BLOCK_SIZE ? alignUp( heapSize / 8, 32 ) : VULKAN_MEMORY_BLOCK_SIZE;
+        }
+    }
+
+    VulkanMemoryAllocator::~VulkanMemoryAllocator() {
+        for( U32 i = 0; i < _memoryProperties.memoryHeapCount; ++i ) {
+            if( _heapStats[i].AllocationCount > 0 ) {
+                Logger::Warn( "Memory heap %d still has %d allocations (%lluB) when destroying the memory allocator.", i, _heapStats[i].AllocationCount, _heapStats[i].AllocatedBytes );
+            }
+        }
+
+        for( U32 i = 0; i < _memoryProperties.memoryTypeCount; ++i ) {
+            for( U64 b = 0; b < _blocks[i].size(); ++b ) {
+                destroyBlock( _blocks[i][b] );
+            }
+            _blocks[i].clear();
+        }
+
+        _device = nullptr;
+    }
+
+    VulkanAllocation* VulkanMemoryAllocator::Allocate( const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, const VulkanAllocationKind kind ) {
+        std::lock_guard<std::mutex> lock( _mutex );
+
+        U32 memoryTypeIndex = findMemoryType( requirements.memoryTypeBits, properties );
+        if( memoryTypeIndex == U32_MAX ) {
+            Logger::Error( "Unable to find a suitable memory type for an allocation of %lluB.", requirements.size );
+            return nullptr;
+        }
+
+        VulkanAllocation* allocation = new VulkanAllocation();
+        allocation->MemoryTypeIndex = memoryTypeIndex;
+        allocation->Kind = kind;
+
+        // Resources which would take up a large part of a block get device memory of their own, rather than leaving most of a block unusable.
+        if( requirements.size > _blockSizes[memoryTypeIndex] / 2 ) {
+            allocation->Memory = allocateDeviceMemory( memoryTypeIndex, requirements.size, &allocation->MappedMemory );
+            if( !allocation->Memory ) {
+                delete allocation;
+                return nullptr;
+            }
+            allocation->Offset = 0;
+            allocation->Size = requirements.size;
+            allocation->Block = nullptr;
+        } else {
+            bool allocated = false;
+            std::vector<VulkanMemoryBlock*>& blocks = _blocks[memoryTypeIndex];
+            for( U64 i = 0; i < blocks.size() && !allocated; ++i ) {
+                allocated = allocateFromBlock( blocks[i], requirements.size, requirements.alignment, allocation );
+            }
+
+            if( !allocated ) {
+                VulkanMemoryBlock* block = createBlock( memoryTypeIndex, requirements.size );
+                if( !block || !allocateFromBlock( block, requirements.size, requirements.alignment, allocation ) ) {
+                    delete allocation;
+                    return nullptr;
+                }
+            }
+        }
+
+        VulkanHeapStats& stats = _heapStats[_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex];
+        stats.AllocatedBytes += allocation->Size;
+        stats.AllocationCount++;
+        return allocation;
+    }
+
+    void VulkanMemoryAllocator::Free( VulkanAllocation* allocation ) {
+        if( !allocation ) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock( _mutex );
+
+        VulkanHeapStats& stats = _heapStats[_memoryProperties.memoryTypes[allocation->MemoryTypeIndex].heapIndex];
+        stats.AllocatedBytes -= allocation->Size;
+        stats.AllocationCount--;
+
+        if( allocation->Block ) {
+            VulkanMemoryBlock* block = allocation->Block;
+            freeFromBlock( block, allocation );
+
+            // Keep one empty block per memory type around, so a resource being recreated does not cost a new block.
+            if( block->AllocationCount == 0 ) {
+                std::vector<VulkanMemoryBlock*>& blocks = _blocks[block->MemoryTypeIndex];
+                for( U64 i = 0; i < blocks.size(); ++i ) {
+                    if( blocks[i] != block && blocks[i]->AllocationCount == 0 ) {
+                        blocks.erase( std::find( blocks.begin(), blocks.end(), block ) );
+                        destroyBlock( block );
+                        break;
+                    }
+                }
+            }
+        } else {
+            freeDeviceMemory( allocation->MemoryTypeIndex, allocation->Memory, allocation->Size );
+        }
+
+        delete allocation;
+    }
+
+    const VulkanHeapStats VulkanMemoryAllocator::GetHeapStats( const U32 heapIndex ) {
+        std::lock_guard<std::mutex> lock( _mutex );
+        return _heapStats[heapIndex];
+    }
+
+    void VulkanMemoryAllocator::LogStats() {
+        std::lock_guard<std::mutex> lock( _mutex );
+
+        for( U32 i = 0; i < _memoryProperties.memoryHeapCount; ++i ) {
+            const VulkanHeapStats& stats = _heapStats[i];
+            Logger::Log( "Memory heap %d: %.2f/%.2f MiB reserved, %.2f MiB in %d allocations across %d device memory objects.", i,
+                (F32)stats.ReservedBytes / 1024.0f / 1024.0f, (F32)stats.Budget / 1024.0f / 1024.0f,
+                (F32)stats.AllocatedBytes / 1024.0f / 1024.0f, stats.AllocationCount, stats.DeviceMemoryCount );
+        }
+    }
+
+    void VulkanMemoryAllocator::GetDefragmentationCandidates( const F32 maxBlockUsage, std::vector<VulkanAllocation*>* outAllocations ) {
+        std::lock_guard<std::mutex> lock( _mutex );
+
+        for( U32 i = 0; i < _memoryProperties.memoryTypeCount; ++i ) {
+
+            // Moving allocations out of the only block of a type frees nothing.
+            if( _blocks[i].size() < 2 ) {
+                continue;
+            }
+
+            for( U64 b = 0; b < _blocks[i].size(); ++b ) {
+                VulkanMemoryBlock* block = _blocks[i][b];
+                if( block->AllocationCount == 0 || (F32)block->AllocatedBytes / (F32)block->Size >= maxBlockUsage ) {
+                    continue;
+                }
+
+                for( U64 r = 0; r < block->Ranges.size(); ++r ) {
+                    if( block->Ranges[r].Allocation ) {
+                        outAllocations->push_back( block->Ranges[r].Allocation );
+                    }
+                }
+            }
+        }
+    }
+
+    void VulkanMemoryAllocator::ReleaseEmptyBlocks() {
+        std::lock_guard<std::mutex> lock( _mutex );
+
+        for( U32 i = 0; i < _memoryProperties.memoryTypeCount; ++i ) {
+            std::vector<VulkanMemoryBlock*>& blocks = _blocks[i];
+            for( U64 b = 0; b < blocks.size(); ) {
+                if( blocks[b]->AllocationCount == 0 ) {
+                    destroyBlock( blocks[b] );
+                    blocks.erase( blocks.begin() + b );
+                } else {
+                    ++b;
+                }
+            }
+        }
+    }
+
+    const U32 VulkanMemoryAllocator::findMemoryType( const U32 typeFilter, VkMemoryPropertyFlags properties ) const {
+        for( U32 i = 0; i < _memoryProperties.memoryTypeCount; ++i ) {
+            if( ( typeFilter & ( 1 << i ) ) && ( _memoryProperties.memoryTypes[i].propertyFlags & properties ) == properties ) {
+                return i;
+            }
+        }
+        return U32_MAX;
+    }
+
+    VkDeviceMemory VulkanMemoryAllocator::allocateDeviceMemory( const U32 memoryTypeIndex, const U64 size, U8** outMappedMemory ) {
+        VulkanHeapStats& stats = _heapStats[_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex];
+        if( stats.ReservedBytes + size > stats.Budget ) {
+            Logger::Warn( "Allocating %lluB from memory heap %d goes over its budget of %lluB.", size, _memoryProperties.memoryTypes[memoryTypeIndex].heapIndex, stats.Budget );
+        }
+
+        VkMemoryAllocateInfo allocateInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+        allocateInfo.allocationSize = size;
+        allocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+        VkDeviceMemory memory;
+        VkResult result = vkAllocateMemory( _device->LogicalDevice, &allocateInfo, nullptr, &memory );
+        if( result != VK_SUCCESS ) {
+            Logger::Error( "Failed to allocate %lluB of device memory from memory type %d (result %d).", size, memoryTypeIndex, result );
+            return nullptr;
+        }
+
+        *outMappedMemory = nullptr;
+        if( _memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT ) {
+            void* mapped;
+            VK_CHECK( vkMapMemory( _device->LogicalDevice, memory, 0, VK_WHOLE_SIZE, 0, &mapped ) );
+            *outMappedMemory = static_cast<U8*>( mapped );
+        }
+
+        stats.ReservedBytes += size;
+        stats.DeviceMemoryCount++;
+        return memory;
+    }
+
+    void VulkanMemoryAllocator::freeDeviceMemory( const U32 memoryTypeIndex, VkDeviceMemory memory, const U64 size ) {
+
+        // Freeing memory implicitly unmaps it.
+        vkFreeMemory( _device->LogicalDevice, memory, nullptr );
+
+        VulkanHeapStats& stats = _heapStats[_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex];
+        stats.ReservedBytes -= size;
+        stats.DeviceMemoryCount--;
+    }
+
+    VulkanMemoryBlock* VulkanMemoryAllocator::createBlock( const U32 memoryTypeIndex, const U64 minimumSize ) {
+        U64 size = _blockSizes[memoryTypeIndex];
+
+        // Try smaller blocks if the heap is running out, down to what is actually needed.
+        VkDeviceMemory memory = nullptr;
+        U8* mappedMemory = nullptr;
+        while( !memory ) {
+            memory = allocateDeviceMemory( memoryTypeIndex, size, &mappedMemory );
+            if( !memory ) {
+                if( size / 2 < minimumSize ) {
+                    return nullptr;
+                }
+                size /= 2;
+            }
+        }
+
+        VulkanMemoryBlock* block = new VulkanMemoryBlock();
+        block->Memory = memory;
+        block->Size = size;
+        block->MemoryTypeIndex = memoryTypeIndex;
+        block->MappedMemory = mappedMemory;
+        block->Ranges.push_back( { 0, size, nullptr } );
+        _blocks[memoryTypeIndex].push_back( block );
+        return block;
+    }
+
+    void VulkanMemoryAllocator::destroyBlock( VulkanMemoryBlock* block ) {
+        freeDeviceMemory( block->MemoryTypeIndex, block->Memory, block->Size );
+        block->Ranges.clear();
+        delete block;
+    }
+
+    const bool VulkanMemoryAllocator::allocateFromBlock( VulkanMemoryBlock* block, const U64 size, const U64 alignment, VulkanAllocation* allocation ) {
+        if( block->Size - block->AllocatedBytes < size ) {
+            return false;
+        }
+
+        // Best fit: use the free range which leaves the least space behind, to keep large ranges whole.
+        U64 bestIndex = U64_MAX;
+        U64 bestOffset = 0;
+        U64 bestRemainder = U64_MAX;
+        U64 rangeCount = block->Ranges.size();
+        for( U64 i = 0; i < rangeCount; ++i ) {
+            const VulkanMemoryRange& range = block->Ranges[i];
+            if( range.Allocation || range.Size < size ) {
+                continue;
+            }
+
+            U64 offset = alignUp( range.Offset, alignment );
+
+            // A different kind of resource must not share a page with this one.
+            if( _bufferImageGranularity > 1 && i > 0 ) {
+                const VulkanMemoryRange& previous = block->Ranges[i - 1];
+                if( previous.Allocation && previous.Allocation->Kind != allocation->Kind && onSamePage( previous.Offset + previous.Size - 1, offset, _bufferImageGranularity ) ) {
+                    offset = alignUp( offset, _bufferImageGranularity );
+                }
+            }
+
+            U64 end = offset + size;
+            if( end > range.Offset + range.Size ) {
+                continue;
+            }
+
+            if( _bufferImageGranularity > 1 && i + 1 < rangeCount ) {
+                const VulkanMemoryRange& next = block->Ranges[i + 1];
+                if( next.Allocation && next.Allocation->Kind != allocation->Kind && onSamePage( end - 1, next.Offset, _bufferImageGranularity ) ) {
+                    continue;
+                }
+            }
+
+            U64 remainder = ( range.Offset + range.Size ) - end;
+            if( remainder < bestRemainder ) {
+                bestIndex = i;
+                bestOffset = offset;
+                bestRemainder = remainder;
+            }
+        }
+
+        if( bestIndex == U64_MAX ) {
+            return false;
+        }
+
+        allocation->Memory = block->Memory;
+        allocation->Offset = bestOffset;
+        allocation->Size = size;
+        allocation->Block = block;
+        allocation->MappedMemory = block->MappedMemory ? block->MappedMemory + bestOffset : nullptr;
+
+        // Split the free range into the padding before the allocation, the allocation, and the space after it.
+        VulkanMemoryRange range = block->Ranges[bestIndex];
+        U64 padding = bestOffset - range.Offset;
+        U64 insertIndex = bestIndex;
+        block->Ranges.erase( block->Ranges.begin() + bestIndex );
+        if( padding > 0 ) {
+            block->Ranges.insert( block->Ranges.begin() + insertIndex, { range.Offset, padding, nullptr } );
+            insertIndex++;
+        }
+        block->Ranges.insert( block->Ranges.begin() + insertIndex, { bestOffset, size, allocation } );
+        insertIndex++;
+        if( bestRemainder > 0 ) {
+            block->Ranges.insert( block->Ranges.begin() + insertIndex, { bestOffset + size, bestRemainder, nullptr } );
+        }
+
+        block->AllocatedBytes += size;
+        block->AllocationCount++;
+        return true;
+    }
+
+    void VulkanMemoryAllocator::freeFromBlock( VulkanMemoryBlock* block, VulkanAllocation* allocation ) {
+        std::vector<VulkanMemoryRange>& ranges = block->Ranges;
+        U64 index = 0;
+        for( ; index < ranges.size(); ++index ) {
+            if( ranges[index].Allocation == allocation ) {
+                break;
+            }
+        }
+
+        if( index == ranges.size() ) {
+            Logger::Error( "Attempted to free an allocation from a memory block it does not belong to." );
+            return;
+        }
+
+        ranges[index].Allocation = nullptr;
+        block->AllocatedBytes -= allocation->Size;
+        block->AllocationCount--;
+
+        // Merge with the free ranges on either side.
+        if( index + 1 < ranges.size() && !ranges[index + 1].Allocation ) {
+            ranges[index].Size += ranges[index + 1].Size;
+            ranges.erase( ranges.begin() + index + 1 );
+        }
+        if( index > 0 && !ranges[index - 1].Allocation ) {
+            ranges[index - 1].Size += ranges[index].Size;
+            ranges.erase( ranges.begin() + index );
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../../../Types.h"
+
+namespace Epoch {
+
+    class VulkanDevice;
+    struct VulkanMemoryBlock;
+
+    /**
+     * The kind of resource an allocation is bound to. Linear and optimal resources which share a page of
+     * bufferImageGranularity may alias on some hardware, so the allocator keeps them apart.
+     */
+    enum class VulkanAllocationKind : U8 {
+
+        /** Buffers and linearly tiled images. */
+        Linear,
+
+        /** Optimally tiled images. */
+        Optimal
+    };
+
+    /**
+     * A range of device memory handed out by the memory allocator.
+     */
+    struct VulkanAllocation {
+
+        /** The device memory the range lives in, which may be shared with other allocations. */
+        VkDeviceMemory Memory = nullptr;
+
+        /** The offset in bytes of the range within the device memory. Resources must be bound at this offset. */
+        U64 Offset = 0;
+
+        /** The size in bytes of the range. */
+        U64 Size = 0;
+
+        /** The index of the memory type the range was allocated from. */
+        U32 MemoryTypeIndex = 0;
+
+        /** The kind of resource bound to this range. */
+        VulkanAllocationKind Kind = VulkanAllocationKind::Linear;
+
+        /** A pointer to the start of the range if it is host visible, which stays mapped for its whole lifetime. Otherwise nullptr. */
+        U8* MappedMemory = nullptr;
+
+        /** The block this range was sub-allocated from, or nullptr if it has device memory of its own. */
+        VulkanMemoryBlock* Block = nullptr;
+
+        /** Set by the owner of the allocation to identify it when defragmenting. Not used by the allocator. */
+        void* UserData = nullptr;
+    };
+
+    /**
+     * A range within a memory block, either free or held by an allocation.
+     */
+    struct VulkanMemoryRange {
+        U64 Offset;
+        U64 Size;
+
+        // nullptr if the range is free.
+        VulkanAllocation* Allocation;
+    };
+
+    /**
+     * A single large piece of device memory which allocations are sub-allocated from.
+     */
+    struct VulkanMemoryBlock {
+        VkDeviceMemory Memory = nullptr;
+        U64 Size = 0;
+        U32 MemoryTypeIndex = 0;
+        U64 AllocatedBytes = 0;
+        U32 AllocationCount = 0;
+
+        // The whole block, mapped once if host visible.
+        U8* MappedMemory = nullptr;
+
+        // Every range in the block, sorted by offset. Adjacent free ranges are always merged.
+        std::vector<VulkanMemoryRange> Ranges;
+    };
+
+    /**
+     * Memory usage statistics of a single memory heap.
+     */
+    struct VulkanHeapStats {
+
+        /** The total size of the heap in bytes. */
+        U64 HeapSize = 0;
+
+        /** The number of bytes the allocator should stay under within the heap. */
+        U64 Budget = 0;
+
+        /** The number of bytes of device memory allocated from the heap, including blocks' free space. */
+        U64 ReservedBytes = 0;
+
+        /** The number of bytes held by live allocations. */
+        U64 AllocatedBytes = 0;
+
+        /** The number of device memory objects allocated from the heap, blocks and dedicated allocations alike. */
+        U32 DeviceMemoryCount = 0;
+
+        /** The number of live allocations. */
+        U32 AllocationCount = 0;
+    };
+
+    /**
+     * Allocates device memory in large blocks per memory type, and sub-allocates buffers and images from them, so the
+     * number of vkAllocateMemory calls stays small regardless of the number of resources. Resources too large to share
+     * a block get memory of their own. Host visible memory is mapped once when allocated and stays mapped.
+     */
+    class VulkanMemoryAllocator {
+    public:
+
+        /**
+         * Creates a new memory allocator.
+         *
+         * @param device The device to allocate memory from.
+         */
+        VulkanMemoryAllocator( VulkanDevice* device );
+        ~VulkanMemoryAllocator();
+
+        /**
+         * Allocates memory for a resource.
+         *
+         * @param requirements The memory requirements of the resource, as returned by vkGet*MemoryRequirements.
+         * @param properties The properties the memory must have.
+         * @param kind The kind of resource the memory will be bound to.
+         *
+         * @returns A pointer to the allocation, which must be returned with Free, or nullptr if out of memory.
+         */
+        VulkanAllocation* Allocate( const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, const VulkanAllocationKind kind );
+
+        /**
+         * Frees the given allocation. Any resource bound to it must already be destroyed or no longer in use by the GPU.
+         *
+         * @param allocation The allocation to free.
+         */
+        void Free( VulkanAllocation* allocation );
+
+        /**
+         * Returns the number of memory heaps on the device.
+         */
+        const U32 GetHeapCount() const { return _memoryProperties.memoryHeapCount; }
+
+        /**
+         * Returns the memory usage statistics of the given heap.
+         *
+         * @param heapIndex The index of the heap.
+         */
+        const VulkanHeapStats GetHeapStats( const U32 heapIndex );
+
+        /**
+         * Logs the memory usage statistics of every heap.
+         */
+        void LogStats();
+
+        /**
+         * Finds allocations which live in sparsely used blocks. If their owners recreate their resources and free the old
+         * allocations, those blocks empty out and can be released with ReleaseEmptyBlocks.
+         *
+         * @param maxBlockUsage The fraction of a block, from 0 to 1, below which its allocations are candidates for moving.
+         * @param outAllocations A pointer to a list to add candidate allocations to.
+         */
+        void GetDefragmentationCandidates( const F32 maxBlockUsage, std::vector<VulkanAllocation*>* outAllocations );
+
+        /**
+         * Returns the device memory of every block with no allocations in it.
+         */
+        void ReleaseEmptyBlocks();
+
+    private:
+        const U32 findMemoryType( const U32 typeFilter, VkMemoryPropertyFlags properties ) const;
+        VkDeviceMemory allocateDeviceMemory( const U32 memoryTypeIndex, const U64 size, U8** outMappedMemory );
+        void freeDeviceMemory( const U32 memoryTypeIndex, VkDeviceMemory memory, const U64 size );
+        VulkanMemoryBlock* createBlock( const U32 memoryTypeIndex, const U64 minimumSize );
+        void destroyBlock( VulkanMemoryBlock* block );
+        const bool allocateFromBlock( VulkanMemoryBlock* block, const U64 size, const U64 alignment, VulkanAllocation* allocation );
+        void freeFromBlock( VulkanMemoryBlock* block, VulkanAllocation* allocation );
+
+    private:
+        VulkanDevice* _device;
+        VkPhysicalDeviceMemoryProperties _memoryProperties;
+        U64 _bufferImageGranularity;
+        std::mutex _mutex;
+
+        // The blocks of each memory type, and the size new blocks of that type are created with.
+        std::vector<VulkanMemoryBlock*> _blocks[VK_MAX_MEMORY_TYPES];
+        U64 _blockSizes[VK_MAX_MEMORY_TYPES];
+
+        VulkanHeapStats _heapStats[VK_MAX_MEMORY_HEAPS];
+    };
+}
\ No newline at end of file
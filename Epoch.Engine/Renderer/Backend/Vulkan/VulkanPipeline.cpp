@@ -1,6 +1,7 @@
 
 #include "../../../Logger.h"
 #include "../../../Math/Vector3.h"
+#include "../../../Math/Matrix4x4.h"
 #include "../../Vertex3D.h"
 
 #include "VulkanUtilities.h"
@@ -29,8 +30,8 @@ namespace Epoch {
     }
 
 
-    VulkanGraphicsPipeline::VulkanGraphicsPipeline( VulkanDevice* device, const PipelineInfo& info ) : VulkanPipeline( device ) {
-        createLayout( info );
+    VulkanGraphicsPipeline::VulkanGraphicsPipeline( VulkanDevice* device, const PipelineInfo& info, VkPipelineCache cache ) : VulkanPipeline( device ) {
+        createLayout( info, cache );
     }
 
     VulkanGraphicsPipeline::~VulkanGraphicsPipeline() {
@@ -45,7 +46,38 @@ namespace Epoch {
         }
     }
 
-    void VulkanGraphicsPipeline::createLayout( const PipelineInfo& info ) {
+    VulkanComputePipeline::VulkanComputePipeline( VulkanDevice* device, const PipelineInfo& info, VkPipelineCache cache ) : VulkanPipeline( device ) {
+        ASSERT_MSG( info.ShaderStages.size() == 1, "A compute pipeline needs exactly one shader stage." );
+
+        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+        pipelineLayoutCreateInfo.setLayoutCount = (U32)info.DescriptorSetLayouts.size();
+        pipelineLayoutCreateInfo.pSetLayouts = info.DescriptorSetLayouts.data();
+        pipelineLayoutCreateInfo.pushConstantRangeCount = (U32)info.PushConstantRanges.size();
+        pipelineLayoutCreateInfo.pPushConstantRanges = info.PushConstantRanges.empty() ? nullptr : info.PushConstantRanges.data();
+        VK_CHECK( vkCreatePipelineLayout( _device->LogicalDevice, &pipelineLayoutCreateInfo, nullptr, &_layout ) );
+
+        VkComputePipelineCreateInfo pipelineCreateInfo = { VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+        pipelineCreateInfo.stage = info.ShaderStages[0];
+        pipelineCreateInfo.layout = _layout;
+        pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineCreateInfo.basePipelineIndex = -1;
+        VK_CHECK( vkCreateComputePipelines( _device->LogicalDevice, cache, 1, &pipelineCreateInfo, nullptr, &_handle ) );
+
+        Logger::Log( "Compute pipeline created!" );
+    }
+
+    VulkanComputePipeline::~VulkanComputePipeline() {
+    }
+
+    void VulkanComputePipeline::Bind( VulkanCommandBuffer* commandBuffer ) {
+        if( _handle ) {
+            vkCmdBindPipeline( commandBuffer->Handle, VK_PIPELINE_BIND_POINT_COMPUTE, _handle );
+        } else {
+            Logger::Fatal( "Attempted to bind a pipeline which does not have a handle." );
+        }
+    }
+
+    void VulkanGraphicsPipeline::createLayout( const PipelineInfo& info, VkPipelineCache cache ) {
 
         // Viewport
         VkViewport viewport = {};
@@ -124,13 +156,18 @@ namespace Epoch {
         dynamicStateCreateInfo.pDynamicStates = dynamicStates;
 
         // Vertex input
-        VkVertexInputBindingDescription bindingDescription;
-        bindingDescription.binding = 0; // Binding index
-        bindingDescription.stride = sizeof( Vertex3D );
-        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX; // Move to next data entry for each vertex.
+        VkVertexInputBindingDescription bindingDescriptions[2];
+        bindingDescriptions[0].binding = 0; // Binding index
+        bindingDescriptions[0].stride = sizeof( Vertex3D );
+        bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX; // Move to next data entry for each vertex.
+
+        // Per-instance world matrix.
+        bindingDescriptions[1].binding = 1;
+        bindingDescriptions[1].stride = sizeof( Matrix4x4 );
+        bindingDescriptions[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE; // Move to next data entry for each instance.
 
         U32 offset = 0;
-        VkVertexInputAttributeDescription attributeDescriptions[4];
+        VkVertexInputAttributeDescription attributeDescriptions[8];
         attributeDescriptions[0].binding = 0; // binding index - should match binding desc
         attributeDescriptions[0].location = 0; // attrib location
         attributeDescriptions[0].format = VkFormat::VK_FORMAT_R32G32B32_SFLOAT; // 3x32-bit floats
@@ -156,10 +193,18 @@ namespace Epoch {
         attributeDescriptions[3].offset = offset;
         offset += sizeof( Vector3 );
 
+        // Model matrix, one column per location.
+        for( U32 i = 0; i < 4; ++i ) {
+            attributeDescriptions[4 + i].binding = 1;
+            attributeDescriptions[4 + i].location = 4 + i;
+            attributeDescriptions[4 + i].format = VkFormat::VK_FORMAT_R32G32B32A32_SFLOAT; // 4x32-bit floats
+            attributeDescriptions[4 + i].offset = sizeof( F32 ) * 4 * i;
+        }
+
         VkPipelineVertexInputStateCreateInfo vertexInputInfo = { VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
-        vertexInputInfo.vertexBindingDescriptionCount = 1;
-        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-        vertexInputInfo.vertexAttributeDescriptionCount = 4;
+        vertexInputInfo.vertexBindingDescriptionCount = 2;
+        vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions;
+        vertexInputInfo.vertexAttributeDescriptionCount = 8;
         vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions;
 
         // Input assembly 
@@ -171,8 +216,8 @@ namespace Epoch {
         VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
         pipelineLayoutCreateInfo.setLayoutCount = (U32)info.DescriptorSetLayouts.size();
         pipelineLayoutCreateInfo.pSetLayouts = info.DescriptorSetLayouts.data();
-        pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
-        pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
+        pipelineLayoutCreateInfo.pushConstantRangeCount = (U32)info.PushConstantRanges.size();
+        pipelineLayoutCreateInfo.pPushConstantRanges = info.PushConstantRanges.empty() ? nullptr : info.PushConstantRanges.data();
         VK_CHECK( vkCreatePipelineLayout( _device->LogicalDevice, &pipelineLayoutCreateInfo, nullptr, &_layout ) );
 
         // Pipeline create
@@ -197,7 +242,7 @@ namespace Epoch {
         pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
         pipelineCreateInfo.basePipelineIndex = -1;
 
-        VK_CHECK( vkCreateGraphicsPipelines( _device->LogicalDevice, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &_handle ) );
+        VK_CHECK( vkCreateGraphicsPipelines( _device->LogicalDevice, cache, 1, &pipelineCreateInfo, nullptr, &_handle ) );
 
         Logger::Log( "Graphics pipeline created!" );
     }
@@ -14,6 +14,7 @@ namespace Epoch {
         std::vector<VkDescriptorSetLayout> DescriptorSetLayouts;
         VulkanRenderPass* Renderpass = nullptr;
         std::vector<VkPipelineShaderStageCreateInfo> ShaderStages;
+        std::vector<VkPushConstantRange> PushConstantRanges;
     };
 
     class VulkanPipeline {
@@ -32,12 +33,25 @@ namespace Epoch {
 
     class VulkanGraphicsPipeline : public VulkanPipeline {
     public:
-        VulkanGraphicsPipeline( VulkanDevice* device, const PipelineInfo& info );
+        VulkanGraphicsPipeline( VulkanDevice* device, const PipelineInfo& info, VkPipelineCache cache = VK_NULL_HANDLE );
         ~VulkanGraphicsPipeline();
 
         void Bind( VulkanCommandBuffer* commandBuffer );
 
     private:
-        void createLayout( const PipelineInfo& info );
+        void createLayout( const PipelineInfo& info, VkPipelineCache cache );
+    };
+
+    class VulkanComputePipeline : public VulkanPipeline {
+    public:
+
+        /**
+         * Creates a compute pipeline. Only the descriptor set layouts, push constant ranges and the single compute stage
+         * of the given info are used.
+         */
+        VulkanComputePipeline( VulkanDevice* device, const PipelineInfo& info, VkPipelineCache cache = VK_NULL_HANDLE );
+        ~VulkanComputePipeline();
+
+        void Bind( VulkanCommandBuffer* commandBuffer );
     };
 }
\ No newline at end of file
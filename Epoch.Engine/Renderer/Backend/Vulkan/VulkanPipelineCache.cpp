@@ -0,0 +1,403 @@
+#include <algorithm>
+#include <cstring>
+
+#include "../../../Logger.h"
+#include "../../../Defines.h"
+#include "../../../Memory/Memory.h"
+#include "../../../FileSystem/FileHandle.h"
+#include "../../../Time/Clock.h"
+
+#include "VulkanUtilities.h"
+#include "VulkanDevice.h"
+#include "VulkanRenderPass.h"
+#include "VulkanPipelineCache.h"
+
+// Identifies a pipeline cache file. "EPPC" in little-endian.
+#define VULKAN_PIPELINE_CACHE_MAGIC 0x43505045
+
+// Bump whenever the file header changes.
+#define VULKAN_PIPELINE_CACHE_FORMAT_VERSION 1
+
+// Bump whenever the fixed-function state set up by VulkanGraphicsPipeline changes, so pipelines hash differently.
+#define VULKAN_PIPELINE_STATE_VERSION 1
+
+// The number of threads compiling pipelines queued with CompileGraphicsPipelineAsync.
+#define VULKAN_PIPELINE_COMPILE_THREADS 2
+
+namespace Epoch {
+
+    /*
+    FORMAT:
+
+    VulkanPipelineCacheFileHeader (48 bytes)
+    <DataSize> bytes of data, as returned by vkGetPipelineCacheData.
+
+    The data is only used if it was saved by the same device and driver version, as it would be rejected anyway.
+    */
+    struct VulkanPipelineCacheFileHeader {
+        U32 Magic;
+        U32 FormatVersion;
+        U32 VendorId;
+        U32 DeviceId;
+        U32 DriverVersion;
+        U8 PipelineCacheUUID[VK_UUID_SIZE];
+        U32 Padding;
+        U64 DataSize;
+    };
+
+    static_assert( sizeof( VulkanPipelineCacheFileHeader ) == 48, "VulkanPipelineCacheFileHeader layout must not change." );
+
+    // Continues a 64-bit FNV-1a hash with the given bytes.
+    static U64 hashBytes( U64 hash, const void* data, const U64 size ) {
+        const U8* bytes = static_cast<const U8*>( data );
+        for( U64 i = 0; i < size; ++i ) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    VulkanPipelineCache::VulkanPipelineCache( VulkanDevice* device, const TString& filePath ) {
+        _device = device;
+        _filePath = filePath;
+
+        std::vector<U8> data;
+        _loadedFromDisk = load( &data );
+
+        VkPipelineCacheCreateInfo createInfo = { VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+        createInfo.initialDataSize = data.size();
+        createInfo.pInitialData = data.empty() ? nullptr : data.data();
+        VK_CHECK( vkCreatePipelineCache( _device->LogicalDevice, &createInfo, nullptr, &_handle ) );
+
+        for( U32 i = 0; i < VULKAN_PIPELINE_COMPILE_THREADS; ++i ) {
+            _compileThreads.push_back( std::thread( &VulkanPipelineCache::compileThreadMain, this ) );
+        }
+    }
+
+    VulkanPipelineCache::~VulkanPipelineCache() {
+
+        // Compiles which have not started yet are dropped. Compiles in progress finish before their thread exits.
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            _shuttingDown = true;
+            for( U64 i = 0; i < _compileQueue.size(); ++i ) {
+                _compileQueue[i]->IsPending = false;
+            }
+            _compileQueue.clear();
+        }
+        _compileQueued.notify_all();
+        for( U64 i = 0; i < _compileThreads.size(); ++i ) {
+            _compileThreads[i].join();
+        }
+        _compileThreads.clear();
+
+        std::unique_lock<std::mutex> lock( _mutex );
+        for( U64 i = 0; i < _entries.size(); ++i ) {
+            VulkanPipelineEntry* entry = _entries[i];
+            finishCompile( lock, entry );
+            if( entry->ReferenceCount > 0 ) {
+                Logger::Warn( "Pipeline %llu still has %d users when destroying the pipeline cache.", entry->Hash, entry->ReferenceCount );
+            }
+            if( entry->Pipeline ) {
+                delete entry->Pipeline;
+            }
+            delete entry;
+        }
+        _entries.clear();
+        lock.unlock();
+
+        Logger::Log( "Created %d pipelines in %llums with a %s pipeline cache.", _compileCount, _compileTimeMs, _loadedFromDisk ? "warm" : "cold" );
+
+        Save();
+
+        if( _handle ) {
+            vkDestroyPipelineCache( _device->LogicalDevice, _handle, nullptr );
+            _handle = nullptr;
+        }
+        _device = nullptr;
+    }
+
+    VulkanGraphicsPipeline* VulkanPipelineCache::AcquireGraphicsPipeline( const PipelineInfo& info ) {
+        U64 hash = hashPipelineInfo( info );
+
+        std::unique_lock<std::mutex> lock( _mutex );
+        VulkanPipelineEntry* entry = findEntry( hash, info );
+        if( !entry ) {
+            entry = new VulkanPipelineEntry();
+            entry->Hash = hash;
+            entry->Info = info;
+            _entries.push_back( entry );
+            compile( entry );
+        }
+
+        // Takes over or waits for a background compile if there is one.
+        finishCompile( lock, entry );
+
+        entry->ReferenceCount++;
+        return entry->Pipeline;
+    }
+
+    void VulkanPipelineCache::ReleaseGraphicsPipeline( VulkanGraphicsPipeline* pipeline ) {
+        std::lock_guard<std::mutex> lock( _mutex );
+        for( U64 i = 0; i < _entries.size(); ++i ) {
+            VulkanPipelineEntry* entry = _entries[i];
+            if( entry->IsPending || entry->Pipeline != pipeline ) {
+                continue;
+            }
+
+            entry->ReferenceCount--;
+            if( entry->ReferenceCount == 0 ) {
+                delete entry->Pipeline;
+                delete entry;
+                _entries.erase( _entries.begin() + i );
+            }
+            return;
+        }
+
+        Logger::Warn( "Attempted to release a pipeline which was not acquired from the pipeline cache." );
+    }
+
+    void VulkanPipelineCache::CompileGraphicsPipelineAsync( const PipelineInfo& info ) {
+        U64 hash = hashPipelineInfo( info );
+
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            if( findEntry( hash, info ) ) {
+                return;
+            }
+
+            VulkanPipelineEntry* entry = new VulkanPipelineEntry();
+            entry->Hash = hash;
+            entry->Info = info;
+            entry->IsPending = true;
+            _entries.push_back( entry );
+            _compileQueue.push_back( entry );
+        }
+        _compileQueued.notify_one();
+    }
+
+    const bool VulkanPipelineCache::Save() {
+        size_t dataSize = 0;
+        VK_CHECK( vkGetPipelineCacheData( _device->LogicalDevice, _handle, &dataSize, nullptr ) );
+        if( dataSize == 0 ) {
+            return false;
+        }
+
+        std::vector<U8> data( dataSize );
+        VK_CHECK( vkGetPipelineCacheData( _device->LogicalDevice, _handle, &dataSize, data.data() ) );
+
+        VulkanPipelineCacheFileHeader header = {};
+        header.Magic = VULKAN_PIPELINE_CACHE_MAGIC;
+        header.FormatVersion = VULKAN_PIPELINE_CACHE_FORMAT_VERSION;
+        header.VendorId = _device->Properties.vendorID;
+        header.DeviceId = _device->Properties.deviceID;
+        header.DriverVersion = _device->Properties.driverVersion;
+        TMemory::Memcpy( header.PipelineCacheUUID, _device->Properties.pipelineCacheUUID, VK_UUID_SIZE );
+        header.DataSize = dataSize;
+
+        FileHandle file( _filePath, true );
+        if( !file.TryOpen( FileMode::FILE_MODE_OUTPUT ) ) {
+            Logger::Warn( "Failed to open pipeline cache file '%s' for writing.", _filePath.CStr() );
+            return false;
+        }
+
+        bool result = file.Write<VulkanPipelineCacheFileHeader>( header ) && file.WriteArray<U8>( data.data(), dataSize );
+        file.Close();
+        if( !result ) {
+            Logger::Warn( "Failed to write pipeline cache file '%s'.", _filePath.CStr() );
+            return false;
+        }
+
+        Logger::Trace( "Saved %lluB of pipeline cache data to '%s'.", dataSize, _filePath.CStr() );
+        return true;
+    }
+
+    const bool VulkanPipelineCache::load( std::vector<U8>* outData ) {
+        FileHandle file( _filePath, true );
+        if( !file.TryOpen( FileMode::FILE_MODE_INPUT ) ) {
+            Logger::Trace( "No pipeline cache found at '%s'. Starting with an empty cache.", _filePath.CStr() );
+            return false;
+        }
+
+        VulkanPipelineCacheFileHeader header;
+        if( file.GetSize() < sizeof( header ) || !file.Read<VulkanPipelineCacheFileHeader>( &header ) ) {
+            Logger::Warn( "Pipeline cache file '%s' is truncated. Starting with an empty cache.", _filePath.CStr() );
+            return false;
+        }
+
+        if( header.Magic != VULKAN_PIPELINE_CACHE_MAGIC || header.FormatVersion != VULKAN_PIPELINE_CACHE_FORMAT_VERSION ) {
+            Logger::Warn( "Pipeline cache file '%s' is not a supported pipeline cache. Starting with an empty cache.", _filePath.CStr() );
+            return false;
+        }
+
+        // Data from another device or driver would be rejected by the driver, so do not bother passing it on.
+        if( header.VendorId != _device->Properties.vendorID || header.DeviceId != _device->Properties.deviceID ||
+            header.DriverVersion != _device->Properties.driverVersion ||
+            TMemory::Memcmp( header.PipelineCacheUUID, _device->Properties.pipelineCacheUUID, VK_UUID_SIZE ) != 0 ) {
+            Logger::Log( "Pipeline cache file '%s' was saved by a different device or driver. Starting with an empty cache.", _filePath.CStr() );
+            return false;
+        }
+
+        if( header.DataSize > file.GetSize() - sizeof( header ) ) {
+            Logger::Warn( "Pipeline cache file '%s' is truncated. Starting with an empty cache.", _filePath.CStr() );
+            return false;
+        }
+
+        U8* data = nullptr;
+        if( !file.ReadArray<U8>( &data, header.DataSize ) ) {
+            Logger::Warn( "Failed to read pipeline cache file '%s'. Starting with an empty cache.", _filePath.CStr() );
+            return false;
+        }
+        outData->assign( data, data + header.DataSize );
+        delete[] data;
+
+        Logger::Trace( "Loaded %lluB of pipeline cache data from '%s'.", header.DataSize, _filePath.CStr() );
+        return true;
+    }
+
+    const U64 VulkanPipelineCache::hashPipelineInfo( const PipelineInfo& info ) {
+        U64 hash = 0xcbf29ce484222325ULL;
+
+        U32 stateVersion = VULKAN_PIPELINE_STATE_VERSION;
+        hash = hashBytes( hash, &stateVersion, sizeof( stateVersion ) );
+        hash = hashBytes( hash, &info.Extent, sizeof( info.Extent ) );
+
+        // Render passes are looked up by name, so the name identifies one.
+        if( info.Renderpass ) {
+            const char* renderPassName = info.Renderpass->GetName();
+            hash = hashBytes( hash, renderPassName, strlen( renderPassName ) );
+        }
+
+        // Descriptor set layouts are created once and shared by every shader using them, so the handle identifies one.
+        U64 layoutCount = info.DescriptorSetLayouts.size();
+        hash = hashBytes( hash, &layoutCount, sizeof( layoutCount ) );
+        if( layoutCount > 0 ) {
+            hash = hashBytes( hash, info.DescriptorSetLayouts.data(), sizeof( VkDescriptorSetLayout ) * layoutCount );
+        }
+
+        U64 pushConstantRangeCount = info.PushConstantRanges.size();
+        hash = hashBytes( hash, &pushConstantRangeCount, sizeof( pushConstantRangeCount ) );
+        if( pushConstantRangeCount > 0 ) {
+            hash = hashBytes( hash, info.PushConstantRanges.data(), sizeof( VkPushConstantRange ) * pushConstantRangeCount );
+        }
+
+        U64 stageCount = info.ShaderStages.size();
+        hash = hashBytes( hash, &stageCount, sizeof( stageCount ) );
+
+        // Modules are owned by the shader library, which loads each shader once, so the handle identifies the code.
+        for( U64 i = 0; i < stageCount; ++i ) {
+            const VkPipelineShaderStageCreateInfo& stage = info.ShaderStages[i];
+            hash = hashBytes( hash, &stage.stage, sizeof( stage.stage ) );
+            hash = hashBytes( hash, &stage.module, sizeof( stage.module ) );
+            if( stage.pName ) {
+                hash = hashBytes( hash, stage.pName, strlen( stage.pName ) );
+            }
+        }
+
+        return hash;
+    }
+
+    const bool VulkanPipelineCache::isSameState( const PipelineInfo& a, const PipelineInfo& b ) {
+        if( a.Extent.width != b.Extent.width || a.Extent.height != b.Extent.height || a.Renderpass != b.Renderpass ) {
+            return false;
+        }
+
+        if( a.DescriptorSetLayouts.size() != b.DescriptorSetLayouts.size() ) {
+            return false;
+        }
+        for( U64 i = 0; i < a.DescriptorSetLayouts.size(); ++i ) {
+            if( a.DescriptorSetLayouts[i] != b.DescriptorSetLayouts[i] ) {
+                return false;
+            }
+        }
+
+        if( a.PushConstantRanges.size() != b.PushConstantRanges.size() ) {
+            return false;
+        }
+        for( U64 i = 0; i < a.PushConstantRanges.size(); ++i ) {
+            const VkPushConstantRange& aRange = a.PushConstantRanges[i];
+            const VkPushConstantRange& bRange = b.PushConstantRanges[i];
+            if( aRange.stageFlags != bRange.stageFlags || aRange.offset != bRange.offset || aRange.size != bRange.size ) {
+                return false;
+            }
+        }
+
+        if( a.ShaderStages.size() != b.ShaderStages.size() ) {
+            return false;
+        }
+        for( U64 i = 0; i < a.ShaderStages.size(); ++i ) {
+            const VkPipelineShaderStageCreateInfo& aStage = a.ShaderStages[i];
+            const VkPipelineShaderStageCreateInfo& bStage = b.ShaderStages[i];
+            if( aStage.stage != bStage.stage || aStage.module != bStage.module ) {
+                return false;
+            }
+            if( ( aStage.pName == nullptr ) != ( bStage.pName == nullptr ) || ( aStage.pName && strcmp( aStage.pName, bStage.pName ) != 0 ) ) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    VulkanPipelineEntry* VulkanPipelineCache::findEntry( const U64 hash, const PipelineInfo& info ) {
+        for( U64 i = 0; i < _entries.size(); ++i ) {
+
+            // A matching hash is only a candidate, as different state can collide.
+            if( _entries[i]->Hash == hash && isSameState( _entries[i]->Info, info ) ) {
+                return _entries[i];
+            }
+        }
+        return nullptr;
+    }
+
+    void VulkanPipelineCache::compile( VulkanPipelineEntry* entry ) {
+        Clock clock( true );
+        entry->Pipeline = new VulkanGraphicsPipeline( _device, entry->Info, _handle );
+        entry->CompileTimeMs = clock.GetTime();
+        Logger::Trace( "Created pipeline %llu in %llums.", entry->Hash, entry->CompileTimeMs );
+    }
+
+    void VulkanPipelineCache::finishCompile( std::unique_lock<std::mutex>& lock, VulkanPipelineEntry* entry ) {
+        if( entry->IsPending ) {
+
+            // Compiled here if no compile thread has picked it up yet, rather than waiting for one to.
+            std::deque<VulkanPipelineEntry*>::iterator queued = std::find( _compileQueue.begin(), _compileQueue.end(), entry );
+            if( queued != _compileQueue.end() ) {
+                _compileQueue.erase( queued );
+                compile( entry );
+                entry->IsPending = false;
+            } else {
+                _compileFinished.wait( lock, [entry]() { return !entry->IsPending; } );
+            }
+        }
+
+        // Counted once the pipeline is known to exist, so compile threads never touch the totals.
+        if( entry->Pipeline && entry->CompileTimeMs != U64_MAX ) {
+            _compileTimeMs += entry->CompileTimeMs;
+            _compileCount++;
+            entry->CompileTimeMs = U64_MAX;
+        }
+    }
+
+    void VulkanPipelineCache::compileThreadMain() {
+        while( true ) {
+            std::unique_lock<std::mutex> lock( _mutex );
+            _compileQueued.wait( lock, [this]() { return _shuttingDown || !_compileQueue.empty(); } );
+            if( _shuttingDown ) {
+                return;
+            }
+
+            VulkanPipelineEntry* entry = _compileQueue.front();
+            _compileQueue.pop_front();
+            lock.unlock();
+
+            // The pipeline cache is internally synchronized, so pipelines can be created on any thread.
+            compile( entry );
+
+            lock.lock();
+            entry->IsPending = false;
+            lock.unlock();
+            _compileFinished.notify_all();
+        }
+    }
+}
\ No newline at end of file
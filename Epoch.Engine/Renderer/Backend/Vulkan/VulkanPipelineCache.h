@@ -0,0 +1,120 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../../../Types.h"
+#include "../../../String/TString.h"
+#include "VulkanPipeline.h"
+
+namespace Epoch {
+
+    class VulkanDevice;
+
+    /**
+     * A graphics pipeline shared by every user with identical pipeline state.
+     */
+    struct VulkanPipelineEntry {
+        U64 Hash = 0;
+        PipelineInfo Info;
+        VulkanGraphicsPipeline* Pipeline = nullptr;
+        U32 ReferenceCount = 0;
+        U64 CompileTimeMs = 0;
+
+        // Set while the pipeline is queued for or being compiled on a compile thread.
+        bool IsPending = false;
+    };
+
+    /**
+     * Creates graphics pipelines through a VkPipelineCache which is loaded from disk on startup and saved on shutdown, so
+     * drivers can skip compiling pipelines they have already compiled on a previous run. Pipelines are also deduplicated by
+     * their full state, so users with identical state share one pipeline. Background compiles run on a fixed number of
+     * compile threads.
+     */
+    class VulkanPipelineCache {
+    public:
+
+        /**
+         * Creates a new pipeline cache, loading the data at the given path if it was saved by the same device and driver.
+         *
+         * @param device The device to create pipelines on.
+         * @param filePath The path of the file the cache is loaded from and saved to.
+         */
+        VulkanPipelineCache( VulkanDevice* device, const TString& filePath );
+
+        /**
+         * Saves the cache to disk and destroys it. All pipelines should have been released first.
+         */
+        ~VulkanPipelineCache();
+
+        /**
+         * Returns a pipeline for the given state, creating it only if no pipeline with identical state exists. Each call must
+         * be matched by a call to ReleaseGraphicsPipeline.
+         *
+         * @param info The state of the pipeline.
+         *
+         * @returns A pointer to the pipeline.
+         */
+        VulkanGraphicsPipeline* AcquireGraphicsPipeline( const PipelineInfo& info );
+
+        /**
+         * Releases a pipeline returned by AcquireGraphicsPipeline, destroying it once it has no more users.
+         *
+         * @param pipeline The pipeline to release.
+         */
+        void ReleaseGraphicsPipeline( VulkanGraphicsPipeline* pipeline );
+
+        /**
+         * Queues a pipeline for the given state to be compiled on a compile thread, so a later AcquireGraphicsPipeline with the
+         * same state does not have to wait for it. Does nothing if such a pipeline already exists.
+         *
+         * @param info The state of the pipeline. Any shader modules and layouts it refers to must live until the pipeline is acquired.
+         */
+        void CompileGraphicsPipelineAsync( const PipelineInfo& info );
+
+        /**
+         * Writes the cache to disk.
+         *
+         * @returns True if the cache was saved; otherwise false.
+         */
+        const bool Save();
+
+        /**
+         * Returns the Vulkan pipeline cache handle.
+         */
+        VkPipelineCache GetHandle() { return _handle; }
+
+    private:
+        const bool load( std::vector<U8>* outData );
+        static const U64 hashPipelineInfo( const PipelineInfo& info );
+        static const bool isSameState( const PipelineInfo& a, const PipelineInfo& b );
+        VulkanPipelineEntry* findEntry( const U64 hash, const PipelineInfo& info );
+        void compile( VulkanPipelineEntry* entry );
+        void finishCompile( std::unique_lock<std::mutex>& lock, VulkanPipelineEntry* entry );
+        void compileThreadMain();
+
+    private:
+        VulkanDevice* _device;
+        VkPipelineCache _handle = nullptr;
+        TString _filePath;
+        bool _loadedFromDisk = false;
+
+        std::mutex _mutex;
+        std::vector<VulkanPipelineEntry*> _entries;
+
+        // Entries waiting for a compile thread, and the threads which compile them.
+        std::deque<VulkanPipelineEntry*> _compileQueue;
+        std::vector<std::thread> _compileThreads;
+        std::condition_variable _compileQueued;
+        std::condition_variable _compileFinished;
+        bool _shuttingDown = false;
+
+        // Time spent creating pipelines, measured to compare startup with a cold cache to startup with a warm one.
+        U64 _compileTimeMs = 0;
+        U32 _compileCount = 0;
+    };
+}
\ No newline at end of file
@@ -162,7 +162,7 @@ namespace Epoch {
         _device = nullptr;
     }
 
-    void VulkanRenderPass::Begin( const RenderPassClearInfo& clearInfo, VkFramebuffer frameBuffer, VulkanCommandBuffer* commandBuffer ) {
+    void VulkanRenderPass::Begin( const RenderPassClearInfo& clearInfo, VkFramebuffer frameBuffer, VulkanCommandBuffer* commandBuffer, const bool hasSecondaryContents ) {
         VkRenderPassBeginInfo renderPassBeginInfo = { VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
         renderPassBeginInfo.renderPass = _handle;
         renderPassBeginInfo.framebuffer = frameBuffer;
@@ -176,7 +176,8 @@ namespace Epoch {
         renderPassBeginInfo.clearValueCount = 2;
         renderPassBeginInfo.pClearValues = clearValues;
 
-        vkCmdBeginRenderPass( commandBuffer->Handle, &renderPassBeginInfo, VkSubpassContents::VK_SUBPASS_CONTENTS_INLINE );
+        VkSubpassContents contents = hasSecondaryContents ? VkSubpassContents::VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VkSubpassContents::VK_SUBPASS_CONTENTS_INLINE;
+        vkCmdBeginRenderPass( commandBuffer->Handle, &renderPassBeginInfo, contents );
     }
 
     void VulkanRenderPass::End( VulkanCommandBuffer* commandBuffer ) {
@@ -25,7 +25,15 @@ namespace Epoch {
         VulkanRenderPass( VulkanDevice* device, RenderPassData renderPassData );
         ~VulkanRenderPass();
 
-        void Begin( const RenderPassClearInfo& clearInfo, VkFramebuffer frameBuffer, VulkanCommandBuffer* commandBuffer );
+        /**
+         * Begins this render pass.
+         *
+         * @param clearInfo The clear values and render area to use.
+         * @param frameBuffer The framebuffer to render to.
+         * @param commandBuffer The primary command buffer to begin the render pass on.
+         * @param hasSecondaryContents Indicates the contents of the render pass are recorded in secondary command buffers rather than inline. Default: false
+         */
+        void Begin( const RenderPassClearInfo& clearInfo, VkFramebuffer frameBuffer, VulkanCommandBuffer* commandBuffer, const bool hasSecondaryContents = false );
 
         void End( VulkanCommandBuffer* commandBuffer );
 
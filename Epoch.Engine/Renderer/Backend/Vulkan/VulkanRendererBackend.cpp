@@ -1,15 +1,21 @@
+#include <thread>
+
 #include "../../../Platform/VulkanPlatform.h"
 #include "../../../Platform/IApplication.h"
 #include "../../../Platform/IWindow.h"
+#include "../../../Platform/WorkerPool.h"
 #include "../../../Logger.h"
 #include "../../../Defines.h"
 #include "../../../Memory/Memory.h"
+#include "../../../Containers/List.h"
 #include "../../../Math/TMath.h"
 #include "../../../Math/Rotator.h"
 #include "../../../Math/Matrix4x4.h"
 #include "../../../Math/Vector3.h"
 #include "../../../Math/Quaternion.h"
+#include "../../../Math/Frustum.h"
 #include "../../../String/TString.h"
+#include "../../../World/Entities/CameraEntity.h"
 
 #include "../../../Resources/ITexture.h"
 #include "../../../Resources/StaticMesh.h"
@@ -35,14 +41,36 @@
 #include "VulkanCommandBuffer.h"
 #include "VulkanQueue.h"
 #include "VulkanShader.h"
+#include "VulkanUploader.h"
+#include "VulkanGlobalUniforms.h"
+#include "VulkanIndirectDrawCuller.h"
 
 #include "VulkanRendererBackend.h"
 
 #include "VulkanDebugger.h"
 
 
+// The number of instances each instance buffer holds when first created. Grown by doubling.
+#define VULKAN_INITIAL_INSTANCE_CAPACITY 1024
+
+// The maximum number of threads which record draws in parallel.
+#define VULKAN_MAX_RECORDING_THREADS 8
+
+// Below this many static mesh groups per thread, recording is faster on fewer threads than the cost of starting more.
+#define VULKAN_MIN_GROUPS_PER_RECORDING_THREAD 64
+
+// The most frames which may be in flight at once. Beyond this, latency grows with no gain in throughput.
+#define VULKAN_MAX_FRAMES_IN_FLIGHT 4
+
+// The number of frames whose times are counted before the frame time histogram is logged and cleared.
+#define VULKAN_FRAME_TIME_HISTOGRAM_FRAMES 1000
+
 namespace Epoch {
 
+    // The upper bound in milliseconds of each frame time histogram bucket, except the last, which holds all slower frames.
+    static const U64 frameTimeBucketBounds[] = { 4, 8, 12, 17, 25, 34, 50, 100 };
+    static const U32 frameTimeBucketCount = sizeof( frameTimeBucketBounds ) / sizeof( frameTimeBucketBounds[0] ) + 1;
+
     VulkanRendererBackend::VulkanRendererBackend( IApplication* application ) {
         _application = application;
         Logger::Trace( "Creating Vulkan renderer backend..." );
@@ -56,7 +84,7 @@ namespace Epoch {
         }
     }
 
-    const bool VulkanRendererBackend::Initialize( const bool enableValidation ) {
+    const bool VulkanRendererBackend::Initialize( const bool enableValidation, const U8 framesInFlight ) {
         _validationEnabled = enableValidation;
         Logger::Trace( "Initializing Vulkan renderer backend..." );
 
@@ -79,8 +107,16 @@ namespace Epoch {
         _device->FramebufferSize = applicationWindow->GetFramebufferExtent();
 
         // Create swapchain
+        U8 frameCount = framesInFlight;
+        if( frameCount == 0 ) {
+            frameCount = 1;
+        } else if( frameCount > VULKAN_MAX_FRAMES_IN_FLIGHT ) {
+            Logger::Warn( "%d frames in flight requested, but at most %d are supported.", frameCount, VULKAN_MAX_FRAMES_IN_FLIGHT );
+            frameCount = VULKAN_MAX_FRAMES_IN_FLIGHT;
+        }
         Extent2D extent = applicationWindow->GetFramebufferExtent();
-        _swapchain = new VulkanSwapchain( _device, _surface, applicationWindow->GetHandle(), extent.Width, extent.Height );
+        _swapchain = new VulkanSwapchain( _device, _surface, applicationWindow->GetHandle(), extent.Width, extent.Height, frameCount );
+        Logger::Trace( "Rendering with %d frames in flight.", frameCount );
 
         // Listen for resize events.
         Event::Listen( EventType::WINDOW_RESIZED, this );
@@ -89,12 +125,21 @@ namespace Epoch {
         createRenderPass();
         _swapchain->RegenerateFramebuffers();
 
-        // Built-in shader creation.
-        _unlitShader = new VulkanUnlitShader( _device, _swapchain->GetSwapchainImageCount(), "RenderPass.Default" );
+        // Built-in shader creation. Global uniforms are shared by all shaders, with a copy per frame in flight. Per-object data
+        // comes from the instance buffer, so there are no per-object uniforms.
+        _globalUniforms = new VulkanGlobalUniforms( _device, frameCount );
+        _unlitShader = new VulkanUnlitShader( _device, "RenderPass.Default", _globalUniforms );
+
+        // Without indirect draws, everything is culled on the CPU and recorded one group at a time.
+        if( _device->SupportsIndirectDraws ) {
+            _indirectDrawCuller = new VulkanIndirectDrawCuller( _device, frameCount );
+            Logger::Trace( "Static meshes are culled on the GPU%s.", _device->SupportsDrawIndirectCount ? ", with indirect draw counts" : "" );
+        }
 
         createBuffers();
-        createCommandBuffers();
-        createSyncObjects();
+        createFrameResources();
+
+        _frameTimeHistogram.resize( frameTimeBucketCount, 0 );
 
         return true;
     }
@@ -102,30 +147,24 @@ namespace Epoch {
     void VulkanRendererBackend::Shutdown() {
         _isShutDown = true;
         _device->WaitIdle();
+
+        // Materials are shut down after this, so anything they are still referenced by must be released now.
+        for( U64 i = 0; i < _frames.size(); ++i ) {
+            releaseDeferredResources( _frames[i] );
+        }
+
+        logFrameTimeHistogram();
     }
 
     void VulkanRendererBackend::Destroy() {
         _device->WaitIdle();
 
-        // sync objects
-        for( U8 i = 0; i < _swapchain->MaxFramesInFlight; ++i ) {
-            delete _imageAvailableSemaphores[i];
-            delete _renderCompleteSemaphores[i];
-
-            delete _inFlightFences[i];
-            _inFlightFences[i] = nullptr;
-            _inFlightImageFences[i] = nullptr;
-        }
-        _inFlightFences.clear();
-        _inFlightImageFences.clear();
-        _imageAvailableSemaphores.clear();
-        _renderCompleteSemaphores.clear();
+        destroyFrameResources();
 
-        U64 swapchainImageCount = _swapchain->GetSwapchainImageCount();
-        for( U64 i = 0; i < swapchainImageCount; ++i ) {
-            _device->CommandPool->FreeCommandBuffer( _commandBuffers[i] );
+        if( _indirectDrawCuller ) {
+            delete _indirectDrawCuller;
+            _indirectDrawCuller = nullptr;
         }
-        _commandBuffers.clear();
 
         if( _indexBuffer ) {
             delete _indexBuffer;
@@ -145,6 +184,11 @@ namespace Epoch {
             _unlitShader = nullptr;
         }
 
+        if( _globalUniforms ) {
+            delete _globalUniforms;
+            _globalUniforms = nullptr;
+        }
+
         if( _swapchain ) {
             delete _swapchain;
             _swapchain = nullptr;
@@ -183,100 +227,98 @@ namespace Epoch {
             return false;
         }
 
-        // Wait for the execution of the current frame to complete. The fence being free will allow this to move on.
-        if( !_inFlightFences[_swapchain->GetCurrentFrameIndex()]->Wait( U64_MAX ) ) {
+        // The first frame has no previous frame to measure from.
+        bool hasFrameTime = _frameClock.IsRunning();
+        U64 frameTimeMs = hasFrameTime ? _frameClock.GetTime() : 0;
+        _frameClock.Start();
+
+        // Wait for the GPU to finish the last frame which used this frame's resources. This is the only place the CPU waits
+        // on the GPU, and only blocks if it is a whole set of frames ahead.
+        _currentFrameIndex = _swapchain->GetCurrentFrameIndex();
+        VulkanFrameResources& frame = _frames[_currentFrameIndex];
+        Clock fenceWaitClock( true );
+        if( !frame.InFlightFence->Wait( U64_MAX ) ) {
             Logger::Warn( "In-flight fence wait failure!" );
         }
+        if( hasFrameTime ) {
+            recordFrameTime( frameTimeMs, fenceWaitClock.GetTime() );
+        }
+
+        // Reclaim anything finished with by now-completed uploads and frames.
+        _device->Uploader->Update();
+        releaseDeferredResources( frame );
 
         // Acquire next image from the swap chain.
-        if( !_swapchain->AcquireNextImageIndex( U64_MAX, _imageAvailableSemaphores[_swapchain->GetCurrentFrameIndex()], nullptr, &_currentImageIndex ) ) {
+        if( !_swapchain->AcquireNextImageIndex( U64_MAX, frame.ImageAvailableSemaphore, nullptr, &_currentImageIndex ) ) {
             return false;
         }
 
+        // The global uniform buffer of this frame is only written if the view or projection changed since it was last used.
+        updateViewProjection();
+        _globalUniforms->Update( _currentFrameIndex, _view, _projection, _viewProjectionVersion );
+
+        // All instance transforms for the frame are written at once, and materials are written before recording begins.
+        uploadInstanceTransforms( frame );
+        updateStaticMeshMaterials();
+
         // Begin recording.
-        VulkanCommandBuffer* currentCommandBuffer = _commandBuffers[_currentImageIndex];
+        VulkanCommandBuffer* currentCommandBuffer = frame.CommandBuffer;
         currentCommandBuffer->Reset();
         currentCommandBuffer->Begin();
 
+        // GPU-culled draws are written by a compute dispatch, which has to be recorded before the render pass begins. The
+        // objects are only uploaded to this frame's buffers if they changed since it was last used.
+        if( _useIndirectDraws ) {
+            _indirectDrawCuller->Update( _currentFrameIndex, _cullObjects.data(), (U32)_cullObjects.size(), (U32)_indirectDrawBatches.size(), _cullObjectsVersion );
+            _indirectDrawCuller->RecordCull( currentCommandBuffer, _currentFrameIndex, Frustum::FromViewProjection( _projection * _view ) );
+        }
+
         // Begin the render pass. TODO: Should probably create these once and reuse.
+        // Its contents are recorded into secondary command buffers, which may be recorded in parallel.
         VulkanRenderPass* renderPass = VulkanRenderPassManager::GetRenderPass( "RenderPass.Default" );
         RenderPassClearInfo clearInfo;
         clearInfo.Color.Set( 0.0f, 0.0f, 0.2f, 0.0f );
         clearInfo.RenderArea.Set( 0, 0, (F32)_swapchain->Extent.width, (F32)_swapchain->Extent.height );
         clearInfo.Depth = 1.0f;
         clearInfo.Stencil = 0;
-        currentCommandBuffer->BeginRenderPass( clearInfo, _swapchain->GetFramebuffer( _currentImageIndex ), renderPass );
-
-        // TEMP =======================================================================
-        // TODO: obtain from camera
-        Matrix4x4 view = Matrix4x4::LookAt( Vector3( 0.0f, 25.0f, 25.0f ), Vector3::Zero(), Vector3::Up() );
-        //Matrix4x4 view = Matrix4x4::LookAt( Vector3( 0.0f, 0.0f, 25.0f ), Vector3::Zero(), Vector3::Up() );
-
-        // TODO: obtain from private var, set only on change of camera/window
-        VkExtent2D extent = _swapchain->Extent;
-        Matrix4x4 projection = Matrix4x4::Perspective( TMath::DegToRad( 90.0f ), (F32)extent.width / (F32)extent.height, 0.1f, 1000.0f );
-        Matrix4x4 correction;
-        correction.Data()[0] = 1.0f;
-        correction.Data()[5] = -1.0f;
-        correction.Data()[10] = 0.5f;
-        correction.Data()[14] = 0.5f;
-        correction.Data()[15] = 1.0f;
-        projection *= correction;
-        // END TEMP ===================================================================
-
-        IShader* currentShader = nullptr;
-        if( _renderTable->StaticMeshCount > 0 ) {
-            StaticMeshRenderReferenceData* ref = static_cast<StaticMeshRenderReferenceData*>( _renderTable->StaticMeshes[0]->GetReferenceData() );
-            currentShader = ref->Material->GetShader();
-            currentShader->ResetDescriptors( _currentImageIndex );
-
-            // TODO: Don't create this every frame, save off locally
-            GlobalUniformObject guo;
-            guo.Projection = projection;
-            guo.View = view;
-            currentShader->SetGlobalUniform( currentCommandBuffer, guo, _currentImageIndex );
-        }
-
-        // Draw static meshes.        
-        for( U32 i = 0; i < _renderTable->StaticMeshCount; ++i ) {
-            StaticMeshEntityComponent* entity = _renderTable->StaticMeshes[i];
-            const StaticMeshRenderReferenceData* ref = static_cast<StaticMeshRenderReferenceData*>( entity->GetReferenceData() );
-            const VulkanBufferDataBlock* vertexBlock = _vertexBuffer->GetDataRangeByIndex( ref->VertexHeapIndex );
-            const VulkanBufferDataBlock* indexBlock = _indexBuffer->GetDataRangeByIndex( ref->IndexHeapIndex );
+        currentCommandBuffer->BeginRenderPass( clearInfo, _swapchain->GetFramebuffer( _currentImageIndex ), renderPass, true );
 
-            // Update the current descriptor set.
-            IShader* shader = ref->Material->GetShader();
-            if( shader != currentShader ) {
-                currentShader->ResetDescriptors( _currentImageIndex );
+        // Split the sorted groups into contiguous ranges, one per thread. Executing the ranges in order keeps the draw order.
+        U32 threadCount = ( _staticMeshGroupCount + VULKAN_MIN_GROUPS_PER_RECORDING_THREAD - 1 ) / VULKAN_MIN_GROUPS_PER_RECORDING_THREAD;
+        if( threadCount > (U32)_recordingCommandPools.size() ) {
+            threadCount = (U32)_recordingCommandPools.size();
+        }
+        _renderStateStats = RenderStateStats();
+        if( _useIndirectDraws ) {
 
-                // TODO: Don't create this every frame, save off locally
-                GlobalUniformObject guo;
-                guo.Projection = projection;
-                guo.View = view;
-                currentShader->SetGlobalUniform( currentCommandBuffer, guo, _currentImageIndex );
+            // A handful of commands per batch, whatever the number of objects, so recording on this thread is enough.
+            if( !_indirectDrawBatches.empty() ) {
+                recordIndirectDraws( frame.SecondaryCommandBuffers[0], renderPass, &_renderStateStats );
+                currentCommandBuffer->ExecuteCommands( frame.SecondaryCommandBuffers.data(), 1 );
+            }
+        } else if( threadCount > 0 ) {
+            std::vector<VulkanCommandBuffer*>& secondaryBuffers = frame.SecondaryCommandBuffers;
+            RenderStateStats threadStats[VULKAN_MAX_RECORDING_THREADS];
+            U32 chunkSize = ( _staticMeshGroupCount + threadCount - 1 ) / threadCount;
+
+            U32 groupCount = _staticMeshGroupCount;
+            _recordingWorkers->Run( threadCount, [this, &secondaryBuffers, &threadStats, renderPass, chunkSize, groupCount]( const U32 t ) {
+                U32 first = chunkSize * t;
+                U32 count = first + chunkSize > groupCount ? groupCount - first : chunkSize;
+                recordStaticMeshGroups( secondaryBuffers[t], renderPass, first, count, &threadStats[t] );
+            } );
+
+            for( U32 t = 0; t < threadCount; ++t ) {
+                _renderStateStats.DrawCalls += threadStats[t].DrawCalls;
+                _renderStateStats.PipelineBinds += threadStats[t].PipelineBinds;
+                _renderStateStats.DescriptorBinds += threadStats[t].DescriptorBinds;
+                _renderStateStats.MaterialBinds += threadStats[t].MaterialBinds;
+                _renderStateStats.VertexBufferBinds += threadStats[t].VertexBufferBinds;
+                _renderStateStats.IndexBufferBinds += threadStats[t].IndexBufferBinds;
+                _renderStateStats.RedundantBindsSkipped += threadStats[t].RedundantBindsSkipped;
             }
 
-            // Bind the buffer to the graphics pipeline
-            shader->BindPipeline( currentCommandBuffer );
-
-            shader->SetModel( *entity->GetWorldMatrix() );
-
-            // Update the descriptor for this object.
-            shader->UpdateDescriptor( currentCommandBuffer, _currentImageIndex, i, ref->Material );
-
-
-            shader->BindDescriptor( currentCommandBuffer, _currentImageIndex, i );
-
-            // Bind vertex buffer
-            _vertexBuffer->Bind( currentCommandBuffer, vertexBlock->Offset );
-
-            // Bind index buffer
-            _indexBuffer->Bind( currentCommandBuffer, indexBlock->Offset );
-
-            // Make the draw call.
-            //vkCmdDraw( _commandBuffers[imageIndex], 3, 1, 0, 0 );
-
-            vkCmdDrawIndexed( currentCommandBuffer->Handle, (U32)indexBlock->ElementCount, 1, 0, 0, 0 );
+            currentCommandBuffer->ExecuteCommands( secondaryBuffers.data(), threadCount );
         }
 
         // End render pass.
@@ -284,40 +326,46 @@ namespace Epoch {
 
         // End recording
         currentCommandBuffer->End();
+        _lastRecordedFrameIndex = _currentFrameIndex;
 
         return true;
     }
 
     const bool VulkanRendererBackend::Frame( const F32 deltaTime ) {
 
-        // Check if a previous frame is using this image (i.e. its fence is being waited on)
-        U8 swapchainFrameIndex = _swapchain->GetCurrentFrameIndex();
-        if( _inFlightImageFences[swapchainFrameIndex] != VK_NULL_HANDLE ) {
-            _inFlightImageFences[swapchainFrameIndex]->Wait( U64_MAX );
-        }
-
-        // Mark the image fence as in-use by this frame.
-        _inFlightImageFences[swapchainFrameIndex] = _inFlightFences[swapchainFrameIndex];
+        VulkanFrameResources& frame = _frames[_currentFrameIndex];
 
-        // Reset the fence for use on the next frame.
-        _inFlightImageFences[swapchainFrameIndex]->Reset();
+        // The fence was waited on in PrepareFrame, so it can be reset for this submission. Swapchain images need no fences of
+        // their own, as everything a frame writes to belongs to the frame rather than the image.
+        frame.InFlightFence->Reset();
 
         // Ensure that the operation cannot begin until the image is available.
-        _commandBuffers[_currentImageIndex]->AddWaitSemaphore( VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, _imageAvailableSemaphores[swapchainFrameIndex] );
+        frame.CommandBuffer->AddWaitSemaphore( VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, frame.ImageAvailableSemaphore );
 
-        // Submit the queue and wait for the operation to complete.
-        _device->GraphicsQueue->Submit( _commandBuffers[_currentImageIndex], _inFlightFences[swapchainFrameIndex], 1, &_renderCompleteSemaphores[swapchainFrameIndex]->Handle, false );
+        // Submit any pending uploads. Vertex input and shaders must not read uploaded data until they are complete, though
+        // anything before that can overlap with them.
+        if( _device->Uploader->Submit( frame.UploadCompleteSemaphore ) ) {
+            VkPipelineStageFlags uploadWaitStages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            frame.CommandBuffer->AddWaitSemaphore( uploadWaitStages, frame.UploadCompleteSemaphore );
+        }
+
+        // Buffers replaced by growing may still be read by earlier frames or by the uploads just submitted. This frame
+        // completes after both, so they are destroyed along with its other deferred resources.
+        _vertexBuffer->TakeRetiredBuffers( frame.RetiredBuffers );
+        _indexBuffer->TakeRetiredBuffers( frame.RetiredBuffers );
+
+        // Submit without waiting. The fence is waited on the next time this frame's resources are needed.
+        _device->GraphicsQueue->Submit( frame.CommandBuffer, frame.InFlightFence, 1, &frame.RenderCompleteSemaphore->Handle, false );
 
         // Give the image back to the swapchain.
-        _swapchain->Present( _device->GraphicsQueue, _device->PresentationQueue, _renderCompleteSemaphores[swapchainFrameIndex], _currentImageIndex );
+        _swapchain->Present( _device->GraphicsQueue, _device->PresentationQueue, frame.RenderCompleteSemaphore, _currentImageIndex );
 
         return true;
     }
 
     const bool VulkanRendererBackend::UploadMeshData( const MeshUploadData& data, StaticMeshRenderReferenceData* referenceData ) {
 
-        _device->GraphicsQueue->WaitIdle();
-
+        // Uploads are queued, and the next frame waits for them on the GPU.
         VulkanBufferDataBlock* vertBlock = _vertexBuffer->AllocateData( data.Vertices );
         VulkanBufferDataBlock* indexBlock = _indexBuffer->AllocateData( data.Indices );
 
@@ -329,18 +377,90 @@ namespace Epoch {
 
     void VulkanRendererBackend::FreeMeshData( StaticMeshRenderReferenceData* referenceData ) {
 
-        _device->WaitIdle();
+        // Frames already recorded may still be drawing this mesh. Frames complete in order, so its data is released once the
+        // last of them does.
+        VulkanDeferredMeshFree deferredFree;
+        deferredFree.VertexHeapIndex = referenceData->VertexHeapIndex;
+        deferredFree.IndexHeapIndex = referenceData->IndexHeapIndex;
+        deferredFree.MaterialName = referenceData->Material->Name;
+        _frames[_lastRecordedFrameIndex].DeferredMeshFrees.push_back( deferredFree );
+    }
+
+    void VulkanRendererBackend::SetStaticMeshInstances( const StaticMeshInstanceGroup* groups, const U32 groupCount, const Matrix4x4* instanceTransforms, const U32 instanceCount ) {
+        _staticMeshGroups = groups;
+        _staticMeshGroupCount = groupCount;
+        _instanceTransforms = instanceTransforms;
+        _instanceCount = instanceCount;
+        _useIndirectDraws = false;
+
+        // Set every frame, so always treated as new. 0 is never used, as it marks a buffer which has never been written.
+        _instanceVersion = _instanceVersion == U32_MAX ? 1 : _instanceVersion + 1;
+    }
+
+    void VulkanRendererBackend::SetStaticMeshObjects( const StaticMeshInstanceGroup* groups, const U32 groupCount, const Matrix4x4* instanceTransforms, const AABB* instanceBounds, const U32 instanceCount ) {
+        ASSERT_MSG( _indirectDrawCuller, "Static meshes can only be culled on the GPU if the device supports indirect draws." );
+        _staticMeshGroups = groups;
+        _staticMeshGroupCount = groupCount;
+        _instanceTransforms = instanceTransforms;
+        _instanceCount = instanceCount;
+        _useIndirectDraws = true;
+        _instanceVersion = _instanceVersion == U32_MAX ? 1 : _instanceVersion + 1;
+
+        // Each instance becomes an object drawn as its own first instance, so its transform is read from its own index.
+        // Meshes live in the shared vertex and index buffers, which are bound once, so each draw selects its mesh by offset.
+        _cullObjects.resize( instanceCount );
+        _indirectDrawBatches.clear();
+        U32 maxBatchObjects = _device->Properties.limits.maxDrawIndirectCount;
+        for( U32 g = 0; g < groupCount; ++g ) {
+            const StaticMeshInstanceGroup& group = groups[g];
+            StaticMeshRenderReferenceData* ref = group.ReferenceData;
+            const VulkanBufferDataBlock* vertexBlock = _vertexBuffer->GetDataRangeByIndex( ref->VertexHeapIndex );
+            const VulkanBufferDataBlock* indexBlock = _indexBuffer->GetDataRangeByIndex( ref->IndexHeapIndex );
+
+            U32 end = group.FirstInstance + group.InstanceCount;
+            for( U32 i = group.FirstInstance; i < end; ++i ) {
 
-        // Release the material reference.
-        MaterialManager::Release( referenceData->Material->Name );
+                // Groups arrive sorted by shader, then material, so a batch runs until the material changes or it is full.
+                if( _indirectDrawBatches.empty() || _indirectDrawBatches.back().Material != ref->Material || _indirectDrawBatches.back().ObjectCount == maxBatchObjects ) {
+                    VulkanIndirectDrawBatch batch;
+                    batch.Material = ref->Material;
+                    batch.FirstObject = i;
+                    _indirectDrawBatches.push_back( batch );
+                }
+                VulkanIndirectDrawBatch& batch = _indirectDrawBatches.back();
+                batch.ObjectCount++;
+
+                CullObjectShaderData& object = _cullObjects[i];
+                Vector3 center = instanceBounds[i].GetCenter();
+                Vector3 extent = instanceBounds[i].GetExtents();
+                object.Center[0] = center.X;
+                object.Center[1] = center.Y;
+                object.Center[2] = center.Z;
+                object.Extent[0] = extent.X;
+                object.Extent[1] = extent.Y;
+                object.Extent[2] = extent.Z;
+                object.FirstIndex = (U32)( indexBlock->Offset / sizeof( U32 ) );
+                object.IndexCount = (U32)indexBlock->ElementCount;
+                object.VertexOffset = (I32)( vertexBlock->Offset / sizeof( Vertex3D ) );
+                object.FirstCommand = batch.FirstObject;
+                object.BatchIndex = (U32)_indirectDrawBatches.size() - 1;
+                object.Reserved = 0;
+            }
+        }
+        _cullObjectsVersion = _cullObjectsVersion == U32_MAX ? 1 : _cullObjectsVersion + 1;
+    }
 
-        // Release buffer data by index.
-        _vertexBuffer->FreeDataRangeByIndex( referenceData->VertexHeapIndex );
-        _indexBuffer->FreeDataRangeByIndex( referenceData->VertexHeapIndex );
+    void VulkanRendererBackend::SetActiveCamera( CameraEntity* camera ) {
+        if( camera != _activeCamera ) {
+            _activeCamera = camera;
+            _viewProjectionDirty = true;
+        }
     }
 
-    void VulkanRendererBackend::SetRenderTable( WorldRenderableObjectTable* renderTable ) {
-        _renderTable = renderTable;
+    void VulkanRendererBackend::GetViewProjection( Matrix4x4* view, Matrix4x4* projection ) {
+        updateViewProjection();
+        *view = _view;
+        *projection = _projection;
     }
 
     void VulkanRendererBackend::OnEvent( const Event* event ) {
@@ -458,46 +578,73 @@ namespace Epoch {
         VulkanRenderPassManager::CreateRenderPass( _device, renderPassData );
     }
 
-    void VulkanRendererBackend::createCommandBuffers() {
-        U32 swapchainImageCount = _swapchain->GetSwapchainImageCount();
-        for( U32 i = 0; i < swapchainImageCount; ++i ) {
-            VulkanCommandBuffer* cmdBuf = _device->CommandPool->AllocateCommandBuffer( true );
-            _commandBuffers.push_back( cmdBuf );
+    void VulkanRendererBackend::createFrameResources() {
+        U32 threadCount = std::thread::hardware_concurrency();
+        if( threadCount == 0 ) {
+            threadCount = 1;
+        } else if( threadCount > VULKAN_MAX_RECORDING_THREADS ) {
+            threadCount = VULKAN_MAX_RECORDING_THREADS;
         }
-    }
-
-    void VulkanRendererBackend::createSyncObjects() {
-        U32 swapchainImageCount = _swapchain->GetSwapchainImageCount();
-        _imageAvailableSemaphores.resize( _swapchain->MaxFramesInFlight ); // _maxFramesInFlight
-        _renderCompleteSemaphores.resize( _swapchain->MaxFramesInFlight );
-        _inFlightFences.resize( _swapchain->MaxFramesInFlight );
+        for( U32 t = 0; t < threadCount; ++t ) {
+            _recordingCommandPools.push_back( new VulkanCommandPool( _device, _device->CommandPool->GetQueueFamilyIndex() ) );
+        }
+        _recordingWorkers = new WorkerPool( threadCount - 1 );
+
+        // Nothing in here depends on the swapchain, so it all lives until the backend is destroyed.
+        _frames.resize( _swapchain->MaxFramesInFlight );
+        for( U64 i = 0; i < _frames.size(); ++i ) {
+            VulkanFrameResources& frame = _frames[i];
+            frame.CommandBuffer = _device->CommandPool->AllocateCommandBuffer( true );
+            for( U64 t = 0; t < _recordingCommandPools.size(); ++t ) {
+                frame.SecondaryCommandBuffers.push_back( _recordingCommandPools[t]->AllocateCommandBuffer( false ) );
+            }
 
-        for( U8 i = 0; i < _swapchain->MaxFramesInFlight; ++i ) {
-            _imageAvailableSemaphores[i] = new VulkanSemaphore( _device );
-            _renderCompleteSemaphores[i] = new VulkanSemaphore( _device );
+            frame.ImageAvailableSemaphore = new VulkanSemaphore( _device );
+            frame.RenderCompleteSemaphore = new VulkanSemaphore( _device );
+            frame.UploadCompleteSemaphore = new VulkanSemaphore( _device );
 
             // Create the fence in a signaled state, indicating that the first frame has already been "rendered".
             // This will prevent the application from waiting indefinitely for the first frame to render since it
             // cannot be rendered until a frame is "rendered" before it.
-            _inFlightFences[i] = new VulkanFence( _device, true );
+            frame.InFlightFence = new VulkanFence( _device, true );
+        }
+    }
+
+    void VulkanRendererBackend::destroyFrameResources() {
+        for( U64 i = 0; i < _frames.size(); ++i ) {
+            VulkanFrameResources& frame = _frames[i];
+            releaseDeferredResources( frame );
+
+            _device->CommandPool->FreeCommandBuffer( frame.CommandBuffer );
+            for( U64 t = 0; t < frame.SecondaryCommandBuffers.size(); ++t ) {
+                _recordingCommandPools[t]->FreeCommandBuffer( frame.SecondaryCommandBuffers[t] );
+            }
+            frame.SecondaryCommandBuffers.clear();
+
+            delete frame.ImageAvailableSemaphore;
+            delete frame.RenderCompleteSemaphore;
+            delete frame.UploadCompleteSemaphore;
+            delete frame.InFlightFence;
+
+            if( frame.InstanceBuffer ) {
+                delete frame.InstanceBuffer;
+            }
         }
+        _frames.clear();
 
-        // In flight fences should not yet exist at this point, so clear the list.
-        _inFlightImageFences.resize( swapchainImageCount );
-        for( U64 i = 0; i < swapchainImageCount; ++i ) {
-            _inFlightImageFences[i] = nullptr;
+        if( _recordingWorkers ) {
+            delete _recordingWorkers;
+            _recordingWorkers = nullptr;
         }
+        for( U64 t = 0; t < _recordingCommandPools.size(); ++t ) {
+            delete _recordingCommandPools[t];
+        }
+        _recordingCommandPools.clear();
     }
 
     void VulkanRendererBackend::cleanupSwapchain() {
 
-        // Free the command buffers in the pool, but do not destroy the pool.
-        U32 swapchainImageCount = _swapchain->GetSwapchainImageCount();
-        for( U32 i = 0; i < swapchainImageCount; ++i ) {
-            _device->CommandPool->FreeCommandBuffer( _commandBuffers[i] );
-        }
-        _commandBuffers.clear();
-
+        // Command buffers belong to frames rather than swapchain images, so only the render pass needs recreating.
         VulkanRenderPassManager::DestroyRenderPass( _device, "RenderPass.Default" );
     }
 
@@ -521,21 +668,241 @@ namespace Epoch {
         createRenderPass();
         _swapchain->RegenerateFramebuffers();
 
-        createCommandBuffers();
-
         _recreatingSwapchain = false;
     }
 
+    void VulkanRendererBackend::uploadInstanceTransforms( VulkanFrameResources& frame ) {
+        if( frame.InstanceBufferVersion == _instanceVersion ) {
+            return;
+        }
+
+        // This frame's fence has signaled, so its instance buffer is no longer in use and can be replaced.
+        if( !frame.InstanceBuffer || frame.InstanceBufferCapacity < _instanceCount ) {
+            U32 capacity = frame.InstanceBufferCapacity > 0 ? frame.InstanceBufferCapacity : VULKAN_INITIAL_INSTANCE_CAPACITY;
+            while( capacity < _instanceCount ) {
+                capacity *= 2;
+            }
+            if( frame.InstanceBuffer ) {
+                delete frame.InstanceBuffer;
+            }
+            VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            frame.InstanceBuffer = new VulkanInternalBuffer( _device, sizeof( Matrix4x4 ) * (U64)capacity, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, flags );
+            frame.InstanceBufferCapacity = capacity;
+        }
+
+        if( _instanceCount > 0 ) {
+            U64 size = sizeof( Matrix4x4 ) * (U64)_instanceCount;
+            void* data = frame.InstanceBuffer->LockMemory( 0, size, 0 );
+            TMemory::Memcpy( data, _instanceTransforms, size );
+            frame.InstanceBuffer->UnlockMemory();
+        }
+    }
+
+    void VulkanRendererBackend::updateViewProjection() {
+        VkExtent2D extent = _swapchain->Extent;
+        bool extentChanged = extent.width != _viewProjectionExtent.width || extent.height != _viewProjectionExtent.height;
+        F32 aspectRatio = (F32)extent.width / (F32)extent.height;
+
+        if( _activeCamera ) {
+
+            // The camera tracks its own changes, so its version is all that needs comparing.
+            _activeCamera->SetAspectRatio( aspectRatio );
+            U32 cameraVersion = _activeCamera->GetVersion();
+            if( !_viewProjectionDirty && cameraVersion == _activeCameraVersion ) {
+                return;
+            }
+            _view = _activeCamera->GetViewMatrix();
+            _projection = _activeCamera->GetProjectionMatrix();
+            _activeCameraVersion = cameraVersion;
+        } else {
+            if( !_viewProjectionDirty && !extentChanged ) {
+                return;
+            }
+
+            // With no camera, fall back to a fixed view of the origin.
+            _view = Matrix4x4::LookAt( Vector3( 0.0f, 25.0f, 25.0f ), Vector3::Zero(), Vector3::Up() );
+            _projection = Matrix4x4::Perspective( TMath::DegToRad( 90.0f ), aspectRatio, 0.1f, 1000.0f );
+        }
+
+        // Flip Y and map depth from [-1, 1] to [0, 1] to match Vulkan's clip space.
+        Matrix4x4 correction;
+        correction.Data()[0] = 1.0f;
+        correction.Data()[5] = -1.0f;
+        correction.Data()[10] = 0.5f;
+        correction.Data()[14] = 0.5f;
+        correction.Data()[15] = 1.0f;
+        _projection *= correction;
+
+        _viewProjectionExtent = extent;
+        _viewProjectionDirty = false;
+        _viewProjectionVersion++;
+    }
+
+    void VulkanRendererBackend::updateStaticMeshMaterials() {
+
+        // Groups arrive sorted by shader, then material, so each material's entry in the material table is brought up to date once.
+        BaseMaterial* currentMaterial = nullptr;
+        for( U32 i = 0; i < _staticMeshGroupCount; ++i ) {
+            BaseMaterial* material = _staticMeshGroups[i].ReferenceData->Material;
+            if( material != currentMaterial ) {
+                currentMaterial = material;
+                currentMaterial->GetShader()->UpdateMaterial( currentMaterial );
+            }
+        }
+    }
+
+    void VulkanRendererBackend::recordStaticMeshGroups( VulkanCommandBuffer* commandBuffer, VulkanRenderPass* renderPass, const U32 firstGroup, const U32 groupCount, RenderStateStats* stats ) {
+        commandBuffer->BeginSecondary( renderPass, _swapchain->GetFramebuffer( _currentImageIndex ), true );
+
+        // Secondary buffers inherit no state, so everything is bound again at the start of each. All meshes share the vertex
+        // and index buffers, which are bound once, and each draw selects its mesh through its first index and vertex offset.
+        VkBuffer instanceBuffer = _frames[_currentFrameIndex].InstanceBuffer->GetHandle();
+        VkDeviceSize instanceBufferOffset = 0;
+        vkCmdBindVertexBuffers( commandBuffer->Handle, 1, 1, &instanceBuffer, &instanceBufferOffset );
+        _vertexBuffer->Bind( commandBuffer, 0 );
+        _indexBuffer->Bind( commandBuffer, 0 );
+        stats->VertexBufferBinds += 2;
+        stats->IndexBufferBinds++;
+
+        // Groups arrive sorted by shader, then material, then mesh, so each piece of state is only bound when it differs from what is already bound.
+        IShader* currentShader = nullptr;
+        BaseMaterial* currentMaterial = nullptr;
+        U32 end = firstGroup + groupCount;
+        for( U32 i = firstGroup; i < end; ++i ) {
+            const StaticMeshInstanceGroup& group = _staticMeshGroups[i];
+            StaticMeshRenderReferenceData* ref = group.ReferenceData;
+            const VulkanBufferDataBlock* vertexBlock = _vertexBuffer->GetDataRangeByIndex( ref->VertexHeapIndex );
+            const VulkanBufferDataBlock* indexBlock = _indexBuffer->GetDataRangeByIndex( ref->IndexHeapIndex );
+
+            // Bind the pipeline and descriptors when the shader changes. Textures are bindless, so descriptors are only bound per shader.
+            IShader* shader = ref->Material->GetShader();
+            if( shader != currentShader ) {
+                currentShader = shader;
+                currentMaterial = nullptr;
+                currentShader->BindPipeline( commandBuffer );
+                currentShader->BindDescriptor( commandBuffer, _currentFrameIndex );
+                stats->PipelineBinds++;
+                stats->DescriptorBinds++;
+            } else {
+                stats->RedundantBindsSkipped++;
+            }
+
+            // Select the material when it changes, which only pushes its index.
+            if( ref->Material != currentMaterial ) {
+                currentMaterial = ref->Material;
+                currentShader->BindMaterial( commandBuffer, currentMaterial );
+                stats->MaterialBinds++;
+            } else {
+                stats->RedundantBindsSkipped++;
+            }
+
+            // Make the draw call. Instance-rate input starts at firstInstance, so each group reads its own range of transforms.
+            // Blocks only ever hold elements of their buffer's type, so their offsets are always whole elements.
+            U32 firstIndex = (U32)( indexBlock->Offset / sizeof( U32 ) );
+            I32 vertexOffset = (I32)( vertexBlock->Offset / sizeof( Vertex3D ) );
+            vkCmdDrawIndexed( commandBuffer->Handle, (U32)indexBlock->ElementCount, group.InstanceCount, firstIndex, vertexOffset, group.FirstInstance );
+            stats->DrawCalls++;
+        }
+
+        commandBuffer->End();
+    }
+
+    void VulkanRendererBackend::recordIndirectDraws( VulkanCommandBuffer* commandBuffer, VulkanRenderPass* renderPass, RenderStateStats* stats ) {
+        commandBuffer->BeginSecondary( renderPass, _swapchain->GetFramebuffer( _currentImageIndex ), true );
+
+        // As with recordStaticMeshGroups, the shared vertex and index buffers are bound once.
+        VkBuffer instanceBuffer = _frames[_currentFrameIndex].InstanceBuffer->GetHandle();
+        VkDeviceSize instanceBufferOffset = 0;
+        vkCmdBindVertexBuffers( commandBuffer->Handle, 1, 1, &instanceBuffer, &instanceBufferOffset );
+        _vertexBuffer->Bind( commandBuffer, 0 );
+        _indexBuffer->Bind( commandBuffer, 0 );
+        stats->VertexBufferBinds += 2;
+        stats->IndexBufferBinds++;
+
+        IShader* currentShader = nullptr;
+        U32 batchCount = (U32)_indirectDrawBatches.size();
+        for( U32 i = 0; i < batchCount; ++i ) {
+            const VulkanIndirectDrawBatch& batch = _indirectDrawBatches[i];
+            IShader* shader = batch.Material->GetShader();
+            if( shader != currentShader ) {
+                currentShader = shader;
+                currentShader->BindPipeline( commandBuffer );
+                currentShader->BindDescriptor( commandBuffer, _currentFrameIndex );
+                stats->PipelineBinds++;
+                stats->DescriptorBinds++;
+            } else {
+                stats->RedundantBindsSkipped++;
+            }
+
+            // Each batch is a different material, unless a batch was split for being too large.
+            currentShader->BindMaterial( commandBuffer, batch.Material );
+            stats->MaterialBinds++;
+
+            _indirectDrawCuller->DrawBatch( commandBuffer, _currentFrameIndex, i, batch.FirstObject, batch.ObjectCount );
+            stats->DrawCalls++;
+        }
+
+        commandBuffer->End();
+    }
+
+    void VulkanRendererBackend::releaseDeferredResources( VulkanFrameResources& frame ) {
+        for( U64 i = 0; i < frame.DeferredMeshFrees.size(); ++i ) {
+            VulkanDeferredMeshFree& deferredFree = frame.DeferredMeshFrees[i];
+            MaterialManager::Release( deferredFree.MaterialName );
+            _vertexBuffer->FreeDataRangeByIndex( deferredFree.VertexHeapIndex );
+            _indexBuffer->FreeDataRangeByIndex( deferredFree.IndexHeapIndex );
+        }
+        frame.DeferredMeshFrees.clear();
+
+        for( U64 i = 0; i < frame.RetiredBuffers.size(); ++i ) {
+            delete frame.RetiredBuffers[i];
+        }
+        frame.RetiredBuffers.clear();
+    }
+
+    void VulkanRendererBackend::recordFrameTime( const U64 frameTimeMs, const U64 fenceWaitMs ) {
+        U32 bucket = 0;
+        while( bucket < frameTimeBucketCount - 1 && frameTimeMs > frameTimeBucketBounds[bucket] ) {
+            bucket++;
+        }
+        _frameTimeHistogram[bucket]++;
+        _frameTimeSampleCount++;
+        _fenceWaitTimeMs += fenceWaitMs;
+
+        if( _frameTimeSampleCount >= VULKAN_FRAME_TIME_HISTOGRAM_FRAMES ) {
+            logFrameTimeHistogram();
+        }
+    }
+
+    void VulkanRendererBackend::logFrameTimeHistogram() {
+        if( _frameTimeSampleCount == 0 ) {
+            return;
+        }
+
+        // Logged as one line per bucket, so a stutter shows up as counts away from the main bucket.
+        Logger::Log( "Frame times over the last %d frames, of which %llums was spent waiting on frames in flight:", _frameTimeSampleCount, _fenceWaitTimeMs );
+        for( U32 i = 0; i < frameTimeBucketCount; ++i ) {
+            if( i < frameTimeBucketCount - 1 ) {
+                Logger::Log( "  <= %llums: %d", frameTimeBucketBounds[i], _frameTimeHistogram[i] );
+            } else {
+                Logger::Log( "   > %llums: %d", frameTimeBucketBounds[i - 1], _frameTimeHistogram[i] );
+            }
+            _frameTimeHistogram[i] = 0;
+        }
+        _frameTimeSampleCount = 0;
+        _fenceWaitTimeMs = 0;
+    }
+
     void VulkanRendererBackend::createBuffers() {
 
         // Vertex buffer.
         _vertexBuffer = new VulkanVertex3DBuffer( _device );
-        // Allocate 128 MiB for the vertex buffer
+        // Allocate 128 MiB for the vertex buffer to start with. It grows if this runs out.
         _vertexBuffer->Allocate( 128 * 1024 * 1024 );
 
         // Index buffer.
         _indexBuffer = new VulkanIndexBuffer( _device );
-        // Allocate 32 MiB for the index buffer.
+        // Allocate 32 MiB for the index buffer to start with. It grows if this runs out.
         _indexBuffer->Allocate( 32 * 1024 * 1024 );
     }
 }
\ No newline at end of file
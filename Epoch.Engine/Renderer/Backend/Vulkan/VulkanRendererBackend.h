@@ -1,9 +1,12 @@
 #pragma once
 
 #include "../../../Types.h"
+#include "../../../String/TString.h"
 #include "../../../Events/IEventHandler.h"
 #include "../IRendererBackend.h"
 #include "../../../Resources/StaticMesh.h"
+#include "../../../Time/Clock.h"
+#include "../../UniformObject.h"
 
 #include <vector>
 #include <vulkan/vulkan.h>
@@ -12,14 +15,15 @@ namespace Epoch {
 
     struct MeshUploadData;
     struct StaticMeshRenderReferenceData;
-    struct WorldRenderableObjectTable;
 
     class ITexture;
     class TString;
     class IUnlitShader;
 
     class IApplication;
+    class WorkerPool;
     class VulkanVertex3DBuffer;
+    class VulkanInternalBuffer;
     class VulkanIndexBuffer;
     class VulkanImage;
     class VulkanTexture;
@@ -30,7 +34,63 @@ namespace Epoch {
     class VulkanFence;
     class VulkanSemaphore;
     class VulkanCommandBuffer;
+    class VulkanCommandPool;
+    class VulkanRenderPass;
+    class VulkanGlobalUniforms;
     class VulkanShader;
+    class VulkanIndirectDrawCuller;
+    class BaseMaterial;
+
+    /**
+     * Mesh data whose release has been requested, held until no frame in flight can still be reading it.
+     */
+    struct VulkanDeferredMeshFree {
+        U64 VertexHeapIndex;
+        U64 IndexHeapIndex;
+        TString MaterialName;
+    };
+
+    /**
+     * A range of objects culled on the GPU which share a material, and so are drawn with a single indirect draw.
+     */
+    struct VulkanIndirectDrawBatch {
+        BaseMaterial* Material = nullptr;
+        U32 FirstObject = 0;
+        U32 ObjectCount = 0;
+    };
+
+    /**
+     * Everything recorded into or read by a single frame in flight. The CPU only touches a frame's resources once its
+     * fence has signaled, so nothing in here ever needs to wait on the GPU.
+     */
+    struct VulkanFrameResources {
+        VulkanCommandBuffer* CommandBuffer = nullptr;
+
+        // One per recording thread.
+        std::vector<VulkanCommandBuffer*> SecondaryCommandBuffers;
+
+        VulkanSemaphore* ImageAvailableSemaphore = nullptr;
+        VulkanSemaphore* RenderCompleteSemaphore = nullptr;
+
+        // Signaled by the uploader once uploads are complete, and waited on by this frame if it is the first to read them.
+        VulkanSemaphore* UploadCompleteSemaphore = nullptr;
+
+        // Signaled when the GPU has finished this frame.
+        VulkanFence* InFlightFence = nullptr;
+
+        // Per-instance world matrices, read by the vertex shader as instance-rate input.
+        VulkanInternalBuffer* InstanceBuffer = nullptr;
+        U32 InstanceBufferCapacity = 0;
+
+        // The version of the instance transforms the instance buffer holds. Only rewritten when they change.
+        U32 InstanceBufferVersion = 0;
+
+        // Mesh data released after this frame was recorded, destroyed once its fence signals.
+        std::vector<VulkanDeferredMeshFree> DeferredMeshFrees;
+
+        // Vertex and index buffers replaced by growing before this frame was submitted, destroyed once its fence signals.
+        std::vector<VulkanInternalBuffer*> RetiredBuffers;
+    };
 
     /**
      * The Vulkan-specific renderer backend. Implements IRendererBackend and is called by the front-end via that interface.
@@ -70,10 +130,11 @@ namespace Epoch {
          * Initializes this renderer.
          *
          * @param enableValidation Indicates if validation should be enabled for this renderer. Has a high performance cost. Should only be used for debugging.
+         * @param framesInFlight The number of frames the CPU may record ahead of the GPU. More hides GPU stalls at the cost of latency.
          *
          * @returns True if successful; otherwise false.
          */
-        const bool Initialize( const bool enableValidation ) override;
+        const bool Initialize( const bool enableValidation, const U8 framesInFlight ) override;
 
         /**
          * Flags this renderer as shut down and begins the shutdown process. Must be invoked before Destroy or delete.
@@ -114,13 +175,24 @@ namespace Epoch {
         const bool UploadMeshData( const MeshUploadData& data, StaticMeshRenderReferenceData* referenceData ) override;
 
         /**
-         * Frees mesh data using the provided reference data.
+         * Frees mesh data using the provided reference data. The release is deferred until frames which may still be
+         * drawing the mesh have completed, so this never waits on the GPU.
          *
          * @param referenceData A pointer to the reference data object whose data should be released.
          */
         void FreeMeshData( StaticMeshRenderReferenceData* referenceData ) override;
 
-        void SetRenderTable( WorldRenderableObjectTable* renderTable ) override;
+        void SetStaticMeshInstances( const StaticMeshInstanceGroup* groups, const U32 groupCount, const Matrix4x4* instanceTransforms, const U32 instanceCount ) override;
+
+        const bool SupportsGpuCulling() const override { return _indirectDrawCuller != nullptr; }
+
+        void SetStaticMeshObjects( const StaticMeshInstanceGroup* groups, const U32 groupCount, const Matrix4x4* instanceTransforms, const AABB* instanceBounds, const U32 instanceCount ) override;
+
+        const RenderStateStats GetRenderStateStats() const override { return _renderStateStats; }
+
+        void SetActiveCamera( CameraEntity* camera ) override;
+
+        void GetViewProjection( Matrix4x4* view, Matrix4x4* projection ) override;
 
         /**
          * Processes the given event.
@@ -154,15 +226,43 @@ namespace Epoch {
     private:
         void createInstance();
         void createRenderPass();
-        void createCommandBuffers();
-        void createSyncObjects();
+        void createFrameResources();
+        void destroyFrameResources();
         void cleanupSwapchain();
         void recreateSwapchain();
         void createBuffers();
+
+        // Releases the mesh data and buffers deferred until the given frame completed. Its fence must have signaled.
+        void releaseDeferredResources( VulkanFrameResources& frame );
+
+        // Adds a frame time to the histogram, and logs the histogram once enough frames have been counted.
+        void recordFrameTime( const U64 frameTimeMs, const U64 fenceWaitMs );
+
+        // Logs and clears the frame time histogram.
+        void logFrameTimeHistogram();
+
+        // Recalculates the cached view and projection if the active camera or the swapchain extent has changed since they were last calculated.
+        void updateViewProjection();
+
+        // Writes this frame's instance transforms to the given frame's instance buffer, growing it if needed. Does nothing if
+        // the buffer already holds them.
+        void uploadInstanceTransforms( VulkanFrameResources& frame );
+
+        // Writes the material table entries used by this frame's static mesh groups. The material table may only be written by
+        // one thread at a time, so this is done on the main thread before any recording.
+        void updateStaticMeshMaterials();
+
+        // Records a range of this frame's static mesh groups into the given secondary command buffer. Safe to call from
+        // multiple threads at once, as long as each uses a buffer from its own command pool.
+        void recordStaticMeshGroups( VulkanCommandBuffer* commandBuffer, VulkanRenderPass* renderPass, const U32 firstGroup, const U32 groupCount, RenderStateStats* stats );
+
+        // Records one indirect draw per batch of GPU-culled objects into the given secondary command buffer.
+        void recordIndirectDraws( VulkanCommandBuffer* commandBuffer, VulkanRenderPass* renderPass, RenderStateStats* stats );
     private:
         bool _isShutDown = false;
         bool _validationEnabled;
         U32 _currentImageIndex = 0;
+        U8 _currentFrameIndex = 0;
         IApplication* _application = nullptr;
 
         std::vector<const char*> _requiredValidationLayers;
@@ -183,19 +283,58 @@ namespace Epoch {
         bool _recreatingSwapchain = false;
         bool _framebufferResizeOccurred = false;
 
-        // Command buffers, 1 per frame
-        std::vector<VulkanCommandBuffer*> _commandBuffers;
+        // One set per frame in flight, used in turn.
+        std::vector<VulkanFrameResources> _frames;
+
+        // The frame most recently recorded, which mesh data released from now on may still be drawn by.
+        U8 _lastRecordedFrameIndex = 0;
+
+        // One command pool per recording thread, as a pool may only be used by one thread at a time.
+        std::vector<VulkanCommandPool*> _recordingCommandPools;
+
+        // Records into all but the first of the pools above, while the render thread records into the first.
+        WorkerPool* _recordingWorkers = nullptr;
+
+        // View/projection data shared by all shaders, written at most once per frame in flight each time it changes.
+        VulkanGlobalUniforms* _globalUniforms = nullptr;
 
-        // Sync objects
-        std::vector<VulkanSemaphore*> _imageAvailableSemaphores;
-        std::vector<VulkanSemaphore*> _renderCompleteSemaphores;
-        std::vector<VulkanFence*> _inFlightFences;
-        std::vector<VulkanFence*> _inFlightImageFences;
+        // The camera rendered from, and the view and projection last calculated. The version changes whenever they do.
+        CameraEntity* _activeCamera = nullptr;
+        U32 _activeCameraVersion = 0;
+        bool _viewProjectionDirty = true;
+        VkExtent2D _viewProjectionExtent = {};
+        Matrix4x4 _view;
+        Matrix4x4 _projection;
+        U32 _viewProjectionVersion = 0;
+
+        // Time between frames, bucketed to show pacing, and the part of it spent waiting on frame fences.
+        Clock _frameClock{ false };
+        std::vector<U32> _frameTimeHistogram;
+        U32 _frameTimeSampleCount = 0;
+        U64 _fenceWaitTimeMs = 0;
 
         // Buffers
         VulkanVertex3DBuffer* _vertexBuffer = nullptr;
         VulkanIndexBuffer* _indexBuffer = nullptr;
 
-        WorldRenderableObjectTable* _renderTable;
+        // Static mesh instances to be drawn in the next frame. Owned by the front end.
+        const StaticMeshInstanceGroup* _staticMeshGroups = nullptr;
+        U32 _staticMeshGroupCount = 0;
+        const Matrix4x4* _instanceTransforms = nullptr;
+        U32 _instanceCount = 0;
+        U32 _instanceVersion = 0;
+
+        // Culls objects and writes their draws on the GPU. Only created if the device supports indirect draws.
+        VulkanIndirectDrawCuller* _indirectDrawCuller = nullptr;
+
+        // Set while static meshes are culled and drawn on the GPU rather than recorded one group at a time.
+        bool _useIndirectDraws = false;
+
+        // Every static mesh as read by the culling shader, the batches they are drawn in, and a version which changes with them.
+        std::vector<CullObjectShaderData> _cullObjects;
+        std::vector<VulkanIndirectDrawBatch> _indirectDrawBatches;
+        U32 _cullObjectsVersion = 0;
+
+        RenderStateStats _renderStateStats;
     };
-}
+}
\ No newline at end of file
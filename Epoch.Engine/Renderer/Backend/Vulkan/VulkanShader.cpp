@@ -1,6 +1,5 @@
 
-#include "../../../String/StringUtilities.h"
-#include "../../../Platform/FileHelper.h"
+#include "../../../Logger.h"
 #include "../../../Events/Event.h"
 #include "../../Material.h"
 #include "../../../Resources/ITexture.h"
@@ -8,11 +7,14 @@
 #include "VulkanRenderPassManager.h"
 #include "VulkanBuffer.h"
 #include "VulkanImage.h"
-#include "VulkanTextureSampler.h"
 #include "VulkanCommandBuffer.h"
 #include "VulkanUtilities.h"
 #include "VulkanDevice.h"
 #include "VulkanPipeline.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanGlobalUniforms.h"
+#include "VulkanBindlessResources.h"
+#include "VulkanShaderLibrary.h"
 #include "VulkanShader.h"
 
 namespace Epoch {
@@ -20,33 +22,28 @@ namespace Epoch {
         _device = device;
         _name = name;
 
-        const char* shaderType;
         VkShaderStageFlagBits stage;
         switch( type ) {
         default:
         case ShaderType::Vertex:
-            shaderType = "vert";
             stage = VK_SHADER_STAGE_VERTEX_BIT;
             break;
         case ShaderType::Fragment:
-            shaderType = "frag";
             stage = VK_SHADER_STAGE_FRAGMENT_BIT;
             break;
         case ShaderType::Geometry:
-            shaderType = "geom";
             stage = VK_SHADER_STAGE_GEOMETRY_BIT;
             break;
         case ShaderType::Compute:
-            shaderType = "comp";
             stage = VK_SHADER_STAGE_COMPUTE_BIT;
             break;
         }
 
-        // TODO: Should probably have this path be configurable.
-        const char* fileName = StringUtilities::Format( "shaders/%s.%s.spv", name, shaderType );
-        VkShaderModuleCreateInfo shaderCreateInfo = { VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
-        shaderCreateInfo.pCode = (U32*)FileHelper::ReadFileBinaryToArray( fileName, &shaderCreateInfo.codeSize );
-        VK_CHECK( vkCreateShaderModule( _device->LogicalDevice, &shaderCreateInfo, nullptr, &_handle ) );
+        _module = _device->ShaderLibrary->GetModule( name, type );
+        if( !_module ) {
+            Logger::Fatal( "Unable to load shader module for '%s'.", name );
+        }
+        _handle = _module->Handle;
 
         // Create shader stage info.
         _shaderStageCreateInfo = { VkStructureType::VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
@@ -56,20 +53,23 @@ namespace Epoch {
     }
 
     VulkanShaderModule::~VulkanShaderModule() {
-        if( _handle ) {
-            vkDestroyShaderModule( _device->LogicalDevice, _handle, nullptr );
-            _handle = nullptr;
-        }
 
+        // The module is owned by the shader library, which destroys it on shutdown.
+        _handle = nullptr;
+        _module = nullptr;
         _device = nullptr;
     }
 
-    VulkanShader::VulkanShader( VulkanDevice* device, const char* name, const U32 imageCount, const TString& renderPassName,
+    const std::vector<ShaderBinding>& VulkanShaderModule::GetBindings() const {
+        return _module->Bindings;
+    }
+
+    VulkanShader::VulkanShader( VulkanDevice* device, const char* name, const TString& renderPassName, VulkanGlobalUniforms* globalUniforms,
         const bool hasVertex, const bool hasFragment, const bool hasGeometry, const bool hasCompute ) {
 
         _device = device;
-        _imageCount = imageCount;
         _renderPassName = renderPassName;
+        _globalUniforms = globalUniforms;
 
         if( hasVertex ) {
             _vertexModule = new VulkanShaderModule( device, name, ShaderType::Vertex );
@@ -89,86 +89,13 @@ namespace Epoch {
     }
 
     VulkanShader::~VulkanShader() {
-        for( U32 i = 0; i < _imageCount; ++i ) {
-            if( _globalUniformBuffers[i] ) {
-                delete _globalUniformBuffers[i];
-                _globalUniformBuffers[i] = nullptr;
-            }
-
-            if( _objectUniformBuffers[i] ) {
-                delete _objectUniformBuffers[i];
-                _objectUniformBuffers[i] = nullptr;
-            }
-        }
-
-        // Free global UBOs
-        for( U32 i = 0; i < _globalUBOCount; ++i ) {
-            if( _globalUniformBuffers[i] ) {
-                delete _globalUniformBuffers[i];
-                _globalUniformBuffers[i] = nullptr;
-            }
-        }
-        TMemory::Free( _globalUniformBuffers );
-        TMemory::Free( _globalUbos );
-
-        // Free object UBOs
-        for( U32 i = 0; i < _objectUBOCount; ++i ) {
-            if( _objectUniformBuffers[i] ) {
-                delete _objectUniformBuffers[i];
-                _objectUniformBuffers[i] = nullptr;
-            }
-        }
-        TMemory::Free( _objectUniformBuffers );
-        TMemory::Free( _objectUbos );
-
         destroyPipeline();
 
-        for( U32 i = 0; i < _imageCount; ++i ) {
-            if( _textureSamplers[i] ) {
-                delete _textureSamplers[i];
-                _textureSamplers[i] = nullptr;
-            }
-        }
-        TMemory::Free( _textureSamplers );
-        _textureSamplerCount = 0;
-
-        for( U32 i = 0; i < _imageCount; ++i ) {
-            if( _globalDescriptorPools[i] ) {
-                vkDestroyDescriptorPool( _device->LogicalDevice, _globalDescriptorPools[i], nullptr );
-                _globalDescriptorPools[i] = nullptr;
-            }
-
-            if( _objectDescriptorPools[i] ) {
-                vkDestroyDescriptorPool( _device->LogicalDevice, _objectDescriptorPools[i], nullptr );
-                _objectDescriptorPools[i] = nullptr;
-            }
-        }
-
-        // Free global descriptor pools.
-        _globalDescriptorPoolCount = 0;
-        _globalDescriptorSetFrameCount = 0;
-        TMemory::Free( _globalDescriptorPools );
-        TMemory::Free( _globalDescriptorSets );
-
-        // Free object descriptor pools.
-        _objectDescriptorPoolCount = 0;
-        TMemory::Free( _objectDescriptorPools );
-        for( U32 i = 0; i < _objectDescriptorSetFrameCount; ++i ) {
-            TMemory::Free( _objectDescriptorSets[i] );
-        }
-        TMemory::Free( _objectDescriptorSets );
-        _objectDescriptorSetFrameCount = 0;
-        _objectDescriptorSetObjectCount = 0;
-
-        if( _globalDescriptorSetLayout ) {
-            vkDestroyDescriptorSetLayout( _device->LogicalDevice, _globalDescriptorSetLayout, nullptr );
-            _globalDescriptorSetLayout = nullptr;
-        }
-
-        if( _objectDescriptorSetLayout ) {
-            vkDestroyDescriptorSetLayout( _device->LogicalDevice, _objectDescriptorSetLayout, nullptr );
-            _objectDescriptorSetLayout = nullptr;
+        // Materials are normally released before their shader. Free the entries of any that were not.
+        for( auto entry = _materialEntries.begin(); entry != _materialEntries.end(); ++entry ) {
+            _device->BindlessResources->RemoveMaterial( entry->second.Index );
         }
+        _materialEntries.clear();
 
         if( _vertexModule ) {
             delete _vertexModule;
@@ -202,100 +129,63 @@ namespace Epoch {
         }
     }
 
-
-    void VulkanShader::SetGlobalUniform( ICommandBuffer* commandBuffer, const GlobalUniformObject& uniform, const U32 frameIndex ) {
-        // may need to:
-        // bind pipeline
-
-        // need to:
-        // alloc desc
-        VkDescriptorSetAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.pNext = nullptr;
-        allocInfo.descriptorPool = _globalDescriptorPools[frameIndex];
-        allocInfo.descriptorSetCount = 1;
-        allocInfo.pSetLayouts = &_globalDescriptorSetLayout;
-
-        VK_CHECK( vkAllocateDescriptorSets( _device->LogicalDevice, &allocInfo, &_globalDescriptorSets[frameIndex] ) );
-
-        // Configure the descriptors for the given index.
-        U32 range = sizeof( GlobalUniformObject ); // nvidia cards require 256-byte alignment
-        U64 offset = 0;// range* (U64)frameIndex;
-
-        VkDescriptorBufferInfo bufferInfo = {};
-        bufferInfo.buffer = _globalUniformBuffers[frameIndex]->GetHandle();// static_cast<VulkanUniformBuffer*>( uniformBuffer )->GetHandle();
-        bufferInfo.offset = offset;
-        bufferInfo.range = range;
-
-        // Perform the ubo update.
-        _globalUbos[frameIndex].Projection = uniform.Projection;
-        _globalUbos[frameIndex].View = uniform.View;
-
-        // Copy
-        void* data = _globalUniformBuffers[frameIndex]->GetInternal()->LockMemory( offset, range, 0 );
-        TMemory::Memcpy( data, &_globalUbos[frameIndex], sizeof( GlobalUniformObject ) );
-        _globalUniformBuffers[frameIndex]->GetInternal()->UnlockMemory();
-
-        VkWriteDescriptorSet descriptorWrite = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
-        descriptorWrite.dstSet = _globalDescriptorSets[frameIndex];
-        descriptorWrite.dstBinding = 0;
-        descriptorWrite.dstArrayElement = 0;
-        descriptorWrite.pNext = nullptr;
-        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptorWrite.descriptorCount = 1;
-        descriptorWrite.pBufferInfo = &bufferInfo;
-
-        vkUpdateDescriptorSets( _device->LogicalDevice, 1, &descriptorWrite, 0, nullptr );
-    }
-
-    void VulkanShader::SetModel( const Matrix4x4& model ) {
-        _model = model;
-    }
-
-    void VulkanShader::ResetDescriptors( const U32 frameIndex ) {
-        VK_CHECK( vkResetDescriptorPool( _device->LogicalDevice, _globalDescriptorPools[frameIndex], 0 ) );
-        VK_CHECK( vkResetDescriptorPool( _device->LogicalDevice, _objectDescriptorPools[frameIndex], 0 ) );
-    }
-
     void VulkanShader::BindPipeline( ICommandBuffer* commandBuffer ) {
         _graphicsPipeline->Bind( static_cast<VulkanCommandBuffer*>( commandBuffer ) );
     }
 
-    void VulkanShader::UpdateDescriptor( ICommandBuffer* commandBuffer, const U32 frameIndex, const U32 objectIndex, BaseMaterial* material ) {
+    void VulkanShader::UpdateMaterial( BaseMaterial* material ) {
+        auto entry = _materialEntries.find( material );
+        bool isNew = entry == _materialEntries.end();
+        if( isNew ) {
+            VulkanMaterialEntry newEntry;
+            newEntry.Index = _device->BindlessResources->AddMaterial();
+            if( newEntry.Index == U32_MAX ) {
+                Logger::Fatal( "Failed to add material '%s' to the material table.", material->Name.CStr() );
+            }
+            entry = _materialEntries.emplace( material, newEntry ).first;
+        }
 
-        VkDescriptorSetAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.pNext = nullptr;
-        allocInfo.descriptorPool = _objectDescriptorPools[frameIndex];
-        allocInfo.descriptorSetCount = 1;
-        allocInfo.pSetLayouts = &_objectDescriptorSetLayout;
+        // Only write the entry if it is new, or if the material has changed since it was written.
+        MaterialShaderData data = {};
+        getMaterialShaderData( material, &data );
+        if( !isNew && TMemory::Memcmp( &data, &entry->second.Data, sizeof( MaterialShaderData ) ) == 0 ) {
+            return;
+        }
+        entry->second.Data = data;
+        _device->BindlessResources->UpdateMaterial( entry->second.Index, data );
+    }
+
+    void VulkanShader::ReleaseMaterial( BaseMaterial* material ) {
 
-        VK_CHECK( vkAllocateDescriptorSets( _device->LogicalDevice, &allocInfo, &_objectDescriptorSets[frameIndex][objectIndex] ) );
+        // The material is only destroyed once no frame can be using it, so its entry is free to be reused.
+        auto entry = _materialEntries.find( material );
+        if( entry != _materialEntries.end() ) {
+            _device->BindlessResources->RemoveMaterial( entry->second.Index );
+            _materialEntries.erase( entry );
+        }
     }
 
-    void VulkanShader::BindDescriptor( ICommandBuffer* commandBuffer, const U32 frameIndex, const U32 objectIndex ) {
-        //vkCmdBindDescriptorSets( static_cast<VulkanCommandBuffer*>( commandBuffer )->GetHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, _graphicsPipeline->GetLayout(), 0, 1, &_objectDescriptorSets[frameIndex][objectIndex], 0, nullptr );
+    void VulkanShader::BindDescriptor( ICommandBuffer* commandBuffer, const U32 frameIndex ) {
 
+        // Per-object data comes from the instance buffer and per-material data from the material table, so the global and
+        // bindless sets are all there is to bind.
         VkDescriptorSet descriptorSets[2];
-        descriptorSets[0] = _globalDescriptorSets[frameIndex];
-        descriptorSets[1] = _objectDescriptorSets[frameIndex][objectIndex];
-
+        descriptorSets[0] = _globalUniforms->GetDescriptorSet( frameIndex );
+        descriptorSets[1] = _device->BindlessResources->GetDescriptorSet();
         vkCmdBindDescriptorSets( static_cast<VulkanCommandBuffer*>( commandBuffer )->Handle, VK_PIPELINE_BIND_POINT_GRAPHICS, _graphicsPipeline->GetLayout(),
             0, 2, descriptorSets, 0, nullptr );
+    }
 
-        /*vkCmdBindDescriptorSets( static_cast<VulkanCommandBuffer*>( commandBuffer )->GetHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, _graphicsPipeline->GetLayout(),
-            0, 1, &descriptorSets[0], 0, nullptr );
+    void VulkanShader::BindMaterial( ICommandBuffer* commandBuffer, BaseMaterial* material ) {
 
-        vkCmdBindDescriptorSets( static_cast<VulkanCommandBuffer*>( commandBuffer )->GetHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, _graphicsPipeline->GetLayout(),
-            0, 1, &descriptorSets[1], 0, nullptr );*/
+        // Only read here, as recording threads call this at the same time. Entries are added by UpdateMaterial beforehand.
+        U32 materialIndex = _materialEntries.at( material ).Index;
+        vkCmdPushConstants( static_cast<VulkanCommandBuffer*>( commandBuffer )->Handle, _graphicsPipeline->GetLayout(), VK_SHADER_STAGE_FRAGMENT_BIT,
+            0, sizeof( U32 ), &materialIndex );
     }
 
     void VulkanShader::intialize() {
-        createDescriptorSetLayout();
-        createDescriptorPools();
-        createTextureSamplers();
         createPipeline( _device->FramebufferSize );
-        createUniformBuffers();
 
         // Listen for resize events.
         Event::Listen( EventType::WINDOW_RESIZED, this );
@@ -303,7 +193,7 @@ namespace Epoch {
 
     void VulkanShader::destroyPipeline() {
         if( _graphicsPipeline ) {
-            delete _graphicsPipeline;
+            _device->PipelineCache->ReleaseGraphicsPipeline( _graphicsPipeline );
             _graphicsPipeline = nullptr;
         }
     }
@@ -312,187 +202,33 @@ namespace Epoch {
     // ///////////////////////////////////// Unlit Shader /////////////////////////////////////
     // ////////////////////////////////////////////////////////////////////////////////////////
 
-    VulkanUnlitShader::VulkanUnlitShader( VulkanDevice* device, const U32 imageCount, const TString& renderPassName ) :
-        VulkanShader( device, BUILTIN_SHADER_NAME_UNLIT, imageCount, renderPassName, true, true, false, false ) {
+    VulkanUnlitShader::VulkanUnlitShader( VulkanDevice* device, const TString& renderPassName, VulkanGlobalUniforms* globalUniforms ) :
+        VulkanShader( device, BUILTIN_SHADER_NAME_UNLIT, renderPassName, globalUniforms, true, true, false, false ) {
 
         intialize();
     }
 
-    void VulkanUnlitShader::UpdateDescriptor( ICommandBuffer* commandBuffer, const U32 frameIndex, const U32 objectIndex, BaseMaterial* material ) {
-
-        VulkanShader::UpdateDescriptor( commandBuffer, frameIndex, objectIndex, material );
-
-        // Configure the descriptors for the given index.
-        U32 range = sizeof( UnlitUniformObject ); // nvidia cards require 256-byte alignment
-        U64 offset = range * (U64)objectIndex;
-
-        VkDescriptorBufferInfo bufferInfo = {};
-        bufferInfo.buffer = _objectUniformBuffers[frameIndex]->GetHandle();// static_cast<VulkanUniformBuffer*>( uniformBuffer )->GetHandle();
-        bufferInfo.offset = offset;
-        bufferInfo.range = range;
-
-        // Perform the ubo update.
-        _objectUbos[frameIndex].Model = _model;
-
-        // Copy
-        void* data = _objectUniformBuffers[frameIndex]->GetInternal()->LockMemory( offset, range, 0 );
-        TMemory::Memcpy( data, &_objectUbos[frameIndex], sizeof( UnlitUniformObject ) );
-        _objectUniformBuffers[frameIndex]->GetInternal()->UnlockMemory();
-
-        // Map images to samplers
+    void VulkanUnlitShader::getMaterialShaderData( BaseMaterial* material, MaterialShaderData* outData ) {
         UnlitMaterial* castMaterial = static_cast<UnlitMaterial*>( material );
-        VulkanImage* diffuseImage = static_cast<VulkanImage*>( castMaterial->DiffuseMap->GetImage() );
-        VkDescriptorImageInfo imageInfo = {};
-        if( diffuseImage != nullptr ) {
-            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageInfo.imageView = diffuseImage->GetView();
-            imageInfo.sampler = _textureSamplers[frameIndex]->GetHandle();
-        }
-
-        VkWriteDescriptorSet descriptorWrites[2];
-        descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[0].dstSet = _objectDescriptorSets[frameIndex][objectIndex];
-        descriptorWrites[0].dstBinding = 0;
-        descriptorWrites[0].dstArrayElement = 0;
-        descriptorWrites[0].pNext = nullptr;
-        descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptorWrites[0].descriptorCount = 1;
-        descriptorWrites[0].pBufferInfo = &bufferInfo;
-
-        // Diffuse sampler.
-        descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[1].dstSet = _objectDescriptorSets[frameIndex][objectIndex];
-        descriptorWrites[1].dstBinding = 1;
-        descriptorWrites[1].dstArrayElement = 0;
-        descriptorWrites[1].pNext = nullptr;
-        descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        descriptorWrites[1].descriptorCount = 1;
-        if( diffuseImage != nullptr ) {
-            descriptorWrites[1].pImageInfo = &imageInfo;
-        } else {
-            descriptorWrites[1].pImageInfo = nullptr;
-        }
 
-        vkUpdateDescriptorSets( _device->LogicalDevice, 2, &descriptorWrites[0], 0, nullptr );
-    }
-
-    void VulkanUnlitShader::createDescriptorSetLayout() {
-
-        // GLOBAL LAYOUT
-        VkDescriptorSetLayoutBinding globalUboLayoutBinding = {};
-        globalUboLayoutBinding.binding = 0;
-        globalUboLayoutBinding.descriptorCount = 1;
-        globalUboLayoutBinding.descriptorType = VkDescriptorType::VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        globalUboLayoutBinding.pImmutableSamplers = nullptr;
-        globalUboLayoutBinding.stageFlags = VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT;
-
-        VkDescriptorSetLayoutCreateInfo globalLayoutInfo = {};
-        globalLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-        globalLayoutInfo.bindingCount = 1;
-        globalLayoutInfo.pBindings = &globalUboLayoutBinding;
-        VK_CHECK( vkCreateDescriptorSetLayout( _device->LogicalDevice, &globalLayoutInfo, nullptr, &_globalDescriptorSetLayout ) );
-
-        // PER-OBJECT LAYOUT -------------------------------------------------------
-
-        // Layout specific to this shader.
-        VkDescriptorSetLayoutBinding objectUboLayoutBinding = {};
-        objectUboLayoutBinding.binding = 0;
-        objectUboLayoutBinding.descriptorCount = 1;
-        objectUboLayoutBinding.descriptorType = VkDescriptorType::VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        objectUboLayoutBinding.pImmutableSamplers = nullptr;
-        objectUboLayoutBinding.stageFlags = VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT;
-
-        VkDescriptorSetLayoutBinding samplerLayoutBinding = {};
-        samplerLayoutBinding.binding = 1;
-        samplerLayoutBinding.descriptorCount = 1;
-        samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        samplerLayoutBinding.pImmutableSamplers = nullptr;
-        samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-
-        const U32 bindingCount = 2;
-        VkDescriptorSetLayoutBinding bindings[bindingCount] = {
-            objectUboLayoutBinding,
-            samplerLayoutBinding
-        };
-
-        VkDescriptorSetLayoutCreateInfo layoutInfo = {};
-        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-        layoutInfo.bindingCount = bindingCount;
-        layoutInfo.pBindings = bindings;
-        VK_CHECK( vkCreateDescriptorSetLayout( _device->LogicalDevice, &layoutInfo, nullptr, &_objectDescriptorSetLayout ) );
-    }
-
-    void VulkanUnlitShader::createDescriptorPools() {
-
-        // GLOBAL
-        // The first section will be used for uniform buffers
-        VkDescriptorPoolSize poolSize;
-        poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        poolSize.descriptorCount = _imageCount;
-
-        VkDescriptorPoolCreateInfo globalPoolInfo = {};
-        globalPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        globalPoolInfo.poolSizeCount = 1;
-        globalPoolInfo.pPoolSizes = &poolSize;
-        globalPoolInfo.maxSets = _imageCount;
-
-        // Global descriptor pool: Used for global items such as view/projection matrix. Create one pool per frame (double/triple).
-        _globalDescriptorPoolCount = _imageCount;
-        _globalDescriptorPools = static_cast<VkDescriptorPool*>( TMemory::Allocate( sizeof( VkDescriptorPool ) * _globalDescriptorPoolCount ) );
-
-        // Global descriptor set: Reserve memory for one descriptor set per frame.
-        _globalDescriptorSetFrameCount = _imageCount;
-        _globalDescriptorSets = static_cast<VkDescriptorSet*>( TMemory::Allocate( sizeof( VkDescriptorSet ) * _globalDescriptorSetFrameCount ) );
-
-        for( U32 i = 0; i < _imageCount; ++i ) {
-            VK_CHECK( vkCreateDescriptorPool( _device->LogicalDevice, &globalPoolInfo, nullptr, &_globalDescriptorPools[i] ) );
-        }
-
-        // PER-OBJECT
-        const U32 poolSizeCount = 2;
-        VkDescriptorPoolSize poolSizes[poolSizeCount];
-
-        // The first section will be used for uniform buffers
-        poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        poolSizes[0].descriptorCount = VULKAN_MAX_UNIFORM_BUFFERS;
-
-        // The second section will be used for image samplers.
-        poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        poolSizes[1].descriptorCount = VULKAN_MAX_IMAGE_SAMPLERS;
-
-        VkDescriptorPoolCreateInfo poolInfo = {};
-        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        poolInfo.poolSizeCount = poolSizeCount;
-        poolInfo.pPoolSizes = poolSizes;
-        poolInfo.maxSets = VULKAN_MAX_DESC_SETS;
-
-        // Create a pool per frame (double/triple).
-        _objectDescriptorPoolCount = _imageCount;
-        _objectDescriptorPools = static_cast<VkDescriptorPool*>( TMemory::Allocate( sizeof( VkDescriptorPool ) * _objectDescriptorPoolCount ) );
-
-        _objectDescriptorSetFrameCount = _imageCount;
-        _objectDescriptorSets = static_cast<VkDescriptorSet**>( TMemory::Allocate( sizeof( VkDescriptorSet* ) * _objectDescriptorSetFrameCount ) );
-        for( U32 i = 0; i < _imageCount; ++i ) {
-            _objectDescriptorSetObjectCount = VULKAN_MAX_DESC_SETS;
-            _objectDescriptorSets[i] = static_cast<VkDescriptorSet*>( TMemory::Allocate( sizeof( VkDescriptorSet ) * _objectDescriptorSetObjectCount ) );
-            VK_CHECK( vkCreateDescriptorPool( _device->LogicalDevice, &poolInfo, nullptr, &_objectDescriptorPools[i] ) );
-        }
-    }
-
-    void VulkanUnlitShader::createTextureSamplers() {
-        _textureSamplerCount = _imageCount;
-        _textureSamplers = static_cast<VulkanTextureSampler**>( TMemory::Allocate( sizeof( VulkanTextureSampler* ) * _textureSamplerCount ) );
-        for( U32 i = 0; i < _textureSamplerCount; ++i ) {
-            _textureSamplers[i] = new VulkanTextureSampler( _device );
-        }
+        // A texture which failed to get a slot falls back to the first slot rather than reading outside the texture array.
+        U32 diffuseIndex = castMaterial->DiffuseMap->GetIndex();
+        outData->DiffuseTextureIndex = diffuseIndex != U32_MAX ? diffuseIndex : 0;
     }
 
     void VulkanUnlitShader::createPipeline( const Extent2D& extent ) {
         PipelineInfo info;
         info.Extent = { (U32)extent.Width, (U32)extent.Height };
         info.Renderpass = VulkanRenderPassManager::GetRenderPass( "RenderPass.Default" );
-        info.DescriptorSetLayouts.push_back( _globalDescriptorSetLayout );
-        info.DescriptorSetLayouts.push_back( _objectDescriptorSetLayout );
+        info.DescriptorSetLayouts.push_back( _globalUniforms->GetLayout() );
+        info.DescriptorSetLayouts.push_back( _device->BindlessResources->GetLayout() );
+
+        // The index of the material being drawn, which selects its entry in the material table.
+        VkPushConstantRange materialIndexRange = {};
+        materialIndexRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        materialIndexRange.offset = 0;
+        materialIndexRange.size = sizeof( U32 );
+        info.PushConstantRanges.push_back( materialIndexRange );
         if( HasVertexStage() ) {
             info.ShaderStages.push_back( _vertexModule->GetShaderStageCreateInfo() );
         }
@@ -509,27 +245,7 @@ namespace Epoch {
             info.ShaderStages.push_back( _computeModule->GetShaderStageCreateInfo() );
         }
 
-        _graphicsPipeline = new VulkanGraphicsPipeline( _device, info );
-    }
-
-    void VulkanUnlitShader::createUniformBuffers() {
-
-        // Global UBOs
-        _globalUBOCount = _imageCount;
-        _globalUniformBuffers = static_cast<VulkanBuffer<GlobalUniformObject>**>( TMemory::Allocate( sizeof( VulkanBuffer<GlobalUniformObject>* ) * _globalUBOCount ) );
-        _globalUbos = static_cast<GlobalUniformObject*>( TMemory::Allocate( sizeof( GlobalUniformObject ) * _globalUBOCount ) );
-        for( U64 i = 0; i < _imageCount; ++i ) {
-            _globalUniformBuffers[i] = new VulkanBuffer<GlobalUniformObject>( _device, VulkanBufferType::UNIFORM );
-            _globalUniformBuffers[i]->Allocate( sizeof( GlobalUniformObject ) * _imageCount );
-        }
-
-        // Per-object UBOs
-        _objectUBOCount = _imageCount;
-        _objectUniformBuffers = static_cast<VulkanBuffer<UnlitUniformObject>**>( TMemory::Allocate( sizeof( VulkanBuffer<UnlitUniformObject>* ) * _objectUBOCount ) );
-        _objectUbos = static_cast<UnlitUniformObject*>( TMemory::Allocate( sizeof( UnlitUniformObject ) * _objectUBOCount ) );
-        for( U64 i = 0; i < _imageCount; ++i ) {
-            _objectUniformBuffers[i] = new VulkanBuffer<Epoch::UnlitUniformObject>( _device, VulkanBufferType::UNIFORM );
-            _objectUniformBuffers[i]->Allocate( sizeof( UnlitUniformObject ) * VULKAN_MAX_UNIFORM_BUFFERS );
-        }
+        // Shaders with identical state share a pipeline.
+        _graphicsPipeline = _device->PipelineCache->AcquireGraphicsPipeline( info );
     }
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <vector>
+#include <unordered_map>
 #include <vulkan/vulkan.h>
 
+#include "../../../Defines.h"
 #include "../../../String/TString.h"
 #include "../../../Events/IEventHandler.h"
 #include "../../IShader.h"
@@ -11,10 +14,6 @@
 
 #define BUILTIN_SHADER_NAME_UNLIT "Builtin.UnlitShader"
 
-#define VULKAN_MAX_DESC_SETS 16384
-#define VULKAN_MAX_IMAGE_SAMPLERS 12384
-#define VULKAN_MAX_UNIFORM_BUFFERS 8192
-
 namespace Epoch {
 
     struct Extent2D;
@@ -22,10 +21,26 @@ namespace Epoch {
     class IUniformBuffer;
     class VulkanDevice;
     class VulkanImage;
-    class VulkanTextureSampler;
     class VulkanGraphicsPipeline;
     class VulkanUniformBuffer;
+    class VulkanGlobalUniforms;
+    struct VulkanShaderLibraryModule;
+    struct ShaderBinding;
+
+    /**
+     * A material's entry in the bindless material table, kept until the material is released.
+     */
+    struct VulkanMaterialEntry {
+        U32 Index = U32_MAX;
 
+        // The data last written to the table. The entry is only rewritten when this changes.
+        MaterialShaderData Data = {};
+    };
+
+    /**
+     * A single stage of a shader. The module itself is owned by the device's shader library, and may be shared with other
+     * shaders whose stage has identical code.
+     */
     class VulkanShaderModule {
     public:
         VulkanShaderModule( VulkanDevice* device, const char* name, ShaderType type );
@@ -33,9 +48,16 @@ namespace Epoch {
 
         VkShaderModule GetHandle() { return _handle; }
         VkPipelineShaderStageCreateInfo GetShaderStageCreateInfo() { return _shaderStageCreateInfo; }
+        VkShaderStageFlagBits GetStage() const { return _shaderStageCreateInfo.stage; }
+
+        /**
+         * Returns the descriptor bindings reflected from this stage, ordered by set and binding.
+         */
+        const std::vector<ShaderBinding>& GetBindings() const;
     private:
         const char* _name;
         VulkanDevice* _device;
+        const VulkanShaderLibraryModule* _module;
         VkShaderModule _handle;
         VkPipelineShaderStageCreateInfo _shaderStageCreateInfo;
     };
@@ -45,18 +67,16 @@ namespace Epoch {
      */
     class VulkanShader : public IShader, public IEventHandler {
     public:
-        VulkanShader( VulkanDevice* device, const char* name, const U32 imageCount, const TString& renderPassName, const bool hasVertex, const bool hasFragment, const bool hasGeometry, const bool hasCompute );
+        VulkanShader( VulkanDevice* device, const char* name, const TString& renderPassName, VulkanGlobalUniforms* globalUniforms, const bool hasVertex, const bool hasFragment, const bool hasGeometry, const bool hasCompute );
         virtual ~VulkanShader();
 
         void OnEvent( const Event* event ) override;
 
-        virtual void SetGlobalUniform( ICommandBuffer* commandBuffer, const GlobalUniformObject& uniform, const U32 frameIndex ) override;
-        virtual void SetModel( const Matrix4x4& model ) override;
-
-        virtual void ResetDescriptors( const U32 frameIndex ) override;
         virtual void BindPipeline( ICommandBuffer* commandBuffer ) override;
-        virtual void UpdateDescriptor( ICommandBuffer* commandBuffer, const U32 frameIndex, const U32 objectIndex, BaseMaterial* material ) override = 0;
-        virtual void BindDescriptor( ICommandBuffer* commandBuffer, const U32 frameIndex, const U32 objectIndex ) override;
+        virtual void UpdateMaterial( BaseMaterial* material ) override;
+        virtual void BindDescriptor( ICommandBuffer* commandBuffer, const U32 frameIndex ) override;
+        virtual void BindMaterial( ICommandBuffer* commandBuffer, BaseMaterial* material ) override;
+        virtual void ReleaseMaterial( BaseMaterial* material ) override;
 
         const bool HasVertexStage() const override { return _vertexModule != nullptr; }
         const bool HasFragmentStage() const override { return _fragmentModule != nullptr; }
@@ -74,53 +94,28 @@ namespace Epoch {
         virtual void intialize();
         virtual void destroyPipeline();
 
-        virtual void createDescriptorSetLayout() = 0;
-        virtual void createDescriptorPools() = 0;
-        virtual void createTextureSamplers() = 0;
+        // Fills in the shader data of the given material, which is written to the material table.
+        virtual void getMaterialShaderData( BaseMaterial* material, MaterialShaderData* outData ) = 0;
+
         virtual void createPipeline( const Extent2D& extent ) = 0;
-        virtual void createUniformBuffers() = 0;
 
     protected:
         bool _needsReset = true;
         TString _renderPassName;
 
-        // Global descriptors (one pool/set per frame)
-        U32 _globalDescriptorPoolCount;
-        VkDescriptorPool* _globalDescriptorPools;
-        VkDescriptorSetLayout _globalDescriptorSetLayout;
-        U32 _globalDescriptorSetFrameCount;
-        VkDescriptorSet* _globalDescriptorSets; // one per frame
-
-        // Object descriptors (one pool/frame, one set per frame per object)
-        U32 _objectDescriptorPoolCount;
-        VkDescriptorPool* _objectDescriptorPools;
-        VkDescriptorSetLayout _objectDescriptorSetLayout;
+        // Global uniforms and their descriptor sets, bound as set 0 by every shader. Not owned by the shader.
+        VulkanGlobalUniforms* _globalUniforms;
 
-        U32 _objectDescriptorSetFrameCount;
-        U32 _objectDescriptorSetObjectCount;
-        VkDescriptorSet** _objectDescriptorSets; // one per frame, per object
-
-        U32 _textureSamplerCount;
-        VulkanTextureSampler** _textureSamplers;
+        // The material table entry of each material drawn with this shader.
+        std::unordered_map<const BaseMaterial*, VulkanMaterialEntry> _materialEntries;
 
         VulkanGraphicsPipeline* _graphicsPipeline;
 
-        // 1 per swap chain image
-        U32 _globalUBOCount;
-        U32 _objectUBOCount;
-        VulkanBuffer<Epoch::GlobalUniformObject>** _globalUniformBuffers;
-        VulkanBuffer<Epoch::UnlitUniformObject>** _objectUniformBuffers;
-        UnlitUniformObject* _objectUbos;
-        GlobalUniformObject* _globalUbos;
-
-        U32 _imageCount;
         VulkanDevice* _device;
         VulkanShaderModule* _vertexModule = nullptr;
         VulkanShaderModule* _fragmentModule = nullptr;
         VulkanShaderModule* _geometryModule = nullptr;
         VulkanShaderModule* _computeModule = nullptr;
-
-        Matrix4x4 _model;
     };
 
     /**
@@ -128,15 +123,10 @@ namespace Epoch {
      */
     class VulkanUnlitShader : public VulkanShader {
     public:
-        VulkanUnlitShader( VulkanDevice* device, const U32 imageCount, const TString& renderPassName );
-        
+        VulkanUnlitShader( VulkanDevice* device, const TString& renderPassName, VulkanGlobalUniforms* globalUniforms );
 
-        virtual void UpdateDescriptor( ICommandBuffer* commandBuffer, const U32 frameIndex, const U32 objectIndex, BaseMaterial* material );
     protected:
-        virtual void createDescriptorSetLayout() override;
-        virtual void createDescriptorPools() override;
-        virtual void createTextureSamplers() override;
+        virtual void getMaterialShaderData( BaseMaterial* material, MaterialShaderData* outData ) override;
         virtual void createPipeline( const Extent2D& extent ) override;
-        virtual void createUniformBuffers() override;
     };
-}
+}
\ No newline at end of file
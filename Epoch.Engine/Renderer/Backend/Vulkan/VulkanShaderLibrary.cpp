@@ -0,0 +1,212 @@
+#include <stdlib.h>
+
+#include "../../../Logger.h"
+#include "../../../FileSystem/FileSystem.h"
+#include "../../../Platform/FileHelper.h"
+#include "../../../Assets/ShaderArchive.h"
+#include "VulkanUtilities.h"
+#include "VulkanDevice.h"
+#include "VulkanShader.h"
+#include "VulkanShaderLibrary.h"
+
+// The name of the shader archive within the shader directory, written by the shader build step.
+#define VULKAN_SHADER_ARCHIVE_NAME "shaders" EPOCH_FILE_EXT_SHADER_ARCHIVE
+
+namespace Epoch {
+
+    static const char* getShaderTypeExtension( const ShaderType type ) {
+        switch( type ) {
+        default:
+        case ShaderType::Vertex:
+            return "vert";
+        case ShaderType::Fragment:
+            return "frag";
+        case ShaderType::Geometry:
+            return "geom";
+        case ShaderType::Compute:
+            return "comp";
+        }
+    }
+
+    static VkDescriptorType getDescriptorType( const ShaderBindingType type, const bool dynamicUniformBuffers ) {
+        switch( type ) {
+        default:
+        case ShaderBindingType::UniformBuffer:
+            return dynamicUniformBuffers ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        case ShaderBindingType::StorageBuffer:
+            return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        case ShaderBindingType::CombinedImageSampler:
+            return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        case ShaderBindingType::SampledImage:
+            return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        case ShaderBindingType::StorageImage:
+            return VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        case ShaderBindingType::Sampler:
+            return VK_DESCRIPTOR_TYPE_SAMPLER;
+        }
+    }
+
+    VulkanShaderLibrary::VulkanShaderLibrary( VulkanDevice* device, const TString& directory ) {
+        _device = device;
+        _directory = directory;
+
+        TString archivePath = _directory + VULKAN_SHADER_ARCHIVE_NAME;
+        if( !FileHelper::FileExists( archivePath.CStr() ) ) {
+            Logger::Warn( "No shader archive found at '%s'. Shader modules will be loaded from loose files.", archivePath.CStr() );
+            return;
+        }
+
+        ShaderArchive archive( archivePath );
+        if( !archive.TryOpen() ) {
+            return;
+        }
+
+        // Create every module now. Modules with identical code have the same offset, and share the first one's handle.
+        U32 moduleCount = archive.GetModuleCount();
+        for( U32 i = 0; i < moduleCount; ++i ) {
+            const ShaderArchiveModule& archiveModule = archive.GetModule( i );
+            VulkanShaderLibraryModule* module = new VulkanShaderLibraryModule();
+            module->Name = archiveModule.Name;
+            module->Type = (ShaderType)archiveModule.Type;
+            for( U32 j = 0; j < i; ++j ) {
+                if( archive.GetModule( j ).CodeOffset == archiveModule.CodeOffset ) {
+                    module->Handle = _modules[j]->Handle;
+                    break;
+                }
+            }
+            if( !module->Handle ) {
+                module->Handle = createModule( archive.GetCode( archiveModule ), archiveModule.CodeSize );
+            }
+
+            const ShaderBinding* bindings = archive.GetBindings( archiveModule );
+            module->Bindings.assign( bindings, bindings + archiveModule.BindingCount );
+            _modules.push_back( module );
+        }
+        Logger::Trace( "Created %u shader modules (%u unique) from '%s'.", moduleCount, (U32)_handles.size(), archivePath.CStr() );
+
+        // Everything needed has been copied out or handed to the driver, so the archive is unmapped here.
+        archive.Close();
+    }
+
+    VulkanShaderLibrary::~VulkanShaderLibrary() {
+        for( U64 i = 0; i < _handles.size(); ++i ) {
+            vkDestroyShaderModule( _device->LogicalDevice, _handles[i], nullptr );
+        }
+        _handles.clear();
+
+        for( U64 i = 0; i < _modules.size(); ++i ) {
+            delete _modules[i];
+        }
+        _modules.clear();
+
+        _device = nullptr;
+    }
+
+    const VulkanShaderLibraryModule* VulkanShaderLibrary::GetModule( const char* name, const ShaderType type ) {
+        for( U64 i = 0; i < _modules.size(); ++i ) {
+            if( _modules[i]->Type == type && _modules[i]->Name == name ) {
+                return _modules[i];
+            }
+        }
+        return loadLooseModule( name, type );
+    }
+
+    void VulkanShaderLibrary::GetSetLayoutBindings( VulkanShaderModule* const* modules, const U32 moduleCount, const U32 set, const bool dynamicUniformBuffers, std::vector<VkDescriptorSetLayoutBinding>* outBindings ) {
+        for( U32 m = 0; m < moduleCount; ++m ) {
+            const std::vector<ShaderBinding>& bindings = modules[m]->GetBindings();
+            for( U64 i = 0; i < bindings.size(); ++i ) {
+                const ShaderBinding& binding = bindings[i];
+                if( binding.Set != set ) {
+                    continue;
+                }
+
+                VkDescriptorType descriptorType = getDescriptorType( (ShaderBindingType)binding.Type, dynamicUniformBuffers );
+                VkDescriptorSetLayoutBinding* existing = nullptr;
+                for( U64 j = 0; j < outBindings->size(); ++j ) {
+                    if( ( *outBindings )[j].binding == binding.Binding ) {
+                        existing = &( *outBindings )[j];
+                        break;
+                    }
+                }
+
+                // Stages sharing a binding must agree on what it is. If they do, the binding is visible to both.
+                if( existing ) {
+                    if( existing->descriptorType != descriptorType || existing->descriptorCount != binding.Count ) {
+                        Logger::Error( "Shader stages disagree on the descriptor at set %u, binding %u.", set, binding.Binding );
+                    }
+                    existing->stageFlags |= modules[m]->GetStage();
+                    continue;
+                }
+
+                // Runtime-sized arrays need variable descriptor counts, which only the shared bindless set is set up for.
+                if( binding.Count == 0 ) {
+                    Logger::Error( "Descriptor at set %u, binding %u is a runtime-sized array, which a reflected layout cannot hold.", set, binding.Binding );
+                    continue;
+                }
+
+                VkDescriptorSetLayoutBinding layoutBinding = {};
+                layoutBinding.binding = binding.Binding;
+                layoutBinding.descriptorType = descriptorType;
+                layoutBinding.descriptorCount = binding.Count;
+                layoutBinding.stageFlags = modules[m]->GetStage();
+                layoutBinding.pImmutableSamplers = nullptr;
+                outBindings->push_back( layoutBinding );
+            }
+        }
+    }
+
+    void VulkanShaderLibrary::GetPoolSizes( const std::vector<VkDescriptorSetLayoutBinding>& bindings, std::vector<VkDescriptorPoolSize>* outSizes ) {
+        for( U64 i = 0; i < bindings.size(); ++i ) {
+            bool found = false;
+            for( U64 j = 0; j < outSizes->size(); ++j ) {
+                if( ( *outSizes )[j].type == bindings[i].descriptorType ) {
+                    ( *outSizes )[j].descriptorCount += bindings[i].descriptorCount;
+                    found = true;
+                    break;
+                }
+            }
+            if( !found ) {
+                VkDescriptorPoolSize size;
+                size.type = bindings[i].descriptorType;
+                size.descriptorCount = bindings[i].descriptorCount;
+                outSizes->push_back( size );
+            }
+        }
+    }
+
+    VulkanShaderLibraryModule* VulkanShaderLibrary::loadLooseModule( const char* name, const ShaderType type ) {
+        TString fileName = TString::Format( "%s%s.%s.spv", _directory.CStr(), name, getShaderTypeExtension( type ) );
+        U64 codeSize;
+        const char* code = FileHelper::ReadFileBinaryToArray( fileName.CStr(), &codeSize );
+
+        VulkanShaderLibraryModule* module = new VulkanShaderLibraryModule();
+        module->Name = name;
+        module->Type = type;
+        List<ShaderBinding> bindings;
+        if( !ShaderReflection::ReflectBindings( reinterpret_cast<const U32*>( code ), codeSize / sizeof( U32 ), bindings ) ) {
+            Logger::Error( "Unable to reflect shader module '%s'.", fileName.CStr() );
+            free( (void*)code );
+            delete module;
+            return nullptr;
+        }
+        module->Bindings.assign( bindings.Data(), bindings.Data() + bindings.Size() );
+        module->Handle = createModule( reinterpret_cast<const U32*>( code ), codeSize );
+
+        // The driver keeps its own copy of the code.
+        free( (void*)code );
+
+        _modules.push_back( module );
+        return module;
+    }
+
+    VkShaderModule VulkanShaderLibrary::createModule( const U32* code, const U64 codeSize ) {
+        VkShaderModuleCreateInfo shaderCreateInfo = { VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+        shaderCreateInfo.codeSize = codeSize;
+        shaderCreateInfo.pCode = code;
+
+        VkShaderModule handle;
+        VK_CHECK( vkCreateShaderModule( _device->LogicalDevice, &shaderCreateInfo, nullptr, &handle ) );
+        _handles.push_back( handle );
+        return handle;
+    }
+}
\ No newline at end of file
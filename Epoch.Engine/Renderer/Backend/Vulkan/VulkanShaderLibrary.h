@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../../../Types.h"
+#include "../../../String/TString.h"
+#include "../../IShader.h"
+#include "../../ShaderReflection.h"
+
+namespace Epoch {
+
+    class VulkanDevice;
+    class VulkanShaderModule;
+
+    /**
+     * A compiled shader stage and the descriptor bindings reflected from it.
+     */
+    struct VulkanShaderLibraryModule {
+        TString Name;
+        ShaderType Type;
+
+        // Shared with every other module whose code is identical. Owned by the library.
+        VkShaderModule Handle = nullptr;
+        std::vector<ShaderBinding> Bindings;
+    };
+
+    /**
+     * Creates every shader module up front from a single shader archive, which is mapped with one call. Modules with
+     * identical code share one VkShaderModule. Modules missing from the archive, or all modules if there is no archive,
+     * are read from loose SPIR-V files and reflected as they are first needed.
+     */
+    class VulkanShaderLibrary {
+    public:
+
+        /**
+         * Creates a new shader library, loading the archive in the given directory if there is one.
+         *
+         * @param device The device to create shader modules on.
+         * @param directory The directory holding the shader archive and any loose SPIR-V files, ending with a separator.
+         */
+        VulkanShaderLibrary( VulkanDevice* device, const TString& directory );
+
+        /**
+         * Destroys every shader module. All pipelines using them should have been destroyed first.
+         */
+        ~VulkanShaderLibrary();
+
+        /**
+         * Returns the module of the given shader and stage, loading it from a loose file if the archive does not have it.
+         *
+         * @param name The name of the shader.
+         * @param type The stage.
+         *
+         * @returns A pointer to the module, or nullptr if it could not be loaded.
+         */
+        const VulkanShaderLibraryModule* GetModule( const char* name, const ShaderType type );
+
+        /**
+         * Builds the layout bindings of a descriptor set from the bindings reflected from the given modules. Bindings
+         * used by several stages are merged.
+         *
+         * @param modules The modules which use the set.
+         * @param moduleCount The number of modules.
+         * @param set The index of the set.
+         * @param dynamicUniformBuffers Indicates if uniform buffers in the set are bound with dynamic offsets.
+         * @param outBindings The list to add the layout bindings to.
+         */
+        static void GetSetLayoutBindings( VulkanShaderModule* const* modules, const U32 moduleCount, const U32 set, const bool dynamicUniformBuffers, std::vector<VkDescriptorSetLayoutBinding>* outBindings );
+
+        /**
+         * Totals the descriptors of each type in the given layout bindings, for sizing the pools sets of that layout are
+         * allocated from.
+         *
+         * @param bindings The layout bindings of a single set.
+         * @param outSizes The list to add the size of each descriptor type to.
+         */
+        static void GetPoolSizes( const std::vector<VkDescriptorSetLayoutBinding>& bindings, std::vector<VkDescriptorPoolSize>* outSizes );
+
+    private:
+        VulkanShaderLibraryModule* loadLooseModule( const char* name, const ShaderType type );
+        VkShaderModule createModule( const U32* code, const U64 codeSize );
+
+    private:
+        VulkanDevice* _device;
+        TString _directory;
+        std::vector<VulkanShaderLibraryModule*> _modules;
+
+        // Every unique shader module, which may be shared by several entries in the module list.
+        std::vector<VkShaderModule> _handles;
+    };
+}
\ No newline at end of file
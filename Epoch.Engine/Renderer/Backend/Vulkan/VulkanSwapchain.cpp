@@ -17,9 +17,10 @@
 namespace Epoch {
 
 
-    VulkanSwapchain::VulkanSwapchain( VulkanDevice* device, VkSurfaceKHR surface, void* windowHandle, U32 width, U32 height ) {
+    VulkanSwapchain::VulkanSwapchain( VulkanDevice* device, VkSurfaceKHR surface, void* windowHandle, U32 width, U32 height, const U8 maxFramesInFlight ) {
         _device = device;
         _surface = surface;
+        MaxFramesInFlight = maxFramesInFlight;
         Extent = { width, height };
         createInternal();
     }
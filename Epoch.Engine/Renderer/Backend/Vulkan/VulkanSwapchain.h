@@ -16,9 +16,11 @@ namespace Epoch {
     public:
         VkSurfaceFormatKHR ImageFormat;
         VkExtent2D Extent;
-        const U8 MaxFramesInFlight = 2;
+
+        // The number of frames which may be recorded before the first of them has finished on the GPU.
+        U8 MaxFramesInFlight;
     public:
-        VulkanSwapchain( VulkanDevice* device, VkSurfaceKHR surface, void* windowHandle, const U32 width, const U32 height );
+        VulkanSwapchain( VulkanDevice* device, VkSurfaceKHR surface, void* windowHandle, const U32 width, const U32 height, const U8 maxFramesInFlight );
         ~VulkanSwapchain();
 
         void Recreate( const U32 width, const U32 height );
@@ -56,7 +58,7 @@ namespace Epoch {
         VkSurfaceKHR _surface;
 
 
-        U32 _currentFrameIndex;
+        U32 _currentFrameIndex = 0;
         VkSwapchainKHR _handle;
 
         std::vector<VkImage> _swapchainImages;
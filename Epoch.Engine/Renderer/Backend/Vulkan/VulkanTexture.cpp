@@ -1,13 +1,20 @@
 
+#include <vector>
 #include <vulkan/vulkan.h>
 
 #include "../../../Defines.h"
+#include "../../../Logger.h"
 #include "../../../Memory/Memory.h"
+#include "../../../FileSystem/FileSystem.h"
+#include "../../../Platform/FileHelper.h"
+#include "../../../Assets/TextureFile.h"
 #include "../../../Assets/Image/ImageUtilities.h"
 
 #include "VulkanRendererBackend.h"
 #include "VulkanUtilities.h"
-#include "VulkanInternalBuffer.h"
+#include "VulkanDevice.h"
+#include "VulkanUploader.h"
+#include "VulkanBindlessResources.h"
 #include "VulkanImage.h"
 #include "VulkanTexture.h"
 
@@ -18,60 +25,140 @@ namespace Epoch {
         _name = name;
         _destroy = true;
 
-        I32 width, height, channelCount;
-        byte* pixels = ImageUtilities::LoadImage( path, &width, &height, &channelCount );
-        ASSERT_MSG( pixels, "Unable to load image!" );
+        // Prefer a cooked texture next to the source image, which is uploaded without decoding anything.
+        if( !tryLoadCooked( path ) ) {
+            loadSource( path );
+        }
 
-        VkDeviceSize imageSize = (U64)width * (U64)height * 4;
+        // Frames which sample the texture wait for its upload, so it can be made visible to shaders right away.
+        _index = _device->BindlessResources->AddTexture( _textureImage );
+    }
 
-        // Create a staging buffer and load data into it.
-        VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-        VulkanInternalBuffer staging( _device, imageSize, usage, flags, true );
+    VulkanTexture::VulkanTexture( VulkanImage* image, const char* name, const bool destroy ) {
+        _device = image->GetDevice();
+        _name = name;
+        _destroy = destroy;
+        _textureImage = image;
+    }
 
-        // Lock, copy, unlock
-        void* data = staging.LockMemory( 0, imageSize, 0 );
-        TMemory::Memcpy( data, pixels, imageSize );
-        staging.UnlockMemory();
+    VulkanTexture::~VulkanTexture() {
+        if( _index != U32_MAX ) {
+            _device->BindlessResources->RemoveTexture( _index );
+            _index = U32_MAX;
+        }
 
-        // Clean up image data.
-        TMemory::Free( pixels );
+        if( _textureImage && _destroy ) {
+            delete _textureImage;            
+        }
+
+        _textureImage = nullptr;
+
+        _device = nullptr;
+    }
+
+    const bool VulkanTexture::tryLoadCooked( const char* path ) {
+        TString cookedPath( path );
+        cookedPath.StripFileExtension();
+        cookedPath.Append( EPOCH_FILE_EXT_TEXTURE );
+        if( !FileHelper::FileExists( cookedPath.CStr() ) ) {
+            return false;
+        }
+
+        TextureFile file( cookedPath );
+        if( !file.TryOpen() ) {
+            return false;
+        }
+
+        const TextureFileHeader* header = file.GetHeader();
+        bool isSrgb = header->IsSrgb != 0;
+        VkFormat format;
+        switch( (TextureFileFormat)header->Format ) {
+        case TextureFileFormat::BC1:
+            format = isSrgb ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            break;
+        case TextureFileFormat::BC3:
+            format = isSrgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+            break;
+        case TextureFileFormat::BC5:
+            format = VK_FORMAT_BC5_UNORM_BLOCK;
+            break;
+        case TextureFileFormat::BC7:
+            format = isSrgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+            break;
+        default:
+            format = isSrgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+            break;
+        }
+        if( header->Format != (U8)TextureFileFormat::RGBA8 && !_device->SupportsBlockCompression ) {
+            Logger::Warn( "Block-compressed textures are not supported by the device. Loading '%s' from its source image instead.", _name.CStr() );
+            return false;
+        }
+
+        // Levels are stored back to back from the first, so the whole chain is uploaded straight from the mapped file.
+        const TextureFileMip& firstMip = file.GetMip( 0 );
+        const TextureFileMip& lastMip = file.GetMip( header->MipLevelCount - 1 );
+        std::vector<U64> mipOffsets( header->MipLevelCount );
+        for( U32 i = 0; i < header->MipLevelCount; ++i ) {
+            mipOffsets[i] = file.GetMip( i ).Offset - firstMip.Offset;
+        }
 
         VulkanImageCreateInfo textureImageCreateInfo = {};
-        textureImageCreateInfo.Width = width;
-        textureImageCreateInfo.Height = height;
-        textureImageCreateInfo.Format = VkFormat::VK_FORMAT_R8G8B8A8_SRGB;
+        textureImageCreateInfo.Width = header->Width;
+        textureImageCreateInfo.Height = header->Height;
+        textureImageCreateInfo.Format = format;
         textureImageCreateInfo.Tiling = VkImageTiling::VK_IMAGE_TILING_OPTIMAL;
         textureImageCreateInfo.Usage = VkImageUsageFlagBits::VK_IMAGE_USAGE_TRANSFER_DST_BIT | VkImageUsageFlagBits::VK_IMAGE_USAGE_SAMPLED_BIT;
         textureImageCreateInfo.Properties = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        textureImageCreateInfo.MipLevels = header->MipLevelCount;
         textureImageCreateInfo.CreateView = true;
         textureImageCreateInfo.ViewAspectFlags = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT;
         VulkanImage::Create( _device, textureImageCreateInfo, &_textureImage );
 
-        // Transition the layout from whatever it is currently to optimal for recieving data.
-        _textureImage->TransitionLayout( textureImageCreateInfo.Format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL );
-
-        // Copy the data from the buffer.
-        _textureImage->CopyFromBuffer( staging.GetHandle() );
-
-        // Transition from optimal for data reciept to shader-read-only optimal layout.
-        _textureImage->TransitionLayout( textureImageCreateInfo.Format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL );
+        // The data is copied into the staging ring, so the file can be unmapped right away.
+        U64 dataSize = lastMip.Offset + lastMip.Size - firstMip.Offset;
+        _device->Uploader->UploadImage( _textureImage, file.GetData() + firstMip.Offset, dataSize, mipOffsets.data() );
+        file.Close();
+        return true;
     }
 
-    VulkanTexture::VulkanTexture( VulkanImage* image, const char* name, const bool destroy ) {
-        _device = image->GetDevice();
-        _name = name;
-        _destroy = destroy;
-        _textureImage = image;
-    }
+    void VulkanTexture::loadSource( const char* path ) {
+        I32 width, height, channelCount;
+        byte* pixels = ImageUtilities::LoadImage( path, &width, &height, &channelCount );
+        ASSERT_MSG( pixels, "Unable to load image!" );
 
-    VulkanTexture::~VulkanTexture() {
-        if( _textureImage && _destroy ) {
-            delete _textureImage;            
+        // Build the full mip chain, so minified textures read from a level close to their size on screen.
+        U32 mipLevels;
+        U64 imageSize;
+        byte* mipChain = ImageUtilities::GenerateMipChain( pixels, (U32)width, (U32)height, true, &mipLevels, &imageSize );
+        TMemory::Free( pixels );
+
+        std::vector<U64> mipOffsets( mipLevels );
+        U64 offset = 0;
+        U32 levelWidth = (U32)width;
+        U32 levelHeight = (U32)height;
+        for( U32 i = 0; i < mipLevels; ++i ) {
+            mipOffsets[i] = offset;
+            offset += (U64)levelWidth * (U64)levelHeight * 4;
+            levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+            levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
         }
 
-        _textureImage = nullptr;
+        VulkanImageCreateInfo textureImageCreateInfo = {};
+        textureImageCreateInfo.Width = width;
+        textureImageCreateInfo.Height = height;
+        textureImageCreateInfo.Format = VkFormat::VK_FORMAT_R8G8B8A8_SRGB;
+        textureImageCreateInfo.Tiling = VkImageTiling::VK_IMAGE_TILING_OPTIMAL;
+        textureImageCreateInfo.Usage = VkImageUsageFlagBits::VK_IMAGE_USAGE_TRANSFER_DST_BIT | VkImageUsageFlagBits::VK_IMAGE_USAGE_SAMPLED_BIT;
+        textureImageCreateInfo.Properties = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        textureImageCreateInfo.MipLevels = mipLevels;
+        textureImageCreateInfo.CreateView = true;
+        textureImageCreateInfo.ViewAspectFlags = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT;
+        VulkanImage::Create( _device, textureImageCreateInfo, &_textureImage );
 
-        _device = nullptr;
+        // Queue the upload, including both layout transitions. The pixels are copied into the staging ring, so can be freed right away.
+        _device->Uploader->UploadImage( _textureImage, mipChain, imageSize, mipOffsets.data() );
+
+        // Clean up image data.
+        TMemory::Free( mipChain );
     }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../../Resources/ITexture.h"
+#include "../../../Defines.h"
 #include "../../../String/TString.h"
 
 namespace Epoch {
@@ -17,12 +18,21 @@ namespace Epoch {
 
         const char* GetName() const { return _name.CStr(); }
 
+        const U32 GetIndex() const { return _index; }
+
         IImage* GetImage() { return (IImage*)_textureImage; }
 
+    private:
+        const bool tryLoadCooked( const char* path );
+        void loadSource( const char* path );
+
     private:
         bool _destroy;
         VulkanDevice* _device;
         TString _name;
         VulkanImage* _textureImage;
+
+        // The slot of this texture in the bindless texture array, or U32_MAX if it has none.
+        U32 _index = U32_MAX;
     };
 }
\ No newline at end of file
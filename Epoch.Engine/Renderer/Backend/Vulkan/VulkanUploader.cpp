@@ -0,0 +1,329 @@
+
+#include "../../../Logger.h"
+#include "../../../Defines.h"
+#include "../../../Memory/Memory.h"
+
+#include "VulkanUtilities.h"
+#include "VulkanDevice.h"
+#include "VulkanQueue.h"
+#include "VulkanFence.h"
+#include "VulkanSemaphore.h"
+#include "VulkanImage.h"
+#include "VulkanInternalBuffer.h"
+#include "VulkanCommandPool.h"
+#include "VulkanCommandBuffer.h"
+#include "VulkanUploader.h"
+
+// Every staging allocation starts on a boundary of this many bytes, which satisfies buffer-to-image copy offset rules for all formats used.
+#define VULKAN_STAGING_ALIGNMENT 16
+
+namespace Epoch {
+
+    VulkanUploader::VulkanUploader( VulkanDevice* device, VulkanQueue* queue, const U64 stagingSize ) {
+        _device = device;
+        _queue = queue;
+        _stagingSize = stagingSize;
+
+        // Command buffers are short-lived and reset on every use.
+        _commandPool = new VulkanCommandPool( _device, _queue->GetIndex(), true, false, true );
+
+        // Mapped once and left mapped. Memory is host coherent, so writes need no flushing.
+        VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        _stagingBuffer = new VulkanInternalBuffer( _device, _stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, flags );
+        _stagingMemory = static_cast<U8*>( _stagingBuffer->LockMemory( 0, _stagingSize, 0 ) );
+    }
+
+    VulkanUploader::~VulkanUploader() {
+        WaitIdle();
+
+        for( U64 i = 0; i < _freeBatches.size(); ++i ) {
+            _commandPool->FreeCommandBuffer( _freeBatches[i]->CommandBuffer );
+            delete _freeBatches[i]->Fence;
+            delete _freeBatches[i];
+        }
+        _freeBatches.clear();
+
+        if( _commandPool ) {
+            delete _commandPool;
+            _commandPool = nullptr;
+        }
+
+        if( _stagingBuffer ) {
+            _stagingBuffer->UnlockMemory();
+            delete _stagingBuffer;
+            _stagingBuffer = nullptr;
+        }
+        _stagingMemory = nullptr;
+
+        _queue = nullptr;
+        _device = nullptr;
+    }
+
+    void VulkanUploader::UploadBuffer( VulkanInternalBuffer* destination, const U64 destinationOffset, const void* data, const U64 size ) {
+        std::lock_guard<std::mutex> lock( _mutex );
+
+        VkBuffer stagingHandle;
+        U64 stagingOffset;
+        U8* staging = allocateStaging( size, &stagingHandle, &stagingOffset );
+        TMemory::Memcpy( staging, data, size );
+
+        VkBufferCopy copyRegion = {};
+        copyRegion.srcOffset = stagingOffset;
+        copyRegion.dstOffset = destinationOffset;
+        copyRegion.size = size;
+        vkCmdCopyBuffer( _recordingBatch->CommandBuffer->Handle, stagingHandle, destination->GetHandle(), 1, &copyRegion );
+    }
+
+    void VulkanUploader::CopyBuffer( VulkanInternalBuffer* source, const U64 sourceOffset, VulkanInternalBuffer* destination, const U64 destinationOffset, const U64 size ) {
+        std::lock_guard<std::mutex> lock( _mutex );
+
+        VkCommandBuffer commandBuffer = getRecordingBatch()->CommandBuffer->Handle;
+
+        // Earlier uploads to the source must land before it is read, and the copy must land before later uploads to the
+        // destination, which may overlap it.
+        VkMemoryBarrier barrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr );
+
+        VkBufferCopy copyRegion = {};
+        copyRegion.srcOffset = sourceOffset;
+        copyRegion.dstOffset = destinationOffset;
+        copyRegion.size = size;
+        vkCmdCopyBuffer( commandBuffer, source->GetHandle(), destination->GetHandle(), 1, &copyRegion );
+
+        vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr );
+    }
+
+    void VulkanUploader::UploadImage( VulkanImage* image, const void* pixels, const U64 size, const U64* mipOffsets ) {
+        U32 mipLevels = image->GetMipLevels();
+        ASSERT_MSG( mipLevels == 1 || mipOffsets, "The offset of each mip level must be given when uploading more than one." );
+
+        std::lock_guard<std::mutex> lock( _mutex );
+
+        VkBuffer stagingHandle;
+        U64 stagingOffset;
+        U8* staging = allocateStaging( size, &stagingHandle, &stagingOffset );
+        TMemory::Memcpy( staging, pixels, size );
+
+        VkCommandBuffer commandBuffer = _recordingBatch->CommandBuffer->Handle;
+
+        VkImageMemoryBarrier barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image->GetHandle();
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = mipLevels;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+
+        // Transition to optimal for receiving data.
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier );
+
+        // One region per level, each half the size of the one before it. Copied directly rather than blitted, as the
+        // transfer queue may not support blits.
+        std::vector<VkBufferImageCopy> regions( mipLevels );
+        U32 levelWidth = image->GetWidth();
+        U32 levelHeight = image->GetHeight();
+        for( U32 i = 0; i < mipLevels; ++i ) {
+            VkBufferImageCopy& region = regions[i];
+            region = {};
+            region.bufferOffset = stagingOffset + ( mipOffsets ? mipOffsets[i] : 0 );
+            region.bufferRowLength = 0;
+            region.bufferImageHeight = 0;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = i;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = { 0, 0, 0 };
+            region.imageExtent = { levelWidth, levelHeight, 1 };
+            levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+            levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+        }
+        vkCmdCopyBufferToImage( commandBuffer, stagingHandle, image->GetHandle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels, regions.data() );
+
+        // Transition to optimal for shader reads. The transfer queue may not support shader stages, so the wait on the
+        // graphics queue's semaphore provides the dependency with the shaders reading it.
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier );
+    }
+
+    const bool VulkanUploader::Submit( VulkanSemaphore* signalSemaphore ) {
+        std::lock_guard<std::mutex> lock( _mutex );
+
+        if( !_recordingBatch && !_hasUnsignaledSubmits ) {
+            return false;
+        }
+
+        submitBatch( signalSemaphore );
+        return true;
+    }
+
+    void VulkanUploader::Update() {
+        std::lock_guard<std::mutex> lock( _mutex );
+        retireBatches( false );
+    }
+
+    void VulkanUploader::WaitIdle() {
+        std::lock_guard<std::mutex> lock( _mutex );
+
+        if( _recordingBatch ) {
+            submitBatch( nullptr );
+        }
+        while( !_submittedBatches.empty() ) {
+            retireBatches( true );
+        }
+    }
+
+    U8* VulkanUploader::allocateStaging( const U64 size, VkBuffer* outBuffer, U64* outOffset ) {
+        U64 alignedSize = ( size + VULKAN_STAGING_ALIGNMENT - 1 ) & ~( (U64)VULKAN_STAGING_ALIGNMENT - 1 );
+
+        // Too large for the ring, so give it a buffer of its own which lives as long as its batch.
+        if( alignedSize > _stagingSize ) {
+            Logger::Trace( "Upload of %lluB is larger than the staging ring. Using a dedicated staging buffer.", size );
+            VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            VulkanInternalBuffer* staging = new VulkanInternalBuffer( _device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, flags );
+            getRecordingBatch()->OversizedStaging.push_back( staging );
+            *outBuffer = staging->GetHandle();
+            *outOffset = 0;
+            return static_cast<U8*>( staging->LockMemory( 0, size, 0 ) );
+        }
+
+        U64 offset;
+        U64 skipped;
+        retireBatches( false );
+        while( !tryAllocateFromRing( alignedSize, &offset, &skipped ) ) {
+
+            // The recording batch's data is in the ring too, so it has to be submitted before its space can ever come back.
+            if( _recordingBatch ) {
+                submitBatch( nullptr );
+            }
+            retireBatches( true );
+        }
+
+        VulkanUploadBatch* batch = getRecordingBatch();
+        _used += skipped + alignedSize;
+        _head = offset + alignedSize;
+        batch->StagingBytes += skipped + alignedSize;
+        batch->StagingEnd = _head;
+
+        *outBuffer = _stagingBuffer->GetHandle();
+        *outOffset = offset;
+        return _stagingMemory + offset;
+    }
+
+    const bool VulkanUploader::tryAllocateFromRing( const U64 size, U64* outOffset, U64* outSkipped ) {
+        *outSkipped = 0;
+
+        // Start from the beginning whenever the ring is empty.
+        if( _used == 0 ) {
+            _head = 0;
+            _tail = 0;
+        } else if( _head == _tail ) {
+            return false;
+        }
+
+        if( _head < _tail ) {
+
+            // Free space is the gap between the head and the tail.
+            if( _head + size > _tail ) {
+                return false;
+            }
+            *outOffset = _head;
+        } else {
+
+            // Free space is from the head to the end, then from the start to the tail. Allocations never straddle the end.
+            if( _head + size <= _stagingSize ) {
+                *outOffset = _head;
+            } else if( size <= _tail ) {
+                *outSkipped = _stagingSize - _head;
+                *outOffset = 0;
+            } else {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    VulkanUploadBatch* VulkanUploader::getRecordingBatch() {
+        if( _recordingBatch ) {
+            return _recordingBatch;
+        }
+
+        if( _freeBatches.empty() ) {
+            _recordingBatch = new VulkanUploadBatch();
+            _recordingBatch->CommandBuffer = _commandPool->AllocateCommandBuffer( true );
+            _recordingBatch->Fence = new VulkanFence( _device, false );
+        } else {
+            _recordingBatch = _freeBatches.back();
+            _freeBatches.pop_back();
+        }
+
+        _recordingBatch->CommandBuffer->Begin( true, false, false );
+        return _recordingBatch;
+    }
+
+    void VulkanUploader::submitBatch( VulkanSemaphore* signalSemaphore ) {
+        U32 signalCount = signalSemaphore ? 1 : 0;
+        VkSemaphore* signalHandles = signalSemaphore ? &signalSemaphore->Handle : nullptr;
+
+        if( _recordingBatch ) {
+            VulkanUploadBatch* batch = _recordingBatch;
+            _recordingBatch = nullptr;
+
+            batch->CommandBuffer->End();
+            batch->Fence->Reset();
+            _queue->Submit( batch->CommandBuffer, batch->Fence, signalCount, signalHandles, false );
+            _submittedBatches.push_back( batch );
+        } else if( signalSemaphore ) {
+
+            // Nothing new to submit, but earlier batches went without a signal. A semaphore signal covers all work
+            // submitted to the queue before it, so an empty submission is enough.
+            VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+            submitInfo.signalSemaphoreCount = signalCount;
+            submitInfo.pSignalSemaphores = signalHandles;
+            VK_CHECK( vkQueueSubmit( _queue->GetHandle(), 1, &submitInfo, nullptr ) );
+        }
+
+        _hasUnsignaledSubmits = signalSemaphore == nullptr;
+    }
+
+    void VulkanUploader::retireBatches( bool waitForOldest ) {
+
+        // Batches complete in the order they were submitted, so stop at the first which has not.
+        while( !_submittedBatches.empty() ) {
+            VulkanUploadBatch* batch = _submittedBatches.front();
+            if( waitForOldest ) {
+                batch->Fence->Wait( U64_MAX );
+                waitForOldest = false;
+            } else if( !batch->Fence->Poll() ) {
+                break;
+            }
+
+            if( batch->StagingBytes > 0 ) {
+                _tail = batch->StagingEnd;
+                _used -= batch->StagingBytes;
+            }
+            batch->StagingBytes = 0;
+            batch->StagingEnd = 0;
+
+            for( U64 i = 0; i < batch->OversizedStaging.size(); ++i ) {
+                batch->OversizedStaging[i]->UnlockMemory();
+                delete batch->OversizedStaging[i];
+            }
+            batch->OversizedStaging.clear();
+
+            _submittedBatches.erase( _submittedBatches.begin() );
+            _freeBatches.push_back( batch );
+        }
+    }
+}
\ No newline at end of file
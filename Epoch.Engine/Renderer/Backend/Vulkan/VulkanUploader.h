@@ -0,0 +1,135 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../../../Types.h"
+
+namespace Epoch {
+
+    class VulkanDevice;
+    class VulkanQueue;
+    class VulkanFence;
+    class VulkanSemaphore;
+    class VulkanImage;
+    class VulkanInternalBuffer;
+    class VulkanCommandPool;
+    class VulkanCommandBuffer;
+
+    /**
+     * A set of uploads recorded into one command buffer and submitted together.
+     */
+    struct VulkanUploadBatch {
+        VulkanCommandBuffer* CommandBuffer = nullptr;
+        VulkanFence* Fence = nullptr;
+
+        // Where this batch's space in the staging ring ends, and how many bytes it holds, including any skipped when wrapping.
+        U64 StagingEnd = 0;
+        U64 StagingBytes = 0;
+
+        // Staging buffers for uploads too large for the ring. Destroyed once the batch completes.
+        std::vector<VulkanInternalBuffer*> OversizedStaging;
+    };
+
+    /**
+     * Uploads buffer and image data to the GPU without stalling. Data is copied into a persistently mapped staging ring,
+     * and copies are recorded into batches which are submitted to the transfer queue. Staging space is reclaimed as each
+     * batch's fence is signaled, and graphics work waits on the uploads through a semaphore rather than the CPU waiting.
+     */
+    class VulkanUploader {
+    public:
+
+        /**
+         * Creates a new uploader.
+         *
+         * @param device The device to upload to.
+         * @param queue The queue to submit uploads to.
+         * @param stagingSize The size in bytes of the staging ring.
+         */
+        VulkanUploader( VulkanDevice* device, VulkanQueue* queue, const U64 stagingSize );
+        ~VulkanUploader();
+
+        /**
+         * Uploads data to a range of the given buffer. The buffer must have been created with VK_BUFFER_USAGE_TRANSFER_DST_BIT.
+         *
+         * @param destination The buffer to upload to.
+         * @param destinationOffset The offset in bytes within the buffer to upload to.
+         * @param data A pointer to the data to be uploaded. Copied before returning, so it may be freed immediately.
+         * @param size The size of the data in bytes.
+         */
+        void UploadBuffer( VulkanInternalBuffer* destination, const U64 destinationOffset, const void* data, const U64 size );
+
+        /**
+         * Copies a range of one buffer to another, after any uploads already recorded and before any recorded later. Both
+         * buffers must outlive the copy, which is complete once anything waiting on the next signaled semaphore may run.
+         *
+         * @param source The buffer to copy from. Must have been created with VK_BUFFER_USAGE_TRANSFER_SRC_BIT.
+         * @param sourceOffset The offset in bytes within the source buffer to copy from.
+         * @param destination The buffer to copy to. Must have been created with VK_BUFFER_USAGE_TRANSFER_DST_BIT.
+         * @param destinationOffset The offset in bytes within the destination buffer to copy to.
+         * @param size The size of the range in bytes.
+         */
+        void CopyBuffer( VulkanInternalBuffer* source, const U64 sourceOffset, VulkanInternalBuffer* destination, const U64 destinationOffset, const U64 size );
+
+        /**
+         * Uploads pixels to every mip level of the given image, leaving it in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL. The
+         * image must have been created with VK_IMAGE_USAGE_TRANSFER_DST_BIT and be in an undefined layout.
+         *
+         * @param image The image to upload to.
+         * @param pixels A pointer to the pixel data of all levels. Copied before returning, so it may be freed immediately.
+         * @param size The size of the pixel data in bytes.
+         * @param mipOffsets The offset in bytes of each mip level within the pixel data, largest first. May be nullptr if the image has a single level.
+         */
+        void UploadImage( VulkanImage* image, const void* pixels, const U64 size, const U64* mipOffsets = nullptr );
+
+        /**
+         * Submits all uploads recorded since the last submit, and has the given semaphore signaled once every upload
+         * submitted so far is complete. Any graphics submission reading uploaded data must wait on the semaphore.
+         *
+         * @param signalSemaphore The semaphore to be signaled.
+         *
+         * @returns True if the semaphore will be signaled and must be waited on; false if nothing was uploaded since it was last signaled.
+         */
+        const bool Submit( VulkanSemaphore* signalSemaphore );
+
+        /**
+         * Reclaims the staging space and batches of any uploads the GPU has finished. Never waits.
+         */
+        void Update();
+
+        /**
+         * Submits any recorded uploads and waits for all uploads to complete.
+         */
+        void WaitIdle();
+
+    private:
+        U8* allocateStaging( const U64 size, VkBuffer* outBuffer, U64* outOffset );
+        const bool tryAllocateFromRing( const U64 size, U64* outOffset, U64* outSkipped );
+        VulkanUploadBatch* getRecordingBatch();
+        void submitBatch( VulkanSemaphore* signalSemaphore );
+        void retireBatches( bool waitForOldest );
+
+    private:
+        VulkanDevice* _device;
+        VulkanQueue* _queue;
+        VulkanCommandPool* _commandPool;
+        std::mutex _mutex;
+
+        // The staging ring. Bytes in use run from the tail up to the head, wrapping at the end.
+        VulkanInternalBuffer* _stagingBuffer;
+        U8* _stagingMemory;
+        U64 _stagingSize;
+        U64 _head = 0;
+        U64 _tail = 0;
+        U64 _used = 0;
+
+        // The batch currently being recorded, batches submitted but not yet complete (oldest first), and batches ready for reuse.
+        VulkanUploadBatch* _recordingBatch = nullptr;
+        std::vector<VulkanUploadBatch*> _submittedBatches;
+        std::vector<VulkanUploadBatch*> _freeBatches;
+
+        // Whether batches have been submitted since a semaphore was last signaled.
+        bool _hasUnsignaledSubmits = false;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+
+#include "../../Memory/Memory.h"
+
+#include "DrawSorter.h"
+
+namespace Epoch {
+
+    const U64 DrawSorter::MakeKey( const DrawPass pass, const U32 shaderId, const U32 materialId, const U32 meshId ) {
+        U64 key = 0;
+        key |= ( (U64)pass & ( ( 1ULL << DRAW_SORT_PASS_BITS ) - 1 ) ) << DRAW_SORT_PASS_SHIFT;
+        key |= ( (U64)shaderId & ( ( 1ULL << DRAW_SORT_SHADER_BITS ) - 1 ) ) << DRAW_SORT_SHADER_SHIFT;
+        key |= ( (U64)materialId & ( ( 1ULL << DRAW_SORT_MATERIAL_BITS ) - 1 ) ) << DRAW_SORT_MATERIAL_SHIFT;
+        key |= ( (U64)meshId & ( ( 1ULL << DRAW_SORT_MESH_BITS ) - 1 ) ) << DRAW_SORT_MESH_SHIFT;
+        return key;
+    }
+
+    const U64 DrawSorter::SetDepth( const U64 key, const DrawPass pass, const F32 normalizedDepth ) {
+        const U32 maxBucket = ( 1U << DRAW_SORT_DEPTH_BITS ) - 1;
+        F32 depth = normalizedDepth < 0.0f ? 0.0f : ( normalizedDepth > 1.0f ? 1.0f : normalizedDepth );
+        U32 bucket = (U32)( depth * (F32)maxBucket );
+        if( pass == DrawPass::Transparent ) {
+            bucket = maxBucket - bucket;
+        }
+        U64 depthMask = (U64)maxBucket << DRAW_SORT_DEPTH_SHIFT;
+        return ( key & ~depthMask ) | ( (U64)bucket << DRAW_SORT_DEPTH_SHIFT );
+    }
+
+    void DrawSorter::Sort( U64* keys, U32* values, const U32 count, U64* scratchKeys, U32* scratchValues ) {
+        if( count < 2 ) {
+            return;
+        }
+
+        // Count every byte of every key up front, so a single read of the keys covers all 8 passes.
+        U32 histograms[8][256];
+        TMemory::MemZero( histograms, sizeof( histograms ) );
+        for( U32 i = 0; i < count; ++i ) {
+            U64 key = keys[i];
+            for( U32 b = 0; b < 8; ++b ) {
+                histograms[b][( key >> ( b * 8 ) ) & 0xFF]++;
+            }
+        }
+
+        U64* sourceKeys = keys;
+        U32* sourceValues = values;
+        U64* targetKeys = scratchKeys;
+        U32* targetValues = scratchValues;
+        for( U32 b = 0; b < 8; ++b ) {
+            U32* histogram = histograms[b];
+            U32 shift = b * 8;
+
+            // If every key has the same value for this byte, this pass would not move anything.
+            if( histogram[( sourceKeys[0] >> shift ) & 0xFF] == count ) {
+                continue;
+            }
+
+            // Turn the counts into the offset of each bucket.
+            U32 offset = 0;
+            for( U32 i = 0; i < 256; ++i ) {
+                U32 bucketCount = histogram[i];
+                histogram[i] = offset;
+                offset += bucketCount;
+            }
+
+            for( U32 i = 0; i < count; ++i ) {
+                U32 destination = histogram[( sourceKeys[i] >> shift ) & 0xFF]++;
+                targetKeys[destination] = sourceKeys[i];
+                targetValues[destination] = sourceValues[i];
+            }
+
+            U64* tempKeys = sourceKeys;
+            sourceKeys = targetKeys;
+            targetKeys = tempKeys;
+            U32* tempValues = sourceValues;
+            sourceValues = targetValues;
+            targetValues = tempValues;
+        }
+
+        // An odd number of passes leaves the result in the scratch arrays.
+        if( sourceKeys != keys ) {
+            TMemory::Memcpy( keys, sourceKeys, sizeof( U64 ) * count );
+            TMemory::Memcpy( values, sourceValues, sizeof( U32 ) * count );
+        }
+    }
+}
\ No newline at end of file
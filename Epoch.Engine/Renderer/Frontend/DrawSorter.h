@@ -0,0 +1,90 @@
+#pragma once
+
+#include "../../Types.h"
+#include "../../Defines.h"
+
+// The layout of a draw sort key, from the most significant bits down. Draws sort by pass, then pipeline, then
+// material, then mesh, then depth, so that state which is most expensive to change changes least often.
+#define DRAW_SORT_PASS_BITS 4
+#define DRAW_SORT_SHADER_BITS 10
+#define DRAW_SORT_MATERIAL_BITS 14
+#define DRAW_SORT_MESH_BITS 20
+#define DRAW_SORT_DEPTH_BITS 16
+
+#define DRAW_SORT_DEPTH_SHIFT 0
+#define DRAW_SORT_MESH_SHIFT ( DRAW_SORT_DEPTH_SHIFT + DRAW_SORT_DEPTH_BITS )
+#define DRAW_SORT_MATERIAL_SHIFT ( DRAW_SORT_MESH_SHIFT + DRAW_SORT_MESH_BITS )
+#define DRAW_SORT_SHADER_SHIFT ( DRAW_SORT_MATERIAL_SHIFT + DRAW_SORT_MATERIAL_BITS )
+#define DRAW_SORT_PASS_SHIFT ( DRAW_SORT_SHADER_SHIFT + DRAW_SORT_SHADER_BITS )
+
+namespace Epoch {
+
+    /**
+     * The passes draws are sorted into, in the order they are drawn.
+     */
+    enum class DrawPass : U8 {
+        Opaque = 0,
+        Transparent = 1
+    };
+
+    /**
+     * Builds and sorts packed 64-bit draw sort keys.
+     */
+    class EPOCH_API DrawSorter final {
+    public:
+
+        /**
+         * Packs the state of a draw into a sort key. Ids are small, dense values assigned by the caller, and are
+         * masked to the number of bits available for them.
+         *
+         * @param pass The pass the draw belongs to.
+         * @param shaderId The id of the shader/pipeline used by the draw.
+         * @param materialId The id of the material used by the draw.
+         * @param meshId The id of the mesh drawn.
+         *
+         * @returns The sort key, with an empty depth bucket.
+         */
+        static const U64 MakeKey( const DrawPass pass, const U32 shaderId, const U32 materialId, const U32 meshId );
+
+        /**
+         * Returns the given sort key with its depth bucket set. Opaque draws sort front to back, and transparent draws back to front.
+         *
+         * @param key The key to set the depth bucket of.
+         * @param pass The pass the draw belongs to.
+         * @param normalizedDepth The distance of the draw from the camera, where 0 is nearest and 1 is farthest.
+         */
+        static const U64 SetDepth( const U64 key, const DrawPass pass, const F32 normalizedDepth );
+
+        /**
+         * Returns the shader id held by the given sort key.
+         */
+        static const U32 GetShaderId( const U64 key ) { return (U32)( ( key >> DRAW_SORT_SHADER_SHIFT ) & ( ( 1ULL << DRAW_SORT_SHADER_BITS ) - 1 ) ); }
+
+        /**
+         * Returns the material id held by the given sort key.
+         */
+        static const U32 GetMaterialId( const U64 key ) { return (U32)( ( key >> DRAW_SORT_MATERIAL_SHIFT ) & ( ( 1ULL << DRAW_SORT_MATERIAL_BITS ) - 1 ) ); }
+
+        /**
+         * Returns the mesh id held by the given sort key.
+         */
+        static const U32 GetMeshId( const U64 key ) { return (U32)( ( key >> DRAW_SORT_MESH_SHIFT ) & ( ( 1ULL << DRAW_SORT_MESH_BITS ) - 1 ) ); }
+
+        /**
+         * Sorts keys in ascending order, along with a value for each, using a stable least-significant-digit
+         * radix sort in linear time. Byte positions which are the same across every key are skipped, so keys
+         * which only use some of their bits sort in fewer passes.
+         *
+         * @param keys A pointer to an array of keys to be sorted in place.
+         * @param values A pointer to an array of values to be reordered along with the keys.
+         * @param count The number of keys.
+         * @param scratchKeys A pointer to an array of at least count keys, used while sorting.
+         * @param scratchValues A pointer to an array of at least count values, used while sorting.
+         */
+        static void Sort( U64* keys, U32* values, const U32 count, U64* scratchKeys, U32* scratchValues );
+
+    private:
+        DrawSorter() noexcept {}
+        ~DrawSorter() noexcept {}
+    };
+}
\ No newline at end of file
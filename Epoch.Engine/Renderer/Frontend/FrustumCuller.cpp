@@ -0,0 +1,184 @@
+#include "../../Math/SSEMath.h"
+#include "../../Math/TMath.h"
+#include "../../Math/Frustum.h"
+#include "../../Platform/WorkerPool.h"
+
+#include "FrustumCuller.h"
+
+// Below this many boxes per thread, the cost of handing work to another thread outweighs the work.
+#define CULLING_MIN_BOXES_PER_THREAD 16384
+
+namespace Epoch {
+
+    void CullingBounds::Add( const AABB& box ) {
+        Vector3 center = box.GetCenter();
+        Vector3 extents = box.GetExtents();
+        CenterX.Add( center.X );
+        CenterY.Add( center.Y );
+        CenterZ.Add( center.Z );
+        ExtentX.Add( extents.X );
+        ExtentY.Add( extents.Y );
+        ExtentZ.Add( extents.Z );
+    }
+
+    void CullingBounds::Set( const U32 index, const AABB& box ) {
+        Vector3 center = box.GetCenter();
+        Vector3 extents = box.GetExtents();
+        CenterX[index] = center.X;
+        CenterY[index] = center.Y;
+        CenterZ[index] = center.Z;
+        ExtentX[index] = extents.X;
+        ExtentY[index] = extents.Y;
+        ExtentZ[index] = extents.Z;
+    }
+
+    void CullingBounds::RemoveAtSwap( const U32 index ) {
+        CenterX.RemoveAtSwap( index );
+        CenterY.RemoveAtSwap( index );
+        CenterZ.RemoveAtSwap( index );
+        ExtentX.RemoveAtSwap( index );
+        ExtentY.RemoveAtSwap( index );
+        ExtentZ.RemoveAtSwap( index );
+    }
+
+    void CullingBounds::Clear() {
+        CenterX.Clear();
+        CenterY.Clear();
+        CenterZ.Clear();
+        ExtentX.Clear();
+        ExtentY.Clear();
+        ExtentZ.Clear();
+    }
+
+    const U32 FrustumCuller::Cull( const Frustum& frustum, const CullingBounds& bounds, U32* outVisibleIndices, const U32 maxThreads ) {
+        U32 count = bounds.Size();
+
+        // The shared pool's workers, plus the calling thread.
+        WorkerPool* workers = WorkerPool::GetShared();
+        U32 threadCount = workers->GetWorkerCount() + 1;
+        if( maxThreads != 0 && threadCount > maxThreads ) {
+            threadCount = maxThreads;
+        }
+        U32 usefulThreads = count / CULLING_MIN_BOXES_PER_THREAD;
+        if( threadCount > usefulThreads ) {
+            threadCount = usefulThreads;
+        }
+
+        if( threadCount <= 1 ) {
+            return CullRange( frustum, bounds, 0, count, outVisibleIndices );
+        }
+
+        // Each thread writes its visible indices to the start of its own slice of the output, and the
+        // slices are compacted afterward. This keeps the output in ascending order with no synchronization.
+        U32 chunkSize = ( count + threadCount - 1 ) / threadCount;
+        U32 chunkResults[64];
+        if( threadCount > 64 ) {
+            threadCount = 64;
+            chunkSize = ( count + threadCount - 1 ) / threadCount;
+        }
+
+        workers->Run( threadCount, [&frustum, &bounds, &chunkResults, outVisibleIndices, chunkSize, count]( const U32 t ) {
+            U32 first = chunkSize * t;
+            U32 chunkCount = first >= count ? 0 : ::Min( chunkSize, count - first );
+            chunkResults[t] = CullRange( frustum, bounds, first, chunkCount, outVisibleIndices + first );
+        } );
+
+        U32 visibleCount = chunkResults[0];
+        for( U32 t = 1; t < threadCount; ++t ) {
+            U32* source = outVisibleIndices + ( chunkSize * t );
+            for( U32 i = 0; i < chunkResults[t]; ++i ) {
+                outVisibleIndices[visibleCount++] = source[i];
+            }
+        }
+
+        return visibleCount;
+    }
+
+    const U32 FrustumCuller::CullRange( const Frustum& frustum, const CullingBounds& bounds, const U32 first, const U32 count, U32* outVisibleIndices ) {
+        const F32* cx = bounds.CenterX.Data();
+        const F32* cy = bounds.CenterY.Data();
+        const F32* cz = bounds.CenterZ.Data();
+        const F32* ex = bounds.ExtentX.Data();
+        const F32* ey = bounds.ExtentY.Data();
+        const F32* ez = bounds.ExtentZ.Data();
+
+        // Splat each plane across a register once up front.
+        VectorRegister planeX[6];
+        VectorRegister planeY[6];
+        VectorRegister planeZ[6];
+        VectorRegister planeD[6];
+        VectorRegister planeAbsX[6];
+        VectorRegister planeAbsY[6];
+        VectorRegister planeAbsZ[6];
+        for( U32 p = 0; p < 6; ++p ) {
+            const Plane& plane = frustum.Planes[p];
+            planeX[p] = _mm_set1_ps( plane.Normal.X );
+            planeY[p] = _mm_set1_ps( plane.Normal.Y );
+            planeZ[p] = _mm_set1_ps( plane.Normal.Z );
+            planeD[p] = _mm_set1_ps( plane.Distance );
+            planeAbsX[p] = _mm_set1_ps( TMath::Abs( plane.Normal.X ) );
+            planeAbsY[p] = _mm_set1_ps( TMath::Abs( plane.Normal.Y ) );
+            planeAbsZ[p] = _mm_set1_ps( TMath::Abs( plane.Normal.Z ) );
+        }
+        const VectorRegister zero = _mm_setzero_ps();
+
+        U32 visibleCount = 0;
+        U32 end = first + count;
+        U32 i = first;
+
+        // Test 4 boxes per iteration. A box is outside if, for any plane, center distance + projected radius < 0.
+        for( ; i + 4 <= end; i += 4 ) {
+            VectorRegister centerX = _mm_loadu_ps( cx + i );
+            VectorRegister centerY = _mm_loadu_ps( cy + i );
+            VectorRegister centerZ = _mm_loadu_ps( cz + i );
+            VectorRegister extentX = _mm_loadu_ps( ex + i );
+            VectorRegister extentY = _mm_loadu_ps( ey + i );
+            VectorRegister extentZ = _mm_loadu_ps( ez + i );
+
+            VectorRegister outside = zero;
+            for( U32 p = 0; p < 6; ++p ) {
+                VectorRegister distance = _mm_add_ps( _mm_add_ps( _mm_mul_ps( planeX[p], centerX ), _mm_mul_ps( planeY[p], centerY ) ), _mm_add_ps( _mm_mul_ps( planeZ[p], centerZ ), planeD[p] ) );
+                VectorRegister radius = _mm_add_ps( _mm_add_ps( _mm_mul_ps( planeAbsX[p], extentX ), _mm_mul_ps( planeAbsY[p], extentY ) ), _mm_mul_ps( planeAbsZ[p], extentZ ) );
+                outside = _mm_or_ps( outside, _mm_cmplt_ps( _mm_add_ps( distance, radius ), zero ) );
+            }
+
+            I32 visibleMask = ~_mm_movemask_ps( outside ) & 0xF;
+            while( visibleMask ) {
+                U32 lane = 0;
+                while( ( visibleMask & ( 1 << lane ) ) == 0 ) {
+                    ++lane;
+                }
+                outVisibleIndices[visibleCount++] = i + lane;
+                visibleMask &= ~( 1 << lane );
+            }
+        }
+
+        // Handle any remaining boxes individually.
+        if( i < end ) {
+            visibleCount += CullRangeScalar( frustum, bounds, i, end - i, outVisibleIndices + visibleCount );
+        }
+
+        return visibleCount;
+    }
+
+    const U32 FrustumCuller::CullRangeScalar( const Frustum& frustum, const CullingBounds& bounds, const U32 first, const U32 count, U32* outVisibleIndices ) {
+        U32 visibleCount = 0;
+        U32 end = first + count;
+        for( U32 i = first; i < end; ++i ) {
+            bool visible = true;
+            for( U32 p = 0; p < 6; ++p ) {
+                const Plane& plane = frustum.Planes[p];
+                F32 distance = plane.Normal.X * bounds.CenterX[i] + plane.Normal.Y * bounds.CenterY[i] + plane.Normal.Z * bounds.CenterZ[i] + plane.Distance;
+                F32 radius = TMath::Abs( plane.Normal.X ) * bounds.ExtentX[i] + TMath::Abs( plane.Normal.Y ) * bounds.ExtentY[i] + TMath::Abs( plane.Normal.Z ) * bounds.ExtentZ[i];
+                if( distance + radius < 0.0f ) {
+                    visible = false;
+                    break;
+                }
+            }
+            if( visible ) {
+                outVisibleIndices[visibleCount++] = i;
+            }
+        }
+        return visibleCount;
+    }
+}
\ No newline at end of file
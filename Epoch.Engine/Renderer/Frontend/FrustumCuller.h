@@ -0,0 +1,101 @@
+#pragma once
+
+#include "../../Types.h"
+#include "../../Defines.h"
+#include "../../Containers/List.h"
+#include "../../Math/BoundingVolumes.h"
+
+namespace Epoch {
+
+    struct Frustum;
+
+    /**
+     * World-space bounding boxes stored as separate center/extent component arrays, so that
+     * several boxes can be tested against a plane at once using SIMD.
+     */
+    struct EPOCH_API CullingBounds {
+    public:
+        List<F32> CenterX;
+        List<F32> CenterY;
+        List<F32> CenterZ;
+        List<F32> ExtentX;
+        List<F32> ExtentY;
+        List<F32> ExtentZ;
+
+    public:
+
+        /**
+         * Appends the given box.
+         *
+         * @param box The box to add.
+         */
+        void Add( const AABB& box );
+
+        /**
+         * Replaces the box at the given index.
+         *
+         * @param index The index of the box to replace.
+         * @param box The new box.
+         */
+        void Set( const U32 index, const AABB& box );
+
+        /**
+         * Removes the box at the given index by moving the last box into its place.
+         *
+         * @param index The index of the box to remove.
+         */
+        void RemoveAtSwap( const U32 index );
+
+        /**
+         * Removes all boxes.
+         */
+        void Clear();
+
+        /**
+         * Returns the number of boxes held.
+         */
+        const U32 Size() const { return CenterX.Size(); }
+    };
+
+    /**
+     * Tests world-space bounds against a view frustum to determine which objects are visible.
+     */
+    class EPOCH_API FrustumCuller final {
+    public:
+
+        /**
+         * Culls all of the given bounds against the given frustum, splitting the work across threads when
+         * there are enough boxes for it to be worthwhile.
+         *
+         * @param frustum The frustum to test against.
+         * @param bounds The bounds to be tested.
+         * @param outVisibleIndices A pointer to an array of at least bounds.Size() elements which receives the indices of visible boxes in ascending order.
+         * @param maxThreads The maximum number of threads to use, including the caller. 0 uses all of the shared worker pool. Default: 0.
+         *
+         * @returns The number of visible boxes.
+         */
+        static const U32 Cull( const Frustum& frustum, const CullingBounds& bounds, U32* outVisibleIndices, const U32 maxThreads = 0 );
+
+        /**
+         * Culls a range of the given bounds against the given frustum on the calling thread, 4 boxes at a time.
+         *
+         * @param frustum The frustum to test against.
+         * @param bounds The bounds to be tested.
+         * @param first The index of the first box to be tested.
+         * @param count The number of boxes to be tested.
+         * @param outVisibleIndices A pointer to an array of at least count elements which receives the indices of visible boxes in ascending order.
+         *
+         * @returns The number of visible boxes.
+         */
+        static const U32 CullRange( const Frustum& frustum, const CullingBounds& bounds, const U32 first, const U32 count, U32* outVisibleIndices );
+
+        /**
+         * A scalar reference implementation of CullRange. Used for testing and benchmarking.
+         */
+        static const U32 CullRangeScalar( const Frustum& frustum, const CullingBounds& bounds, const U32 first, const U32 count, U32* outVisibleIndices );
+
+    private:
+        FrustumCuller() noexcept {}
+        ~FrustumCuller() noexcept {}
+    };
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 
 #include "../../Resources/ITexture.h"
+#include "../../Resources/StaticMesh.h"
 #include "../../Engine.h"
 #include "../../Logger.h"
 #include "../Backend/IRendererBackend.h"
@@ -7,6 +8,9 @@
 #include "../TextureCache.h"
 #include "../Material.h"
 #include "../../World/World.h"
+#include "../../Math/Frustum.h"
+#include "FrustumCuller.h"
+#include "DrawSorter.h"
 
 #include "RendererFrontend.h"
 
@@ -21,16 +25,40 @@ namespace Epoch {
     // The internal texture cache.
     TextureCache* RendererFrontEnd::_textureCache;
 
+    // Indices into the render table of static meshes which survived culling this frame.
+    List<U32> RendererFrontEnd::_visibleStaticMeshes;
+    U32 RendererFrontEnd::_culledStaticMeshCount = 0;
+
+    // The visible static meshes grouped for instanced drawing, and the world matrices of every instance, ordered by group.
+    List<StaticMeshInstanceGroup> RendererFrontEnd::_staticMeshInstanceGroups;
+    List<Matrix4x4> RendererFrontEnd::_staticMeshInstanceTransforms;
+
+    // The bounds of every instance when culling on the GPU, and which version of which render table the backend was last given.
+    List<AABB> RendererFrontEnd::_staticMeshInstanceBounds;
+    WorldRenderableObjectTable* RendererFrontEnd::_submittedObjectTable = nullptr;
+    U32 RendererFrontEnd::_submittedObjectTableVersion = 0;
+
+    std::unordered_map<const IShader*, U32> RendererFrontEnd::_shaderSortIds;
+    std::unordered_map<const BaseMaterial*, U32> RendererFrontEnd::_materialSortIds;
+    std::unordered_map<const StaticMeshRenderReferenceData*, U64> RendererFrontEnd::_meshSortKeys;
+    List<U64> RendererFrontEnd::_drawSortKeys;
+    List<F32> RendererFrontEnd::_drawDepths;
+    List<U64> RendererFrontEnd::_drawSortScratchKeys;
+    List<U32> RendererFrontEnd::_drawSortScratchIndices;
+
     const bool RendererFrontEnd::Initialize( Engine* engine ) {
 
         _engine = engine;
         const bool validationEnabled = false;
+
+        // The number of frames the CPU may record ahead of the GPU.
+        const U8 framesInFlight = 2;
         Logger::Log( "Created renderer front end. Renderer validation %s enabled.", validationEnabled ? "IS" : "IS NOT" );
 
         // TODO: Choose this from configuration instead of hardcoding it.
         // TODO: Should probably be created via factory to prevent this class from knowing about the specific type.
         _backend = new VulkanRendererBackend( _engine->GetApplication() );
-        _backend->Initialize( validationEnabled );
+        _backend->Initialize( validationEnabled, framesInFlight );
 
         _textureCache = new TextureCache();
         _textureCache->Initialize();
@@ -62,19 +90,52 @@ namespace Epoch {
 
     const bool RendererFrontEnd::Frame( World* world, const F32 deltaTime ) {
 
+        // Nothing to do once the backend has begun shutting down.
+        if( _backend->IsShutdown() ) {
+            return true;
+        }
+
         // TODO: Get a pointer to the world, then  the ask it for all objects to be rendered.
         // Sort these by entity type. Render sky, then statics, terrain, animated, then special items such as fog, water, etc. 
         WorldRenderableObjectTable* objectTable = world->GetRenderableObjects();
 
         // TODO: All front-end work goes here (scene sorting, culling, etc) before adding the object to the render table.
 
-        /*if( objectTable->StaticMeshCount > 1 ) {
-            sortByMaterialShader( objectTable->StaticMeshes, objectTable->StaticMeshCount );
-        }*/
-
-        _backend->SetRenderTable( objectTable );
-
-        // TODO: Within each group, sort by material.
+        // Frustum culling.
+        _backend->SetActiveCamera( world->GetActiveCamera() );
+        Matrix4x4 view;
+        Matrix4x4 projection;
+        _backend->GetViewProjection( &view, &projection );
+        Frustum frustum = Frustum::FromViewProjection( projection * view );
+
+        U32 staticMeshCount = objectTable->StaticMeshBounds.Size();
+        if( _backend->SupportsGpuCulling() ) {
+
+            // The backend culls and builds the draws itself each frame, so everything is sent unculled, and only when something changed.
+            if( objectTable != _submittedObjectTable || objectTable->Version != _submittedObjectTableVersion ) {
+                _visibleStaticMeshes.Resize( staticMeshCount );
+                for( U32 i = 0; i < staticMeshCount; ++i ) {
+                    _visibleStaticMeshes[i] = i;
+                }
+                sortVisibleStaticMeshes( objectTable, view );
+                buildInstanceGroups( objectTable );
+                buildInstanceBounds( objectTable );
+                _backend->SetStaticMeshObjects( _staticMeshInstanceGroups.Data(), _staticMeshInstanceGroups.Size(), _staticMeshInstanceTransforms.Data(), _staticMeshInstanceBounds.Data(), _staticMeshInstanceTransforms.Size() );
+                _submittedObjectTable = objectTable;
+                _submittedObjectTableVersion = objectTable->Version;
+            }
+            _culledStaticMeshCount = 0;
+        } else {
+            _visibleStaticMeshes.Resize( staticMeshCount );
+            U32 visibleCount = FrustumCuller::Cull( frustum, objectTable->StaticMeshBounds, _visibleStaticMeshes.Data() );
+            _visibleStaticMeshes.Resize( visibleCount );
+            _culledStaticMeshCount = staticMeshCount - visibleCount;
+
+            // Sort by state, then draw instances of the same mesh and material together.
+            sortVisibleStaticMeshes( objectTable, view );
+            buildInstanceGroups( objectTable );
+            _backend->SetStaticMeshInstances( _staticMeshInstanceGroups.Data(), _staticMeshInstanceGroups.Size(), _staticMeshInstanceTransforms.Data(), _staticMeshInstanceTransforms.Size() );
+        }
 
         // TODO: For special items like fog and water, specialized calls will need to be made as these will require additional render passes.
 
@@ -83,15 +144,11 @@ namespace Epoch {
         // TODO: Finally render UI
 
         // If the frame preparation indicates we should wait, boot out early.
-        if( !_backend->IsShutdown() ) {
-            if( !_backend->PrepareFrame( deltaTime ) ) {
-                return true;
-            }
-
-            return _backend->Frame( deltaTime );
-        } else {
+        if( !_backend->PrepareFrame( deltaTime ) ) {
             return true;
         }
+
+        return _backend->Frame( deltaTime );
     }
 
     const bool RendererFrontEnd::UploadMeshData( const MeshUploadData& data, StaticMeshRenderReferenceData* referenceData ) {
@@ -132,39 +189,85 @@ namespace Epoch {
         return _backend->GetBuiltinMaterialShader( type );
     }
 
-    void swap( StaticMeshEntityComponent* a, StaticMeshEntityComponent* b ) {
-        StaticMeshEntityComponent* temp = a;
-        a = b;
-        b = temp;
+    const RenderStateStats RendererFrontEnd::GetRenderStateStats() {
+        return _backend->GetRenderStateStats();
     }
 
-    int partition( StaticMeshEntityComponent* arr[], I64 low, I64 high ) {
-        StaticMeshEntityComponent* pivot = arr[high];
-        I64 i = ( low - 1 );
-
-        for( I64 j = low; j <= high - 1; ++j ) {
-            // If current element is smaller than pivot, increment the low element.
-            // TODO: Need to sort this by actual id versus just address.
-            if( ( (StaticMeshRenderReferenceData*)arr[j]->GetReferenceData() )->Material <= ( (StaticMeshRenderReferenceData*)pivot )->Material ) {
-                i++;
-                swap( arr[i], arr[j] );
+    void RendererFrontEnd::sortVisibleStaticMeshes( WorldRenderableObjectTable* objectTable, const Matrix4x4& view ) {
+        _shaderSortIds.clear();
+        _materialSortIds.clear();
+        _meshSortKeys.clear();
+
+        U32 visibleCount = _visibleStaticMeshes.Size();
+        _drawSortKeys.Resize( visibleCount );
+        _drawDepths.Resize( visibleCount );
+
+        // The view matrix is column-major, so the view-space z of a point is the dot product of its third row with the point.
+        const F32* v = view.Data();
+        const CullingBounds& bounds = objectTable->StaticMeshBounds;
+        F32 maxDepth = 0.0f;
+        for( U32 i = 0; i < visibleCount; ++i ) {
+            U32 index = _visibleStaticMeshes[i];
+            StaticMeshRenderReferenceData* ref = static_cast<StaticMeshRenderReferenceData*>( objectTable->StaticMeshes[index].Component->GetReferenceData() );
+
+            // Reference data is shared by all components using the same mesh, so ids only need to be looked up once per mesh.
+            auto meshResult = _meshSortKeys.emplace( ref, 0 );
+            if( meshResult.second ) {
+                IShader* shader = ref->Material->GetShader();
+                U32 shaderId = _shaderSortIds.emplace( shader, (U32)_shaderSortIds.size() ).first->second;
+                U32 materialId = _materialSortIds.emplace( ref->Material, (U32)_materialSortIds.size() ).first->second;
+                U32 meshId = (U32)_meshSortKeys.size() - 1;
+                meshResult.first->second = DrawSorter::MakeKey( DrawPass::Opaque, shaderId, materialId, meshId );
+            }
+            _drawSortKeys[i] = meshResult.first->second;
+
+            // Only visible objects are sorted, which are all in front of the camera, so the distance is the absolute view-space z.
+            F32 depth = v[2] * bounds.CenterX[index] + v[6] * bounds.CenterY[index] + v[10] * bounds.CenterZ[index] + v[14];
+            depth = depth < 0.0f ? -depth : depth;
+            _drawDepths[i] = depth;
+            if( depth > maxDepth ) {
+                maxDepth = depth;
             }
         }
-        swap( arr[i + 1], arr[high] );
-        return ( i + 1 );
-    }
 
-    void quickSort( StaticMeshEntityComponent* arr[], I64 low, I64 high ) {
-        if( low < high ) {
-            I64 pivot = partition( arr, low, high );
+        F32 depthScale = maxDepth > 0.0f ? 1.0f / maxDepth : 0.0f;
+        for( U32 i = 0; i < visibleCount; ++i ) {
+            _drawSortKeys[i] = DrawSorter::SetDepth( _drawSortKeys[i], DrawPass::Opaque, _drawDepths[i] * depthScale );
+        }
+
+        _drawSortScratchKeys.Resize( visibleCount );
+        _drawSortScratchIndices.Resize( visibleCount );
+        DrawSorter::Sort( _drawSortKeys.Data(), _visibleStaticMeshes.Data(), visibleCount, _drawSortScratchKeys.Data(), _drawSortScratchIndices.Data() );
+    }
 
-            // Sort sub-arrays indepently
-            quickSort( arr, low, pivot - 1 );
-            quickSort( arr, pivot + 1, high );
+    void RendererFrontEnd::buildInstanceGroups( WorldRenderableObjectTable* objectTable ) {
+        _staticMeshInstanceGroups.Clear();
+
+        // Draws are sorted, so each mesh's instances are already adjacent and in order front to back. A new group starts wherever the mesh changes.
+        U32 visibleCount = _visibleStaticMeshes.Size();
+        _staticMeshInstanceTransforms.Resize( visibleCount );
+        for( U32 i = 0; i < visibleCount; ++i ) {
+            const StaticMeshRenderProxy& proxy = objectTable->StaticMeshes[_visibleStaticMeshes[i]];
+            if( i == 0 || DrawSorter::GetMeshId( _drawSortKeys[i] ) != DrawSorter::GetMeshId( _drawSortKeys[i - 1] ) ) {
+                StaticMeshInstanceGroup group;
+                group.ReferenceData = static_cast<StaticMeshRenderReferenceData*>( proxy.Component->GetReferenceData() );
+                group.FirstInstance = i;
+                _staticMeshInstanceGroups.Add( group );
+            }
+            _staticMeshInstanceGroups[_staticMeshInstanceGroups.Size() - 1].InstanceCount++;
+            _staticMeshInstanceTransforms[i] = proxy.WorldMatrix;
         }
     }
 
-    void RendererFrontEnd::sortByMaterialShader( StaticMeshEntityComponent** references, I32 count ) {
-        quickSort( references, 0, count - 1 );
+    void RendererFrontEnd::buildInstanceBounds( WorldRenderableObjectTable* objectTable ) {
+        const CullingBounds& bounds = objectTable->StaticMeshBounds;
+        U32 instanceCount = _visibleStaticMeshes.Size();
+        _staticMeshInstanceBounds.Resize( instanceCount );
+        for( U32 i = 0; i < instanceCount; ++i ) {
+            U32 index = _visibleStaticMeshes[i];
+            Vector3 center( bounds.CenterX[index], bounds.CenterY[index], bounds.CenterZ[index] );
+            Vector3 extent( bounds.ExtentX[index], bounds.ExtentY[index], bounds.ExtentZ[index] );
+            _staticMeshInstanceBounds[i] = AABB( center - extent, center + extent );
+        }
     }
 }
\ No newline at end of file
@@ -1,6 +1,12 @@
 #pragma once
 
+#include <unordered_map>
+
 #include "../../Types.h"
+#include "../../Containers/List.h"
+#include "../../Math/Matrix4x4.h"
+#include "../../Math/BoundingVolumes.h"
+#include "../RenderData.h"
 
 namespace Epoch {
 
@@ -8,6 +14,7 @@ namespace Epoch {
     struct MeshUploadData;
     struct StaticMeshRenderReferenceData;
     class StaticMeshEntityComponent;
+    struct WorldRenderableObjectTable;
 
     class Engine;
     class World;
@@ -16,6 +23,7 @@ namespace Epoch {
     class TextureCache;
     class ITexture;
     class IShader;
+    class BaseMaterial;
 
     /*
      The renderer "front-end", which represents the interaction point with the rest of the engine.
@@ -69,12 +77,40 @@ namespace Epoch {
 
         static IShader* GetBuiltinMaterialShader( const MaterialType type );
 
+        /**
+         * Returns the number of static meshes which survived culling in the last frame. When culling on the GPU, this is
+         * every static mesh, as the results never come back to the CPU.
+         */
+        static const U32 GetVisibleStaticMeshCount() { return _visibleStaticMeshes.Size(); }
+
+        /**
+         * Returns the number of static meshes which were culled on the CPU in the last frame.
+         */
+        static const U32 GetCulledStaticMeshCount() { return _culledStaticMeshCount; }
+
+        /**
+         * Returns the number of instanced static mesh draws issued in the last frame.
+         */
+        static const U32 GetStaticMeshDrawCount() { return _staticMeshInstanceGroups.Size(); }
+
+        /**
+         * Returns the number of state changes made and skipped by the back end in the last recorded frame.
+         */
+        static const RenderStateStats GetRenderStateStats();
+
     private:
         // Remove the ability to instantiate this class.
         RendererFrontEnd() noexcept {}
         ~RendererFrontEnd() noexcept {}
 
-        static void sortByMaterialShader( StaticMeshEntityComponent** references, I32 count );
+        // Builds a sort key for each visible static mesh and sorts them, so that draws sharing state are adjacent.
+        static void sortVisibleStaticMeshes( WorldRenderableObjectTable* objectTable, const Matrix4x4& view );
+
+        // Groups the sorted static meshes by mesh and material, gathering their world matrices so each group's are contiguous.
+        static void buildInstanceGroups( WorldRenderableObjectTable* objectTable );
+
+        // Collects the bounds of every instance in the same order as their transforms, for culling on the GPU.
+        static void buildInstanceBounds( WorldRenderableObjectTable* objectTable );
 
     private:
 
@@ -85,5 +121,32 @@ namespace Epoch {
         static IRendererBackend* _backend;
 
         static TextureCache* _textureCache;
+
+        // Indices into the render table of static meshes which survived culling this frame.
+        static List<U32> _visibleStaticMeshes;
+        static U32 _culledStaticMeshCount;
+
+        // The visible static meshes grouped for instanced drawing, and the world matrices of every instance, ordered by group.
+        static List<StaticMeshInstanceGroup> _staticMeshInstanceGroups;
+        static List<Matrix4x4> _staticMeshInstanceTransforms;
+
+        // The bounds of every instance when culling on the GPU, and which version of which render table the backend was last given.
+        static List<AABB> _staticMeshInstanceBounds;
+        static WorldRenderableObjectTable* _submittedObjectTable;
+        static U32 _submittedObjectTableVersion;
+
+        // Dense ids for the shaders and materials seen while sorting, assigned per frame in the order they are
+        // first seen. Kept between frames so their buckets are reused.
+        static std::unordered_map<const IShader*, U32> _shaderSortIds;
+        static std::unordered_map<const BaseMaterial*, U32> _materialSortIds;
+
+        // The sort key of each mesh's reference data without a depth bucket, so each is only built once per frame.
+        static std::unordered_map<const StaticMeshRenderReferenceData*, U64> _meshSortKeys;
+
+        // The sort key and camera distance of each visible static mesh, at the same index as _visibleStaticMeshes, and scratch space for sorting.
+        static List<U64> _drawSortKeys;
+        static List<F32> _drawDepths;
+        static List<U64> _drawSortScratchKeys;
+        static List<U32> _drawSortScratchIndices;
     };
 }
\ No newline at end of file
@@ -2,8 +2,6 @@
 
 namespace Epoch {
 
-    struct GlobalUniformObject;
-
     class ICommandBuffer;
     class IUniformBuffer;
     class BaseMaterial;
@@ -45,14 +43,6 @@ namespace Epoch {
          */
         virtual const bool HasComputeStage() const = 0;
 
-        /**
-         * Resets all descriptors in this shader. Typically done at the start of a frame before any binding is done.
-         * Should always be done once before any object is drawn.
-         *
-         * @param frameIndex The current index of the frame (or swapchain image) being drawn to.
-         */
-        virtual void ResetDescriptors( const U32 frameIndex ) = 0;
-
         /**
          * Binds the internal graphics pipeline to the provided command buffer. Should be called once per object, per frame.
          *
@@ -61,40 +51,37 @@ namespace Epoch {
         virtual void BindPipeline( ICommandBuffer* commandBuffer ) = 0;
 
         /**
-         * Sets global uniform information on this shader (such as view and projection matrices).
+         * Writes the given material's properties to the material table read by this shader. Only writes anything when the
+         * material is new or its properties have changed, so it is cheap to call once per material, per frame. Must not be
+         * called while recording on other threads.
          *
-         * @param commandBuffer The command buffer to bind to.
-         * @param uniform The uniform data to be set.
-         * @param frameIndex The current index of the frame (or swapchain image) being drawn to.
+         * @param material A pointer to the material whose properties should be written.
          */
-        virtual void SetGlobalUniform( ICommandBuffer* commandBuffer, const GlobalUniformObject& uniform, const U32 frameIndex ) = 0;
+        virtual void UpdateMaterial( BaseMaterial* material ) = 0;
 
         /**
-         * Sets the model matrix on this shader.
+         * Binds the descriptors shared by everything drawn with this shader. Should be done once after BindPipeline.
          *
-         * @param model A reference to the model matrix to be used.
+         * @param commandBuffer The commandBuffer currently being recorded to.
+         * @param frameIndex The current index of the frame (or swapchain image) being drawn to.
          */
-        virtual void SetModel( const Matrix4x4& model ) = 0;
+        virtual void BindDescriptor( ICommandBuffer* commandBuffer, const U32 frameIndex ) = 0;
 
         /**
-         * Updates the descriptors for the given frame and object indices. Should be done after BindPipeline.
-         * Should be called once per object, per frame.
+         * Selects the given material for the draws that follow. No descriptors are bound; only the material's index into the
+         * material table is passed to the shader. The material must have been passed to UpdateMaterial first.
          *
          * @param commandBuffer The commandBuffer currently being recorded to.
-         * @param frameIndex The current index of the frame (or swapchain image) being drawn to.
-         * @param objectIndex The current list index of the object being rendered.
-         * @param material A pointer to the material whose properties should be bound.
+         * @param material A pointer to the material to draw with.
          */
-        virtual void UpdateDescriptor( ICommandBuffer* commandBuffer, const U32 frameIndex, const U32 objectIndex, BaseMaterial* material ) = 0;
+        virtual void BindMaterial( ICommandBuffer* commandBuffer, BaseMaterial* material ) = 0;
 
         /**
-         * Binds the internal descriptor to the provided pipeline. Should be completed after UpdateDescriptor.
-         * Should be called once per object, per frame.
+         * Releases anything this shader has cached for the given material. Called when the material is destroyed, once no
+         * frame in flight can still be drawing with it.
          *
-         * @param commandBuffer The commandBuffer currently being recorded to.
-         * @param frameIndex The current index of the frame (or swapchain image) being drawn to.
-         * @param objectIndex The current list index of the object being rendered.
+         * @param material A pointer to the material being destroyed.
          */
-        virtual void BindDescriptor( ICommandBuffer* commandBuffer, const U32 frameIndex, const U32 objectIndex ) = 0;
+        virtual void ReleaseMaterial( BaseMaterial* material ) = 0;
     };
 }
\ No newline at end of file
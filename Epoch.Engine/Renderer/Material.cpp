@@ -6,6 +6,7 @@
 #include "../Resources/ITexture.h"
 #include "../String/StringUtilities.h"
 #include "Frontend/RendererFrontend.h"
+#include "IShader.h"
 
 #include "Material.h"
 
@@ -37,6 +38,10 @@ namespace Epoch {
     }
 
     UnlitMaterial::~UnlitMaterial() {
+        if( _shader ) {
+            _shader->ReleaseMaterial( this );
+        }
+
         if( DiffuseMap ) {
             RendererFrontEnd::ReleaseTexture( DiffuseMap->GetName() );
             DiffuseMap = nullptr;
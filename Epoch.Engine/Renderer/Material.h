@@ -44,7 +44,7 @@ namespace Epoch {
 
     protected:
         MaterialType _type;
-        IShader* _shader;
+        IShader* _shader = nullptr;
     };
 
     /**
@@ -5,6 +5,8 @@
 
 namespace Epoch {
 
+    struct StaticMeshRenderReferenceData;
+
     struct RenderReferenceData {
     public:
     public:
@@ -27,4 +29,29 @@ namespace Epoch {
         RenderableComponentType _componentType;
     };
 
+    /**
+     * A group of visible instances which share a static mesh and material, and so can be drawn with a single instanced draw.
+     * The world matrices of the instances are contiguous in the frame's instance transform list.
+     */
+    struct StaticMeshInstanceGroup {
+        StaticMeshRenderReferenceData* ReferenceData = nullptr;
+
+        // The index of the group's first world matrix in the instance transform list.
+        U32 FirstInstance = 0;
+        U32 InstanceCount = 0;
+    };
+
+    /**
+     * Counts of the state changes made while recording a frame, and of those which were skipped because the state was already bound.
+     */
+    struct RenderStateStats {
+        U32 DrawCalls = 0;
+        U32 PipelineBinds = 0;
+        U32 DescriptorBinds = 0;
+        U32 MaterialBinds = 0;
+        U32 VertexBufferBinds = 0;
+        U32 IndexBufferBinds = 0;
+        U32 RedundantBindsSkipped = 0;
+    };
+
 }
\ No newline at end of file
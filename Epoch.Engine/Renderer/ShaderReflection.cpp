@@ -0,0 +1,216 @@
+#include <vector>
+#include <algorithm>
+
+#include "../Logger.h"
+#include "ShaderReflection.h"
+
+// The first word of every SPIR-V module.
+#define SPIRV_MAGIC 0x07230203U
+
+// The number of words in a SPIR-V module's header, before its first instruction.
+#define SPIRV_HEADER_WORD_COUNT 5
+
+// The opcodes, decorations and storage classes reflection cares about. The rest are skipped.
+#define SPIRV_OP_TYPE_IMAGE 25
+#define SPIRV_OP_TYPE_SAMPLER 26
+#define SPIRV_OP_TYPE_SAMPLED_IMAGE 27
+#define SPIRV_OP_TYPE_ARRAY 28
+#define SPIRV_OP_TYPE_RUNTIME_ARRAY 29
+#define SPIRV_OP_TYPE_STRUCT 30
+#define SPIRV_OP_TYPE_POINTER 32
+#define SPIRV_OP_CONSTANT 43
+#define SPIRV_OP_VARIABLE 59
+#define SPIRV_OP_DECORATE 71
+#define SPIRV_DECORATION_BUFFER_BLOCK 3
+#define SPIRV_DECORATION_BINDING 33
+#define SPIRV_DECORATION_DESCRIPTOR_SET 34
+#define SPIRV_STORAGE_CLASS_UNIFORM 2
+#define SPIRV_STORAGE_CLASS_STORAGE_BUFFER 12
+
+namespace Epoch {
+
+    /**
+     * What reflection knows about a single SPIR-V id.
+     */
+    struct SpirvId {
+        U32 Opcode = 0;
+
+        // For pointers, the storage class. For images, whether sampled (1) or storage (2). For constants, the value.
+        U32 Value = 0;
+
+        // For pointers and arrays, the type pointed to or of each element. For arrays, also the id of the length constant.
+        U32 Type = 0;
+        U32 Length = 0;
+
+        U32 Set = 0;
+        U32 Binding = 0;
+        bool HasSet = false;
+        bool HasBinding = false;
+        bool IsBufferBlock = false;
+    };
+
+    /**
+     * Returns the fewest words an instruction reflection reads can have, or 0 if reflection does not read it.
+     */
+    static U32 getMinimumInstructionLength( const U32 opcode ) {
+        switch( opcode ) {
+        case SPIRV_OP_TYPE_SAMPLER:
+        case SPIRV_OP_TYPE_STRUCT:
+            return 2;
+        case SPIRV_OP_TYPE_SAMPLED_IMAGE:
+        case SPIRV_OP_TYPE_RUNTIME_ARRAY:
+        case SPIRV_OP_DECORATE:
+            return 3;
+        case SPIRV_OP_TYPE_ARRAY:
+        case SPIRV_OP_TYPE_POINTER:
+        case SPIRV_OP_CONSTANT:
+        case SPIRV_OP_VARIABLE:
+            return 4;
+        case SPIRV_OP_TYPE_IMAGE:
+            return 9;
+        default:
+            return 0;
+        }
+    }
+
+    const bool ShaderReflection::ReflectBindings( const U32* code, const U64 wordCount, List<ShaderBinding>& outBindings ) {
+        if( wordCount < SPIRV_HEADER_WORD_COUNT || code[0] != SPIRV_MAGIC ) {
+            Logger::Error( "Shader code is not SPIR-V." );
+            return false;
+        }
+
+        // Every id is below the bound in the header, so ids can index straight into a table.
+        U32 bound = code[3];
+        std::vector<SpirvId> ids( bound );
+        std::vector<U32> variables;
+        for( U64 position = SPIRV_HEADER_WORD_COUNT; position < wordCount; ) {
+            U32 opcode = code[position] & 0xFFFFU;
+            U32 length = code[position] >> 16;
+            if( length == 0 || position + length > wordCount ) {
+                Logger::Error( "SPIR-V module is truncated or corrupt." );
+                return false;
+            }
+
+            // Instructions other than the ones below are skipped without looking at their operands.
+            const U32* operands = code + position + 1;
+            U32 minimumLength = getMinimumInstructionLength( opcode );
+            if( minimumLength == 0 ) {
+                position += length;
+                continue;
+            }
+
+            U32 result = opcode == SPIRV_OP_CONSTANT || opcode == SPIRV_OP_VARIABLE ? operands[1] : operands[0];
+            if( length < minimumLength || result >= bound ) {
+                Logger::Error( "SPIR-V module is truncated or corrupt." );
+                return false;
+            }
+
+            switch( opcode ) {
+            case SPIRV_OP_DECORATE:
+                if( operands[1] == SPIRV_DECORATION_DESCRIPTOR_SET && length > 3 ) {
+                    ids[result].Set = operands[2];
+                    ids[result].HasSet = true;
+                } else if( operands[1] == SPIRV_DECORATION_BINDING && length > 3 ) {
+                    ids[result].Binding = operands[2];
+                    ids[result].HasBinding = true;
+                } else if( operands[1] == SPIRV_DECORATION_BUFFER_BLOCK ) {
+                    ids[result].IsBufferBlock = true;
+                }
+                break;
+            case SPIRV_OP_TYPE_IMAGE:
+                ids[result].Opcode = opcode;
+                ids[result].Value = operands[6];
+                break;
+            case SPIRV_OP_TYPE_SAMPLER:
+            case SPIRV_OP_TYPE_SAMPLED_IMAGE:
+            case SPIRV_OP_TYPE_STRUCT:
+                ids[result].Opcode = opcode;
+                break;
+            case SPIRV_OP_TYPE_ARRAY:
+                ids[result].Opcode = opcode;
+                ids[result].Type = operands[1];
+                ids[result].Length = operands[2];
+                break;
+            case SPIRV_OP_TYPE_RUNTIME_ARRAY:
+                ids[result].Opcode = opcode;
+                ids[result].Type = operands[1];
+                break;
+            case SPIRV_OP_TYPE_POINTER:
+                ids[result].Opcode = opcode;
+                ids[result].Value = operands[1];
+                ids[result].Type = operands[2];
+                break;
+            case SPIRV_OP_CONSTANT:
+                ids[result].Opcode = opcode;
+                ids[result].Value = operands[2];
+                break;
+            case SPIRV_OP_VARIABLE:
+                ids[result].Opcode = opcode;
+                ids[result].Type = operands[0];
+                ids[result].Value = operands[2];
+                variables.push_back( result );
+                break;
+            default:
+                break;
+            }
+            position += length;
+        }
+
+        std::vector<ShaderBinding> bindings;
+        for( U64 i = 0; i < variables.size(); ++i ) {
+            const SpirvId& variable = ids[variables[i]];
+            if( !variable.HasSet || !variable.HasBinding || variable.Type >= bound ) {
+                continue;
+            }
+
+            // Unwrap the pointer and any arrays down to the resource itself.
+            U32 count = 1;
+            U32 typeId = ids[variable.Type].Type;
+            while( typeId < bound && ( ids[typeId].Opcode == SPIRV_OP_TYPE_ARRAY || ids[typeId].Opcode == SPIRV_OP_TYPE_RUNTIME_ARRAY ) ) {
+                const SpirvId& array = ids[typeId];
+                count = array.Opcode == SPIRV_OP_TYPE_RUNTIME_ARRAY || array.Length >= bound ? 0 : count * ids[array.Length].Value;
+                typeId = array.Type;
+            }
+            if( typeId >= bound ) {
+                Logger::Error( "SPIR-V module refers to id %u, beyond its bound of %u.", typeId, bound );
+                return false;
+            }
+
+            ShaderBinding binding = {};
+            binding.Set = variable.Set;
+            binding.Binding = variable.Binding;
+            binding.Count = count;
+            const SpirvId& type = ids[typeId];
+            switch( type.Opcode ) {
+            case SPIRV_OP_TYPE_STRUCT:
+                if( variable.Value == SPIRV_STORAGE_CLASS_STORAGE_BUFFER || ( variable.Value == SPIRV_STORAGE_CLASS_UNIFORM && type.IsBufferBlock ) ) {
+                    binding.Type = (U8)ShaderBindingType::StorageBuffer;
+                } else {
+                    binding.Type = (U8)ShaderBindingType::UniformBuffer;
+                }
+                break;
+            case SPIRV_OP_TYPE_SAMPLED_IMAGE:
+                binding.Type = (U8)ShaderBindingType::CombinedImageSampler;
+                break;
+            case SPIRV_OP_TYPE_IMAGE:
+                binding.Type = type.Value == 2 ? (U8)ShaderBindingType::StorageImage : (U8)ShaderBindingType::SampledImage;
+                break;
+            case SPIRV_OP_TYPE_SAMPLER:
+                binding.Type = (U8)ShaderBindingType::Sampler;
+                break;
+            default:
+                Logger::Warn( "Skipping descriptor at set %u, binding %u of unsupported type.", binding.Set, binding.Binding );
+                continue;
+            }
+            bindings.push_back( binding );
+        }
+
+        std::sort( bindings.begin(), bindings.end(), []( const ShaderBinding& a, const ShaderBinding& b ) {
+            return a.Set != b.Set ? a.Set < b.Set : a.Binding < b.Binding;
+        } );
+        for( U64 i = 0; i < bindings.size(); ++i ) {
+            outBindings.Add( bindings[i] );
+        }
+        return true;
+    }
+}
\ No newline at end of file
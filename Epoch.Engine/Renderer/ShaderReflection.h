@@ -0,0 +1,52 @@
+#pragma once
+
+#include "../Types.h"
+#include "../Defines.h"
+#include "../Containers/List.h"
+
+namespace Epoch {
+
+    /**
+     * The kinds of resource a shader can bind through a descriptor.
+     */
+    enum class ShaderBindingType : U8 {
+        UniformBuffer = 0x00U,
+        StorageBuffer = 0x01U,
+        CombinedImageSampler = 0x02U,
+        SampledImage = 0x03U,
+        StorageImage = 0x04U,
+        Sampler = 0x05U
+    };
+
+    /**
+     * A single descriptor binding used by a shader module. Written to shader archives as-is.
+     */
+    struct ShaderBinding {
+        U32 Set;
+        U32 Binding;
+
+        // The number of descriptors in the binding, or 0 if it is a runtime-sized array.
+        U32 Count;
+        U8 Type;
+        U8 Padding[3];
+    };
+
+    /**
+     * Reads the descriptor bindings a compiled shader module uses straight from its SPIR-V, so descriptor set layouts can be
+     * built from the shaders rather than written out by hand.
+     */
+    class EPOCH_API ShaderReflection {
+    public:
+
+        /**
+         * Reflects the descriptor bindings of the given SPIR-V module.
+         *
+         * @param code The SPIR-V words.
+         * @param wordCount The number of words.
+         * @param outBindings The list to add the bindings to, ordered by set and binding.
+         *
+         * @returns True if successful; otherwise false.
+         */
+        static const bool ReflectBindings( const U32* code, const U64 wordCount, List<ShaderBinding>& outBindings );
+    };
+}
\ No newline at end of file
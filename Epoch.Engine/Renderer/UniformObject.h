@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../Types.h"
 #include "../Math/Matrix4x4.h"
 
 namespace Epoch {
@@ -16,14 +17,44 @@ namespace Epoch {
     };
 
     /**
-     * A uniform object which is used for commonly-used, commonly-updated, per-object data, such as the model matrix or material data. 
-     * For use with unlit materials. Must be 256 bytes total.
+     * Per-material data read by shaders from the material buffer, indexed by the material's index. Must be 16 bytes total.
      */
-    struct UnlitUniformObject {
-        Matrix4x4 Model; // 64 bytes
+    struct MaterialShaderData {
+        U32 DiffuseTextureIndex; // 4 bytes
 
-        Matrix4x4 Reserved1; // 64 bytes, reserved for future use
-        Matrix4x4 Reserved2; // 64 bytes, reserved for future use
-        Matrix4x4 Reserved3; // 64 bytes, reserved for future use
+        U32 Reserved[3]; // 12 bytes, reserved for future use
+    };
+
+    static_assert( sizeof( MaterialShaderData ) == 16, "MaterialShaderData must match the shaders' std430 layout." );
+
+    /**
+     * A single object read by the culling compute shader, which writes an indirect draw for it if its bounds are visible.
+     * Must be 48 bytes total.
+     */
+    struct CullObjectShaderData {
+        F32 Center[3]; // 12 bytes, world-space center of the object's bounds
+        U32 FirstIndex; // 4 bytes, in the shared index buffer
+
+        F32 Extent[3]; // 12 bytes, world-space half size of the object's bounds
+        U32 IndexCount; // 4 bytes
+
+        I32 VertexOffset; // 4 bytes, in the shared vertex buffer
+        U32 FirstCommand; // 4 bytes, the first indirect draw of the object's batch
+        U32 BatchIndex; // 4 bytes, the draw count written to for the object's batch
+        U32 Reserved; // 4 bytes, reserved for future use
+    };
+
+    static_assert( sizeof( CullObjectShaderData ) == 48, "CullObjectShaderData must match the culling shader's std430 layout." );
+
+    /**
+     * Push constants of the culling compute shader. Must be at most 128 bytes total.
+     */
+    struct CullPushConstants {
+        F32 Planes[6][4]; // 96 bytes, frustum planes as normal and distance
+        U32 ObjectCount; // 4 bytes
+
+        // 4 bytes. If set, visible draws are packed at the start of their batch and counted. Otherwise every object gets a draw
+        // at its own index, with no instances if culled.
+        U32 CompactDraws;
     };
 }
\ No newline at end of file
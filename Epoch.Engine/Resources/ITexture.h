@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../Types.h"
+
 namespace Epoch {
 
     class IImage;
@@ -9,6 +11,11 @@ namespace Epoch {
         virtual ~ITexture() {}
         virtual const char* GetName() const = 0;
 
+        /**
+         * Returns the index of this texture in the renderer's texture array, through which shaders sample it.
+         */
+        virtual const U32 GetIndex() const = 0;
+
         virtual IImage* GetImage() = 0;
     };
 }
\ No newline at end of file
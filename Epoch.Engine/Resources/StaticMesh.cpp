@@ -26,11 +26,7 @@ namespace Epoch {
             return true;
         }
 
-        Logger::Trace( "Loading static mesh '%s' from file '%s'", _name.CStr(), _path.CStr() );
-        const bool result = _data.DeserializeBinary( _path );
-
-        Logger::Log( "StaticMesh::loadMeshDataFromFile() - Mesh verts require %.2f MiB", ( (F32)_data.Vertices.Size() / 1024.0f / 1024.0f ) );
-        Logger::Log( "StaticMesh::loadMeshDataFromFile() - Mesh indices require %.2f MiB", ( (F32)_data.Indices.Size() / 1024.0f / 1024.0f ) );
+        const bool result = LoadData();
 
         uploadToGPU();
 
@@ -39,6 +35,20 @@ namespace Epoch {
         return result;
     }
 
+    const bool StaticMesh::LoadData() {
+        if( _isDataLoaded ) {
+            return true;
+        }
+
+        Logger::Trace( "Loading static mesh '%s' from file '%s'", _name.CStr(), _path.CStr() );
+        _isDataLoaded = _data.DeserializeBinary( _path );
+
+        Logger::Log( "StaticMesh::loadMeshDataFromFile() - Mesh verts require %.2f MiB", ( (F32)_data.Vertices.Size() / 1024.0f / 1024.0f ) );
+        Logger::Log( "StaticMesh::loadMeshDataFromFile() - Mesh indices require %.2f MiB", ( (F32)_data.Indices.Size() / 1024.0f / 1024.0f ) );
+
+        return _isDataLoaded;
+    }
+
     void StaticMesh::Unload() {
         _data.Vertices.Clear();
         _data.Indices.Clear();
@@ -50,6 +60,7 @@ namespace Epoch {
         }
 
         _isLoaded = false;
+        _isDataLoaded = false;
     }
 
     const bool StaticMesh::uploadToGPU() {
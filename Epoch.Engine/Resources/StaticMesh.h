@@ -73,9 +73,18 @@ namespace Epoch {
 
         /**
          * Loads resources required by this static mesh. Also uploads this mesh to the GPU.
+         * Mesh data is read from disk first if LoadData() has not already been called.
          */
         virtual const bool Load();
 
+        /**
+         * Reads this mesh's data from disk without uploading it. Does not touch the renderer,
+         * so this is safe to call from a worker thread.
+         *
+         * @returns True if successful; otherwise false.
+         */
+        const bool LoadData();
+
         /**
          * Unloads this mesh's data from the GPU. Does not clear index/vertex data.
          */
@@ -93,6 +102,26 @@ namespace Epoch {
          */
         const bool IsLoaded() const noexcept { return _isLoaded; }
 
+        /**
+         * Returns the path of the file this mesh is loaded from.
+         */
+        const TString& GetPath() const noexcept { return _path; }
+
+        /**
+         * Returns the number of bytes of vertex and index data held by this mesh.
+         */
+        const U64 GetDataSize() const noexcept { return ( sizeof( Vertex3D ) * (U64)_data.Vertices.Size() ) + ( sizeof( U32 ) * (U64)_data.Indices.Size() ); }
+
+        /**
+         * Returns the object-space axis-aligned bounds of this mesh. Only valid once loaded.
+         */
+        const AABB& GetBounds() const noexcept { return _data.Bounds; }
+
+        /**
+         * Returns the object-space bounding sphere of this mesh. Only valid once loaded.
+         */
+        const BoundingSphere& GetBoundingSphere() const noexcept { return _data.Sphere; }
+
     private:
         const bool uploadToGPU();
 
@@ -100,6 +129,7 @@ namespace Epoch {
         TString _name;
         TString _path;
         bool _isLoaded = false;
+        bool _isDataLoaded = false;
         StaticMeshData _data;
         StaticMeshRenderReferenceData _referenceData;
     };
@@ -1,5 +1,6 @@
 
 #include "CameraEntity.h"
+#include "../../Logger.h"
 #include "../../Math/TMath.h"
 
 namespace Epoch {
@@ -12,17 +13,26 @@ namespace Epoch {
         UpdateManager::StopListening( this );
     }
 
+    CameraEntity* CameraEntity::Create( const TString& name ) {
+        CameraEntity* result = static_cast<CameraEntity*>( WObject::Allocate( sizeof( CameraEntity ) ) );
+
+        // Use placement new to call constructor manually.
+        new ( result )CameraEntity();
+        result->Name = name;
+        return result;
+    }
+
     void CameraEntity::Update( const F32 deltaTime ) {
         Quaternion rotation = GetRotation();
 
         // Yaw
         if( _turningLeft ) {
             _yaw += ( -_rotateSpeed * deltaTime );
-            rotation *= Quaternion::FromAxisAngle( Vector3::Up(), _yaw );
+            rotation *= Quaternion::FromAxisAngle( Vector3::Up(), TMath::DegToRad( _yaw ) );
             _viewDirty = true;
         } else if( _turningRight ) {
             _yaw += ( _rotateSpeed * deltaTime );
-            rotation *= Quaternion::FromAxisAngle( Vector3::Up(), _yaw );
+            rotation *= Quaternion::FromAxisAngle( Vector3::Up(), TMath::DegToRad( _yaw ) );
             _viewDirty = true;
         }
 
@@ -32,14 +42,14 @@ namespace Epoch {
 
             // Ensure the rotation is clamped between -89 and 89 deg
             _pitch = TMath::ClampFloat32( pitch, -89.0f, 89.0f );
-            rotation *= Quaternion::FromAxisAngle( Vector3::Left(), pitch );
+            rotation *= Quaternion::FromAxisAngle( Vector3::Left(), TMath::DegToRad( pitch ) );
             _viewDirty = true;
         } else if( _lookingUp ) {
             float pitch = _pitch + ( _rotateSpeed * (float)deltaTime );
 
             // Ensure the rotation is clamped between -89 and 89 deg
             _pitch = TMath::ClampFloat32( pitch, -89.0f, 89.0f );
-            rotation *= Quaternion::FromAxisAngle( Vector3::Left(), pitch );
+            rotation *= Quaternion::FromAxisAngle( Vector3::Left(), TMath::DegToRad( pitch ) );
             _viewDirty = true;
         }
 
@@ -47,9 +57,11 @@ namespace Epoch {
 
         // Recalculate vectors
         if( _viewDirty ) {
-            _forward.X = TMath::Cos( _pitch ) * TMath::Cos( _yaw );
-            _forward.Y = TMath::Sin( _pitch );
-            _forward.Z = TMath::Cos( _pitch ) * TMath::Sin( _yaw );
+            F32 yaw = TMath::DegToRad( _yaw );
+            F32 pitch = TMath::DegToRad( _pitch );
+            _forward.X = TMath::Cos( pitch ) * TMath::Cos( yaw );
+            _forward.Y = TMath::Sin( pitch );
+            _forward.Z = TMath::Cos( pitch ) * TMath::Sin( yaw );
             _forward.Normalize();
 
             Vector3 up = Vector3::Up();
@@ -103,11 +115,74 @@ namespace Epoch {
         }
     }
 
-    Matrix4x4* CameraEntity::GetViewMatrix() {
-        if( !_viewDirty ) {
-            return &_view;
-        } else {
-            // Use the owning object's position. Combine with PYR of this camera. Scale can be ignored.
+    const Matrix4x4& CameraEntity::GetViewMatrix() {
+        updateView();
+        return _view;
+    }
+
+    const Matrix4x4& CameraEntity::GetProjectionMatrix() {
+        updateProjection();
+        return _projection;
+    }
+
+    void CameraEntity::SetPerspective( const F32 fieldOfView, const F32 nearClip, const F32 farClip ) {
+        _fieldOfView = fieldOfView;
+        _nearClip = nearClip;
+        _farClip = farClip;
+        _projectionDirty = true;
+    }
+
+    void CameraEntity::SetAspectRatio( const F32 aspectRatio ) {
+        if( aspectRatio != _aspectRatio ) {
+            _aspectRatio = aspectRatio;
+            _projectionDirty = true;
+        }
+    }
+
+    void CameraEntity::LookAt( const Vector3& target ) {
+        Vector3 direction = target - GetPosition();
+        if( direction.Length() == 0.0f ) {
+            Logger::Warn( "CameraEntity::LookAt called with the camera's own position. Nothing was done." );
+            return;
         }
+
+        // Yaw and pitch are kept in step with the new direction, so turning continues from it.
+        _forward = Vector3::Normalized( direction );
+        _pitch = TMath::RadToDeg( TMath::ASin( _forward.Y ) );
+        _yaw = TMath::RadToDeg( TMath::ATan2( _forward.Z, _forward.X ) );
+        _right = Vector3::Normalized( Vector3::Cross( Vector3::Up(), _forward ) );
+        _up = Vector3::Cross( _forward, _right );
+        _viewDirty = true;
+    }
+
+    const U32 CameraEntity::GetVersion() {
+        updateView();
+        updateProjection();
+        return _version;
+    }
+
+    void CameraEntity::updateView() {
+
+        // The position can also be set from outside of Update, so it is checked as well.
+        const Vector3& position = GetPosition();
+        if( !_viewDirty && position == _viewPosition ) {
+            return;
+        }
+
+        // Use the owning object's position. Combine with PYR of this camera. Scale can be ignored.
+        _view = Matrix4x4::LookAt( position, position + _forward, Vector3::Up() );
+        _viewPosition = position;
+        _viewDirty = false;
+        _version++;
+    }
+
+    void CameraEntity::updateProjection() {
+        if( !_projectionDirty ) {
+            return;
+        }
+
+        _projection = Matrix4x4::Perspective( TMath::DegToRad( _fieldOfView ), _aspectRatio, _nearClip, _farClip );
+        _projectionDirty = false;
+        _version++;
     }
 }
\ No newline at end of file
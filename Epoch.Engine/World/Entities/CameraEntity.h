@@ -13,25 +13,93 @@ namespace Epoch {
         CameraEntity();
         ~CameraEntity();
 
+        /**
+         * Creates a new camera. It must be added to a level before it is updated or rendered from.
+         *
+         * @param name The name of the camera.
+         *
+         * @returns A pointer to the new camera.
+         */
+        static CameraEntity* Create( const TString& name );
+
         /**
          * Called if this object is opted-into updates via UpdateManager::OptIn()
          */
         virtual void Update( const F32 deltaTime ) override;
 
-        Matrix4x4* GetViewMatrix();
+        /**
+         * Returns the view matrix of this camera, recalculating it only if the camera has moved or turned.
+         */
+        const Matrix4x4& GetViewMatrix();
+
+        /**
+         * Returns the projection matrix of this camera, recalculating it only if its parameters have changed.
+         */
+        const Matrix4x4& GetProjectionMatrix();
+
+        /**
+         * Sets the perspective parameters of this camera.
+         *
+         * @param fieldOfView The vertical field of view in degrees.
+         * @param nearClip The distance of the near clipping plane.
+         * @param farClip The distance of the far clipping plane.
+         */
+        void SetPerspective( const F32 fieldOfView, const F32 nearClip, const F32 farClip );
+
+        /**
+         * Sets the aspect ratio of this camera. Typically set by the renderer to match its output. Has no effect if unchanged.
+         *
+         * @param aspectRatio The width of the output divided by its height.
+         */
+        void SetAspectRatio( const F32 aspectRatio );
+
+        /**
+         * Turns this camera to face the given point from its current position.
+         *
+         * @param target The world position to look at.
+         */
+        void LookAt( const Vector3& target );
+
+        /**
+         * Returns the direction this camera is facing.
+         */
+        const Vector3& GetForward() const { return _forward; }
+
+        /**
+         * Returns a number which changes whenever the view or projection matrix of this camera changes. Used to skip
+         * work when neither has changed since it was last read.
+         */
+        const U32 GetVersion();
+
+    private:
+        void updateView();
+        void updateProjection();
 
     private:
         bool _viewDirty = true;
         Matrix4x4 _view;
+        Vector3 _viewPosition;
+
+        bool _projectionDirty = true;
+        Matrix4x4 _projection;
+        F32 _fieldOfView = 90.0f;
+        F32 _nearClip = 0.1f;
+        F32 _farClip = 1000.0f;
+        F32 _aspectRatio = 16.0f / 9.0f;
+
+        U32 _version = 0;
 
         // Degrees/second
         float _rotateSpeed = 45.0f;
-        Vector3 _forward, _right, _up;
+        Vector3 _forward = Vector3( 1.0f, 0.0f, 0.0f );
+        Vector3 _right, _up;
+
+        // In degrees. The forward vector is rebuilt from these whenever the view changes.
         float _yaw = 0;
         float _pitch = 0;
 
         // Hack - putting camera controls here for now until a proper control system is built.
-        bool _turningLeft, _turningRight, _lookingUp, _lookingDown;
-        bool _movingForward, _movingBackward, _movingLeft, _movingRight, _movingUp, _movingDown;
+        bool _turningLeft = false, _turningRight = false, _lookingUp = false, _lookingDown = false;
+        bool _movingForward = false, _movingBackward = false, _movingLeft = false, _movingRight = false, _movingUp = false, _movingDown = false;
     };
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 
 #include "EntityComponents/EntityComponent.h"
 #include "Level.h"
+#include "Prefab.h"
 #include "Entity.h"
 
 namespace Epoch {
@@ -17,8 +18,7 @@ namespace Epoch {
     void Entity::Destroy( Entity* entity ) {
         entity->Destroy();
 
-        // Manually call destructor.
-        entity->~Entity();
+        // Free calls the destructor.
         WObject::Free( entity );
     }
 
@@ -39,32 +39,38 @@ namespace Epoch {
     void Entity::AddChild( Entity* child ) {
         _children.Add( child );
         child->setParent( this );
-        child->setLevel( _level );
-        _level->OnEntityAdded( child );
+        child->attachToLevel( _level );
+        child->flagWorldMatrixDirty();
     }
 
     void Entity::AddChildAt( Entity* child, const U32 index ) {
         _children.InsertAt( child, index );
         child->setParent( this );
-        child->setLevel( _level );
-        _level->OnEntityAdded( child );
+        child->attachToLevel( _level );
+        child->flagWorldMatrixDirty();
     }
 
     const bool Entity::RemoveChild( Entity* child ) {
         I32 index = _children.Remove( child );
+        if( index == -1 ) {
+            return false;
+        }
         child->setParent( nullptr );
-        child->setLevel( nullptr );
-        _level->OnEntityRemoved( child );
-        return index != -1;
+        child->attachToLevel( nullptr );
+        child->flagWorldMatrixDirty();
+        return true;
     }
 
     Entity* Entity::RemoveChildAt( const U32 index ) {
+        if( index >= _children.Size() ) {
+            return nullptr;
+        }
         Entity* child = _children.Get( index );
         if( child ) {
             child->setParent( nullptr );
             _children.RemoveAt( index );
-            child->setLevel( nullptr );
-            _level->OnEntityRemoved( child );
+            child->attachToLevel( nullptr );
+            child->flagWorldMatrixDirty();
         }
         return child;
     }
@@ -72,40 +78,57 @@ namespace Epoch {
     void Entity::AddComponent( EntityComponent* component ) {
         _components.Add( component );
         component->setOwningEntity( this );
-        if( component->IsRenderable() ) {
+        if( _level && component->IsRenderable() ) {
             _level->OnRenderableEntityComponentAdded( static_cast<RenderableEntityComponent*>( component ) );
+            _level->OnEntityBoundsChanged( this );
         }
     }
 
     void Entity::AddComponentAt( EntityComponent* component, const U32 index ) {
         _components.InsertAt( component, index );
         component->setOwningEntity( this );
-        if( component->IsRenderable() ) {
+        if( _level && component->IsRenderable() ) {
             _level->OnRenderableEntityComponentAdded( static_cast<RenderableEntityComponent*>( component ) );
+            _level->OnEntityBoundsChanged( this );
         }
     }
 
     const bool Entity::RemoveComponent( EntityComponent* component ) {
         I32 index = _components.Remove( component );
-        component->setOwningEntity( nullptr );
-        if( component->IsRenderable() ) {
+        if( index == -1 ) {
+            return false;
+        }
+        if( _level && component->IsRenderable() ) {
             _level->OnRenderableEntityComponentRemoved( static_cast<RenderableEntityComponent*>( component ) );
+            _level->OnEntityBoundsChanged( this );
         }
-        return index != -1;
+        component->setOwningEntity( nullptr );
+        return true;
     }
 
     EntityComponent* Entity::RemoveComponentAt( const U32 index ) {
+        if( index >= _components.Size() ) {
+            return nullptr;
+        }
         EntityComponent* component = _components.Get( index );
         if( component ) {
-            component->setOwningEntity( nullptr );
             _components.RemoveAt( index );
-            if( component->IsRenderable() ) {
+            if( _level && component->IsRenderable() ) {
                 _level->OnRenderableEntityComponentRemoved( static_cast<RenderableEntityComponent*>( component ) );
+                _level->OnEntityBoundsChanged( this );
             }
+            component->setOwningEntity( nullptr );
         }
         return component;
     }
 
+    const TString& Entity::GetName() const {
+        if( _prefab && Name.IsEmpty() ) {
+            return _prefab->GetName();
+        }
+        return Name;
+    }
+
     const Matrix4x4* Entity::GetWorldMatrix() {
         if( _worldMatrixDirty ) {
             if( _parent ) {
@@ -115,16 +138,80 @@ namespace Epoch {
             } else {
                 _worldMatrix = _transform.GetTransformation();
             }
+            _worldMatrixDirty = false;
         }
 
         return &_worldMatrix;
     }
 
+    const AABB Entity::GetWorldBounds() {
+        const Matrix4x4* world = GetWorldMatrix();
+
+        bool hasBounds = false;
+        AABB result;
+        U32 componentCount = ComponentCount();
+        for( U32 i = 0; i < componentCount; ++i ) {
+            if( _components[i]->IsRenderable() ) {
+                AABB componentBounds = static_cast<RenderableEntityComponent*>( _components[i] )->GetLocalBounds().Transformed( *world );
+                result = hasBounds ? AABB::Union( result, componentBounds ) : componentBounds;
+                hasBounds = true;
+            }
+        }
+
+        if( !hasBounds ) {
+            Vector3 position( world->Data()[12], world->Data()[13], world->Data()[14] );
+            result = AABB( position, position );
+        }
+        return result;
+    }
+
     void Entity::flagWorldMatrixDirty() {
         _worldMatrixDirty = true;
+
+        // Let the level know so that render proxies and spatial bounds for this entity are refreshed.
+        if( _level ) {
+            _level->OnEntityBoundsChanged( this );
+            U32 componentCount = ComponentCount();
+            for( U32 i = 0; i < componentCount; ++i ) {
+                if( _components[i]->IsRenderable() ) {
+                    _level->OnRenderableEntityComponentTransformChanged( static_cast<RenderableEntityComponent*>( _components[i] ) );
+                }
+            }
+        }
+
         U32 childCount = ChildCount();
         for( U32 i = 0; i < childCount; ++i ) {
             _children[i]->flagWorldMatrixDirty();
         }
     }
+
+    void Entity::attachToLevel( Level* level ) {
+        if( _level != level ) {
+            U32 componentCount = ComponentCount();
+            if( _level ) {
+                for( U32 i = 0; i < componentCount; ++i ) {
+                    if( _components[i]->IsRenderable() ) {
+                        _level->OnRenderableEntityComponentRemoved( static_cast<RenderableEntityComponent*>( _components[i] ) );
+                    }
+                }
+                _level->OnEntityRemoved( this );
+            }
+
+            _level = level;
+
+            if( _level ) {
+                _level->OnEntityAdded( this );
+                for( U32 i = 0; i < componentCount; ++i ) {
+                    if( _components[i]->IsRenderable() ) {
+                        _level->OnRenderableEntityComponentAdded( static_cast<RenderableEntityComponent*>( _components[i] ) );
+                    }
+                }
+            }
+        }
+
+        U32 childCount = ChildCount();
+        for( U32 i = 0; i < childCount; ++i ) {
+            _children[i]->attachToLevel( level );
+        }
+    }
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "../Defines.h"
 #include "../String/TString.h"
 #include "../Math/Transform.h"
+#include "../Math/BoundingVolumes.h"
 #include "../Containers/List.h"
 #include "UpdateManager.h"
 #include "WObject.h"
@@ -11,6 +12,7 @@
 namespace Epoch {
 
     class Level;
+    class Prefab;
     class EntityComponent;
 
     class EPOCH_API Entity : public WObject, public IUpdatable {
@@ -22,6 +24,10 @@ namespace Epoch {
     public:
 
 
+        /**
+         * Flags this entity and all of its children as destroyed. This does not detach or free anything;
+         * use EntityCommandBuffer::DestroyEntity() to have the entity removed and freed at the next sync point.
+         */
         void Destroy();
 
         void AddChild( Entity* child );
@@ -54,6 +60,26 @@ namespace Epoch {
          */
         const Matrix4x4* GetWorldMatrix();
 
+        /**
+         * Returns the world-space bounds of this entity's renderable components. If there are none, a zero-size box at the entity's position is returned.
+         */
+        const AABB GetWorldBounds();
+
+        /**
+         * Returns the name of this entity. If Name is empty and this entity is a prefab instance, the prefab's name is returned.
+         */
+        const TString& GetName() const;
+
+        /**
+         * Returns the prefab this entity is an instance of. If none, nullptr is returned.
+         */
+        const Prefab* GetPrefab() const { return _prefab; }
+
+        /**
+         * Returns the level this entity belongs to. If none, nullptr is returned.
+         */
+        Level* GetLevel() const { return _level; }
+
         /**
          * Returns the number of children within this entity.
          */
@@ -64,6 +90,13 @@ namespace Epoch {
          */
         const U32 ComponentCount() const { return _components.Size(); }
 
+        /**
+         * Returns the component at the given index.
+         *
+         * @param index The index of the component. Must be less than ComponentCount().
+         */
+        EntityComponent* GetComponentAt( const U32 index ) { return _components[index]; }
+
         /**
          * Indicates if this entity has been destroyed.
          */
@@ -89,7 +122,7 @@ namespace Epoch {
          */
         void SetPosition( const Vector3& value ) {
             _transform.Position = value;
-            _worldMatrixDirty = true;
+            flagWorldMatrixDirty();
         }
 
         /**
@@ -102,7 +135,7 @@ namespace Epoch {
          */
         void SetRotation( const Quaternion& value ) {
             _transform.Rotation = value;
-            _worldMatrixDirty = true;
+            flagWorldMatrixDirty();
         }
 
         /**
@@ -114,7 +147,7 @@ namespace Epoch {
         void SetPositionAndRotation( const Vector3& position, const Quaternion& rotation ) {
             _transform.Position = position;
             _transform.Rotation = rotation;
-            _worldMatrixDirty = true;
+            flagWorldMatrixDirty();
         }
 
         /**
@@ -127,7 +160,7 @@ namespace Epoch {
          */
         void SetScale( const Vector3& value ) {
             _transform.Scale = value;
-            _worldMatrixDirty = true;
+            flagWorldMatrixDirty();
         }
 
         /**
@@ -141,7 +174,7 @@ namespace Epoch {
             _transform.Position = position;
             _transform.Rotation = rotation;
             _transform.Scale = scale;
-            _worldMatrixDirty = true;
+            flagWorldMatrixDirty();
         }
 
     protected:
@@ -155,20 +188,36 @@ namespace Epoch {
         void setParent( Entity* parent ) { _parent = parent; }
         void setLevel( Level* level ) { _level = level; }
 
+        // Moves this entity, its renderable components and all children from their current level to the given one.
+        void attachToLevel( Level* level );
+
     protected:
         bool _isDestroyed = false;
         Entity* _parent = nullptr;
         Level* _level = nullptr;
+        const Prefab* _prefab = nullptr;
         List<Entity*> _children;
         List<EntityComponent*> _components;
 
     private:
         bool _worldMatrixDirty = true;
 
+        // Bookkeeping for the level. Slots are indices into the level's lists, so that removal is constant time.
+        U32 _levelSlot = U32_MAX;
+        U32 _spatialIndexHandle = U32_MAX;
+        U32 _dirtySpatialSlot = U32_MAX;
+
+        // Bookkeeping for EntityCommandBuffer while applying destroys.
+        bool _isPendingRelease = false;
+        bool _hasReleasedChildren = false;
+
         // Transform should never be changed directly. This is because any change should flag the world matrix as being dirty.
         Transform _transform;
         Matrix4x4 _worldMatrix;
 
         friend class Level;
+        friend class RenderableEntityComponent;
+        friend class EntityCommandBuffer;
+        friend class Prefab;
     };
 }
\ No newline at end of file
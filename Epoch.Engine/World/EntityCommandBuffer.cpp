@@ -0,0 +1,315 @@
+#include "../Logger.h"
+
+#include "EntityComponents/EntityComponent.h"
+#include "Entity.h"
+#include "Level.h"
+#include "Prefab.h"
+#include "EntityCommandBuffer.h"
+
+namespace Epoch {
+
+    EntityCommandBuffer::EntityCommandBuffer() {
+    }
+
+    EntityCommandBuffer::~EntityCommandBuffer() {
+
+        // Anything created or handed over but never applied is not attached to anything, so it is only freed here.
+        for( U32 b = 0; b < 2; ++b ) {
+            List<EntityCommand>& creates = _commands[b][(U32)EntityCommandType::CREATE];
+            U32 createCount = creates.Size();
+            for( U32 i = 0; i < createCount; ++i ) {
+                WObject::Free( creates[i].Target );
+            }
+
+            List<EntityCommand>& adds = _commands[b][(U32)EntityCommandType::ADD_COMPONENT];
+            U32 addCount = adds.Size();
+            for( U32 i = 0; i < addCount; ++i ) {
+                WObject::Free( adds[i].Component );
+            }
+
+            for( U32 t = 0; t < (U32)EntityCommandType::COUNT; ++t ) {
+                _commands[b][t].Clear( true );
+            }
+        }
+    }
+
+    Entity* EntityCommandBuffer::CreateEntity( const TString& name, Entity* parent ) {
+        if( !parent ) {
+            Logger::Warn( "EntityCommandBuffer::CreateEntity called without a parent. Entity '%s' not created.", name.CStr() );
+            return nullptr;
+        }
+
+        Entity* entity = Entity::Create( name );
+        record( EntityCommandType::CREATE, entity, parent, nullptr );
+        return entity;
+    }
+
+    void EntityCommandBuffer::DestroyEntity( Entity* entity ) {
+        record( EntityCommandType::DESTROY, entity, nullptr, nullptr );
+    }
+
+    void EntityCommandBuffer::SetParent( Entity* entity, Entity* parent ) {
+        if( !parent ) {
+            Logger::Warn( "EntityCommandBuffer::SetParent called without a parent. Use DestroyEntity to remove an entity." );
+            return;
+        }
+        record( EntityCommandType::REPARENT, entity, parent, nullptr );
+    }
+
+    void EntityCommandBuffer::AddComponent( Entity* entity, EntityComponent* component ) {
+        record( EntityCommandType::ADD_COMPONENT, entity, nullptr, component );
+    }
+
+    void EntityCommandBuffer::RemoveComponent( Entity* entity, EntityComponent* component ) {
+        record( EntityCommandType::REMOVE_COMPONENT, entity, nullptr, component );
+    }
+
+    void EntityCommandBuffer::Apply() {
+        U32 applyIndex;
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            applyIndex = _recordIndex;
+            _recordIndex ^= 1;
+        }
+        List<EntityCommand>* commands = _commands[applyIndex];
+
+        List<EntityCommand>& creates = commands[(U32)EntityCommandType::CREATE];
+        U32 createCount = creates.Size();
+        for( U32 i = 0; i < createCount; ++i ) {
+            creates[i].Parent->AddChild( creates[i].Target );
+        }
+
+        List<EntityCommand>& reparents = commands[(U32)EntityCommandType::REPARENT];
+        U32 reparentCount = reparents.Size();
+        for( U32 i = 0; i < reparentCount; ++i ) {
+            applyReparent( reparents[i].Target, reparents[i].Parent );
+        }
+
+        List<EntityCommand>& adds = commands[(U32)EntityCommandType::ADD_COMPONENT];
+        U32 addCount = adds.Size();
+        for( U32 i = 0; i < addCount; ++i ) {
+            adds[i].Target->AddComponent( adds[i].Component );
+        }
+
+        List<EntityCommand>& removes = commands[(U32)EntityCommandType::REMOVE_COMPONENT];
+        U32 removeCount = removes.Size();
+        for( U32 i = 0; i < removeCount; ++i ) {
+            if( removes[i].Target->RemoveComponent( removes[i].Component ) ) {
+                WObject::Free( removes[i].Component );
+                _stats.ComponentsFreed++;
+            } else {
+                Logger::Warn( "Attempted to remove a component from entity '%s' which does not own it.", removes[i].Target->Name.CStr() );
+            }
+        }
+
+        applyDestroys( commands[(U32)EntityCommandType::DESTROY] );
+
+        for( U32 t = 0; t < (U32)EntityCommandType::COUNT; ++t ) {
+            _stats.Applied += commands[t].Size();
+            commands[t].Clear();
+        }
+    }
+
+    const U32 EntityCommandBuffer::GetPendingCount() {
+        std::lock_guard<std::mutex> lock( _mutex );
+        U32 count = 0;
+        for( U32 t = 0; t < (U32)EntityCommandType::COUNT; ++t ) {
+            count += _commands[_recordIndex][t].Size();
+        }
+        return count;
+    }
+
+    void EntityCommandBuffer::SetReleaseCallback( EntityReleasedCallback callback, void* context ) {
+        _releaseCallback = callback;
+        _releaseContext = context;
+    }
+
+    void EntityCommandBuffer::record( const EntityCommandType type, Entity* target, Entity* parent, EntityComponent* component ) {
+        EntityCommand command;
+        command.Target = target;
+        command.Parent = parent;
+        command.Component = component;
+
+        std::lock_guard<std::mutex> lock( _mutex );
+        _commands[_recordIndex][(U32)type].Add( command );
+        _stats.Recorded++;
+    }
+
+    void EntityCommandBuffer::applyReparent( Entity* entity, Entity* parent ) {
+        if( isLevelRoot( entity ) ) {
+            Logger::Warn( "The root entity of a level cannot be reparented." );
+            return;
+        }
+        if( entity->_parent == parent ) {
+            return;
+        }
+
+        // Also catches an entity being parented to itself.
+        for( Entity* ancestor = parent; ancestor; ancestor = ancestor->_parent ) {
+            if( ancestor == entity ) {
+                Logger::Warn( "Cannot parent entity '%s' to one of its own descendants.", entity->GetName().CStr() );
+                return;
+            }
+        }
+
+        // Moved directly rather than through RemoveChild/AddChild, so an entity staying in the same level is never unregistered from it.
+        if( entity->_parent ) {
+            entity->_parent->_children.Remove( entity );
+        }
+        parent->_children.Add( entity );
+        entity->setParent( parent );
+
+        // Prefabs belong to the level which spawned their instances, so anything leaving that level must stop referring to its prefab.
+        if( entity->_level != parent->_level ) {
+            detachFromPrefabs( entity );
+        }
+        entity->attachToLevel( parent->_level );
+        entity->flagWorldMatrixDirty();
+    }
+
+    void EntityCommandBuffer::detachFromPrefabs( Entity* entity ) {
+        _releaseStack.Clear();
+        _releaseStack.Add( entity );
+        while( _releaseStack.Size() > 0 ) {
+            U32 top = _releaseStack.Size() - 1;
+            Entity* current = _releaseStack[top];
+            _releaseStack.RemoveAt( top );
+
+            U32 childCount = current->_children.Size();
+            for( U32 c = 0; c < childCount; ++c ) {
+                _releaseStack.Add( current->_children[c] );
+            }
+
+            if( !current->_prefab ) {
+                continue;
+            }
+            if( current->Name.IsEmpty() ) {
+                current->Name = current->_prefab->GetName();
+            }
+            current->_prefab = nullptr;
+
+            U32 componentCount = current->_components.Size();
+            for( U32 c = 0; c < componentCount; ++c ) {
+                EntityComponent* component = current->_components[c];
+                if( component->_sharedName ) {
+                    component->_name = *component->_sharedName;
+                    component->_sharedName = nullptr;
+                }
+            }
+        }
+    }
+
+    void EntityCommandBuffer::applyDestroys( List<EntityCommand>& commands ) {
+
+        // Flag every entity being released first. Entities already flagged, either recorded twice or beneath another
+        // recorded entity, are skipped, so each hierarchy is released exactly once.
+        _releaseTargets.Clear();
+        U32 commandCount = commands.Size();
+        for( U32 i = 0; i < commandCount; ++i ) {
+            Entity* target = commands[i].Target;
+            if( target->_isPendingRelease ) {
+                continue;
+            }
+            if( isLevelRoot( target ) ) {
+                Logger::Warn( "The root entity of a level cannot be destroyed. Unload the level instead." );
+                continue;
+            }
+
+            _releaseStack.Clear();
+            _releaseStack.Add( target );
+            while( _releaseStack.Size() > 0 ) {
+                U32 top = _releaseStack.Size() - 1;
+                Entity* entity = _releaseStack[top];
+                _releaseStack.RemoveAt( top );
+                if( entity->_isPendingRelease ) {
+                    continue;
+                }
+                entity->_isPendingRelease = true;
+                entity->_isDestroyed = true;
+                U32 childCount = entity->_children.Size();
+                for( U32 c = 0; c < childCount; ++c ) {
+                    _releaseStack.Add( entity->_children[c] );
+                }
+            }
+            _releaseTargets.Add( target );
+        }
+
+        // Keep only the topmost targets, and collect their surviving parents. This must be done before anything is freed.
+        _releaseParents.Clear();
+        U32 topCount = 0;
+        U32 targetCount = _releaseTargets.Size();
+        for( U32 i = 0; i < targetCount; ++i ) {
+            Entity* target = _releaseTargets[i];
+            Entity* parent = target->_parent;
+            if( parent && parent->_isPendingRelease ) {
+                continue;
+            }
+            _releaseTargets[topCount++] = target;
+            if( parent && !parent->_hasReleasedChildren ) {
+                parent->_hasReleasedChildren = true;
+                _releaseParents.Add( parent );
+            }
+        }
+        _releaseTargets.Resize( topCount );
+
+        // Compact each surviving parent's children once, keeping their order, however many of them are going.
+        U32 parentCount = _releaseParents.Size();
+        for( U32 i = 0; i < parentCount; ++i ) {
+            Entity* parent = _releaseParents[i];
+            U32 childCount = parent->_children.Size();
+            U32 keptCount = 0;
+            for( U32 c = 0; c < childCount; ++c ) {
+                Entity* child = parent->_children[c];
+                if( !child->_isPendingRelease ) {
+                    parent->_children[keptCount++] = child;
+                }
+            }
+            parent->_children.Resize( keptCount );
+            parent->_hasReleasedChildren = false;
+        }
+
+        for( U32 i = 0; i < topCount; ++i ) {
+            releaseHierarchy( _releaseTargets[i] );
+        }
+    }
+
+    void EntityCommandBuffer::releaseHierarchy( Entity* entity ) {
+        _releaseStack.Clear();
+        _releaseStack.Add( entity );
+        while( _releaseStack.Size() > 0 ) {
+            U32 top = _releaseStack.Size() - 1;
+            Entity* current = _releaseStack[top];
+            _releaseStack.RemoveAt( top );
+
+            U32 childCount = current->_children.Size();
+            for( U32 c = 0; c < childCount; ++c ) {
+                _releaseStack.Add( current->_children[c] );
+            }
+
+            // The level removes each entry in constant time, so this is proportional to what is being released, not the size of the level.
+            Level* level = current->_level;
+            U32 componentCount = current->_components.Size();
+            for( U32 c = 0; c < componentCount; ++c ) {
+                EntityComponent* component = current->_components[c];
+                if( level && component->IsRenderable() ) {
+                    level->OnRenderableEntityComponentRemoved( static_cast<RenderableEntityComponent*>( component ) );
+                }
+                WObject::Free( component );
+                _stats.ComponentsFreed++;
+            }
+            if( level ) {
+                level->OnEntityRemoved( current );
+            }
+            if( _releaseCallback ) {
+                _releaseCallback( _releaseContext, current );
+            }
+
+            WObject::Free( current );
+            _stats.EntitiesFreed++;
+        }
+    }
+
+    const bool EntityCommandBuffer::isLevelRoot( Entity* entity ) {
+        return entity->_level && entity->_level->GetRootEntity() == entity;
+    }
+}
\ No newline at end of file
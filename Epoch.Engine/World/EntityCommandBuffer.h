@@ -0,0 +1,162 @@
+#pragma once
+
+#include <mutex>
+
+#include "../Types.h"
+#include "../Defines.h"
+#include "../String/TString.h"
+#include "../Containers/List.h"
+
+namespace Epoch {
+
+    class Entity;
+    class EntityComponent;
+
+    /**
+     * The types of structural changes which can be recorded. Commands are applied in this order.
+     */
+    enum class EntityCommandType : U8 {
+        CREATE,
+        REPARENT,
+        ADD_COMPONENT,
+        REMOVE_COMPONENT,
+        DESTROY,
+        COUNT
+    };
+
+    /**
+     * A snapshot of the work done by an entity command buffer.
+     */
+    struct EntityCommandBufferStats {
+        U32 Recorded = 0;
+        U32 Applied = 0;
+        U32 EntitiesFreed = 0;
+        U32 ComponentsFreed = 0;
+    };
+
+    /**
+     * Records structural changes to the entity hierarchy (creates, destroys, reparents and component adds/removes)
+     * so they can be made from anywhere during update, including other threads, without touching level
+     * bookkeeping. Everything recorded is applied together at a single sync point, grouped by type so that
+     * creates always happen first and destroys always happen last.
+     */
+    class EPOCH_API EntityCommandBuffer {
+    public:
+
+        // Called with each entity destroyed by Apply, just before it is freed.
+        typedef void ( *EntityReleasedCallback )( void* context, Entity* entity );
+        EntityCommandBuffer();
+
+        /**
+         * Frees any entities and components which were created or handed over by recorded commands but never applied.
+         */
+        ~EntityCommandBuffer();
+
+        /**
+         * Allocates a new entity, which is attached to the given parent when commands are applied. The entity
+         * may be used in other commands right away, but should not be otherwise touched until then. Safe to call from any thread.
+         *
+         * @param name The name of the entity.
+         * @param parent The entity to attach to. Use a level's root entity to attach at the top of that level. Must not be nullptr.
+         *
+         * @returns The new entity, or nullptr if no parent was given.
+         */
+        Entity* CreateEntity( const TString& name, Entity* parent );
+
+        /**
+         * Records that the given entity and all of its children should be detached and freed, along with their components.
+         * Safe to call from any thread.
+         *
+         * @param entity The entity to destroy. Must not be a level's root entity.
+         */
+        void DestroyEntity( Entity* entity );
+
+        /**
+         * Records that the given entity should be moved to a new parent, which may be in another level. Safe to call from any thread.
+         *
+         * @param entity The entity to move.
+         * @param parent The new parent. Must not be nullptr.
+         */
+        void SetParent( Entity* entity, Entity* parent );
+
+        /**
+         * Records that the given component should be added to an entity. Safe to call from any thread.
+         *
+         * @param entity The entity to add to.
+         * @param component The component to add. Owned by this buffer until applied.
+         */
+        void AddComponent( Entity* entity, EntityComponent* component );
+
+        /**
+         * Records that the given component should be removed from an entity and freed. Safe to call from any thread.
+         *
+         * @param entity The entity to remove from.
+         * @param component The component to remove.
+         */
+        void RemoveComponent( Entity* entity, EntityComponent* component );
+
+        /**
+         * Applies all recorded commands, in order of type and then in the order they were recorded. Must be called on the main thread,
+         * while nothing else is touching the entity hierarchy. Commands recorded while applying are kept for the next call.
+         */
+        void Apply();
+
+        /**
+         * Sets a function to call with each entity destroyed by Apply, just before it is freed. Used by owners to drop
+         * references they hold to destroyed entities.
+         *
+         * @param callback The function to call. Pass nullptr to stop being called.
+         * @param context A pointer passed back to the callback.
+         */
+        void SetReleaseCallback( EntityReleasedCallback callback, void* context );
+
+        /**
+         * Returns the number of commands waiting to be applied.
+         */
+        const U32 GetPendingCount();
+
+        /**
+         * Returns the stats accumulated since creation.
+         */
+        const EntityCommandBufferStats GetStats() const { return _stats; }
+
+    private:
+        struct EntityCommand {
+            Entity* Target;
+            Entity* Parent;
+            EntityComponent* Component;
+        };
+
+        void record( const EntityCommandType type, Entity* target, Entity* parent, EntityComponent* component );
+        void applyReparent( Entity* entity, Entity* parent );
+
+        // Gives the given entity and its descendants their own copies of anything they share with a prefab, and clears their prefab.
+        void detachFromPrefabs( Entity* entity );
+        void applyDestroys( List<EntityCommand>& commands );
+
+        // Unregisters the given entity and all of its descendants from their level and frees them, along with their components. Child lists are not touched.
+        void releaseHierarchy( Entity* entity );
+
+        static const bool isLevelRoot( Entity* entity );
+
+    private:
+
+        // Commands are kept in a list per type, which keeps them sorted by type without any sorting, and double-buffered
+        // so recording can continue while a batch is applied. Lists are cleared rather than freed, so a steady state does not allocate.
+        List<EntityCommand> _commands[2][(U32)EntityCommandType::COUNT];
+        U32 _recordIndex = 0;
+
+        // Guards recording into the current set of lists.
+        std::mutex _mutex;
+
+        // Scratch lists used while applying.
+        List<Entity*> _releaseTargets;
+        List<Entity*> _releaseParents;
+        List<Entity*> _releaseStack;
+
+        EntityCommandBufferStats _stats;
+
+        EntityReleasedCallback _releaseCallback = nullptr;
+        void* _releaseContext = nullptr;
+    };
+}
\ No newline at end of file
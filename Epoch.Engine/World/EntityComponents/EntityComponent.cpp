@@ -1,5 +1,6 @@
 
 #include "../Entity.h"
+#include "../Level.h"
 #include "EntityComponent.h"
 
 namespace Epoch {
@@ -15,4 +16,11 @@ namespace Epoch {
     const Matrix4x4* RenderableEntityComponent::GetWorldMatrix() { 
         return getOwningEntity()->GetWorldMatrix(); 
     }
+
+    void RenderableEntityComponent::flagRenderProxyDirty() {
+        Entity* owner = getOwningEntity();
+        if( owner && owner->_level ) {
+            owner->_level->OnRenderableEntityComponentTransformChanged( this );
+        }
+    }
 }
\ No newline at end of file
@@ -2,13 +2,17 @@
 
 #include "../../Containers/List.h"
 #include "../../String/TString.h"
+#include "../../Math/BoundingVolumes.h"
 #include "../WObject.h"
 
+#define INVALID_RENDER_PROXY_INDEX 0xFFFFFFFFU
+
 namespace Epoch {
 
     class Entity;
     class Matrix4x4;
     struct RenderReferenceData;
+    struct WorldRenderableObjectTable;
 
     class EntityComponent : public WObject {
     public:
@@ -17,7 +21,10 @@ namespace Epoch {
 
         virtual const bool IsRenderable() const = 0;
 
-        const TString& GetName() const { return _name; }
+        /**
+         * Returns the name of this component. Components of prefab instances share their prefab's name for the component.
+         */
+        const TString& GetName() const { return _sharedName ? *_sharedName : _name; }
 
     protected:
         void setOwningEntity( Entity* entity );
@@ -26,9 +33,14 @@ namespace Epoch {
     protected:
         TString _name;
     private:
-        Entity* _owner;
+        Entity* _owner = nullptr;
+
+        // Set for components of prefab instances, which do not keep a name of their own.
+        const TString* _sharedName = nullptr;
 
         friend class Entity;
+        friend class Prefab;
+        friend class EntityCommandBuffer;
     };
 
     enum class RenderableComponentType {
@@ -49,6 +61,27 @@ namespace Epoch {
 
         virtual const RenderableComponentType GetRenderableComponentType() const = 0;
 
+        /**
+         * Returns the object-space bounds of this component, used for visibility culling.
+         */
+        virtual const AABB GetLocalBounds() const = 0;
+
+    protected:
+
+        // Should be called when something other than the owner's transform changes this component's render proxy, such as its bounds.
+        void flagRenderProxyDirty();
+
+    private:
+
+        // Bookkeeping for the world's render table, which keeps a proxy for this component.
+        U32 _renderProxyIndex = INVALID_RENDER_PROXY_INDEX;
+        U32 _dirtyProxySlot = INVALID_RENDER_PROXY_INDEX;
+
+        // Index into the owning level's list of renderable components.
+        U32 _levelSlot = INVALID_RENDER_PROXY_INDEX;
+
+        friend struct WorldRenderableObjectTable;
+        friend class Level;
     };
 
     class EntityComponentFactory final {
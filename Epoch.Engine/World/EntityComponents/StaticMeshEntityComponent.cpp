@@ -27,10 +27,9 @@ namespace Epoch {
     }
 
     StaticMeshEntityComponent::~StaticMeshEntityComponent() {
-        if( _mesh ) {
-            delete _mesh;
-            _mesh = nullptr;
-        }
+
+        // The mesh is shared between components and owned by the level which loaded it.
+        _mesh = nullptr;
     }
 
     const bool StaticMeshEntityComponent::HasReferenceData() {
@@ -41,7 +40,14 @@ namespace Epoch {
         return _mesh->GetReferenceData();
     }
 
+    const AABB StaticMeshEntityComponent::GetLocalBounds() const {
+        return _mesh ? _mesh->GetBounds() : AABB();
+    }
+
     void StaticMeshEntityComponent::SetStaticMesh( StaticMesh* mesh ) {
         _mesh = mesh;
+
+        // Bounds come from the mesh, so the render proxy needs refreshing.
+        flagRenderProxyDirty();
     }
 }
\ No newline at end of file
@@ -16,12 +16,16 @@ namespace Epoch {
         virtual RenderReferenceData* GetReferenceData();
 
         virtual const RenderableComponentType GetRenderableComponentType() const override { return RenderableComponentType::STATIC_MESH; }
+
+        virtual const AABB GetLocalBounds() const override;
     public:
         StaticMeshEntityComponent( const TString& name );
         virtual ~StaticMeshEntityComponent();
         void SetStaticMesh( StaticMesh* mesh );
 
+        StaticMesh* GetStaticMesh() { return _mesh; }
+
     private:
-        StaticMesh* _mesh;
+        StaticMesh* _mesh = nullptr;
     };
 }
\ No newline at end of file
@@ -2,121 +2,589 @@
 #include "EntityComponents/StaticMeshEntityComponent.h"
 #include "EntityComponents/EntityComponent.h"
 #include "World.h"
-#include "../Math/TMath.h"
 #include "../Resources/StaticMesh.h"
+#include "../FileSystem/FileHandle.h"
+#include "../FileSystem/MappedFile.h"
+#include "../Logger.h"
 
 #include "Entity.h"
+#include "Prefab.h"
+#include "LooseOctree.h"
 #include "Level.h"
 
+// The half-size of the root cell of each level's spatial index. Entities outside of it are still indexed, just less efficiently.
+#define LEVEL_SPATIAL_INDEX_HALF_SIZE 2048.0f
+
+// Identifies a level file. "ELVL" in little-endian.
+#define LEVEL_FILE_MAGIC 0x4C564C45U
+
+// Every section of a level file begins on a boundary of this many bytes.
+#define LEVEL_FILE_ALIGNMENT 16
+
 namespace Epoch {
 
+    /**
+     * A reference to a section of a level file. Stored on disk as an offset from the start of the file,
+     * and replaced in place by a pointer once the file is mapped.
+     */
+    template<typename T>
+    union LevelFileRef {
+        U64 Offset;
+        T* Pointer;
+    };
+
+    enum class LevelFileComponentType : U32 {
+        STATIC_MESH = 0x01U
+    };
+
+    struct LevelFileEntity {
+        F32 Position[3];
+        F32 Rotation[4];
+        F32 Scale[3];
+
+        // -1 for children of the level root.
+        I32 ParentIndex;
+        U32 NameOffset;
+        U32 FirstComponent;
+        U32 ComponentCount;
+        U32 Padding[2];
+    };
+
+    struct LevelFileComponent {
+        U32 Type;
+
+        // Index into the mesh table for static meshes. -1 for none.
+        I32 AssetIndex;
+    };
+
+    struct LevelFileMesh {
+
+        // Hash of the asset path, so assets can be resolved without string comparisons.
+        U64 Guid;
+        U32 PathOffset;
+        U32 Padding;
+    };
+
+    struct LevelFileHeader {
+        U32 Magic;
+        U8 Version;
+        U8 Padding[3];
+        U32 EntityCount;
+        U32 ComponentCount;
+        U32 MeshCount;
+        U32 StringDataSize;
+        U64 FileSize;
+        LevelFileRef<LevelFileEntity> Entities;
+        LevelFileRef<LevelFileComponent> Components;
+        LevelFileRef<LevelFileMesh> Meshes;
+        LevelFileRef<const char> Strings;
+    };
+
+    static_assert( sizeof( LevelFileHeader ) == 64, "LevelFileHeader layout must not change." );
+    static_assert( sizeof( LevelFileEntity ) == 64, "LevelFileEntity layout must not change." );
+    static_assert( sizeof( LevelFileComponent ) == 8, "LevelFileComponent layout must not change." );
+    static_assert( sizeof( LevelFileMesh ) == 16, "LevelFileMesh layout must not change." );
+
+    // 64-bit FNV-1a hash of an asset path.
+    static U64 hashAssetPath( const TString& path ) {
+        U64 hash = 0xcbf29ce484222325ULL;
+        const char* str = path.CStr();
+        for( U32 i = 0; str[i] != '\0'; ++i ) {
+            hash ^= (U8)str[i];
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    static U64 alignLevelFileOffset( const U64 offset ) {
+        return ( offset + ( LEVEL_FILE_ALIGNMENT - 1 ) ) & ~( (U64)LEVEL_FILE_ALIGNMENT - 1 );
+    }
+
+    static const bool isValidLevelFileSection( const U64 offset, const U64 size, const U64 fileSize ) {
+        return ( offset % LEVEL_FILE_ALIGNMENT ) == 0 && offset <= fileSize && size <= fileSize - offset;
+    }
+
+    // Appends a zero-terminated copy of the given string, returning its offset.
+    static U32 addLevelFileString( List<char>& strings, const TString& str ) {
+        U32 offset = strings.Size();
+        U32 length = str.Length();
+        const char* data = str.CStr();
+        for( U32 i = 0; i < length; ++i ) {
+            strings.Add( data[i] );
+        }
+        strings.Add( '\0' );
+        return offset;
+    }
+
+    // Pads the file with zeroes up to the given offset, then writes the section.
+    static const bool writeLevelFileSection( FileHandle& file, U64* position, const U64 offset, const void* data, const U64 size ) {
+        bool result = true;
+        for( ; result && *position < offset; ++( *position ) ) {
+            result = file.Write<U8>( 0 );
+        }
+        if( result && size > 0 ) {
+            result = file.WriteArray<U8>( static_cast<const U8*>( data ), size );
+        }
+        *position += size;
+        return result;
+    }
+
     // This constructor is only available to the World via friend and prvately.
     // It is used to construct the root level.
     Level::Level() {
         _isRoot = true;
+        _spatialIndex = new LooseOctree( Vector3::Zero(), LEVEL_SPATIAL_INDEX_HALF_SIZE );
+        ensureRootEntity();
     }
 
     Level::Level( const TString& name ) {
         Name = name;
+        _spatialIndex = new LooseOctree( Vector3::Zero(), LEVEL_SPATIAL_INDEX_HALF_SIZE );
+        ensureRootEntity();
     }
 
     Level::~Level() {
         Name.Clear();
+        if( _spatialIndex ) {
+            delete _spatialIndex;
+            _spatialIndex = nullptr;
+        }
     }
 
-    void Level::Load() {
-        _root = new Entity();
-        _root->Name = "__ROOT__";
-        _root->setLevel( this );
-
-        // TODO: Need to read in from a file (deserialize?) and stand up object heirarchy appropriately.
-        // TODO: This is a test, remove this in favour of actual loading later.
+    void Level::Unload( EntityCommandBuffer::EntityReleasedCallback releaseCallback, void* releaseContext ) {
+        if( _renderTable ) {
+            Logger::Warn( "Level '%s' was unloaded while still attached to a world.", Name.CStr() );
+            setRenderTable( nullptr );
+        }
 
-        StaticMesh* testMesh = new StaticMesh( "test", "assets/models/Teapot001.esm" );
-        testMesh->Load();
+        // Entities and components are freed directly rather than detached one by one, since the whole level is going away.
+        // Owners still hear about each entity, so they can drop references to it.
+        U32 entityCount = _entities.Size();
+        for( U32 i = 0; i < entityCount; ++i ) {
+            Entity* entity = _entities[i];
+            U32 componentCount = entity->_components.Size();
+            for( U32 c = 0; c < componentCount; ++c ) {
+                WObject::Free( entity->_components[c] );
+            }
+            if( releaseCallback ) {
+                releaseCallback( releaseContext, entity );
+            }
+            WObject::Free( entity );
+        }
+        _entities.Clear();
+        _renderableEntityComponents.Clear();
+        _dirtySpatialEntities.Clear();
+        _spatialIndex->Clear();
 
-        //srand( 43456 );
+        U32 prefabCount = _prefabs.Size();
+        for( U32 i = 0; i < prefabCount; ++i ) {
+            delete _prefabs[i];
+        }
+        _prefabs.Clear();
 
-        for( U32 i = 0; i < 100; ++i ) {
-            TString name = "testObj";
-            name.Append( i );
-            Entity* entity = Entity::Create( name );
-            F32 min = -15.0f;
-            F32 max = 15.0f;
-            F32 x = TMath::FloatRandomRange( min, max );
-            F32 y = TMath::FloatRandomRange( min, max );
-            F32 z = TMath::FloatRandomRange( min, max );
+        if( _root ) {
+            delete _root;
+            _root = nullptr;
+        }
 
-            F32 smin = 0.2f;
-            F32 smax = 2.0f;
-            F32 scale = TMath::FloatRandomRange( smin, smax );
+        U32 meshCount = _meshes.Size();
+        for( U32 i = 0; i < meshCount; ++i ) {
+            _meshes[i]->Unload();
+            delete _meshes[i];
+        }
+        _meshes.Clear();
+    }
 
-            entity->SetPosition( Vector3( x, y, z ) );
-            entity->SetScale( Vector3( scale, scale, scale ) );
-            _root->AddChild( entity );
+    void Level::Update( const F32 deltaTime ) {
+        updateSpatialIndex();
 
-            // Add a test entity component.
-            StaticMeshEntityComponent* staticMeshComponent2 = EntityComponentFactory::CreateComponent<StaticMeshEntityComponent>( "TestComponent2" );
-            staticMeshComponent2->SetStaticMesh( testMesh );
-            entity->AddComponent( staticMeshComponent2 );
+        U32 childCount = _children.Size();
+        for( U32 i = 0; i < childCount; ++i ) {
+            _children[i]->Update( deltaTime );
         }
     }
 
-    void Level::Unload() {
+    /*
+    FORMAT:
+
+    The file is a set of fixed-size record arrays, laid out so it can be mapped and used directly rather
+    than parsed. All references are offsets from the start of the file, and every section begins on a
+    LEVEL_FILE_ALIGNMENT boundary. All values are little-endian.
+
+    LevelFileHeader (64 bytes)
+    <EntityCount> of LevelFileEntity (64 bytes each). Parents always precede their children.
+    <ComponentCount> of LevelFileComponent (8 bytes each). Each entity owns a contiguous run of these.
+    <MeshCount> of LevelFileMesh (16 bytes each).
+    <StringDataSize> bytes of zero-terminated strings, referenced by offset from the start of this section.
+
+    */
+    const bool Level::SerializeBinary( const TString& filePath ) {
+        FileHandle file( filePath, true );
+        if( !file.TryOpen( FileMode::FILE_MODE_OUTPUT ) ) {
+            Logger::Error( "Failed to open level file located at '%s'.", filePath.CStr() );
+            return false;
+        }
+
+        // Flatten the hierarchy depth-first, so parents always come before their children regardless of the order they were attached in.
+        U32 entityCount = _entities.Size();
+        List<Entity*> entities;
+        List<I32> parentIndices;
+        entities.Reserve( entityCount );
+        parentIndices.Reserve( entityCount );
+        List<Entity*> stack;
+        List<I32> stackParents;
+        if( _root ) {
+            for( I32 c = (I32)_root->ChildCount() - 1; c >= 0; --c ) {
+                stack.Add( _root->_children[c] );
+                stackParents.Add( -1 );
+            }
+        }
+        while( stack.Size() > 0 ) {
+            U32 top = stack.Size() - 1;
+            Entity* entity = stack[top];
+            I32 parentIndex = stackParents[top];
+            stack.RemoveAt( top );
+            stackParents.RemoveAt( top );
+
+            I32 index = (I32)entities.Size();
+            entities.Add( entity );
+            parentIndices.Add( parentIndex );
+            for( I32 c = (I32)entity->ChildCount() - 1; c >= 0; --c ) {
+                stack.Add( entity->_children[c] );
+                stackParents.Add( index );
+            }
+        }
+        entityCount = entities.Size();
+
+        List<LevelFileEntity> entityRecords;
+        entityRecords.Reserve( entityCount );
+        List<LevelFileComponent> componentRecords;
+        List<LevelFileMesh> meshRecords;
+        List<StaticMesh*> meshes;
+        List<char> strings;
+
+        for( U32 i = 0; i < entityCount; ++i ) {
+            Entity* entity = entities[i];
+            const Vector3& position = entity->GetPosition();
+            const Quaternion& rotation = entity->GetRotation();
+            const Vector3& scale = entity->GetScale();
+
+            LevelFileEntity record = {};
+            record.Position[0] = position.X;
+            record.Position[1] = position.Y;
+            record.Position[2] = position.Z;
+            record.Rotation[0] = rotation.X;
+            record.Rotation[1] = rotation.Y;
+            record.Rotation[2] = rotation.Z;
+            record.Rotation[3] = rotation.W;
+            record.Scale[0] = scale.X;
+            record.Scale[1] = scale.Y;
+            record.Scale[2] = scale.Z;
+            record.ParentIndex = parentIndices[i];
+            record.NameOffset = addLevelFileString( strings, entity->GetName() );
+            record.FirstComponent = componentRecords.Size();
+
+            // Meshes are referenced by index into the mesh table, which holds each distinct mesh once.
+            U32 componentCount = entity->ComponentCount();
+            for( U32 c = 0; c < componentCount; ++c ) {
+                EntityComponent* component = entity->_components[c];
+                if( !component->IsRenderable() || static_cast<RenderableEntityComponent*>( component )->GetRenderableComponentType() != RenderableComponentType::STATIC_MESH ) {
+                    continue;
+                }
+
+                StaticMesh* mesh = static_cast<StaticMeshEntityComponent*>( component )->GetStaticMesh();
+                I32 meshIndex = -1;
+                if( mesh ) {
+                    meshIndex = meshes.IndexOf( mesh );
+                    if( meshIndex == -1 ) {
+                        meshIndex = (I32)meshes.Size();
+                        meshes.Add( mesh );
+
+                        LevelFileMesh meshRecord = {};
+                        meshRecord.Guid = hashAssetPath( mesh->GetPath() );
+                        meshRecord.PathOffset = addLevelFileString( strings, mesh->GetPath() );
+                        meshRecords.Add( meshRecord );
+                    }
+                }
+
+                LevelFileComponent componentRecord;
+                componentRecord.Type = (U32)LevelFileComponentType::STATIC_MESH;
+                componentRecord.AssetIndex = meshIndex;
+                componentRecords.Add( componentRecord );
+            }
+            record.ComponentCount = componentRecords.Size() - record.FirstComponent;
+            entityRecords.Add( record );
+        }
+
+        LevelFileHeader header = {};
+        header.Magic = LEVEL_FILE_MAGIC;
+        header.Version = (U8)LevelFileVersion::VERSION_2_0;
+        header.EntityCount = entityCount;
+        header.ComponentCount = componentRecords.Size();
+        header.MeshCount = meshRecords.Size();
+        header.StringDataSize = strings.Size();
+        header.Entities.Offset = alignLevelFileOffset( sizeof( LevelFileHeader ) );
+        header.Components.Offset = alignLevelFileOffset( header.Entities.Offset + sizeof( LevelFileEntity ) * (U64)header.EntityCount );
+        header.Meshes.Offset = alignLevelFileOffset( header.Components.Offset + sizeof( LevelFileComponent ) * (U64)header.ComponentCount );
+        header.Strings.Offset = alignLevelFileOffset( header.Meshes.Offset + sizeof( LevelFileMesh ) * (U64)header.MeshCount );
+        header.FileSize = header.Strings.Offset + header.StringDataSize;
+
+        U64 position = 0;
+        bool result = writeLevelFileSection( file, &position, 0, &header, sizeof( LevelFileHeader ) ) &&
+            writeLevelFileSection( file, &position, header.Entities.Offset, entityRecords.Data(), sizeof( LevelFileEntity ) * (U64)header.EntityCount ) &&
+            writeLevelFileSection( file, &position, header.Components.Offset, componentRecords.Data(), sizeof( LevelFileComponent ) * (U64)header.ComponentCount ) &&
+            writeLevelFileSection( file, &position, header.Meshes.Offset, meshRecords.Data(), sizeof( LevelFileMesh ) * (U64)header.MeshCount ) &&
+            writeLevelFileSection( file, &position, header.Strings.Offset, strings.Data(), header.StringDataSize );
 
+        file.Close();
+        if( !result ) {
+            Logger::Error( "Error writing level file '%s'. Process aborted.", filePath.CStr() );
+        }
+        return result;
     }
 
-    void Level::Update( const F32 deltaTime ) {
+    const bool Level::DeserializeBinary( const TString& filePath ) {
+        MappedFile file( filePath );
+        if( !file.TryOpen() ) {
+            Logger::Error( "Failed to open level file located at '%s'.", filePath.CStr() );
+            return false;
+        }
+
+        U8* base = file.GetData();
+        U64 fileSize = file.GetSize();
+        LevelFileHeader* header = reinterpret_cast<LevelFileHeader*>( base );
+        if( fileSize < sizeof( LevelFileHeader ) || header->Magic != LEVEL_FILE_MAGIC ) {
+            Logger::Error( "'%s' is not a level file.", filePath.CStr() );
+            return false;
+        }
+        if( header->Version != (U8)LevelFileVersion::VERSION_2_0 ) {
+            Logger::Error( "Unsupported level file version %u in '%s'.", header->Version, filePath.CStr() );
+            return false;
+        }
+
+        // Validate everything up front, so nothing below needs to bounds-check against the file.
+        bool valid = header->FileSize == fileSize &&
+            isValidLevelFileSection( header->Entities.Offset, sizeof( LevelFileEntity ) * (U64)header->EntityCount, fileSize ) &&
+            isValidLevelFileSection( header->Components.Offset, sizeof( LevelFileComponent ) * (U64)header->ComponentCount, fileSize ) &&
+            isValidLevelFileSection( header->Meshes.Offset, sizeof( LevelFileMesh ) * (U64)header->MeshCount, fileSize ) &&
+            isValidLevelFileSection( header->Strings.Offset, header->StringDataSize, fileSize ) &&
+            ( header->StringDataSize == 0 || base[header->Strings.Offset + header->StringDataSize - 1] == '\0' );
+        if( !valid ) {
+            Logger::Error( "Level file '%s' is truncated or corrupt.", filePath.CStr() );
+            return false;
+        }
+
+        // Fix up section offsets into pointers in place. The mapping is copy-on-write, so this only touches the header's page.
+        header->Entities.Pointer = reinterpret_cast<LevelFileEntity*>( base + header->Entities.Offset );
+        header->Components.Pointer = reinterpret_cast<LevelFileComponent*>( base + header->Components.Offset );
+        header->Meshes.Pointer = reinterpret_cast<LevelFileMesh*>( base + header->Meshes.Offset );
+        header->Strings.Pointer = reinterpret_cast<const char*>( base + header->Strings.Offset );
+        const char* strings = header->Strings.Pointer;
 
-        // Randomly rotate the objects in the scene. TODO: Remove this temporary test logic.
-        U32 count = _entities.Size();
-        for( I32 i = 0; i < count; ++i ) {
-            F32 amount = ( i % 2 == 0 ) ? 1.0f : -1.0f;
-            if( _entities[i] ) {
-                Quaternion q = Quaternion::FromAxisAngle( Vector3::Up(), deltaTime * amount );
-                Quaternion rotation = _entities[i]->GetRotation() * q;
-                _entities[i]->SetRotation( rotation );
+        ensureRootEntity();
+        _isLoading = true;
+
+        // Meshes. Their data is read here, but uploading is left to FinalizeLoad.
+        U32 meshBase = _meshes.Size();
+        for( U32 i = 0; i < header->MeshCount; ++i ) {
+            const LevelFileMesh& record = header->Meshes.Pointer[i];
+            if( record.PathOffset >= header->StringDataSize ) {
+                valid = false;
+                break;
+            }
+            const char* path = strings + record.PathOffset;
+            StaticMesh* mesh = new StaticMesh( path, path );
+            _meshes.Add( mesh );
+            if( !mesh->LoadData() ) {
+                Logger::Warn( "Level '%s' failed to load mesh data for '%s'.", Name.CStr(), path );
+            }
+        }
+
+        // Entities, read straight out of the mapped records.
+        List<Entity*> created;
+        created.Reserve( header->EntityCount );
+        Reserve( header->EntityCount, header->ComponentCount );
+        for( U32 i = 0; valid && i < header->EntityCount; ++i ) {
+            const LevelFileEntity& record = header->Entities.Pointer[i];
+            if( record.ParentIndex >= (I32)i || record.NameOffset >= header->StringDataSize ||
+                (U64)record.FirstComponent + record.ComponentCount > header->ComponentCount ) {
+                valid = false;
+                break;
+            }
+
+            Entity* entity = Entity::Create( strings + record.NameOffset );
+            entity->SetPositionRotationAndScale(
+                Vector3( record.Position[0], record.Position[1], record.Position[2] ),
+                Quaternion( record.Rotation[0], record.Rotation[1], record.Rotation[2], record.Rotation[3] ),
+                Vector3( record.Scale[0], record.Scale[1], record.Scale[2] ) );
+            Entity* parent = record.ParentIndex < 0 ? _root : created[record.ParentIndex];
+            parent->AddChild( entity );
+            created.Add( entity );
+
+            for( U32 c = 0; c < record.ComponentCount; ++c ) {
+                const LevelFileComponent& component = header->Components.Pointer[record.FirstComponent + c];
+                if( component.Type == (U32)LevelFileComponentType::STATIC_MESH && component.AssetIndex >= 0 && (U32)component.AssetIndex < header->MeshCount ) {
+                    StaticMeshEntityComponent* meshComponent = EntityComponentFactory::CreateComponent<StaticMeshEntityComponent>( entity->Name );
+                    meshComponent->SetStaticMesh( _meshes[meshBase + component.AssetIndex] );
+                    entity->AddComponent( meshComponent );
+                }
+            }
+        }
+
+        file.Close();
+        _isLoading = false;
+        buildSpatialIndex();
+
+        if( !valid ) {
+            Logger::Error( "Level file '%s' contains invalid references. Process aborted.", filePath.CStr() );
+        }
+        return valid;
+    }
+
+    void Level::FinalizeLoad() {
+        U32 meshCount = _meshes.Size();
+        for( U32 i = 0; i < meshCount; ++i ) {
+            if( !_meshes[i]->IsLoaded() ) {
+                _meshes[i]->Load();
             }
         }
     }
 
+    const U64 Level::GetResidentBytes() const {
+        U64 total = sizeof( Level ) + ( sizeof( Entity ) * (U64)_entities.Size() ) + ( sizeof( StaticMeshEntityComponent ) * (U64)_renderableEntityComponents.Size() );
+        U32 meshCount = _meshes.Size();
+        for( U32 i = 0; i < meshCount; ++i ) {
+            total += _meshes[i]->GetDataSize();
+        }
+        return total;
+    }
+
+    void Level::Reserve( const U32 entityCount, const U32 renderableComponentCount ) {
+        _entities.Reserve( _entities.Size() + entityCount );
+        _renderableEntityComponents.Reserve( _renderableEntityComponents.Size() + renderableComponentCount );
+    }
+
     void Level::OnEntityAdded( Entity* entity ) {
+        entity->_levelSlot = _entities.Size();
         _entities.Add( entity );
+
+        // The actual bounds are picked up on the next update.
+        if( !_isLoading ) {
+            entity->_spatialIndexHandle = _spatialIndex->Insert( entity, AABB() );
+            OnEntityBoundsChanged( entity );
+        }
     }
 
     void Level::OnEntityRemoved( Entity* entity ) {
-        _entities.Remove( entity );
+
+        // Swap the last entries into the vacated slots and fix up their back-references.
+        U32 slot = entity->_levelSlot;
+        U32 lastSlot = _entities.Size() - 1;
+        if( slot != lastSlot ) {
+            _entities[lastSlot]->_levelSlot = slot;
+        }
+        _entities.RemoveAtSwap( slot );
+        entity->_levelSlot = INVALID_SPATIAL_INDEX_HANDLE;
+
+        U32 dirtySlot = entity->_dirtySpatialSlot;
+        if( dirtySlot != INVALID_SPATIAL_INDEX_HANDLE ) {
+            U32 lastDirtySlot = _dirtySpatialEntities.Size() - 1;
+            if( dirtySlot != lastDirtySlot ) {
+                _dirtySpatialEntities[lastDirtySlot]->_dirtySpatialSlot = dirtySlot;
+            }
+            _dirtySpatialEntities.RemoveAtSwap( dirtySlot );
+            entity->_dirtySpatialSlot = INVALID_SPATIAL_INDEX_HANDLE;
+        }
+        if( entity->_spatialIndexHandle != INVALID_SPATIAL_INDEX_HANDLE ) {
+            _spatialIndex->Remove( entity->_spatialIndexHandle );
+            entity->_spatialIndexHandle = INVALID_SPATIAL_INDEX_HANDLE;
+        }
+    }
+
+    void Level::OnEntityBoundsChanged( Entity* entity ) {
+        if( entity->_spatialIndexHandle == INVALID_SPATIAL_INDEX_HANDLE || entity->_dirtySpatialSlot != INVALID_SPATIAL_INDEX_HANDLE ) {
+            return;
+        }
+
+        entity->_dirtySpatialSlot = _dirtySpatialEntities.Size();
+        _dirtySpatialEntities.Add( entity );
+    }
+
+    LooseOctree* Level::GetSpatialIndex() {
+        updateSpatialIndex();
+        return _spatialIndex;
     }
 
     void Level::OnRenderableEntityComponentAdded( RenderableEntityComponent* component ) {
+        component->_levelSlot = _renderableEntityComponents.Size();
         _renderableEntityComponents.Add( component );
+        if( _renderTable ) {
+            _renderTable->AddRenderable( component );
+        }
     }
 
     void Level::OnRenderableEntityComponentRemoved( RenderableEntityComponent* component ) {
-        _renderableEntityComponents.Remove( component );
+        U32 slot = component->_levelSlot;
+        U32 lastSlot = _renderableEntityComponents.Size() - 1;
+        if( slot != lastSlot ) {
+            _renderableEntityComponents[lastSlot]->_levelSlot = slot;
+        }
+        _renderableEntityComponents.RemoveAtSwap( slot );
+        component->_levelSlot = INVALID_RENDER_PROXY_INDEX;
+        if( _renderTable ) {
+            _renderTable->RemoveRenderable( component );
+        }
     }
 
-    void Level::AddRenderablesToTable( WorldRenderableObjectTable** renderableObjectTable ) {
-        U32 entityCount = _renderableEntityComponents.Size();
-        for( U32 i = 0; i < entityCount; ++i ) {
-            RenderableEntityComponent* entity = _renderableEntityComponents[i];
-
-            // Add static meshes types
-            if( entity->GetRenderableComponentType() == RenderableComponentType::STATIC_MESH ) {
-                ( *renderableObjectTable )->StaticMeshes[( *renderableObjectTable )->StaticMeshCount] = static_cast<StaticMeshEntityComponent*>( entity );
-                ( *renderableObjectTable )->StaticMeshCount++;
-                /* StaticMeshEntityComponent* castedComponent = static_cast<StaticMeshEntityComponent*>( entity );
-                 if( castedComponent->HasReferenceData() ) {
-                     List<StaticMeshRenderReferenceData> referenceData = castedComponent->GetReferenceData();
-                     U32 refDataCount = referenceData.Size();
-                     for( U32 r = 0; r < refDataCount; ++r ) {
-                         renderableObjectTable->StaticMeshes[renderableObjectTable->StaticMeshCount] = referenceData[r];
-                         renderableObjectTable->StaticMeshCount++;
-                         renderableObjectTable->StaticMeshes.Add( referenceData[r] );
-                     }
-                 }*/
+    void Level::OnRenderableEntityComponentTransformChanged( RenderableEntityComponent* component ) {
+        if( _renderTable ) {
+            _renderTable->MarkTransformDirty( component );
+        }
+    }
+
+    void Level::AddChild( Level* child ) {
+        if( child->_parent ) {
+            child->_parent->RemoveChild( child );
+        }
+
+        _children.Add( child );
+        child->_parent = this;
+        child->setRenderTable( _renderTable );
+    }
+
+    const bool Level::RemoveChild( Level* child ) {
+        I32 index = _children.Remove( child );
+        if( index == -1 ) {
+            return false;
+        }
+
+        child->setRenderTable( nullptr );
+        child->_parent = nullptr;
+        return true;
+    }
+
+    void Level::setRenderTable( WorldRenderableObjectTable* renderTable ) {
+        if( _renderTable == renderTable ) {
+            return;
+        }
+
+        U32 renderableCount = _renderableEntityComponents.Size();
+        if( _renderTable ) {
+            for( U32 i = 0; i < renderableCount; ++i ) {
+                _renderTable->RemoveRenderable( _renderableEntityComponents[i] );
+            }
+        }
+
+        _renderTable = renderTable;
+        if( _renderTable ) {
+            for( U32 i = 0; i < renderableCount; ++i ) {
+                _renderTable->AddRenderable( _renderableEntityComponents[i] );
             }
-            // TODO: other types
+        }
+
+        U32 childCount = _children.Size();
+        for( U32 i = 0; i < childCount; ++i ) {
+            _children[i]->setRenderTable( renderTable );
         }
     }
 
@@ -128,4 +596,41 @@ namespace Epoch {
         }
         return totalCount;
     }
-}
+
+    void Level::ensureRootEntity() {
+        if( !_root ) {
+            _root = new Entity();
+            _root->Name = "__ROOT__";
+            _root->setLevel( this );
+        }
+    }
+
+    void Level::updateSpatialIndex() {
+        U32 dirtyCount = _dirtySpatialEntities.Size();
+        for( U32 i = 0; i < dirtyCount; ++i ) {
+            Entity* entity = _dirtySpatialEntities[i];
+            _spatialIndex->Update( entity->_spatialIndexHandle, entity->GetWorldBounds() );
+            entity->_dirtySpatialSlot = INVALID_SPATIAL_INDEX_HANDLE;
+        }
+        _dirtySpatialEntities.Clear();
+    }
+
+    void Level::buildSpatialIndex() {
+        U32 entityCount = _entities.Size();
+        List<AABB> bounds( entityCount );
+        List<U32> handles( entityCount );
+        bounds.Resize( entityCount );
+        handles.Resize( entityCount );
+        for( U32 i = 0; i < entityCount; ++i ) {
+            bounds[i] = _entities[i]->GetWorldBounds();
+        }
+
+        _spatialIndex->Build( _entities.Data(), bounds.Data(), entityCount, handles.Data() );
+
+        for( U32 i = 0; i < entityCount; ++i ) {
+            _entities[i]->_spatialIndexHandle = handles[i];
+            _entities[i]->_dirtySpatialSlot = INVALID_SPATIAL_INDEX_HANDLE;
+        }
+        _dirtySpatialEntities.Clear();
+    }
+}
\ No newline at end of file
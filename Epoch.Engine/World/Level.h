@@ -4,48 +4,140 @@
 #include "../Defines.h"
 #include "../Types.h"
 #include "../String/TString.h"
-
+#include "../FileSystem/IBinarySerializable.h"
+#include "EntityCommandBuffer.h"
 
 namespace Epoch {
 
     class World;
     class Entity;
     class RenderableEntityComponent;
+    class LooseOctree;
+    class StaticMesh;
+    class Prefab;
     struct WorldRenderableObjectTable;
 
+    enum class LevelFileVersion : U8 {
+        UNKNOWN = 0x00U,
+
+        // Sequential format. No longer supported.
+        VERSION_1_0 = 0x01U,
+
+        // Aligned, offset-based format which is memory-mapped and used in place.
+        VERSION_2_0 = 0x02U
+    };
+
     /**
      * Represents a container which holds entities, which in turn hold many types of components.
      */
-    class EPOCH_API Level {
+    class EPOCH_API Level : public IBinarySerializable {
     public:
         TString Name;
     public:
         Level( const TString& name );
         ~Level();
 
-        void Load();
-        void Unload();
+        /**
+         * Destroys all entities and components in this level and releases the meshes it loaded.
+         * The level should be detached from its parent first.
+         *
+         * @param releaseCallback Called with each entity just before it is freed, as entity command buffers do. Optional.
+         * @param releaseContext A pointer passed back to the callback.
+         */
+        void Unload( EntityCommandBuffer::EntityReleasedCallback releaseCallback = nullptr, void* releaseContext = nullptr );
 
+        /**
+         * Updates this level and all child levels.
+         *
+         * @param deltaTime The amount of time in seconds since the last frame.
+         */
         void Update( const F32 deltaTime );
+
+        /**
+         * Binary-serializes the entities in this level to a file at the given path.
+         *
+         * @param filePath The path of the file to serialize to.
+         *
+         * @returns True if successful; otherwise false.
+         */
+        const bool SerializeBinary( const TString& filePath );
+
+        /**
+         * Binary-deserializes entities into this level from the file at the given path, also reading the data of
+         * all referenced meshes. The file is memory-mapped and its records are read in place. Does not touch the renderer, so this is safe to call from a worker thread
+         * while the level is detached. FinalizeLoad() must be called on the main thread afterward.
+         *
+         * @param filePath The path of the file to deserialize from.
+         *
+         * @returns True if successful; otherwise false.
+         */
+        const bool DeserializeBinary( const TString& filePath );
+
+        /**
+         * Uploads any meshes read by DeserializeBinary to the GPU. Must be called on the main thread.
+         */
+        void FinalizeLoad();
+
+        /**
+         * Returns an estimate of the memory held by this level's entities and mesh data, in bytes. Does not include child levels.
+         */
+        const U64 GetResidentBytes() const;
         
+        /**
+         * Ensures this level can take on the given number of additional entities and renderable components without reallocating.
+         *
+         * @param entityCount The number of entities about to be added.
+         * @param renderableComponentCount The number of renderable components about to be added.
+         */
+        void Reserve( const U32 entityCount, const U32 renderableComponentCount );
+
         void OnEntityAdded( Entity* entity );
         void OnEntityRemoved( Entity* entity );
         void OnRenderableEntityComponentAdded( RenderableEntityComponent* component );
         void OnRenderableEntityComponentRemoved( RenderableEntityComponent* component );
+        void OnRenderableEntityComponentTransformChanged( RenderableEntityComponent* component );
+
+        /**
+         * Flags the given entity's spatial index bounds as needing to be refreshed.
+         *
+         * @param entity The entity whose transform or renderable components have changed.
+         */
+        void OnEntityBoundsChanged( Entity* entity );
 
         /**
-         * Adds all renderable components to the provided render table. Recursive to child levels.
-         * 
-         * @param renderableObjectTable The render table to add to.
+         * Returns the spatial index of the entities in this level (not including child levels), with any pending bounds changes applied.
          */
-        void AddRenderablesToTable( WorldRenderableObjectTable** renderableObjectTable );
+        LooseOctree* GetSpatialIndex();
+
+        /**
+         * Attaches the given level as a child of this one. Its renderables are registered with
+         * the world's render table if this level is part of a world.
+         *
+         * @param child The level to be attached.
+         */
+        void AddChild( Level* child );
+
+        /**
+         * Detaches the given child level from this one, unregistering its renderables.
+         *
+         * @param child The level to be detached.
+         *
+         * @returns True if the level was a child of this one; otherwise false.
+         */
+        const bool RemoveChild( Level* child );
 
         /**
          * Obtain the count of all renderable components. Recursive to child levels.
          */
         const U32 MaxRenderableComponentCount() const;
 
+        /**
+         * Returns the number of entities in this level, not including its root entity or child levels.
+         */
+        const U32 GetEntityCount() const { return _entities.Size(); }
+
         const bool IsRoot() const { return _isRoot; }
+        Level* GetParent() { return _parent; }
         Entity* GetRootEntity() { return _root; }
 
     private:
@@ -53,17 +145,45 @@ namespace Epoch {
         // Should only ever be called by the World.
         Level();
 
+        // Sets the render table for this level and all child levels, moving renderables from the old table to the new one.
+        void setRenderTable( WorldRenderableObjectTable* renderTable );
+
+        // Creates the root entity if it does not exist. It is released on Unload.
+        void ensureRootEntity();
+
+        // Refreshes the spatial index bounds of all entities flagged as dirty.
+        void updateSpatialIndex();
+
+        // Rebuilds the spatial index from all entities in this level at once.
+        void buildSpatialIndex();
+
     private:
         bool _isRoot = false;
-        Level* _parent;
+        Level* _parent = nullptr;
         List<Level*> _children;
 
-        Entity* _root;
+        Entity* _root = nullptr;
+
+        // Meshes loaded by and owned by this level.
+        List<StaticMesh*> _meshes;
+
+        // Prefabs owned by this level. Released after the entities, since instances refer to them.
+        List<Prefab*> _prefabs;
+
+        // The render table of the world this level belongs to. Null while detached.
+        WorldRenderableObjectTable* _renderTable = nullptr;
 
         // A flat list of all entities.
         List<Entity*> _entities;
         List<RenderableEntityComponent*> _renderableEntityComponents;
 
+        // Spatial index of all entities, and those whose bounds have changed since it was last updated.
+        LooseOctree* _spatialIndex = nullptr;
+        List<Entity*> _dirtySpatialEntities;
+
+        // While loading, entities are not individually added to the spatial index. It is built once loading completes.
+        bool _isLoading = false;
+
         friend class World;
     };
 }
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include "../Logger.h"
+
+#include "Level.h"
+#include "LevelStreamer.h"
+
+namespace Epoch {
+
+    LevelStreamer::LevelStreamer( const U32 workerCount ) : _clock( true ) {
+        U32 count = workerCount == 0 ? 1 : workerCount;
+        for( U32 i = 0; i < count; ++i ) {
+            _workers.Add( new std::thread( [this]() { workerMain(); } ) );
+        }
+    }
+
+    LevelStreamer::~LevelStreamer() {
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            _isShuttingDown = true;
+            _pending.Clear();
+        }
+        _condition.notify_all();
+
+        U32 workerCount = _workers.Size();
+        for( U32 i = 0; i < workerCount; ++i ) {
+            _workers[i]->join();
+            delete _workers[i];
+        }
+        _workers.Clear();
+
+        // With the workers stopped, anything loaded but not yet attached can be released directly.
+        U32 levelCount = _levels.Size();
+        for( U32 i = 0; i < levelCount; ++i ) {
+            StreamingLevel* entry = _levels[i];
+            if( entry->State == StreamingState::RESIDENT ) {
+                unload( entry );
+            } else if( entry->LoadedLevel ) {
+                entry->LoadedLevel->Unload();
+                delete entry->LoadedLevel;
+            }
+            delete entry;
+        }
+        _levels.Clear();
+    }
+
+    const bool LevelStreamer::Register( const TString& name, const TString& filePath, Level* parent, const Vector3& center, const F32 loadRadius, const F32 unloadRadius ) {
+        if( find( name ) ) {
+            Logger::Warn( "A streaming level named '%s' is already registered.", name.CStr() );
+            return false;
+        }
+
+        StreamingLevel* entry = new StreamingLevel();
+        entry->Name = name;
+        entry->FilePath = filePath;
+        entry->Parent = parent;
+        entry->Center = center;
+        entry->LoadRadius = loadRadius;
+        entry->UnloadRadius = unloadRadius < loadRadius ? loadRadius : unloadRadius;
+        _levels.Add( entry );
+        return true;
+    }
+
+    const bool LevelStreamer::RequestLoad( const TString& name ) {
+        StreamingLevel* entry = find( name );
+        if( !entry ) {
+            return false;
+        }
+        entry->Requested = true;
+        return true;
+    }
+
+    void LevelStreamer::SetReleaseCallback( EntityCommandBuffer::EntityReleasedCallback callback, void* context ) {
+        _releaseCallback = callback;
+        _releaseContext = context;
+    }
+
+    const bool LevelStreamer::RequestUnload( const TString& name ) {
+        StreamingLevel* entry = find( name );
+        if( !entry ) {
+            return false;
+        }
+        entry->Requested = false;
+        return true;
+    }
+
+    void LevelStreamer::Update( const Vector3& viewerPosition ) {
+
+        // Attach anything which finished loading since the last update.
+        List<StreamingLevel*> completed;
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            U32 completedCount = _completed.Size();
+            for( U32 i = 0; i < completedCount; ++i ) {
+                completed.Add( _completed[i] );
+            }
+            _completed.Clear();
+        }
+
+        U32 completedCount = completed.Size();
+        for( U32 i = 0; i < completedCount; ++i ) {
+            StreamingLevel* entry = completed[i];
+            if( !entry->LoadedLevel ) {
+                entry->State = StreamingState::UNLOADED;
+                _stats.LoadsFailed++;
+                continue;
+            }
+
+            // Attaching registers all of the level's renderables at once, so it never appears partially.
+            entry->LoadedLevel->FinalizeLoad();
+            entry->Parent->AddChild( entry->LoadedLevel );
+            entry->ResidentBytes = entry->LoadedLevel->GetResidentBytes();
+            entry->State = StreamingState::RESIDENT;
+            _stats.ResidentBytes += entry->ResidentBytes;
+            _stats.ResidentLevels++;
+
+            U64 latency = _clock.GetTime() - entry->RequestTime;
+            _stats.LoadsCompleted++;
+            _stats.LastLoadMs = latency;
+            _stats.MaxLoadMs = latency > _stats.MaxLoadMs ? latency : _stats.MaxLoadMs;
+            _totalLoadMs += latency;
+            _stats.AverageLoadMs = _totalLoadMs / _stats.LoadsCompleted;
+            Logger::Trace( "Streamed in level '%s' (%llu bytes) in %llums.", entry->Name.CStr(), entry->ResidentBytes, latency );
+        }
+
+        // Queue loads and unloads by distance. Using a larger unload radius keeps levels near the boundary from thrashing.
+        U32 levelCount = _levels.Size();
+        for( U32 i = 0; i < levelCount; ++i ) {
+            StreamingLevel* entry = _levels[i];
+            F32 distance = Vector3::Distance( viewerPosition, entry->Center );
+            if( entry->IsEvicted && distance > entry->UnloadRadius ) {
+                entry->IsEvicted = false;
+            }
+            if( entry->State == StreamingState::UNLOADED ) {
+                if( entry->Requested || ( !entry->IsEvicted && distance <= entry->LoadRadius ) ) {
+                    queueLoad( entry );
+                }
+            } else if( entry->State == StreamingState::RESIDENT ) {
+                if( !entry->Requested && distance > entry->UnloadRadius ) {
+                    unload( entry );
+                }
+            }
+        }
+
+        // Evict the furthest levels which were not explicitly requested until back within budget.
+        while( _budgetBytes > 0 && _stats.ResidentBytes > _budgetBytes ) {
+            StreamingLevel* furthest = nullptr;
+            F32 furthestDistance = -1.0f;
+            for( U32 i = 0; i < levelCount; ++i ) {
+                StreamingLevel* entry = _levels[i];
+                if( entry->State != StreamingState::RESIDENT || entry->Requested ) {
+                    continue;
+                }
+                F32 distance = Vector3::Distance( viewerPosition, entry->Center );
+                if( distance > furthestDistance ) {
+                    furthest = entry;
+                    furthestDistance = distance;
+                }
+            }
+            if( !furthest ) {
+                break;
+            }
+            Logger::Trace( "Streaming budget exceeded, evicting level '%s'.", furthest->Name.CStr() );
+            unload( furthest );
+            furthest->IsEvicted = true;
+        }
+    }
+
+    const LevelStreamingStats LevelStreamer::GetStats() {
+        LevelStreamingStats stats = _stats;
+        stats.BudgetBytes = _budgetBytes;
+        stats.PendingLoads = 0;
+        U32 levelCount = _levels.Size();
+        for( U32 i = 0; i < levelCount; ++i ) {
+            StreamingState state = _levels[i]->State;
+            if( state == StreamingState::QUEUED || state == StreamingState::LOADING || state == StreamingState::LOADED ) {
+                stats.PendingLoads++;
+            }
+        }
+        return stats;
+    }
+
+    LevelStreamer::StreamingLevel* LevelStreamer::find( const TString& name ) {
+        U32 levelCount = _levels.Size();
+        for( U32 i = 0; i < levelCount; ++i ) {
+            if( _levels[i]->Name == name ) {
+                return _levels[i];
+            }
+        }
+        return nullptr;
+    }
+
+    void LevelStreamer::queueLoad( StreamingLevel* entry ) {
+        entry->RequestTime = _clock.GetTime();
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            entry->State = StreamingState::QUEUED;
+            _pending.Add( entry );
+        }
+        _condition.notify_one();
+    }
+
+    void LevelStreamer::unload( StreamingLevel* entry ) {
+        entry->Parent->RemoveChild( entry->LoadedLevel );
+        entry->LoadedLevel->Unload( _releaseCallback, _releaseContext );
+        delete entry->LoadedLevel;
+        entry->LoadedLevel = nullptr;
+        entry->State = StreamingState::UNLOADED;
+
+        _stats.ResidentBytes -= entry->ResidentBytes;
+        _stats.ResidentLevels--;
+        _stats.Unloads++;
+        entry->ResidentBytes = 0;
+    }
+
+    void LevelStreamer::workerMain() {
+        while( true ) {
+            StreamingLevel* entry = nullptr;
+            {
+                std::unique_lock<std::mutex> lock( _mutex );
+                _condition.wait( lock, [this]() { return _isShuttingDown || _pending.Size() > 0; } );
+                if( _isShuttingDown ) {
+                    return;
+                }
+                entry = _pending[0];
+                _pending.RemoveAt( 0 );
+                entry->State = StreamingState::LOADING;
+            }
+
+            // The level is detached and owned by this thread until it is handed back, so no locking is needed here.
+            Level* level = new Level( entry->Name );
+            if( !level->DeserializeBinary( entry->FilePath ) ) {
+                Logger::Error( "Failed to stream in level '%s' from '%s'.", entry->Name.CStr(), entry->FilePath.CStr() );
+                level->Unload();
+                delete level;
+                level = nullptr;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock( _mutex );
+                entry->LoadedLevel = level;
+                entry->State = StreamingState::LOADED;
+                _completed.Add( entry );
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#include "../Types.h"
+#include "../Defines.h"
+#include "../String/TString.h"
+#include "../Containers/List.h"
+#include "../Math/Vector3.h"
+#include "../Time/Clock.h"
+#include "EntityCommandBuffer.h"
+
+namespace Epoch {
+
+    class Level;
+
+    /**
+     * A snapshot of the state of a level streamer.
+     */
+    struct LevelStreamingStats {
+        U32 ResidentLevels = 0;
+        U32 PendingLoads = 0;
+        U64 ResidentBytes = 0;
+        U64 BudgetBytes = 0;
+        U32 LoadsCompleted = 0;
+        U32 LoadsFailed = 0;
+        U32 Unloads = 0;
+
+        /** Time from a load being queued to its level being attached, in milliseconds. */
+        U64 LastLoadMs = 0;
+        U64 AverageLoadMs = 0;
+        U64 MaxLoadMs = 0;
+    };
+
+    /**
+     * Loads and unloads levels in the background based on the viewer's position, within a memory budget.
+     * Levels are read from disk on worker threads while detached, then attached to their parent level on
+     * the main thread during Update, so a level's entities appear in the world all at once.
+     */
+    class EPOCH_API LevelStreamer {
+    public:
+
+        /**
+         * Creates a new level streamer.
+         *
+         * @param workerCount The number of worker threads used to load levels. Default: 1.
+         */
+        LevelStreamer( const U32 workerCount = 1 );
+
+        /**
+         * Stops all workers and unloads any resident levels.
+         */
+        ~LevelStreamer();
+
+        /**
+         * Registers a streamable level. It is loaded once the viewer comes within loadRadius of center, and unloaded
+         * once the viewer moves beyond unloadRadius. unloadRadius should be larger than loadRadius to avoid thrashing.
+         *
+         * @param name The name of the level.
+         * @param filePath The path to the level file.
+         * @param parent The level to attach to once loaded.
+         * @param center The center of the streaming region.
+         * @param loadRadius The distance from center within which the level is loaded.
+         * @param unloadRadius The distance from center beyond which the level is unloaded.
+         *
+         * @returns True if registered; false if a level with the same name already exists.
+         */
+        const bool Register( const TString& name, const TString& filePath, Level* parent, const Vector3& center, const F32 loadRadius, const F32 unloadRadius );
+
+        /**
+         * Requests the named level be loaded and kept resident regardless of the viewer's position.
+         *
+         * @param name The name of the level.
+         *
+         * @returns True if the level is registered; otherwise false.
+         */
+        const bool RequestLoad( const TString& name );
+
+        /**
+         * Clears an explicit load request. The level is then streamed by distance as normal.
+         *
+         * @param name The name of the level.
+         *
+         * @returns True if the level is registered; otherwise false.
+         */
+        const bool RequestUnload( const TString& name );
+
+        /**
+         * Sets the memory budget for resident levels. Levels furthest from the viewer are evicted while over budget.
+         *
+         * @param bytes The budget in bytes. 0 disables the budget.
+         */
+        void SetMemoryBudget( const U64 bytes ) { _budgetBytes = bytes; }
+
+        /**
+         * Sets a function to call with each entity of a resident level as it is unloaded, just before it is freed.
+         *
+         * @param callback The function to call. Pass nullptr to stop being called.
+         * @param context A pointer passed back to the callback.
+         */
+        void SetReleaseCallback( EntityCommandBuffer::EntityReleasedCallback callback, void* context );
+
+        /**
+         * Attaches levels which finished loading, then queues loads and unloads based on the viewer's position.
+         * Must be called on the main thread, between frames.
+         *
+         * @param viewerPosition The world position of the viewer.
+         */
+        void Update( const Vector3& viewerPosition );
+
+        /**
+         * Returns the current streaming stats.
+         */
+        const LevelStreamingStats GetStats();
+
+    private:
+        enum class StreamingState {
+            UNLOADED,
+            QUEUED,
+            LOADING,
+
+            // Loaded by a worker, waiting to be attached.
+            LOADED,
+            RESIDENT
+        };
+
+        struct StreamingLevel {
+            TString Name;
+            TString FilePath;
+            Level* Parent = nullptr;
+            Vector3 Center;
+            F32 LoadRadius = 0.0f;
+            F32 UnloadRadius = 0.0f;
+            bool Requested = false;
+
+            // Written by workers under the lock, but read by the main thread without it.
+            std::atomic<StreamingState> State { StreamingState::UNLOADED };
+
+            // Set when evicted to meet the budget. The level is not loaded again by distance until the viewer has moved
+            // beyond its unload radius, so an evicted level is not immediately reloaded.
+            bool IsEvicted = false;
+
+            // Set by the worker once loaded. Null if the load failed.
+            Level* LoadedLevel = nullptr;
+            U64 ResidentBytes = 0;
+            U64 RequestTime = 0;
+        };
+
+        StreamingLevel* find( const TString& name );
+        void queueLoad( StreamingLevel* entry );
+        void unload( StreamingLevel* entry );
+        void workerMain();
+
+    private:
+        List<StreamingLevel*> _levels;
+        U64 _budgetBytes = 0;
+        Clock _clock;
+        LevelStreamingStats _stats;
+        U64 _totalLoadMs = 0;
+
+        // Guards the queues, and the loaded level of entries which are QUEUED, LOADING or LOADED.
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        List<StreamingLevel*> _pending;
+        List<StreamingLevel*> _completed;
+        List<std::thread*> _workers;
+        bool _isShuttingDown = false;
+
+        EntityCommandBuffer::EntityReleasedCallback _releaseCallback = nullptr;
+        void* _releaseContext = nullptr;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include <limits>
+
+#include "../Math/TMath.h"
+#include "../Math/Frustum.h"
+
+#include "LooseOctree.h"
+
+#define OCTREE_MAX_DEPTH 16
+
+namespace Epoch {
+
+    // Returns the reciprocal of each component of a ray direction. Zero components are mapped to infinity, which the
+    // slab test treats as parallel to that axis.
+    static Vector3 getInverseDirection( const Vector3& direction ) {
+        const F32 infinity = std::numeric_limits<F32>::infinity();
+        return Vector3(
+            direction.X != 0.0f ? 1.0f / direction.X : infinity,
+            direction.Y != 0.0f ? 1.0f / direction.Y : infinity,
+            direction.Z != 0.0f ? 1.0f / direction.Z : infinity );
+    }
+
+    LooseOctree::LooseOctree( const Vector3& center, const F32 halfSize, const U32 maxDepth ) {
+        _center = center;
+        _halfSize = halfSize;
+        _maxDepth = maxDepth > OCTREE_MAX_DEPTH ? OCTREE_MAX_DEPTH : maxDepth;
+        Clear();
+    }
+
+    LooseOctree::~LooseOctree() {
+        _nodes.Clear( true );
+        _elements.Clear( true );
+    }
+
+    template<typename NodeTest, typename ElementTest>
+    void LooseOctree::query( NodeTest nodeTest, ElementTest elementTest, List<Entity*>& results ) const {
+
+        // Each visited node pushes at most 8 children, so this is bounded by 7 * max depth + 8.
+        U32 stack[7 * OCTREE_MAX_DEPTH + 8];
+        U32 stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while( stackSize > 0 ) {
+            const Node& node = _nodes[stack[--stackSize]];
+            if( node.SubtreeCount == 0 ) {
+                continue;
+            }
+
+            // The root also holds anything outside of its cell, so it is always visited.
+            if( node.Depth > 0 && !nodeTest( getLooseBounds( node ) ) ) {
+                continue;
+            }
+
+            for( U32 e = node.FirstElement; e != INVALID_SPATIAL_INDEX_HANDLE; e = _elements[e].Next ) {
+                if( elementTest( _elements[e].Bounds ) ) {
+                    results.Add( _elements[e].Owner );
+                }
+            }
+
+            for( U32 c = 0; c < 8; ++c ) {
+                if( node.Children[c] != INVALID_SPATIAL_INDEX_HANDLE ) {
+                    stack[stackSize++] = node.Children[c];
+                }
+            }
+        }
+    }
+
+    const U32 LooseOctree::Insert( Entity* entity, const AABB& bounds ) {
+        U32 handle;
+        if( _freeElement != INVALID_SPATIAL_INDEX_HANDLE ) {
+            handle = _freeElement;
+            _freeElement = _elements[handle].Next;
+        } else {
+            handle = _elements.Size();
+            _elements.Add( Element() );
+        }
+
+        Element& element = _elements[handle];
+        element.Bounds = bounds;
+        element.Owner = entity;
+        link( handle, findNode( bounds ) );
+        _elementCount++;
+        return handle;
+    }
+
+    void LooseOctree::Update( const U32 handle, const AABB& bounds ) {
+        _elements[handle].Bounds = bounds;
+
+        U32 nodeIndex = findNode( bounds );
+        if( nodeIndex != _elements[handle].Node ) {
+            unlink( handle );
+            link( handle, nodeIndex );
+        }
+    }
+
+    void LooseOctree::Remove( const U32 handle ) {
+        unlink( handle );
+
+        Element& element = _elements[handle];
+        element.Owner = nullptr;
+        element.Next = _freeElement;
+        _freeElement = handle;
+        _elementCount--;
+    }
+
+    void LooseOctree::Build( Entity* const* entities, const AABB* bounds, const U32 count, U32* outHandles ) {
+        Clear();
+
+        // Size the element pool up front so the inserts below never reallocate.
+        _elements.Reserve( count );
+
+        for( U32 i = 0; i < count; ++i ) {
+            outHandles[i] = Insert( entities[i], bounds[i] );
+        }
+    }
+
+    void LooseOctree::Clear() {
+        _nodes.Clear();
+        _elements.Clear();
+        _elementCount = 0;
+        _freeElement = INVALID_SPATIAL_INDEX_HANDLE;
+        createNode( _center, _halfSize, 0, INVALID_SPATIAL_INDEX_HANDLE );
+    }
+
+    void LooseOctree::QueryFrustum( const Frustum& frustum, List<Entity*>& results ) const {
+        query(
+            [&frustum]( const AABB& nodeBounds ) { return frustum.IntersectsAABB( nodeBounds ); },
+            [&frustum]( const AABB& bounds ) { return frustum.IntersectsAABB( bounds ); },
+            results );
+    }
+
+    void LooseOctree::QuerySphere( const BoundingSphere& sphere, List<Entity*>& results ) const {
+        query(
+            [&sphere]( const AABB& nodeBounds ) { return nodeBounds.Intersects( sphere ); },
+            [&sphere]( const AABB& bounds ) { return bounds.Intersects( sphere ); },
+            results );
+    }
+
+    void LooseOctree::QueryAABB( const AABB& box, List<Entity*>& results ) const {
+        query(
+            [&box]( const AABB& nodeBounds ) { return nodeBounds.Intersects( box ); },
+            [&box]( const AABB& bounds ) { return bounds.Intersects( box ); },
+            results );
+    }
+
+    void LooseOctree::QueryRay( const Vector3& origin, const Vector3& direction, const F32 maxDistance, List<Entity*>& results ) const {
+        Vector3 inverseDirection = getInverseDirection( direction );
+        query(
+            [&]( const AABB& nodeBounds ) { return nodeBounds.IntersectsRay( origin, inverseDirection, maxDistance ); },
+            [&]( const AABB& bounds ) { return bounds.IntersectsRay( origin, inverseDirection, maxDistance ); },
+            results );
+    }
+
+    Entity* LooseOctree::Raycast( const Vector3& origin, const Vector3& direction, const F32 maxDistance, F32* outDistance ) const {
+        Vector3 inverseDirection = getInverseDirection( direction );
+        Entity* closest = nullptr;
+        F32 closestDistance = maxDistance;
+
+        // Nodes are skipped once they start beyond the closest hit found so far.
+        List<Entity*> hits;
+        query(
+            [&]( const AABB& nodeBounds ) { return nodeBounds.IntersectsRay( origin, inverseDirection, closestDistance ); },
+            [&]( const AABB& bounds ) { return bounds.IntersectsRay( origin, inverseDirection, closestDistance, &closestDistance ); },
+            hits );
+
+        if( hits.Size() > 0 ) {
+
+            // Each accepted hit was closer than all before it, so the last one is the closest.
+            closest = hits[hits.Size() - 1];
+            if( outDistance ) {
+                *outDistance = closestDistance;
+            }
+        }
+        return closest;
+    }
+
+    const U32 LooseOctree::createNode( const Vector3& center, const F32 halfSize, const U32 depth, const U32 parent ) {
+        Node node;
+        node.Center = center;
+        node.HalfSize = halfSize;
+        node.Depth = depth;
+        node.Parent = parent;
+        for( U32 i = 0; i < 8; ++i ) {
+            node.Children[i] = INVALID_SPATIAL_INDEX_HANDLE;
+        }
+        node.FirstElement = INVALID_SPATIAL_INDEX_HANDLE;
+        node.SubtreeCount = 0;
+
+        U32 index = _nodes.Size();
+        _nodes.Add( node );
+        return index;
+    }
+
+    const U32 LooseOctree::findNode( const AABB& bounds ) {
+        Vector3 center = bounds.GetCenter();
+        Vector3 extents = bounds.GetExtents();
+        F32 radius = ::Max( extents.X, ::Max( extents.Y, extents.Z ) );
+
+        // Anything whose center is outside of the root cell stays at the root.
+        const Node& root = _nodes[0];
+        if( TMath::Abs( center.X - root.Center.X ) > root.HalfSize ||
+            TMath::Abs( center.Y - root.Center.Y ) > root.HalfSize ||
+            TMath::Abs( center.Z - root.Center.Z ) > root.HalfSize ) {
+            return 0;
+        }
+
+        // Descend while the bounds still fit within a child's loose bounds, which extend
+        // a child's half-size beyond its cell on every side.
+        U32 nodeIndex = 0;
+        while( _nodes[nodeIndex].Depth < _maxDepth ) {
+            const Node& node = _nodes[nodeIndex];
+            F32 childHalfSize = node.HalfSize * 0.5f;
+            if( radius > childHalfSize ) {
+                break;
+            }
+
+            U32 octant = ( center.X >= node.Center.X ? 1 : 0 ) | ( center.Y >= node.Center.Y ? 2 : 0 ) | ( center.Z >= node.Center.Z ? 4 : 0 );
+            U32 childIndex = node.Children[octant];
+            if( childIndex == INVALID_SPATIAL_INDEX_HANDLE ) {
+                Vector3 childCenter(
+                    node.Center.X + ( ( octant & 1 ) ? childHalfSize : -childHalfSize ),
+                    node.Center.Y + ( ( octant & 2 ) ? childHalfSize : -childHalfSize ),
+                    node.Center.Z + ( ( octant & 4 ) ? childHalfSize : -childHalfSize ) );
+                U32 depth = node.Depth + 1;
+
+                // NOTE: This can reallocate the node list, so node must not be used after.
+                childIndex = createNode( childCenter, childHalfSize, depth, nodeIndex );
+                _nodes[nodeIndex].Children[octant] = childIndex;
+            }
+            nodeIndex = childIndex;
+        }
+
+        return nodeIndex;
+    }
+
+    void LooseOctree::link( const U32 elementIndex, const U32 nodeIndex ) {
+        Element& element = _elements[elementIndex];
+        Node& node = _nodes[nodeIndex];
+        element.Node = nodeIndex;
+        element.Prev = INVALID_SPATIAL_INDEX_HANDLE;
+        element.Next = node.FirstElement;
+        if( node.FirstElement != INVALID_SPATIAL_INDEX_HANDLE ) {
+            _elements[node.FirstElement].Prev = elementIndex;
+        }
+        node.FirstElement = elementIndex;
+
+        for( U32 i = nodeIndex; i != INVALID_SPATIAL_INDEX_HANDLE; i = _nodes[i].Parent ) {
+            _nodes[i].SubtreeCount++;
+        }
+    }
+
+    void LooseOctree::unlink( const U32 elementIndex ) {
+        Element& element = _elements[elementIndex];
+        if( element.Prev != INVALID_SPATIAL_INDEX_HANDLE ) {
+            _elements[element.Prev].Next = element.Next;
+        } else {
+            _nodes[element.Node].FirstElement = element.Next;
+        }
+        if( element.Next != INVALID_SPATIAL_INDEX_HANDLE ) {
+            _elements[element.Next].Prev = element.Prev;
+        }
+
+        for( U32 i = element.Node; i != INVALID_SPATIAL_INDEX_HANDLE; i = _nodes[i].Parent ) {
+            _nodes[i].SubtreeCount--;
+        }
+        element.Node = INVALID_SPATIAL_INDEX_HANDLE;
+        element.Prev = INVALID_SPATIAL_INDEX_HANDLE;
+        element.Next = INVALID_SPATIAL_INDEX_HANDLE;
+    }
+
+    const AABB LooseOctree::getLooseBounds( const Node& node ) const {
+        Vector3 extents( node.HalfSize * 2.0f );
+        return AABB( node.Center - extents, node.Center + extents );
+    }
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "../Types.h"
+#include "../Defines.h"
+#include "../Containers/List.h"
+#include "../Math/Vector3.h"
+#include "../Math/BoundingVolumes.h"
+
+#define INVALID_SPATIAL_INDEX_HANDLE U32_MAX
+
+namespace Epoch {
+
+    class Entity;
+    struct Frustum;
+
+    /**
+     * A dynamic spatial index of entity bounds. Each node's bounds are "loose", extending to twice its cell size,
+     * so that an entity can always be placed by its center and size alone and moving entities rarely change node.
+     * Entities larger than a cell (or outside of the root cell) are held at the deepest node which can contain them.
+     */
+    class EPOCH_API LooseOctree {
+    public:
+
+        /**
+         * Creates a new octree.
+         *
+         * @param center The center of the root cell.
+         * @param halfSize Half of the width of the root cell.
+         * @param maxDepth The maximum depth of the tree, where the root is depth 0. Clamped to 16.
+         */
+        LooseOctree( const Vector3& center, const F32 halfSize, const U32 maxDepth = 8 );
+        ~LooseOctree();
+
+        /**
+         * Adds an entity to this tree.
+         *
+         * @param entity The entity to add.
+         * @param bounds The world-space bounds of the entity.
+         *
+         * @returns A handle used to update or remove the entity later.
+         */
+        const U32 Insert( Entity* entity, const AABB& bounds );
+
+        /**
+         * Updates the bounds of the entity with the given handle. If the entity still belongs in the same node,
+         * this only stores the new bounds.
+         *
+         * @param handle The handle returned from Insert.
+         * @param bounds The new world-space bounds of the entity.
+         */
+        void Update( const U32 handle, const AABB& bounds );
+
+        /**
+         * Removes the entity with the given handle from this tree. The handle may be reused by a later insert.
+         *
+         * @param handle The handle returned from Insert.
+         */
+        void Remove( const U32 handle );
+
+        /**
+         * Clears this tree and inserts all of the given entities at once.
+         *
+         * @param entities A pointer to an array of entities.
+         * @param bounds A pointer to an array of world-space bounds, one per entity.
+         * @param count The number of entities.
+         * @param outHandles A pointer to an array which receives a handle per entity.
+         */
+        void Build( Entity* const* entities, const AABB* bounds, const U32 count, U32* outHandles );
+
+        /**
+         * Removes all entities from this tree.
+         */
+        void Clear();
+
+        /**
+         * Returns the number of entities in this tree.
+         */
+        const U32 Size() const { return _elementCount; }
+
+        /**
+         * Adds all entities whose bounds intersect the given frustum to the results list.
+         */
+        void QueryFrustum( const Frustum& frustum, List<Entity*>& results ) const;
+
+        /**
+         * Adds all entities whose bounds intersect the given sphere to the results list.
+         */
+        void QuerySphere( const BoundingSphere& sphere, List<Entity*>& results ) const;
+
+        /**
+         * Adds all entities whose bounds intersect the given box to the results list.
+         */
+        void QueryAABB( const AABB& box, List<Entity*>& results ) const;
+
+        /**
+         * Adds all entities whose bounds are hit by the given ray to the results list, in no particular order.
+         *
+         * @param origin The origin of the ray.
+         * @param direction The direction of the ray. Need not be normalized; maxDistance is in multiples of its length.
+         * @param maxDistance The maximum distance along the ray to test.
+         * @param results The list to add results to.
+         */
+        void QueryRay( const Vector3& origin, const Vector3& direction, const F32 maxDistance, List<Entity*>& results ) const;
+
+        /**
+         * Finds the entity whose bounds are hit first by the given ray.
+         *
+         * @param origin The origin of the ray.
+         * @param direction The direction of the ray.
+         * @param maxDistance The maximum distance along the ray to test.
+         * @param outDistance A pointer to hold the distance to the hit. Optional.
+         *
+         * @returns The closest entity hit, or nullptr if nothing was hit.
+         */
+        Entity* Raycast( const Vector3& origin, const Vector3& direction, const F32 maxDistance, F32* outDistance = nullptr ) const;
+
+    private:
+        struct Node {
+            Vector3 Center;
+            F32 HalfSize;
+            U32 Depth;
+            U32 Parent;
+            U32 Children[8];
+
+            // Head of the intrusive list of elements held directly by this node.
+            U32 FirstElement;
+
+            // The number of elements held by this node and all of its descendants. Used to skip empty branches.
+            U32 SubtreeCount;
+        };
+
+        struct Element {
+            AABB Bounds;
+            Entity* Owner;
+            U32 Node;
+            U32 Prev;
+            U32 Next;
+        };
+
+        const U32 createNode( const Vector3& center, const F32 halfSize, const U32 depth, const U32 parent );
+        const U32 findNode( const AABB& bounds );
+        void link( const U32 elementIndex, const U32 nodeIndex );
+        void unlink( const U32 elementIndex );
+        const AABB getLooseBounds( const Node& node ) const;
+
+        template<typename NodeTest, typename ElementTest>
+        void query( NodeTest nodeTest, ElementTest elementTest, List<Entity*>& results ) const;
+
+    private:
+        Vector3 _center;
+        F32 _halfSize;
+        U32 _maxDepth;
+
+        List<Node> _nodes;
+        List<Element> _elements;
+        U32 _elementCount = 0;
+
+        // Head of the list of free element slots, linked through Element::Next.
+        U32 _freeElement = INVALID_SPATIAL_INDEX_HANDLE;
+    };
+}
\ No newline at end of file
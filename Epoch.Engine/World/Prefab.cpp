@@ -0,0 +1,99 @@
+#include "../Logger.h"
+
+#include "EntityComponents/StaticMeshEntityComponent.h"
+#include "Entity.h"
+#include "Level.h"
+#include "Prefab.h"
+
+// Every object within a batch of instances begins on a boundary of this many bytes.
+#define PREFAB_INSTANCE_ALIGNMENT 16
+
+namespace Epoch {
+
+    static const U64 alignInstanceSize( const U64 size ) {
+        return ( ( size + PREFAB_INSTANCE_ALIGNMENT - 1 ) / PREFAB_INSTANCE_ALIGNMENT ) * PREFAB_INSTANCE_ALIGNMENT;
+    }
+
+    Prefab::Prefab( const TString& name ) {
+        _name = name;
+    }
+
+    Prefab::~Prefab() {
+        U32 componentCount = _components.Size();
+        for( U32 i = 0; i < componentCount; ++i ) {
+            delete _components[i];
+        }
+        _components.Clear( true );
+    }
+
+    const bool Prefab::AddStaticMeshComponent( const TString& name, StaticMesh* mesh ) {
+        if( _instanceCount > 0 ) {
+            Logger::Warn( "Cannot add component '%s' to prefab '%s', as it already has instances.", name.CStr(), _name.CStr() );
+            return false;
+        }
+
+        PrefabComponent* component = new PrefabComponent();
+        component->Name = name;
+        component->Mesh = mesh;
+        _components.Add( component );
+        return true;
+    }
+
+    Entity* Prefab::Spawn( Entity* parent, const Transform& transform ) {
+        List<Entity*> spawned;
+        Spawn( parent, &transform, 1, &spawned );
+        return spawned[0];
+    }
+
+    void Prefab::Spawn( Entity* parent, const Transform* transforms, const U32 count, List<Entity*>* outEntities ) {
+        if( count == 0 ) {
+            return;
+        }
+
+        // Each instance is laid out as its entity followed by its components.
+        U32 componentCount = _components.Size();
+        U64 entitySize = alignInstanceSize( sizeof( Entity ) );
+        U64 componentSize = alignInstanceSize( sizeof( StaticMeshEntityComponent ) );
+        U64 instanceSize = entitySize + ( componentSize * componentCount );
+        U8* memory = static_cast<U8*>( WObject::AllocateBatch( instanceSize * count, count * ( 1 + componentCount ), PREFAB_INSTANCE_ALIGNMENT ) );
+
+        // Size the lists which are about to grow up front, so they are not reallocated per instance.
+        parent->_children.Reserve( parent->_children.Size() + count );
+        if( parent->_level ) {
+            parent->_level->Reserve( count, count * componentCount );
+        }
+        if( outEntities ) {
+            outEntities->Reserve( outEntities->Size() + count );
+        }
+
+        TString emptyName;
+        for( U32 i = 0; i < count; ++i ) {
+            U8* instance = memory + ( instanceSize * i );
+
+            // Use placement new to call constructor manually. Instances are left unnamed so GetName falls back to the prefab's
+            // name, and component names stay shared with it.
+            Entity* entity = new ( instance )Entity();
+            WObject::AddToBatch( entity, memory, PREFAB_INSTANCE_ALIGNMENT );
+            entity->_prefab = this;
+            entity->_transform = transforms[i];
+            entity->_components.Reserve( componentCount );
+
+            for( U32 c = 0; c < componentCount; ++c ) {
+                StaticMeshEntityComponent* component = new ( instance + entitySize + ( componentSize * c ) )StaticMeshEntityComponent( emptyName );
+                WObject::AddToBatch( component, memory, PREFAB_INSTANCE_ALIGNMENT );
+                component->_sharedName = &_components[c]->Name;
+                component->SetStaticMesh( _components[c]->Mesh );
+                component->setOwningEntity( entity );
+                entity->_components.Add( component );
+            }
+
+            // Attaching registers the entity and all of its components with the level at once.
+            parent->AddChild( entity );
+            if( outEntities ) {
+                outEntities->Add( entity );
+            }
+        }
+
+        _instanceCount += count;
+    }
+}
\ No newline at end of file
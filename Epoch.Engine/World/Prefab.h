@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../Types.h"
+#include "../Defines.h"
+#include "../String/TString.h"
+#include "../Containers/List.h"
+#include "../Math/Transform.h"
+
+namespace Epoch {
+
+    class Entity;
+    class StaticMesh;
+
+    /**
+     * The defaults for a single component of a prefab, shared by every instance.
+     */
+    struct PrefabComponent {
+        TString Name;
+        StaticMesh* Mesh = nullptr;
+    };
+
+    /**
+     * An entity archetype whose component defaults are defined once and shared by all of its instances. Instances only
+     * store what can differ between them, such as their transform and name; component names are shared with the prefab.
+     * Spawning many instances at once places all of them and their components in a single allocation.
+     *
+     * A prefab cannot be changed once it has instances, and must outlive all of them.
+     */
+    class EPOCH_API Prefab {
+    public:
+
+        /**
+         * Creates a new, empty prefab.
+         *
+         * @param name The name shared by all instances of this prefab.
+         */
+        Prefab( const TString& name );
+        ~Prefab();
+
+        /**
+         * Returns the name shared by all instances of this prefab.
+         */
+        const TString& GetName() const { return _name; }
+
+        /**
+         * Adds a static mesh component to this prefab.
+         *
+         * @param name The name shared by this component on all instances.
+         * @param mesh The mesh shared by this component on all instances. Not owned by the prefab.
+         *
+         * @returns True if added; false if this prefab already has instances.
+         */
+        const bool AddStaticMeshComponent( const TString& name, StaticMesh* mesh );
+
+        /**
+         * Returns the number of components each instance of this prefab has.
+         */
+        const U32 ComponentCount() const { return _components.Size(); }
+
+        /**
+         * Returns the number of instances spawned from this prefab so far, including any which have since been destroyed.
+         */
+        const U32 InstanceCount() const { return _instanceCount; }
+
+        /**
+         * Spawns a single instance of this prefab.
+         *
+         * @param parent The entity to attach the instance to.
+         * @param transform The transform of the instance.
+         *
+         * @returns The new instance.
+         */
+        Entity* Spawn( Entity* parent, const Transform& transform );
+
+        /**
+         * Spawns many instances of this prefab at once, using a single allocation for all of them and their components.
+         * Instances are freed individually as normal; the allocation is released along with the last of them.
+         *
+         * @param parent The entity to attach the instances to.
+         * @param transforms A pointer to an array of transforms, one per instance.
+         * @param count The number of instances to spawn.
+         * @param outEntities A list to add the new instances to. Optional.
+         */
+        void Spawn( Entity* parent, const Transform* transforms, const U32 count, List<Entity*>* outEntities = nullptr );
+
+    private:
+        TString _name;
+        List<PrefabComponent*> _components;
+        U32 _instanceCount = 0;
+    };
+}
\ No newline at end of file
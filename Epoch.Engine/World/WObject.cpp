@@ -6,7 +6,7 @@
 
 namespace Epoch {
 
-    U32 WObject::GLOBAL_OBJECT_ID = 0;
+    std::atomic<U32> WObject::GLOBAL_OBJECT_ID( 0 );
 
     WObject* WObject::Allocate( U64 size, U64 alignment ) {
         WObject* result = static_cast<WObject*>( TMemory::AllocateAligned( size, alignment ) );
@@ -16,10 +16,36 @@ namespace Epoch {
         return result;
     }
 
+    void* WObject::AllocateBatch( U64 size, U32 objectCount, U64 alignment ) {
+
+        // The batch header sits before the objects, padded out so they keep the requested alignment.
+        U64 headerSize = ( ( sizeof( Batch ) + alignment - 1 ) / alignment ) * alignment;
+        U8* block = static_cast<U8*>( TMemory::AllocateAligned( headerSize + size, alignment ) );
+        Batch* batch = new ( block )Batch();
+        batch->LiveCount.store( objectCount, std::memory_order_relaxed );
+        return block + headerSize;
+    }
+
+    void WObject::AddToBatch( WObject* object, void* batchMemory, U64 alignment ) {
+        U64 headerSize = ( ( sizeof( Batch ) + alignment - 1 ) / alignment ) * alignment;
+        object->_batch = reinterpret_cast<Batch*>( static_cast<U8*>( batchMemory ) - headerSize );
+    }
+
     void WObject::Free( WObject* object ) {
+        Batch* batch = object->_batch;
+
         // Manually call destructor.
         object->~WObject();
-        TMemory::FreeAligned( object );
+        if( batch ) {
+
+            // Objects within a batch are only truly released along with the last of them.
+            if( batch->LiveCount.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ) {
+                batch->~Batch();
+                TMemory::FreeAligned( batch );
+            }
+        } else {
+            TMemory::FreeAligned( object );
+        }
         object = nullptr;
     }
 
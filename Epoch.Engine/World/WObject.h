@@ -3,6 +3,8 @@
 #include "../Defines.h"
 #include "../Types.h"
 
+#include <atomic>
+
 namespace Epoch {
 
     /**
@@ -12,6 +14,29 @@ namespace Epoch {
     class EPOCH_API WObject {
     public:
         static WObject* Allocate( U64 size, U64 alignment = 16 );
+
+        /**
+         * Allocates a single block of memory to hold many objects, which are placement-constructed into it by the caller
+         * and then registered with AddToBatch(). Each object is still released with Free(); the block itself is released
+         * once all of its objects have been.
+         *
+         * @param size The total size in bytes of all objects to be held.
+         * @param objectCount The number of objects which will be held.
+         * @param alignment The alignment of the returned memory. Default: 16.
+         *
+         * @returns A pointer to the start of the usable memory.
+         */
+        static void* AllocateBatch( U64 size, U32 objectCount, U64 alignment = 16 );
+
+        /**
+         * Marks an object constructed within memory returned by AllocateBatch() as belonging to that batch.
+         *
+         * @param object The object.
+         * @param batchMemory The pointer returned by AllocateBatch().
+         * @param alignment The alignment passed to AllocateBatch(). Default: 16.
+         */
+        static void AddToBatch( WObject* object, void* batchMemory, U64 alignment = 16 );
+
         static void Free( WObject* object );
     public:
         const U32 GetId() const { return _id; }
@@ -19,8 +44,16 @@ namespace Epoch {
         WObject();
         virtual ~WObject();
     private:
-        static U32 GLOBAL_OBJECT_ID;
+        // Atomic, as objects may be created on level streaming worker threads.
+        static std::atomic<U32> GLOBAL_OBJECT_ID;
+    private:
+        struct Batch {
+            std::atomic<U32> LiveCount;
+        };
     private:
         U32 _id;
+
+        // The batch this object was allocated within, if any.
+        Batch* _batch = nullptr;
     };
 }
\ No newline at end of file
@@ -1,44 +1,169 @@
 
+#include "../Logger.h"
+#include "EntityComponents/StaticMeshEntityComponent.h"
+#include "Entities/CameraEntity.h"
 #include "Entity.h"
+#include "EntityCommandBuffer.h"
 #include "Level.h"
+#include "LevelStreamer.h"
 #include "World.h"
 
 
 namespace Epoch {
 
+    void WorldRenderableObjectTable::AddRenderable( RenderableEntityComponent* component ) {
+        if( component->_renderProxyIndex != INVALID_RENDER_PROXY_INDEX ) {
+            return;
+        }
+
+        // Only static meshes have proxies. RemoveRenderable and Update rely on every proxied component being one.
+        if( component->GetRenderableComponentType() != RenderableComponentType::STATIC_MESH ) {
+            Logger::Warn( "WorldRenderableObjectTable::AddRenderable called with an unsupported renderable component type. Nothing was done." );
+            return;
+        }
+
+        StaticMeshRenderProxy proxy;
+        proxy.Component = static_cast<StaticMeshEntityComponent*>( component );
+        component->_renderProxyIndex = StaticMeshes.Size();
+        StaticMeshes.Add( proxy );
+        StaticMeshBounds.Add( AABB() );
+
+        // The world matrix is picked up on the next update.
+        MarkTransformDirty( component );
+        bumpVersion();
+    }
+
+    void WorldRenderableObjectTable::RemoveRenderable( RenderableEntityComponent* component ) {
+        U32 index = component->_renderProxyIndex;
+        if( index == INVALID_RENDER_PROXY_INDEX ) {
+            return;
+        }
+
+        U32 dirtySlot = component->_dirtyProxySlot;
+        if( dirtySlot != INVALID_RENDER_PROXY_INDEX ) {
+            U32 lastDirtySlot = _dirtyComponents.Size() - 1;
+            if( dirtySlot != lastDirtySlot ) {
+                _dirtyComponents[lastDirtySlot]->_dirtyProxySlot = dirtySlot;
+            }
+            _dirtyComponents.RemoveAtSwap( dirtySlot );
+            component->_dirtyProxySlot = INVALID_RENDER_PROXY_INDEX;
+        }
+
+        // Swap the last proxy into the vacated slot and fix up its back-reference.
+        U32 lastIndex = StaticMeshes.Size() - 1;
+        if( index != lastIndex ) {
+            StaticMeshes[lastIndex].Component->_renderProxyIndex = index;
+        }
+        StaticMeshes.RemoveAtSwap( index );
+        StaticMeshBounds.RemoveAtSwap( index );
+        component->_renderProxyIndex = INVALID_RENDER_PROXY_INDEX;
+        bumpVersion();
+    }
+
+    void WorldRenderableObjectTable::MarkTransformDirty( RenderableEntityComponent* component ) {
+        if( component->_renderProxyIndex == INVALID_RENDER_PROXY_INDEX || component->_dirtyProxySlot != INVALID_RENDER_PROXY_INDEX ) {
+            return;
+        }
+
+        component->_dirtyProxySlot = _dirtyComponents.Size();
+        _dirtyComponents.Add( component );
+    }
+
+    void WorldRenderableObjectTable::Update() {
+        U32 dirtyCount = _dirtyComponents.Size();
+        for( U32 i = 0; i < dirtyCount; ++i ) {
+            RenderableEntityComponent* component = _dirtyComponents[i];
+            U32 index = component->_renderProxyIndex;
+            StaticMeshes[index].WorldMatrix = *component->GetWorldMatrix();
+            StaticMeshBounds.Set( index, component->GetLocalBounds().Transformed( StaticMeshes[index].WorldMatrix ) );
+            component->_dirtyProxySlot = INVALID_RENDER_PROXY_INDEX;
+        }
+        if( dirtyCount > 0 ) {
+            _dirtyComponents.Clear();
+            bumpVersion();
+        }
+    }
+
+    void WorldRenderableObjectTable::bumpVersion() {
+        Version = Version == U32_MAX ? 1 : Version + 1;
+    }
 
     World::World() {
+        _objectTable = new WorldRenderableObjectTable();
+
         _rootLevel = new Level();
         _rootLevel->Name = "__ROOT__";
-        _rootLevel->Load();
+        _rootLevel->setRenderTable( _objectTable );
+
+        // Entities are released either by the command buffer or by unloading their level. Either way the world hears of it.
+        _streamer = new LevelStreamer();
+        _streamer->SetReleaseCallback( &World::onEntityReleased, this );
+        _commandBuffer = new EntityCommandBuffer();
+        _commandBuffer->SetReleaseCallback( &World::onEntityReleased, this );
+
+        // Rendered from until another camera is made active. Owned by the root level, like any other entity.
+        CameraEntity* camera = CameraEntity::Create( "DefaultCamera" );
+        camera->SetPosition( Vector3( 0.0f, 25.0f, 25.0f ) );
+        camera->LookAt( Vector3::Zero() );
+        _rootLevel->GetRootEntity()->AddChild( camera );
+        _activeCamera = camera;
     }
 
     World::~World() {
+
+        // Anything still recorded is discarded. Entities and components it was holding are freed with it.
+        if( _commandBuffer ) {
+            delete _commandBuffer;
+            _commandBuffer = nullptr;
+        }
+
+        // Streamed levels are children of the root level, so they must go first.
+        if( _streamer ) {
+            delete _streamer;
+            _streamer = nullptr;
+        }
+
         if( _rootLevel ) {
-            _rootLevel->Unload();
+            _rootLevel->setRenderTable( nullptr );
+            _rootLevel->Unload( &World::onEntityReleased, this );
             delete _rootLevel;
             _rootLevel = nullptr;
         }
+
+        if( _objectTable ) {
+            delete _objectTable;
+            _objectTable = nullptr;
+        }
     }
 
     void World::Update( const F32 deltaTime ) {
+
+        // Streamed levels are attached and detached here, between frames.
+        _streamer->Update( _viewerPosition );
+
         if( _rootLevel ) {
             _rootLevel->Update( deltaTime );
         }
+
+        // The sync point for structural changes recorded during update.
+        _commandBuffer->Apply();
     }
 
-    WorldRenderableObjectTable* World::GetRenderableObjects() {
-        if( !_objectTable ) {
-            _objectTable = new WorldRenderableObjectTable();
-        }
+    const bool World::SaveRootLevel( const TString& filePath ) {
+        return _rootLevel->SerializeBinary( filePath );
+    }
 
-        // Reset counts
-        _objectTable->StaticMeshCount = 0;        
+    void World::onEntityReleased( void* context, Entity* entity ) {
+        World* world = static_cast<World*>( context );
+        if( world->_activeCamera == entity ) {
+            world->_activeCamera = nullptr;
+        }
+    }
 
-        if( _rootLevel ) {
-            _rootLevel->AddRenderablesToTable( &_objectTable );
-        } 
+    WorldRenderableObjectTable* World::GetRenderableObjects() {
 
+        // Only proxies whose transforms changed since the last frame are touched here.
+        _objectTable->Update();
         return _objectTable;
     }
 }
\ No newline at end of file
@@ -7,41 +7,84 @@
 #include "../Containers/List.h"
 #include "../Renderer/RenderData.h"
 #include "../Resources/StaticMesh.h"
+#include "../Renderer/Frontend/FrustumCuller.h"
 
 #include "WObject.h"
 
 namespace Epoch {
 
     class StaticMeshEntityComponent;
+    class RenderableEntityComponent;
 
+    /**
+     * A render proxy for a single static mesh component. Holds a cached copy of the component's
+     * world matrix so the renderer does not need to walk the entity hierarchy each frame.
+     */
+    struct StaticMeshRenderProxy {
+        StaticMeshEntityComponent* Component = nullptr;
+        Matrix4x4 WorldMatrix;
+    };
+
+    /**
+     * A persistent table of everything renderable in the world, across the full level hierarchy.
+     * Entries are added/removed as renderable components come and go, and only proxies whose
+     * transforms have changed are refreshed each frame.
+     */
     struct WorldRenderableObjectTable {
     public:
-        U32 StaticMeshCount = 0;
-        StaticMeshEntityComponent** StaticMeshes = nullptr;
+        List<StaticMeshRenderProxy> StaticMeshes;
+
+        /**
+         * World-space bounds for each entry in StaticMeshes, at the same index.
+         */
+        CullingBounds StaticMeshBounds;
 
-        //List<StaticMeshRenderReferenceData> StaticMeshes;
+        /**
+         * Changes whenever a proxy is added, removed or moved, so consumers can tell if anything needs resending. Never 0.
+         */
+        U32 Version = 1;
 
     public:
-        WorldRenderableObjectTable() {
-
-            // TODO: Big, but should be more than enough in most cases.
-            U64 staticMeshArraySize = sizeof( StaticMeshEntityComponent* ) * 16384;
-            StaticMeshes = (StaticMeshEntityComponent**)TMemory::Allocate( staticMeshArraySize );
-            TMemory::MemZero( StaticMeshes, staticMeshArraySize );
-        }
-
-        ~WorldRenderableObjectTable() {
-            if( StaticMeshes ) {
-                StaticMeshCount = 0;
-                TMemory::Free( StaticMeshes );
-                StaticMeshes = nullptr;
-            }
-        }
+
+        /**
+         * Adds a proxy for the given component. Does nothing if it is already present.
+         *
+         * @param component The component to be added.
+         */
+        void AddRenderable( RenderableEntityComponent* component );
+
+        /**
+         * Removes the proxy for the given component. Does nothing if it is not present.
+         *
+         * @param component The component to be removed.
+         */
+        void RemoveRenderable( RenderableEntityComponent* component );
+
+        /**
+         * Flags the proxy for the given component as needing its transform refreshed.
+         *
+         * @param component The component whose transform has changed.
+         */
+        void MarkTransformDirty( RenderableEntityComponent* component );
+
+        /**
+         * Refreshes the world matrices and bounds of all proxies flagged as dirty since the last call.
+         */
+        void Update();
+
+    private:
+        void bumpVersion();
+
+    private:
+        List<RenderableEntityComponent*> _dirtyComponents;
     };
 
     class Entity;
+    class CameraEntity;
 
     class Level;
+    class LevelStreamer;
+    class EntityCommandBuffer;
 
     class World {
     public:
@@ -50,10 +93,65 @@ namespace Epoch {
 
         void Update( const F32 deltaTime );
 
+        /**
+         * Returns the renderable object table for this world, with any pending transform changes applied.
+         */
         WorldRenderableObjectTable* GetRenderableObjects();
+
+        /**
+         * Saves the entities of the root level to a level file. Streamed levels are not included, as they are saved to their own files.
+         *
+         * @param filePath The path of the file to save to.
+         *
+         * @returns True if successful; otherwise false.
+         */
+        const bool SaveRootLevel( const TString& filePath );
+
+        /**
+         * Returns the level streamer for this world. Streamed levels are typically registered as children of the root level.
+         */
+        LevelStreamer* GetLevelStreamer() { return _streamer; }
+
+        /**
+         * Returns the command buffer used to make structural changes to entities during update. It is applied at the end of each update.
+         */
+        EntityCommandBuffer* GetCommandBuffer() { return _commandBuffer; }
+
+        /**
+         * Returns the root level of this world.
+         */
+        Level* GetRootLevel() { return _rootLevel; }
+
+        /**
+         * Sets the position used to decide which levels are streamed in. Applied on the next update.
+         *
+         * @param position The world position of the viewer.
+         */
+        void SetStreamingViewerPosition( const Vector3& position ) { _viewerPosition = position; }
+
+        /**
+         * Sets the camera the world is rendered from. The root level starts with a default camera, which is active until
+         * this is called. Cleared if the camera is destroyed through the command buffer.
+         *
+         * @param camera A pointer to the camera. Pass nullptr to render from the renderer's default view.
+         */
+        void SetActiveCamera( CameraEntity* camera ) { _activeCamera = camera; }
+
+        /**
+         * Returns the camera the world is rendered from. Can return nullptr.
+         */
+        CameraEntity* GetActiveCamera() { return _activeCamera; }
+
+    private:
+        static void onEntityReleased( void* context, Entity* entity );
+
     private:
         Level* _rootLevel;
         WorldRenderableObjectTable* _objectTable = nullptr;
+        LevelStreamer* _streamer = nullptr;
+        EntityCommandBuffer* _commandBuffer = nullptr;
+        Vector3 _viewerPosition;
+        CameraEntity* _activeCamera = nullptr;
     };
 
-}
+}
\ No newline at end of file
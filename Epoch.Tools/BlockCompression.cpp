@@ -0,0 +1,342 @@
+#include <Memory/Memory.h>
+
+#include "BlockCompression.h"
+
+// The number of power iterations used to find the principal axis of a block's colors.
+#define BLOCK_COMPRESSION_AXIS_ITERATIONS 8
+
+namespace Epoch {
+
+    // The interpolation weights of 4-bit BC7 indices, out of 64.
+    static const U32 bc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    /**
+     * Finds the line which best fits the given channels of a block's texels, and the extent of the texels along it.
+     * Each endpoint is written in the range of 0-255 per channel.
+     */
+    static void fitBlockLine( const U8* texels, const U32 channelCount, F32* outStart, F32* outEnd ) {
+        F32 mean[4] = {};
+        for( U32 i = 0; i < 16; ++i ) {
+            for( U32 c = 0; c < channelCount; ++c ) {
+                mean[c] += texels[i * 4 + c];
+            }
+        }
+        for( U32 c = 0; c < channelCount; ++c ) {
+            mean[c] /= 16.0f;
+        }
+
+        F32 covariance[4][4] = {};
+        for( U32 i = 0; i < 16; ++i ) {
+            for( U32 a = 0; a < channelCount; ++a ) {
+                F32 da = texels[i * 4 + a] - mean[a];
+                for( U32 b = 0; b < channelCount; ++b ) {
+                    covariance[a][b] += da * ( texels[i * 4 + b] - mean[b] );
+                }
+            }
+        }
+
+        // Power iteration converges on the principal axis quickly enough for a block of 16 texels.
+        F32 axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        for( U32 iteration = 0; iteration < BLOCK_COMPRESSION_AXIS_ITERATIONS; ++iteration ) {
+            F32 next[4] = {};
+            F32 largest = 0.0f;
+            for( U32 a = 0; a < channelCount; ++a ) {
+                for( U32 b = 0; b < channelCount; ++b ) {
+                    next[a] += covariance[a][b] * axis[b];
+                }
+                F32 magnitude = next[a] < 0.0f ? -next[a] : next[a];
+                largest = magnitude > largest ? magnitude : largest;
+            }
+
+            // Every texel is the same, so any axis will do.
+            if( largest <= 0.0f ) {
+                break;
+            }
+            for( U32 c = 0; c < channelCount; ++c ) {
+                axis[c] = next[c] / largest;
+            }
+        }
+
+        F32 lengthSquared = 0.0f;
+        for( U32 c = 0; c < channelCount; ++c ) {
+            lengthSquared += axis[c] * axis[c];
+        }
+
+        F32 minT = 0.0f;
+        F32 maxT = 0.0f;
+        for( U32 i = 0; i < 16; ++i ) {
+            F32 t = 0.0f;
+            for( U32 c = 0; c < channelCount; ++c ) {
+                t += ( texels[i * 4 + c] - mean[c] ) * axis[c];
+            }
+            t /= lengthSquared;
+            minT = t < minT ? t : minT;
+            maxT = t > maxT ? t : maxT;
+        }
+
+        for( U32 c = 0; c < channelCount; ++c ) {
+            F32 start = mean[c] + axis[c] * minT;
+            F32 end = mean[c] + axis[c] * maxT;
+            outStart[c] = start < 0.0f ? 0.0f : ( start > 255.0f ? 255.0f : start );
+            outEnd[c] = end < 0.0f ? 0.0f : ( end > 255.0f ? 255.0f : end );
+        }
+    }
+
+    static U16 packColor565( const F32* color ) {
+        U32 r = (U32)( color[0] * 31.0f / 255.0f + 0.5f );
+        U32 g = (U32)( color[1] * 63.0f / 255.0f + 0.5f );
+        U32 b = (U32)( color[2] * 31.0f / 255.0f + 0.5f );
+        return (U16)( ( r << 11 ) | ( g << 5 ) | b );
+    }
+
+    static void unpackColor565( const U16 packed, I32* outColor ) {
+        I32 r = ( packed >> 11 ) & 0x1F;
+        I32 g = ( packed >> 5 ) & 0x3F;
+        I32 b = packed & 0x1F;
+        outColor[0] = ( r << 3 ) | ( r >> 2 );
+        outColor[1] = ( g << 2 ) | ( g >> 4 );
+        outColor[2] = ( b << 3 ) | ( b >> 2 );
+    }
+
+    /**
+     * Encodes a single channel of a block as BC4, using the mode with 6 interpolated values.
+     */
+    static void encodeBC4( const U8* texels, const U32 channel, U8* outBlock ) {
+        U8 minValue = 255;
+        U8 maxValue = 0;
+        for( U32 i = 0; i < 16; ++i ) {
+            U8 value = texels[i * 4 + channel];
+            minValue = value < minValue ? value : minValue;
+            maxValue = value > maxValue ? value : maxValue;
+        }
+
+        // With the first endpoint greater, values are: max, min, then 6 steps from max to min.
+        I32 palette[8];
+        palette[0] = maxValue;
+        palette[1] = minValue;
+        for( I32 i = 1; i < 7; ++i ) {
+            palette[i + 1] = ( ( 7 - i ) * maxValue + i * minValue + 3 ) / 7;
+        }
+
+        U64 indices = 0;
+        if( maxValue != minValue ) {
+            for( U32 i = 0; i < 16; ++i ) {
+                I32 value = texels[i * 4 + channel];
+                U32 best = 0;
+                I32 bestError = 256;
+                for( U32 p = 0; p < 8; ++p ) {
+                    I32 error = value > palette[p] ? value - palette[p] : palette[p] - value;
+                    if( error < bestError ) {
+                        bestError = error;
+                        best = p;
+                    }
+                }
+                indices |= (U64)best << ( i * 3 );
+            }
+        }
+
+        outBlock[0] = maxValue;
+        outBlock[1] = minValue;
+        for( U32 i = 0; i < 6; ++i ) {
+            outBlock[2 + i] = (U8)( indices >> ( i * 8 ) );
+        }
+    }
+
+    void BlockCompression::EncodeBC1( const U8* texels, U8* outBlock ) {
+        F32 start[4];
+        F32 end[4];
+        fitBlockLine( texels, 3, start, end );
+
+        // The first endpoint must be the greater one, which selects the 4 color mode rather than 3 colors and black.
+        U16 color0 = packColor565( end );
+        U16 color1 = packColor565( start );
+        if( color0 < color1 ) {
+            U16 swap = color0;
+            color0 = color1;
+            color1 = swap;
+        }
+
+        I32 palette[4][3];
+        unpackColor565( color0, palette[0] );
+        unpackColor565( color1, palette[1] );
+        for( U32 c = 0; c < 3; ++c ) {
+            palette[2][c] = ( 2 * palette[0][c] + palette[1][c] ) / 3;
+            palette[3][c] = ( palette[0][c] + 2 * palette[1][c] ) / 3;
+        }
+
+        U32 indices = 0;
+        if( color0 != color1 ) {
+            for( U32 i = 0; i < 16; ++i ) {
+                U32 best = 0;
+                I32 bestError = 0x7FFFFFFF;
+                for( U32 p = 0; p < 4; ++p ) {
+                    I32 error = 0;
+                    for( U32 c = 0; c < 3; ++c ) {
+                        I32 d = (I32)texels[i * 4 + c] - palette[p][c];
+                        error += d * d;
+                    }
+                    if( error < bestError ) {
+                        bestError = error;
+                        best = p;
+                    }
+                }
+                indices |= best << ( i * 2 );
+            }
+        }
+
+        outBlock[0] = (U8)( color0 & 0xFF );
+        outBlock[1] = (U8)( color0 >> 8 );
+        outBlock[2] = (U8)( color1 & 0xFF );
+        outBlock[3] = (U8)( color1 >> 8 );
+        for( U32 i = 0; i < 4; ++i ) {
+            outBlock[4 + i] = (U8)( indices >> ( i * 8 ) );
+        }
+    }
+
+    void BlockCompression::EncodeBC3( const U8* texels, U8* outBlock ) {
+        encodeBC4( texels, 3, outBlock );
+        EncodeBC1( texels, outBlock + 8 );
+    }
+
+    void BlockCompression::EncodeBC5( const U8* texels, U8* outBlock ) {
+        encodeBC4( texels, 0, outBlock );
+        encodeBC4( texels, 1, outBlock + 8 );
+    }
+
+    void BlockCompression::EncodeBC7( const U8* texels, U8* outBlock ) {
+        F32 start[4];
+        F32 end[4];
+        fitBlockLine( texels, 4, start, end );
+
+        // Each endpoint is 7 bits per channel plus a low bit shared by all of its channels. Pick whichever low bit fits best.
+        U32 endpoints[2][4];
+        U32 pBits[2];
+        const F32* fitted[2] = { start, end };
+        for( U32 e = 0; e < 2; ++e ) {
+            F32 bestError = 0.0f;
+            for( U32 p = 0; p < 2; ++p ) {
+                U32 quantized[4];
+                F32 error = 0.0f;
+                for( U32 c = 0; c < 4; ++c ) {
+                    I32 q = (I32)( ( fitted[e][c] - p ) * 0.5f + 0.5f );
+                    q = q < 0 ? 0 : ( q > 127 ? 127 : q );
+                    quantized[c] = (U32)q;
+                    F32 d = fitted[e][c] - (F32)( ( q << 1 ) | p );
+                    error += d * d;
+                }
+                if( p == 0 || error < bestError ) {
+                    bestError = error;
+                    pBits[e] = p;
+                    for( U32 c = 0; c < 4; ++c ) {
+                        endpoints[e][c] = quantized[c];
+                    }
+                }
+            }
+        }
+
+        I32 palette[16][4];
+        for( U32 c = 0; c < 4; ++c ) {
+            U32 e0 = ( endpoints[0][c] << 1 ) | pBits[0];
+            U32 e1 = ( endpoints[1][c] << 1 ) | pBits[1];
+            for( U32 w = 0; w < 16; ++w ) {
+                palette[w][c] = (I32)( ( ( 64 - bc7Weights[w] ) * e0 + bc7Weights[w] * e1 + 32 ) >> 6 );
+            }
+        }
+
+        U32 indices[16];
+        for( U32 i = 0; i < 16; ++i ) {
+            U32 best = 0;
+            I32 bestError = 0x7FFFFFFF;
+            for( U32 w = 0; w < 16; ++w ) {
+                I32 error = 0;
+                for( U32 c = 0; c < 4; ++c ) {
+                    I32 d = (I32)texels[i * 4 + c] - palette[w][c];
+                    error += d * d;
+                }
+                if( error < bestError ) {
+                    bestError = error;
+                    best = w;
+                }
+            }
+            indices[i] = best;
+        }
+
+        // The high bit of the first index is implied to be 0, so flip the line if it is set.
+        if( indices[0] >= 8 ) {
+            for( U32 c = 0; c < 4; ++c ) {
+                U32 swap = endpoints[0][c];
+                endpoints[0][c] = endpoints[1][c];
+                endpoints[1][c] = swap;
+            }
+            U32 swap = pBits[0];
+            pBits[0] = pBits[1];
+            pBits[1] = swap;
+            for( U32 i = 0; i < 16; ++i ) {
+                indices[i] = 15 - indices[i];
+            }
+        }
+
+        // Mode 6 layout, from the lowest bit: mode (7), R0 R1 G0 G1 B0 B1 A0 A1 (7 each), P0 P1, then the indices.
+        U64 bits[2] = { 0, 0 };
+        U32 position = 0;
+        auto writeBits = [&]( const U64 value, const U32 count ) {
+            for( U32 i = 0; i < count; ++i, ++position ) {
+                bits[position >> 6] |= ( ( value >> i ) & 1 ) << ( position & 63 );
+            }
+        };
+        writeBits( 1 << 6, 7 );
+        for( U32 c = 0; c < 4; ++c ) {
+            writeBits( endpoints[0][c], 7 );
+            writeBits( endpoints[1][c], 7 );
+        }
+        writeBits( pBits[0], 1 );
+        writeBits( pBits[1], 1 );
+        writeBits( indices[0], 3 );
+        for( U32 i = 1; i < 16; ++i ) {
+            writeBits( indices[i], 4 );
+        }
+
+        for( U32 i = 0; i < 16; ++i ) {
+            outBlock[i] = (U8)( bits[i >> 3] >> ( ( i & 7 ) * 8 ) );
+        }
+    }
+
+    void BlockCompression::EncodeImage( const TextureFileFormat format, const U8* pixels, const U32 width, const U32 height, U8* outData ) {
+        if( format == TextureFileFormat::RGBA8 ) {
+            TMemory::Memcpy( outData, pixels, (U64)width * (U64)height * 4 );
+            return;
+        }
+
+        U64 blockSize = format == TextureFileFormat::BC1 ? 8 : 16;
+        U32 blocksWide = ( width + 3 ) / 4;
+        U32 blocksHigh = ( height + 3 ) / 4;
+        U8 texels[64];
+        for( U32 by = 0; by < blocksHigh; ++by ) {
+            for( U32 bx = 0; bx < blocksWide; ++bx ) {
+                for( U32 y = 0; y < 4; ++y ) {
+                    U32 sourceY = by * 4 + y < height ? by * 4 + y : height - 1;
+                    for( U32 x = 0; x < 4; ++x ) {
+                        U32 sourceX = bx * 4 + x < width ? bx * 4 + x : width - 1;
+                        TMemory::Memcpy( texels + ( y * 4 + x ) * 4, pixels + ( (U64)sourceY * width + sourceX ) * 4, 4 );
+                    }
+                }
+
+                U8* block = outData + ( (U64)by * blocksWide + bx ) * blockSize;
+                switch( format ) {
+                case TextureFileFormat::BC1:
+                    EncodeBC1( texels, block );
+                    break;
+                case TextureFileFormat::BC3:
+                    EncodeBC3( texels, block );
+                    break;
+                case TextureFileFormat::BC5:
+                    EncodeBC5( texels, block );
+                    break;
+                default:
+                    EncodeBC7( texels, block );
+                    break;
+                }
+            }
+        }
+    }
+}
\ No newline at end of file
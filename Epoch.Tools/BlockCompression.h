@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Types.h>
+#include <Assets/TextureFile.h>
+
+namespace Epoch {
+
+    /**
+     * Encodes RGBA8 images into block-compressed formats on the CPU. Each 4x4 block is encoded on its own by fitting a
+     * line through its colors and picking the nearest point on that line for each texel. This is much faster than an
+     * exhaustive search, at some cost in quality, which is good enough for cooking during development.
+     */
+    class BlockCompression {
+    public:
+
+        /**
+         * Encodes a 4x4 block as BC1. Alpha is ignored.
+         *
+         * @param texels The 16 texels of the block, row by row, 4 bytes each.
+         * @param outBlock The 8 bytes to write the block to.
+         */
+        static void EncodeBC1( const U8* texels, U8* outBlock );
+
+        /**
+         * Encodes a 4x4 block as BC3, which is BC4 alpha followed by BC1 color.
+         *
+         * @param texels The 16 texels of the block, row by row, 4 bytes each.
+         * @param outBlock The 16 bytes to write the block to.
+         */
+        static void EncodeBC3( const U8* texels, U8* outBlock );
+
+        /**
+         * Encodes the red and green channels of a 4x4 block as BC5, which is two BC4 blocks.
+         *
+         * @param texels The 16 texels of the block, row by row, 4 bytes each.
+         * @param outBlock The 16 bytes to write the block to.
+         */
+        static void EncodeBC5( const U8* texels, U8* outBlock );
+
+        /**
+         * Encodes a 4x4 block as BC7. Only mode 6 is used, which has a single RGBA line and 4-bit indices.
+         *
+         * @param texels The 16 texels of the block, row by row, 4 bytes each.
+         * @param outBlock The 16 bytes to write the block to.
+         */
+        static void EncodeBC7( const U8* texels, U8* outBlock );
+
+        /**
+         * Encodes a whole image. Blocks hanging off the right or bottom edge repeat the last column or row.
+         *
+         * @param format The format to encode to. RGBA8 copies the pixels as they are.
+         * @param pixels The image, row by row, 4 bytes per texel.
+         * @param width The width of the image.
+         * @param height The height of the image.
+         * @param outData The memory to write to, of the size given by TextureFile::GetMipSize.
+         */
+        static void EncodeImage( const TextureFileFormat format, const U8* pixels, const U32 width, const U32 height, U8* outData );
+    };
+}
\ No newline at end of file
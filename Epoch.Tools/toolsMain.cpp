@@ -6,9 +6,397 @@
 #include <FileSystem/FileSystem.h>
 #include <Assets/MaterialData.h>
 #include <Logger.h>
+#include <Math/TMath.h>
+#include <Math/Matrix4x4.h>
+#include <Math/Frustum.h>
+#include <Renderer/Frontend/FrustumCuller.h>
+#include <World/Entity.h>
+#include <World/LooseOctree.h>
+#include <World/Level.h>
+#include <World/EntityComponents/StaticMeshEntityComponent.h>
+#include <Resources/StaticMesh.h>
+#include <Assets/TextureFile.h>
+#include <Assets/Image/ImageUtilities.h>
+#include <Assets/ShaderArchive.h>
+#include <Renderer/ShaderReflection.h>
+#include <Renderer/IShader.h>
+#include <Memory/Memory.h>
+
+#include "BlockCompression.h"
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
 
 using namespace Epoch;
 
+// Culls a large number of randomly-placed boxes using each culling path and reports the average timings.
+static int benchmarkCulling() {
+    const U32 boxCount = 1000000;
+    const U32 iterations = 20;
+
+    CullingBounds bounds;
+    for( U32 i = 0; i < boxCount; ++i ) {
+        F32 min = -500.0f;
+        F32 max = 500.0f;
+        Vector3 center( TMath::FloatRandomRange( min, max ), TMath::FloatRandomRange( min, max ), TMath::FloatRandomRange( min, max ) );
+        F32 smin = 0.5f;
+        F32 smax = 5.0f;
+        Vector3 extents( TMath::FloatRandomRange( smin, smax ) );
+        bounds.Add( AABB( center - extents, center + extents ) );
+    }
+
+    Matrix4x4 view = Matrix4x4::LookAt( Vector3( 0.0f, 25.0f, 25.0f ), Vector3::Zero(), Vector3::Up() );
+    Matrix4x4 projection = Matrix4x4::Perspective( TMath::DegToRad( 90.0f ), 16.0f / 9.0f, 0.1f, 1000.0f );
+    Frustum frustum = Frustum::FromViewProjection( projection * view );
+
+    List<U32> visible;
+    visible.Resize( boxCount );
+
+    const char* names[3] = { "scalar", "SIMD (1 thread)", "SIMD (all threads)" };
+    for( U32 mode = 0; mode < 3; ++mode ) {
+        U32 visibleCount = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for( U32 i = 0; i < iterations; ++i ) {
+            if( mode == 0 ) {
+                visibleCount = FrustumCuller::CullRangeScalar( frustum, bounds, 0, boxCount, visible.Data() );
+            } else if( mode == 1 ) {
+                visibleCount = FrustumCuller::CullRange( frustum, bounds, 0, boxCount, visible.Data() );
+            } else {
+                visibleCount = FrustumCuller::Cull( frustum, bounds, visible.Data() );
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        F64 ms = std::chrono::duration<F64, std::milli>( end - start ).count() / iterations;
+        Logger::Log( "Culling %u boxes, %s: %.3f ms (%u visible, %u culled)", boxCount, names[mode], ms, visibleCount, boxCount - visibleCount );
+    }
+
+    return 0;
+}
+
+// Runs spatial queries against a loose octree and against a brute-force scan of the same bounds, and reports the average timings.
+static int benchmarkSpatialIndex() {
+    const U32 entityCount = 100000;
+    const U32 queryCount = 1000;
+
+    List<Entity*> entities;
+    List<AABB> bounds;
+    for( U32 i = 0; i < entityCount; ++i ) {
+        F32 min = -1000.0f;
+        F32 max = 1000.0f;
+        Vector3 center( TMath::FloatRandomRange( min, max ), TMath::FloatRandomRange( min, max ), TMath::FloatRandomRange( min, max ) );
+        F32 smin = 0.5f;
+        F32 smax = 5.0f;
+        Vector3 extents( TMath::FloatRandomRange( smin, smax ) );
+        entities.Add( Entity::Create( "bench" ) );
+        bounds.Add( AABB( center - extents, center + extents ) );
+    }
+
+    List<U32> handles;
+    handles.Resize( entityCount );
+    LooseOctree octree( Vector3::Zero(), 1024.0f );
+    auto buildStart = std::chrono::high_resolution_clock::now();
+    octree.Build( entities.Data(), bounds.Data(), entityCount, handles.Data() );
+    auto buildEnd = std::chrono::high_resolution_clock::now();
+    Logger::Log( "Built octree of %u entities in %.3f ms", entityCount, std::chrono::duration<F64, std::milli>( buildEnd - buildStart ).count() );
+
+    // Moving every entity slightly should mostly stay within the same node.
+    auto updateStart = std::chrono::high_resolution_clock::now();
+    for( U32 i = 0; i < entityCount; ++i ) {
+        bounds[i] = AABB( bounds[i].Min + Vector3( 0.1f ), bounds[i].Max + Vector3( 0.1f ) );
+        octree.Update( handles[i], bounds[i] );
+    }
+    auto updateEnd = std::chrono::high_resolution_clock::now();
+    Logger::Log( "Updated %u entities in %.3f ms", entityCount, std::chrono::duration<F64, std::milli>( updateEnd - updateStart ).count() );
+
+    List<Entity*> results;
+    const char* names[4] = { "sphere", "AABB", "ray", "frustum" };
+    for( U32 type = 0; type < 4; ++type ) {
+        U64 octreeHits = 0;
+        U64 bruteHits = 0;
+        F64 octreeMs = 0.0;
+        F64 bruteMs = 0.0;
+        for( U32 q = 0; q < queryCount; ++q ) {
+            F32 min = -1000.0f;
+            F32 max = 1000.0f;
+            Vector3 point( TMath::FloatRandomRange( min, max ), TMath::FloatRandomRange( min, max ), TMath::FloatRandomRange( min, max ) );
+            BoundingSphere sphere;
+            sphere.Center = point;
+            sphere.Radius = 50.0f;
+            AABB box( point - Vector3( 50.0f ), point + Vector3( 50.0f ) );
+            Vector3 direction = Vector3::Normalized( Vector3::Zero() - point );
+            Vector3 inverseDirection( 1.0f / direction.X, 1.0f / direction.Y, 1.0f / direction.Z );
+            Matrix4x4 view = Matrix4x4::LookAt( point, Vector3::Zero(), Vector3::Up() );
+            Matrix4x4 projection = Matrix4x4::Perspective( TMath::DegToRad( 60.0f ), 16.0f / 9.0f, 0.1f, 300.0f );
+            Frustum frustum = Frustum::FromViewProjection( projection * view );
+
+            results.Clear();
+            auto start = std::chrono::high_resolution_clock::now();
+            switch( type ) {
+            case 0: octree.QuerySphere( sphere, results ); break;
+            case 1: octree.QueryAABB( box, results ); break;
+            case 2: octree.QueryRay( point, direction, 2000.0f, results ); break;
+            default: octree.QueryFrustum( frustum, results ); break;
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            octreeMs += std::chrono::duration<F64, std::milli>( end - start ).count();
+            octreeHits += results.Size();
+
+            results.Clear();
+            start = std::chrono::high_resolution_clock::now();
+            for( U32 i = 0; i < entityCount; ++i ) {
+                bool hit;
+                switch( type ) {
+                case 0: hit = bounds[i].Intersects( sphere ); break;
+                case 1: hit = bounds[i].Intersects( box ); break;
+                case 2: hit = bounds[i].IntersectsRay( point, inverseDirection, 2000.0f ); break;
+                default: hit = frustum.IntersectsAABB( bounds[i] ); break;
+                }
+                if( hit ) {
+                    results.Add( entities[i] );
+                }
+            }
+            end = std::chrono::high_resolution_clock::now();
+            bruteMs += std::chrono::duration<F64, std::milli>( end - start ).count();
+            bruteHits += results.Size();
+        }
+
+        Logger::Log( "%s query: octree %.4f ms, brute force %.4f ms (hits: %llu vs %llu)", names[type], octreeMs / queryCount, bruteMs / queryCount, octreeHits, bruteHits );
+    }
+
+    for( U32 i = 0; i < entityCount; ++i ) {
+        Entity::Destroy( entities[i] );
+    }
+    return 0;
+}
+
+// Saves a large generated level, then loads it back several times and reports the average timings.
+static int benchmarkLevelLoad() {
+    const U32 entityCount = 100000;
+    const U32 iterations = 5;
+    const TString filePath = "benchmark" EPOCH_FILE_EXT_LEVEL;
+
+    // Groups of 10 entities, each a chain of children, all sharing one mesh.
+    Level source( "benchmark" );
+    StaticMesh* mesh = new StaticMesh( "test", "assets/models/Teapot001.esm" );
+    Entity* parent = nullptr;
+    for( U32 i = 0; i < entityCount; ++i ) {
+        F32 min = -1000.0f;
+        F32 max = 1000.0f;
+        Entity* entity = Entity::Create( "bench" );
+        entity->SetPosition( Vector3( TMath::FloatRandomRange( min, max ), TMath::FloatRandomRange( min, max ), TMath::FloatRandomRange( min, max ) ) );
+        if( i % 10 == 0 ) {
+            source.GetRootEntity()->AddChild( entity );
+        } else {
+            parent->AddChild( entity );
+        }
+        StaticMeshEntityComponent* component = EntityComponentFactory::CreateComponent<StaticMeshEntityComponent>( "bench" );
+        component->SetStaticMesh( mesh );
+        entity->AddComponent( component );
+        parent = entity;
+    }
+
+    auto saveStart = std::chrono::high_resolution_clock::now();
+    if( !source.SerializeBinary( filePath ) ) {
+        return 1;
+    }
+    auto saveEnd = std::chrono::high_resolution_clock::now();
+    Logger::Log( "Saved %u entities in %.3f ms", entityCount, std::chrono::duration<F64, std::milli>( saveEnd - saveStart ).count() );
+    source.Unload();
+    delete mesh;
+
+    F64 totalMs = 0.0;
+    for( U32 i = 0; i < iterations; ++i ) {
+        Level* level = new Level( "benchmark" );
+        auto start = std::chrono::high_resolution_clock::now();
+        bool result = level->DeserializeBinary( filePath );
+        auto end = std::chrono::high_resolution_clock::now();
+        totalMs += std::chrono::duration<F64, std::milli>( end - start ).count();
+        level->Unload();
+        delete level;
+        if( !result ) {
+            return 1;
+        }
+    }
+    Logger::Log( "Loaded %u entities in %.3f ms (average of %u)", entityCount, totalMs / iterations, iterations );
+
+    return 0;
+}
+
+// Loads a source image, builds its mip chain and writes every level in the given format to a texture file.
+static const bool cookTexture( const TString& sourcePath, const TString& outputPath, const TextureFileFormat format, const bool isSrgb ) {
+    I32 width, height, channelCount;
+    byte* pixels = ImageUtilities::LoadImage( sourcePath.CStr(), &width, &height, &channelCount );
+    if( !pixels ) {
+        Logger::Error( "Failed to load image '%s'.", sourcePath.CStr() );
+        return false;
+    }
+
+    U32 mipLevelCount;
+    U64 chainSize;
+    byte* chain = ImageUtilities::GenerateMipChain( pixels, (U32)width, (U32)height, isSrgb, &mipLevelCount, &chainSize );
+    TMemory::Free( pixels );
+
+    // Encode each level into its own buffer, reading the levels from the tightly packed chain.
+    List<U8*> levels;
+    U64 sourceOffset = 0;
+    U32 levelWidth = (U32)width;
+    U32 levelHeight = (U32)height;
+    for( U32 i = 0; i < mipLevelCount; ++i ) {
+        U8* level = static_cast<U8*>( TMemory::Allocate( TextureFile::GetMipSize( format, levelWidth, levelHeight ) ) );
+        BlockCompression::EncodeImage( format, chain + sourceOffset, levelWidth, levelHeight, level );
+        levels.Add( level );
+        sourceOffset += (U64)levelWidth * (U64)levelHeight * 4;
+        levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+        levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+    }
+    TMemory::Free( chain );
+
+    Logger::Log( "Writing texture file: %s (%ux%u, %u levels)", outputPath.CStr(), width, height, mipLevelCount );
+    bool result = TextureFile::Write( outputPath, format, isSrgb, (U32)width, (U32)height, mipLevelCount, levels.Data() );
+
+    for( U32 i = 0; i < mipLevelCount; ++i ) {
+        TMemory::Free( levels[i] );
+    }
+    return result;
+}
+
+// Compares loading a source image and building its mip chain at runtime against mapping a cooked texture file.
+static int benchmarkTextureLoad( const TString& sourcePath, const TextureFileFormat format ) {
+    const U32 iterations = 5;
+    const TString filePath = "benchmark" EPOCH_FILE_EXT_TEXTURE;
+
+    bool isSrgb = format != TextureFileFormat::BC5;
+    if( !cookTexture( sourcePath, filePath, format, isSrgb ) ) {
+        return 1;
+    }
+
+    F64 sourceMs = 0.0;
+    U64 sourceSize = 0;
+    U64 sourcePeakSize = 0;
+    for( U32 i = 0; i < iterations; ++i ) {
+        auto start = std::chrono::high_resolution_clock::now();
+        I32 width, height, channelCount;
+        byte* pixels = ImageUtilities::LoadImage( sourcePath.CStr(), &width, &height, &channelCount );
+        U32 mipLevelCount;
+        byte* chain = ImageUtilities::GenerateMipChain( pixels, (U32)width, (U32)height, isSrgb, &mipLevelCount, &sourceSize );
+        auto end = std::chrono::high_resolution_clock::now();
+        sourceMs += std::chrono::duration<F64, std::milli>( end - start ).count();
+
+        // The decoded image and its chain are both held while the chain is built.
+        sourcePeakSize = (U64)width * (U64)height * 4 + sourceSize;
+        TMemory::Free( pixels );
+        TMemory::Free( chain );
+    }
+    Logger::Log( "Source image: %.3f ms (average of %u), %llu bytes uploaded, %llu bytes peak", sourceMs / iterations, iterations, sourceSize, sourcePeakSize );
+
+    F64 cookedMs = 0.0;
+    U64 cookedSize = 0;
+    for( U32 i = 0; i < iterations; ++i ) {
+        auto start = std::chrono::high_resolution_clock::now();
+        TextureFile file( filePath );
+        if( !file.TryOpen() ) {
+            return 1;
+        }
+        const TextureFileHeader* header = file.GetHeader();
+        const TextureFileMip& lastMip = file.GetMip( header->MipLevelCount - 1 );
+        cookedSize = lastMip.Offset + lastMip.Size - file.GetMip( 0 ).Offset;
+
+        // Touch every page, as the upload copy would.
+        const U8* data = file.GetData();
+        volatile U64 checksum = 0;
+        for( U64 offset = file.GetMip( 0 ).Offset; offset < header->FileSize; offset += 4096 ) {
+            checksum += data[offset];
+        }
+        file.Close();
+        auto end = std::chrono::high_resolution_clock::now();
+        cookedMs += std::chrono::duration<F64, std::milli>( end - start ).count();
+    }
+    Logger::Log( "Cooked texture: %.3f ms (average of %u), %llu bytes uploaded, nothing decoded", cookedMs / iterations, iterations, cookedSize );
+
+    return 0;
+}
+
+// Parses the name of a texture file format, as given on the command line.
+static const bool parseTextureFormat( const TString& name, TextureFileFormat* outFormat ) {
+    const char* names[5] = { "rgba8", "bc1", "bc3", "bc5", "bc7" };
+    for( U8 i = 0; i < 5; ++i ) {
+        if( name == names[i] ) {
+            *outFormat = (TextureFileFormat)i;
+            return true;
+        }
+    }
+    Logger::Error( "Unknown texture format '%s'. Expected one of rgba8, bc1, bc3, bc5 or bc7.", name.CStr() );
+    return false;
+}
+
+// Reflects every compiled module in the given directory, named "<shader>.<stage>.spv", and packs them all into one archive.
+static int packShaders( const TString& directory, const TString& outputPath ) {
+    const char* stageNames[4] = { "vert", "frag", "comp", "geom" };
+    const ShaderType stageTypes[4] = { ShaderType::Vertex, ShaderType::Fragment, ShaderType::Compute, ShaderType::Geometry };
+
+    // Sorted, so the same modules always produce the same archive.
+    std::vector<std::filesystem::path> paths;
+    for( const auto& file : std::filesystem::directory_iterator( directory.CStr() ) ) {
+        if( file.is_regular_file() && file.path().extension() == ".spv" ) {
+            paths.push_back( file.path() );
+        }
+    }
+    std::sort( paths.begin(), paths.end() );
+
+    std::vector<std::vector<U32>> codes( paths.size() );
+    std::vector<List<ShaderBinding>> bindings( paths.size() );
+    std::vector<ShaderArchiveEntry> entries;
+    for( U64 i = 0; i < paths.size(); ++i ) {
+        std::string stem = paths[i].stem().string();
+        std::string::size_type separator = stem.find_last_of( '.' );
+        I32 stage = -1;
+        for( I32 s = 0; separator != std::string::npos && s < 4; ++s ) {
+            if( stem.compare( separator + 1, std::string::npos, stageNames[s] ) == 0 ) {
+                stage = s;
+            }
+        }
+        if( stage == -1 ) {
+            Logger::Warn( "Skipping '%s', which is not named after a shader stage.", paths[i].string().c_str() );
+            continue;
+        }
+
+        std::ifstream file( paths[i].string(), std::ios::ate | std::ios::binary );
+        U64 size = file.is_open() ? (U64)file.tellg() : 0;
+        if( size == 0 || ( size % sizeof( U32 ) ) != 0 ) {
+            Logger::Error( "Failed to read shader module '%s'.", paths[i].string().c_str() );
+            return 1;
+        }
+        codes[i].resize( size / sizeof( U32 ) );
+        file.seekg( 0 );
+        file.read( reinterpret_cast<char*>( codes[i].data() ), size );
+
+        if( !ShaderReflection::ReflectBindings( codes[i].data(), codes[i].size(), bindings[i] ) ) {
+            Logger::Error( "Failed to reflect shader module '%s'.", paths[i].string().c_str() );
+            return 1;
+        }
+
+        ShaderArchiveEntry entry;
+        entry.Name = stem.substr( 0, separator ).c_str();
+        entry.Type = (U8)stageTypes[stage];
+        entry.Code = codes[i].data();
+        entry.CodeSize = size;
+        entry.Bindings = bindings[i].Data();
+        entry.BindingCount = bindings[i].Size();
+        entries.push_back( entry );
+        Logger::Log( "Packing shader module: %s (%u bindings)", paths[i].filename().string().c_str(), entry.BindingCount );
+    }
+
+    if( !ShaderArchive::Write( outputPath, entries.data(), (U32)entries.size() ) ) {
+        return 1;
+    }
+    Logger::Log( "Wrote %u shader modules to %s", (U32)entries.size(), outputPath.CStr() );
+    return 0;
+}
+
 int main( int argc, const char* argv[] ) {
 
     // Make arguments easily digestible.
@@ -17,6 +405,50 @@ int main( int argc, const char* argv[] ) {
         arguments.Add( argv[i] );
     }
 
+    if( arguments.Size() > 1 && arguments[1] == "-benchmark-culling" ) {
+        return benchmarkCulling();
+    }
+
+    if( arguments.Size() > 1 && arguments[1] == "-benchmark-spatial" ) {
+        return benchmarkSpatialIndex();
+    }
+
+    if( arguments.Size() > 1 && arguments[1] == "-benchmark-level" ) {
+        return benchmarkLevelLoad();
+    }
+
+    // -pack-shaders <directory> [output]
+    if( arguments.Size() > 2 && arguments[1] == "-pack-shaders" ) {
+        TString outputPath = arguments.Size() > 3 ? arguments[3] : arguments[2] + "/shaders" EPOCH_FILE_EXT_SHADER_ARCHIVE;
+        return packShaders( arguments[2], outputPath );
+    }
+
+    // -cook-texture <source> <output> [rgba8|bc1|bc3|bc5|bc7] [-linear]
+    if( arguments.Size() > 3 && arguments[1] == "-cook-texture" ) {
+        TextureFileFormat format = TextureFileFormat::BC7;
+        if( arguments.Size() > 4 && arguments[4] != "-linear" && !parseTextureFormat( arguments[4], &format ) ) {
+            return 1;
+        }
+
+        // Two-channel data such as normals is never color, so is always linear.
+        bool isSrgb = format != TextureFileFormat::BC5;
+        for( U32 i = 4; i < arguments.Size(); ++i ) {
+            if( arguments[i] == "-linear" ) {
+                isSrgb = false;
+            }
+        }
+        return cookTexture( arguments[2], arguments[3], format, isSrgb ) ? 0 : 1;
+    }
+
+    // -benchmark-textures <source> [rgba8|bc1|bc3|bc5|bc7]
+    if( arguments.Size() > 2 && arguments[1] == "-benchmark-textures" ) {
+        TextureFileFormat format = TextureFileFormat::BC7;
+        if( arguments.Size() > 3 && !parseTextureFormat( arguments[3], &format ) ) {
+            return 1;
+        }
+        return benchmarkTextureLoad( arguments[2], format );
+    }
+
     // TODO: assuming OBJ file conversion for now.
     if( true ) {
         TString name = "rubbish";
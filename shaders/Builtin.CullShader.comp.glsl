@@ -0,0 +1,71 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Must match VULKAN_CULL_WORKGROUP_SIZE.
+layout(local_size_x = 64) in;
+
+struct CullObject {
+    vec3 center;
+    uint firstIndex;
+    vec3 extent;
+    uint indexCount;
+    int vertexOffset;
+    uint firstCommand;
+    uint batchIndex;
+    uint reserved;
+};
+
+struct DrawIndexedCommand {
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer CullObjects {
+    CullObject objects[];
+} cullObjects;
+
+layout(std430, set = 0, binding = 1) writeonly buffer DrawCommands {
+    DrawIndexedCommand draws[];
+} drawCommands;
+
+layout(std430, set = 0, binding = 2) buffer DrawCounts {
+    uint counts[];
+} drawCounts;
+
+layout(push_constant) uniform CullConstants {
+    vec4 planes[6];
+    uint objectCount;
+    uint compactDraws;
+} cull;
+
+void main() {
+    uint objectIndex = gl_GlobalInvocationID.x;
+    if (objectIndex >= cull.objectCount) {
+        return;
+    }
+
+    // A box is outside if it is entirely behind any plane.
+    CullObject object = cullObjects.objects[objectIndex];
+    bool visible = true;
+    for (int i = 0; i < 6; ++i) {
+        vec4 plane = cull.planes[i];
+        float radius = dot(object.extent, abs(plane.xyz));
+        if (dot(plane.xyz, object.center) + plane.w < -radius) {
+            visible = false;
+            break;
+        }
+    }
+
+    // The object's transform is at its own index in the instance buffer, so it is drawn as its own first instance.
+    if (cull.compactDraws != 0) {
+        if (visible) {
+            uint slot = object.firstCommand + atomicAdd(drawCounts.counts[object.batchIndex], 1);
+            drawCommands.draws[slot] = DrawIndexedCommand(object.indexCount, 1, object.firstIndex, object.vertexOffset, objectIndex);
+        }
+    } else {
+        drawCommands.draws[objectIndex] = DrawIndexedCommand(object.indexCount, visible ? 1 : 0, object.firstIndex, object.vertexOffset, objectIndex);
+    }
+}
\ No newline at end of file
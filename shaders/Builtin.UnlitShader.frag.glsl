@@ -1,13 +1,29 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
+#extension GL_EXT_nonuniform_qualifier : enable
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec2 fragTexCoord;
 
-layout(set = 1, binding = 1) uniform sampler2D texSampler;
+// Every loaded texture, indexed by the material table.
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+struct MaterialData {
+    uint diffuseTextureIndex;
+    uint reserved[3];
+};
+
+layout(std430, set = 1, binding = 1) readonly buffer MaterialTable {
+    MaterialData materials[];
+} materialTable;
+
+layout(push_constant) uniform MaterialPush {
+    uint materialIndex;
+} push;
 
 layout(location = 0) out vec4 outColor;
 
 void main() {
-    outColor = vec4(fragColor * texture(texSampler, fragTexCoord).rgb, 1.0);
+    MaterialData material = materialTable.materials[push.materialIndex];
+    outColor = vec4(fragColor * texture(textures[nonuniformEXT(material.diffuseTextureIndex)], fragTexCoord).rgb, 1.0);
 }
\ No newline at end of file
@@ -6,6 +6,9 @@ layout(location = 1) in vec3 inNormal;
 layout(location = 2) in vec2 inTexCoord;
 layout(location = 3) in vec3 inColor;
 
+// Per-instance world matrix. Occupies locations 4-7.
+layout(location = 4) in mat4 inModel;
+
 layout(set = 0, binding = 0) uniform GlobalUniformObject {
 	mat4 view;
 	mat4 projection;
@@ -13,18 +16,11 @@ layout(set = 0, binding = 0) uniform GlobalUniformObject {
 	mat4 reserved2;
 } globalUbo;
 
-layout(set = 1, binding = 0) uniform UnlitUniformObject {
-	mat4 model;
-	mat4 reserved1;
-	mat4 reserved2;
-	mat4 reserved3;
-} objectUbo;
-
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
 
 void main() {
-    gl_Position = globalUbo.projection * globalUbo.view * objectUbo.model * vec4(inPosition, 1.0);
+    gl_Position = globalUbo.projection * globalUbo.view * inModel * vec4(inPosition, 1.0);
     fragColor = inColor;
 	fragTexCoord = inTexCoord;
 }
\ No newline at end of file
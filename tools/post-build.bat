@@ -6,10 +6,20 @@ REM Run from root directory!
 if not exist "%1build\shaders\" mkdir "%1build\shaders"
 
 echo "Compiling shaders..."
-echo "%1shaders/Builtin.UnlitShader.vert.glsl -> %1build/shaders/Builtin.UnlitShader.vert.spv"
-glslc.exe -fshader-stage=vert %1shaders/Builtin.UnlitShader.vert.glsl -o %1build/shaders/Builtin.UnlitShader.vert.spv
-echo "%1shaders/Builtin.UnlitShader.frag.glsl -> %1build/shaders/Builtin.UnlitShader.frag.spv"
-glslc.exe -fshader-stage=frag %1shaders/Builtin.UnlitShader.frag.glsl -o %1build/shaders/Builtin.UnlitShader.frag.spv
+REM Every shader is named NAME.STAGE.glsl, and is compiled to NAME.STAGE.spv.
+for %%s in (vert frag geom comp) do (
+    for %%f in ("%1shaders\*.%%s.glsl") do (
+        echo "%%f -> %1build/shaders/%%~nf.spv"
+        glslc.exe --target-env=vulkan1.2 -fshader-stage=%%s "%%f" -o "%1build/shaders/%%~nf.spv"
+    )
+)
+
+REM Reflect and pack every module into one archive. Epoch.Tools is built after the engine, so may not exist yet on a
+REM first build, in which case the engine falls back to the loose modules.
+if exist "%1build\Epoch.Tools.exe" (
+    echo "Packing shaders..."
+    "%1build\Epoch.Tools.exe" -pack-shaders "%1build\shaders" "%1build\shaders\shaders.esa"
+)
 
 echo "Copying assets..."
 echo xcopy "%1assets" "%1build\assets" /h /i /c /k /e /r /y